@@ -48,8 +48,116 @@
 /** \cond INTERNAL */
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
 CY_SECTION(".cy_boot_noinit.appId") __USED static uint8_t cy_dfu_appId;
+
+#if CY_DFU_OPT_VALID_CACHE != 0
+/* The cached result of Cy_DFU_ValidateApp() for an application */
+typedef struct
+{
+    uint32_t metadataCrc;   /* The CRC-32C of the application ID and metadata the result is for */
+    uint32_t generation;    /* The write generation the result is for */
+} cy_stc_dfu_valid_entry_t;
+
+/* The cache of the valid applications, kept over a software reset */
+typedef struct
+{
+    uint32_t magic;         /* VALID_CACHE_MAGIC if the cache is initialized */
+    uint32_t crc;           /* The CRC-32C of the fields below */
+    uint32_t generation;    /* Advanced by each NVM write, see Cy_DFU_ValidCacheInvalidate() */
+    cy_stc_dfu_valid_entry_t apps[CY_DFU_MAX_APPS];
+} cy_stc_dfu_valid_cache_t;
+
+CY_SECTION(".cy_boot_noinit") __USED static cy_stc_dfu_valid_cache_t cy_dfu_validCache;
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+/* The current record of an application in the metadata journal */
+typedef struct
+{
+    uint32_t verifyAddress; /* The verified area of the application */
+    uint32_t verifySize;
+    uint32_t row;           /* The journal row of the record, JOURNAL_NO_ROW if there is none */
+    uint32_t sequence;      /* The sequence number of the record */
+} cy_stc_dfu_journal_entry_t;
+
+/* The RAM index of the metadata journal, see JournalBuild() */
+typedef struct
+{
+    cy_stc_dfu_journal_entry_t apps[CY_DFU_MAX_APPS];
+    uint32_t headRow;       /* The row of the newest record, the next record is written after it */
+    uint32_t headSequence;  /* The sequence number of the newest record */
+    bool     built;         /* The index is built from the journal in the NVM */
+} cy_stc_dfu_journal_t;
+
+static cy_stc_dfu_journal_t cy_dfu_journal;
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+
+#if CY_DFU_OPT_SWAP != 0
+/* The status record of a slot swap, written to a row of the swap status area, see SwapSave() */
+typedef struct
+{
+    uint32_t magic;         /* SWAP_MAGIC */
+    uint32_t crc;           /* The CRC-32C of the fields below */
+    uint32_t sequence;      /* Incremented with each write, the record with the highest one is current */
+    uint32_t primary;       /* The start address of the primary slot */
+    uint32_t secondary;     /* The start address of the secondary slot */
+    uint32_t length;        /* The number of the bytes of each slot */
+    uint32_t count;         /* The number of the blocks the swap exchanges, starting from block 0 */
+    uint32_t block;         /* The block being exchanged, count if the swap is complete */
+    uint32_t step;          /* The next step of the block, see SwapRun() */
+    uint32_t revert;        /* Non-zero if the blocks are exchanged back when the swap is complete */
+} cy_stc_dfu_swap_status_t;
+#endif /* CY_DFU_OPT_SWAP != 0 */
+
+#if CY_DFU_OPT_METADATA_CACHE != 0
+/* The number of the metadata bytes kept in RAM: the whole metadata, the first row of the journal */
+#if (CY_DFU_OPT_METADATA_V2 != 0) && (CY_DFU_OPT_METADATA_JOURNAL == 0)
+    #define METADATA_CACHE_SIZE             (CY_DFU_METADATA_LENGTH)
+#else
+    #define METADATA_CACHE_SIZE             (CY_NVM_SIZEOF_ROW)
+#endif /* (CY_DFU_OPT_METADATA_V2 != 0) && (CY_DFU_OPT_METADATA_JOURNAL == 0) */
+
+/* The RAM copy of the metadata, see Cy_DFU_MetadataCacheInvalidate() */
+typedef struct
+{
+    uint32_t data[METADATA_CACHE_SIZE / sizeof(uint32_t)];  /* The metadata bytes, loaded by MetadataCacheData() */
+    cy_en_dfu_status_t status;  /* The result of Cy_DFU_ValidateMetadata() for the metadata */
+    bool     loaded;            /* data is read from the NVM */
+    bool     validated;         /* status is set */
+} cy_stc_dfu_metadata_cache_t;
+
+static cy_stc_dfu_metadata_cache_t cy_dfu_metadataCache;
+#endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
+#if CY_DFU_OPT_NVM_CACHE != 0
+/* The RAM copy of an erase unit of an NVM region, written back by Cy_DFU_NvmFlush() */
+typedef struct
+{
+    uint32_t data[CY_DFU_NVM_CACHE_SIZE / sizeof(uint32_t)];  /* The bytes of the erase unit */
+    const cy_stc_dfu_nvm_region_t *region;  /* The region of the unit, NULL if the cache is empty */
+    uint32_t address;       /* The address of the unit */
+} cy_stc_dfu_nvm_cache_t;
+
+static cy_stc_dfu_nvm_cache_t cy_dfu_nvmCache;
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
+
+#if CY_DFU_OPT_NVM_ASYNC != 0
+/* The Program Data command that waits for its NVM write, see ProgramDataPoll() */
+typedef struct
+{
+    uint32_t address;       /* The address of the data */
+    uint32_t length;        /* The length in bytes of the data */
+    bool     active;        /* The write returned CY_DFU_IN_PROGRESS, the response is not sent yet */
+} cy_stc_dfu_program_pending_t;
+
+static cy_stc_dfu_program_pending_t cy_dfu_programPending;
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+
+#if CY_DFU_OPT_CRYPTO_HW != 0
+/* The Crypto block is enabled by CryptoAcquire() */
+static bool cy_dfu_cryptoEnabled = false;
+#endif /* CY_DFU_OPT_CRYPTO_HW != 0 */
+
 
 /* The timeout for Cy_DFU_Continue(), in milliseconds */
 #define UPDATE_TIMEOUT                      (20U)
@@ -83,6 +191,12 @@ CY_SECTION(".cy_boot_noinit.appId") __USED static uint8_t cy_dfu_appId;
 #define CRC_CCITT_INIT                      (0xFFFFU)
 #define CRC_CCITT_POLYNOMIAL                (0x8408U)
 
+#if (CY_DFU_OPT_PACKET_CRC != 0U)
+    #define PACKET_CHECKSUM_INIT            (CRC_CCITT_INIT)
+#else
+    #define PACKET_CHECKSUM_INIT            (0U)
+#endif /* CY_DFU_OPT_PACKET_CRC != 0U */
+
 #define STATUS_BYTE_MSK                     (0xFFU)
 
 /* The size in bytes of the DFU command parameters */
@@ -138,6 +252,158 @@ CY_SECTION(".cy_boot_noinit.appId") __USED static uint8_t cy_dfu_appId;
 #define PACKET_DATA_IDX                     (0x04U)
 #define PACKET_CHECKSUM_LENGTH              (2U)    /* The length in bytes of a packet checksum field */
 
+/* The size in bytes of the data field in the Get Stats command */
+#define GET_STATS_DATA_SIZE                 (1U)
+/* Not a DFU command, Cy_DFU_Continue() has not received a packet */
+#define STATS_NO_COMMAND                    (0x100U)
+
+/* The size in bytes of the data field in the Get Progress command */
+#define GET_PROGRESS_DATA_SIZE              (14U)
+/* The offsets in bytes to the fields of the Get Progress command data */
+#define GET_PROGRESS_START_OFFSET           (4U)
+#define GET_PROGRESS_LENGTH_OFFSET          (8U)
+#define GET_PROGRESS_BITMAP_OFFSET          (12U)
+/* The size in bytes of the row count and done count fields of the Get Progress response */
+#define GET_PROGRESS_RSP_HEADER_SIZE        (8U)
+/* "DFUP", the magic number of a progress record */
+#define PROGRESS_MAGIC                      (0x50554644U)
+/* The offsets in bytes to the fields of a progress record */
+#define PROGRESS_CRC_OFFSET                 (4U)
+#define PROGRESS_SEQUENCE_OFFSET            (8U)
+/* "DFUV", the magic number of the validity cache */
+#define VALID_CACHE_MAGIC                   (0x56554644U)
+/* The size in bytes of the validity cache fields covered by its CRC */
+#define VALID_CACHE_CRC_SIZE                (sizeof(cy_stc_dfu_valid_cache_t) - (2U * UINT32_SIZE))
+
+/* "DFUS", the magic number of a swap status record */
+#define SWAP_MAGIC                          (0x53554644U)
+/* The steps of the exchange of a block: secondary to scratch, primary to secondary, scratch to primary */
+#define SWAP_STEP_TO_SCRATCH                (0U)
+#define SWAP_STEP_TO_SECONDARY              (1U)
+#define SWAP_STEP_TO_PRIMARY                (2U)
+/* The swap of the record is not complete */
+#define SWAP_IN_PROGRESS(record)            (((record).block < (record).count) || ((record).revert != 0U))
+/* The size in bytes of the swap status record fields covered by its CRC */
+#define SWAP_CRC_SIZE                       (sizeof(cy_stc_dfu_swap_status_t) - (2U * UINT32_SIZE))
+
+#if CY_DFU_OPT_NOR != 0
+    /* The serial NOR commands used with all the devices */
+    #define NOR_CMD_WRITE_ENABLE            (0x06U)
+    #define NOR_CMD_READ_STATUS             (0x05U)
+    #define NOR_CMD_READ_STATUS2            (0x35U)
+    #define NOR_CMD_WRITE_STATUS            (0x01U)
+    #define NOR_CMD_PAGE_PROGRAM            (0x02U)
+    #define NOR_CMD_FAST_READ               (0x0BU)
+    #define NOR_CMD_READ_SFDP               (0x5AU)
+    #define NOR_CMD_ENTER_4BYTE             (0xB7U)
+    /* The write-in-progress bit of the status register */
+    #define NOR_STATUS_WIP                  (0x01U)
+    /* "SFDP", the signature of the SFDP header */
+    #define NOR_SFDP_SIGNATURE              (0x50444653U)
+    /* The size in bytes of the SFDP header and of a parameter header */
+    #define NOR_SFDP_HEADER_SIZE            (8U)
+    /* The number of the DWORDs of the basic flash parameter table the driver reads */
+    #define NOR_SFDP_DWORDS                 (16U)
+    /* The dummy cycles of the SFDP read and of the 1-1-1 fast read */
+    #define NOR_DUMMY_CYCLES                (8U)
+    /* The page size of the devices with the SFDP tables older than JESD216B */
+    #define NOR_DEFAULT_PAGE_SIZE           (256U)
+    /* The size in bytes of the chunks Cy_DFU_NorCompare() reads the device in */
+    #define NOR_COMPARE_CHUNK               (64U)
+    /* The number of the status polls of a page program and of an erase */
+    #define NOR_PROGRAM_POLLS               ((CY_DFU_NOR_PROGRAM_TIMEOUT_MS * 1000U) / CY_DFU_NOR_POLL_INTERVAL_US)
+    #define NOR_ERASE_POLLS                 ((CY_DFU_NOR_ERASE_TIMEOUT_MS * 1000U) / CY_DFU_NOR_POLL_INTERVAL_US)
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+/* The metadata journal row of an application that has no record */
+#define JOURNAL_NO_ROW                      (0xFFFFFFFFU)
+/* The size in bytes of the record fields that the user's code sets: the verified area, version, flags and digest */
+#define JOURNAL_RECORD_DATA_SIZE            ((4U * UINT32_SIZE) + CY_DFU_METADATA_DIGEST_SIZE)
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0)
+    #if CY_DFU_OPT_METADATA_V2 == 0
+        #error "CY_DFU_OPT_METADATA_JOURNAL requires CY_DFU_OPT_METADATA_V2"
+    #endif /* CY_DFU_OPT_METADATA_V2 == 0 */
+    #if CY_DFU_METADATA_JOURNAL_ROWS <= CY_DFU_MAX_APPS
+        #error "CY_DFU_METADATA_JOURNAL_ROWS must be more than CY_DFU_MAX_APPS"
+    #endif /* CY_DFU_METADATA_JOURNAL_ROWS <= CY_DFU_MAX_APPS */
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0) */
+
+#if CY_DFU_OPT_STATS != 0
+    #if CY_DFU_STATS_HIST_BINS > 32U
+        #error "CY_DFU_STATS_HIST_BINS must not exceed 32"
+    #endif /* CY_DFU_STATS_HIST_BINS > 32U */
+
+    #define STATS_PACKET_BEGIN(params)                  StatsPacketBegin(params)
+    #define STATS_PACKET_END(params, command, status)   StatsPacketEnd((params), (command), (status))
+    #define STATS_STAGE_BEGIN(params)                   StatsStageBegin(params)
+    #define STATS_STAGE_END(params, stage)              StatsStageEnd((params), (stage))
+    #define NVM_STATS_BEGIN(params)                     Cy_DFU_StatsNvmBegin(params)
+    #define NVM_STATS_END(params, operation, address, length, result) \
+                                Cy_DFU_StatsNvmEnd((params), (operation), (address), (length), (uint32_t)(result))
+#else
+    #define STATS_PACKET_BEGIN(params)
+    #define STATS_PACKET_END(params, command, status)
+    #define STATS_STAGE_BEGIN(params)
+    #define STATS_STAGE_END(params, stage)
+    #define NVM_STATS_BEGIN(params)
+    #define NVM_STATS_END(params, operation, address, length, result)
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+#if CY_DFU_OPT_RESUME != 0
+    #if (CY_DFU_PROGRESS_SLOTS == 0U) || (CY_DFU_PROGRESS_INTERVAL == 0U)
+        #error "CY_DFU_PROGRESS_SLOTS and CY_DFU_PROGRESS_INTERVAL must not be 0"
+    #endif /* (CY_DFU_PROGRESS_SLOTS == 0U) || (CY_DFU_PROGRESS_INTERVAL == 0U) */
+
+    #define PROGRESS_MARK(params, address, length)      ProgressMark((params), (address), (length))
+    #define PROGRESS_UNMARK(params, address)            ProgressUnmark((params), (address))
+    #define PROGRESS_FINISH(params)                     ProgressFinish(params)
+    #define PROGRESS_FLUSH(params)                      ProgressFlush(params)
+#else
+    #define PROGRESS_MARK(params, address, length)
+    #define PROGRESS_UNMARK(params, address)
+    #define PROGRESS_FINISH(params)
+    #define PROGRESS_FLUSH(params)
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
+#if CY_DFU_OPT_NVM_CACHE != 0
+    #if (CY_DFU_NVM_CACHE_SIZE == 0U) || ((CY_DFU_NVM_CACHE_SIZE % 4U) != 0U)
+        #error "CY_DFU_NVM_CACHE_SIZE must be a non-zero multiple of 4"
+    #endif /* (CY_DFU_NVM_CACHE_SIZE == 0U) || ((CY_DFU_NVM_CACHE_SIZE % 4U) != 0U) */
+
+    #define NVM_CACHE_FLUSH(params)                     Cy_DFU_NvmFlush(params)
+#else
+    #define NVM_CACHE_FLUSH(params)                     (CY_DFU_SUCCESS)
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0)
+    #if (CY_DFU_APP_FORMAT != CY_DFU_BASIC_APP) || ((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_OPT_SHA256 == 0))
+        #error "CY_DFU_OPT_INLINE_DIGEST requires the basic application format with CRC-32C or SHA-256"
+    #endif /* (CY_DFU_APP_FORMAT != CY_DFU_BASIC_APP) || ((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_OPT_SHA256 == 0)) */
+
+    #define DIGEST_ENABLED                              (1)
+    #define DIGEST_START(params, appId)                 DigestStart((params), (appId))
+    #define DIGEST_UPDATE(params, address, length)      DigestUpdate((params), (address), (length))
+#else
+    #define DIGEST_ENABLED                              (0)
+    #define DIGEST_START(params, appId)
+    #define DIGEST_UPDATE(params, address, length)
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0) */
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_CACHE != 0)
+    #define METADATA_CACHE_INVALIDATE()                 Cy_DFU_MetadataCacheInvalidate()
+#else
+    #define METADATA_CACHE_INVALIDATE()
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_CACHE != 0) */
+
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+#if CY_DFU_OPT_VALID_CACHE != 0
+static bool ValidCacheIntact(void);
+static void ValidCacheSeal(void);
+static uint32_t ValidCacheKey(uint32_t appId, uint32_t verifyAddress, uint32_t verifySize);
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
 /* The Flash Boot verification functions*/
 #if(CY_DFU_APP_FORMAT != CY_DFU_BASIC_APP)
@@ -156,18 +422,59 @@ typedef void (*cy_fn_dfu_jump_ptr_t)(void);
     static uint32_t ElfSymbolToAddr(void volatile const *symbol);
     static __NO_RETURN void SwitchToApp(uint32_t stackPointer, uint32_t address);
     #if ((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))
-        static bool ComputeSha1(uint32_t address, uint32_t length, uint8_t *result);
+        static bool ComputeSha(uint32_t address, uint32_t length, uint8_t *result, cy_en_crypto_sha_mode_t mode);
     #endif /*((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))*/
+    #if ((CY_DFU_OPT_SHA256 != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))
+        static bool ComputeSha256(uint32_t address, uint32_t length, uint8_t *result);
+    #endif /*((CY_DFU_OPT_SHA256 != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))*/
+    #if CY_DFU_OPT_SHA256 != 0
+        static void Sha256Block(uint32_t state[], const uint8_t block[]);
+        static uint32_t Sha256Rotr(uint32_t value, uint32_t shift);
+    #endif /* CY_DFU_OPT_SHA256 != 0 */
+    static cy_en_dfu_status_t MetadataValidate(uint32_t metadataAddress, cy_stc_dfu_params_t *params);
+    #if CY_DFU_OPT_SWAP != 0
+        static bool SwapLoad(cy_stc_dfu_swap_status_t *record, uint32_t *slot, cy_stc_dfu_params_t *params);
+        static cy_en_dfu_status_t SwapSave(cy_stc_dfu_swap_status_t *record, uint32_t *slot,
+                                           cy_stc_dfu_params_t *params);
+        static cy_en_dfu_status_t SwapRun(cy_stc_dfu_swap_status_t *record, uint32_t *slot,
+                                          cy_stc_dfu_params_t *params);
+        static uint32_t SwapSlotSize(void);
+        static bool SwapLayoutValid(uint32_t primaryAddress, uint32_t secondaryAddress);
+    #endif /* CY_DFU_OPT_SWAP != 0 */
+    #if CY_DFU_OPT_METADATA_CACHE != 0
+        static const uint8_t *MetadataCacheData(void);
+    #endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+    #if CY_DFU_OPT_METADATA_V2 != 0
+        static uint32_t MetadataRecordAddress(uint32_t appId);
+        static bool MetadataRecordValid(const uint8_t record[], cy_stc_dfu_params_t *params);
+        #if CY_DFU_OPT_METADATA_JOURNAL != 0
+            static void JournalBuild(void);
+            static bool JournalRecordValid(const cy_stc_dfu_app_metadata_t *record, uint32_t row);
+            static bool JournalRowCurrent(uint32_t row);
+            #if CY_DFU_METADATA_WRITABLE != 0
+                static cy_en_dfu_status_t JournalAppend(uint32_t appId, const cy_stc_dfu_app_metadata_t *record,
+                                                        cy_stc_dfu_params_t *params);
+            #endif /* CY_DFU_METADATA_WRITABLE != 0 */
+        #else
+            static uint32_t MetadataRecordOffset(uint32_t appId);
+            static void MetadataHeaderInit(cy_stc_dfu_metadata_header_t *header, cy_stc_dfu_params_t *params);
+            #if CY_DFU_METADATA_WRITABLE != 0
+                static cy_en_dfu_status_t MetadataFormat(uint32_t metadataAddress, cy_stc_dfu_params_t *params);
+            #endif /* CY_DFU_METADATA_WRITABLE != 0 */
+        #endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+    #endif /* CY_DFU_OPT_METADATA_V2 != 0 */
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
 static uint16_t GetU16(uint8_t const array[]);
 static uint32_t GetU32(uint8_t const array[]);
 static void     PutU16(uint8_t array[], uint32_t offset, uint32_t value);
 
-/* Because PutU32() is used only when updating the metadata */
-#if (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
+/* Because PutU32() is used only when updating the metadata and the progress record */
+#if ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL == 0)) || \
+    (CY_DFU_OPT_RESUME != 0)
     static void PutU32(uint8_t array[], uint32_t offset, uint32_t value);
-#endif /* (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) */
+#endif /* ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL == 0)) ||
+          (CY_DFU_OPT_RESUME != 0) */
 static uint32_t PacketChecksumIndex(uint32_t size);
 static uint32_t PacketEopIndex(uint32_t size);
 static uint32_t GetPacketCommand(const uint8_t packet[]);
@@ -181,9 +488,16 @@ static void SetPacketDSize(uint8_t packet[], uint32_t size);
 static void SetPacketChecksum(uint8_t packet[], uint32_t size, uint32_t checksum);
 static void SetPacketFooter(uint8_t packet[], uint32_t size);
 
+static uint32_t PacketChecksumUpdate(uint32_t checksum, const uint8_t buffer[], uint32_t size);
+static uint32_t PacketChecksumFinish(uint32_t checksum);
 static uint32_t PacketChecksum(const uint8_t buffer[], uint32_t size);
-static cy_en_dfu_status_t VerifyPacket(uint32_t numberRead, const uint8_t packet[]);
-static cy_en_dfu_status_t ReadVerifyPacket(uint8_t packet[], bool *noResponse, uint32_t timeout);
+static cy_en_dfu_status_t VerifyPacket(uint32_t numberRead, const uint8_t packet[],
+                                       const uint8_t payload[], uint32_t payloadSize);
+#if CY_DFU_OPT_ZERO_COPY != 0
+    static cy_en_dfu_status_t ReadExact(uint8_t buffer[], uint32_t size, uint32_t timeout);
+    static cy_en_dfu_status_t ReadPacketZeroCopy(uint8_t packet[], cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+static cy_en_dfu_status_t ReadVerifyPacket(uint8_t packet[], bool *noResponse, cy_stc_dfu_params_t *params);
 static cy_en_dfu_status_t WritePacket(cy_en_dfu_status_t status, uint8_t *packet, uint32_t rspSize);
 static void EnterResponse(uint8_t *packet, uint32_t *rspSize, uint32_t *state);
 
@@ -193,6 +507,10 @@ static cy_en_dfu_status_t CopyToDataBuffer(uint8_t dataBuffer[], uint32_t *dataO
 static cy_en_dfu_status_t CommandEnter(uint8_t *packet, uint32_t *rspSize, uint32_t *state,
                                             cy_stc_dfu_params_t *params);
 static cy_en_dfu_status_t CommandProgramData(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params);
+static cy_en_dfu_status_t ProgramDataComplete(uint32_t address, uint32_t length, cy_stc_dfu_params_t *params);
+#if CY_DFU_OPT_NVM_ASYNC != 0
+static cy_en_dfu_status_t ProgramDataPoll(cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
 
 #if CY_DFU_OPT_ERASE_DATA != 0
 static cy_en_dfu_status_t CommandEraseData(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params);
@@ -224,6 +542,69 @@ static cy_en_dfu_status_t CommandGetMetadata(uint8_t *packet, uint32_t *rspSize,
 #endif /* CY_DFU_OPT_SET_EIVECTOR != 0 */
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
+#if CY_DFU_OPT_STATS != 0
+static uint32_t StatsSlot(uint32_t command);
+static void StatsPacketBegin(cy_stc_dfu_params_t *params);
+static void StatsPacketEnd(cy_stc_dfu_params_t *params, uint32_t command, cy_en_dfu_status_t status);
+static void StatsStageBegin(cy_stc_dfu_params_t *params);
+static void StatsStageEnd(cy_stc_dfu_params_t *params, uint32_t stage);
+static cy_en_dfu_status_t CommandGetStats(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+#if CY_DFU_OPT_RESUME != 0
+static void ProgressLoad(cy_stc_dfu_params_t *params);
+static cy_en_dfu_status_t ProgressSave(cy_stc_dfu_params_t *params);
+static void ProgressMark(cy_stc_dfu_params_t *params, uint32_t address, uint32_t length);
+#if (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
+static bool ProgressUnitDone(const cy_stc_dfu_progress_t *progress, uint32_t address);
+#endif /* (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) */
+static void ProgressUnmark(cy_stc_dfu_params_t *params, uint32_t address);
+static void ProgressFinish(cy_stc_dfu_params_t *params);
+static void ProgressFlush(cy_stc_dfu_params_t *params);
+static cy_en_dfu_status_t CommandGetProgress(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
+#if CY_DFU_OPT_CRYPTO_HW == 0
+static uint32_t CrcUpdate(uint32_t crc, const uint8_t *address, uint32_t length);
+#else
+static cy_en_crypto_status_t CryptoAcquire(void);
+#endif /* CY_DFU_OPT_CRYPTO_HW == 0 */
+
+static bool NvmRangeValid(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t NvmCompare(const cy_stc_dfu_nvm_region_t *region, uint32_t address, const uint8_t data[],
+                                     uint32_t length);
+static cy_en_dfu_status_t NvmProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                     uint32_t length, bool eraseOnly, bool wait, cy_stc_dfu_params_t *params);
+#if CY_DFU_OPT_NVM_CACHE != 0
+static bool NvmCacheable(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t NvmCacheWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                        cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
+
+#if CY_DFU_OPT_NOR != 0
+static void NorCmdInit(cy_stc_dfu_nor_cmd_t *cmd, uint8_t opcode, uint32_t addressSize, uint32_t address);
+static cy_en_dfu_status_t NorSfdpRead(const cy_stc_dfu_nor_t *nor, uint32_t address, uint8_t data[],
+                                      uint32_t length);
+static cy_en_dfu_status_t NorRegisterRead(const cy_stc_dfu_nor_t *nor, uint8_t opcode, uint8_t *value);
+static cy_en_dfu_status_t NorWaitReady(const cy_stc_dfu_nor_t *nor, uint32_t polls);
+static cy_en_dfu_status_t NorWrite(const cy_stc_dfu_nor_t *nor, const cy_stc_dfu_nor_cmd_t *cmd, uint32_t polls);
+static cy_en_dfu_status_t NorQuadEnable(const cy_stc_dfu_nor_t *nor, uint32_t requirement);
+static bool NorRangeValid(const cy_stc_dfu_nor_t *nor, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t NorRegionRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                        uint32_t length);
+static cy_en_dfu_status_t NorRegionCompare(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                           const uint8_t data[], uint32_t length);
+static cy_en_dfu_status_t NorRegionErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t NorRegionProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                           const uint8_t data[], uint32_t length);
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+#if DIGEST_ENABLED != 0
+static void DigestStart(cy_stc_dfu_params_t *params, uint32_t appId);
+static void DigestUpdate(cy_stc_dfu_params_t *params, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t DigestVerify(uint32_t appId, cy_stc_dfu_params_t *params);
+#endif /* DIGEST_ENABLED != 0 */
+
 static cy_en_dfu_status_t CommandUnsupported(uint8_t packet[], uint32_t *rspSize,
                                                               cy_stc_dfu_params_t *params );
 static cy_en_dfu_status_t ContinueHelper(uint32_t command, uint8_t *packet, uint32_t *rspSize,
@@ -274,6 +655,15 @@ cy_en_dfu_status_t Cy_DFU_Init(uint32_t *state, cy_stc_dfu_params_t *params)
     {
         *state = CY_DFU_STATE_NONE;
         params->dataOffset = 0U;
+    #if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0)
+        /* The journal index is built again on the next use */
+        cy_dfu_journal.built = false;
+    #endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0) */
+        METADATA_CACHE_INVALIDATE();
+    #if CY_DFU_OPT_NVM_ASYNC != 0
+        /* The response of an unfinished Program Data command is not sent */
+        cy_dfu_programPending.active = false;
+    #endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
     }
     return (status);
 }
@@ -410,6 +800,13 @@ CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting pointer to a int is safe
 * providing a function with the same name.
 * This allows the user to place metadata in any NVM.
 *
+* With \ref CY_DFU_OPT_METADATA_V2, the values are read from the application
+* record, and its CRC is not checked, see \ref Cy_DFU_GetAppRecord. With
+* \ref CY_DFU_OPT_METADATA_JOURNAL, they are read from the RAM index of the
+* journal, and \ref CY_DFU_ERROR_VERIFY is returned with 0 values if the
+* application has no record. Otherwise, with \ref CY_DFU_OPT_METADATA_CACHE,
+* they are read from the RAM copy of the metadata.
+*
 * \note It is assumed appId is a valid application number.
 *
 * \param appId          The application number.
@@ -427,7 +824,30 @@ __WEAK cy_en_dfu_status_t Cy_DFU_GetAppMetadata(uint32_t appId, uint32_t *verify
 
    CY_ASSERT(appId < CY_DFU_MAX_APPS);
 
-   uint32_t *ptr = (uint32_t*) ( ElfSymbolToAddr(&__cy_boot_metadata_addr) + (appId * METADATA_BYTES_PER_APP) );
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+   if (!cy_dfu_journal.built)
+   {
+       JournalBuild();
+   }
+   const cy_stc_dfu_journal_entry_t *entry = &cy_dfu_journal.apps[appId];
+   const uint32_t ptr[2U] = { entry->verifyAddress, entry->verifySize };
+   if (entry->row == JOURNAL_NO_ROW)
+   {
+       status = CY_DFU_ERROR_VERIFY;
+   }
+#else
+  #if CY_DFU_OPT_METADATA_V2 != 0
+   uint32_t offset = MetadataRecordOffset(appId);
+  #else
+   uint32_t offset = appId * METADATA_BYTES_PER_APP;
+  #endif /* CY_DFU_OPT_METADATA_V2 != 0 */
+  #if CY_DFU_OPT_METADATA_CACHE != 0
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The cached metadata is 4-byte aligned and so are the application records.');
+   const uint32_t *ptr = (const uint32_t *) &MetadataCacheData()[offset];
+  #else
+   uint32_t *ptr = (uint32_t*) ( ElfSymbolToAddr(&__cy_boot_metadata_addr) + offset );
+  #endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
 
    if (verifyAddress != NULL)
    {
@@ -445,45 +865,46 @@ __WEAK cy_en_dfu_status_t Cy_DFU_GetAppMetadata(uint32_t appId, uint32_t *verify
 /* Use PDL Hardware Crypto API */
 #if ((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))
 /*******************************************************************************
-* Function Name: ComputeSha1
+* Function Name: ComputeSha
 ****************************************************************************//**
 *
-* This function computes SHA1 for the message.
+* This function computes SHA1 or SHA-256 for the message.
 *
 * \note Ensure the Crypto block is properly initialized
-* and \ref CY_DFU_OPT_CRYPTO_HW is set.
+* and \ref CY_DFU_OPT_CRYPTO_HW is set. The Crypto block is left enabled,
+* see \ref Cy_DFU_CryptoRelease.
 *
 * \param address    The pointer to a buffer containing data to compute
 *                   the checksum for. \n
 *                   It must be 4-byte aligned.
-* \param length     The number of bytes in the buffer to compute SHA1 for.
-* \param result     The pointer to a buffer to store the SHA1 output.
+* \param length     The number of bytes in the buffer to compute SHA for.
+* \param result     The pointer to a buffer to store the SHA output.
 *                   It must be 4-byte aligned.
+* \param mode       CY_CRYPTO_MODE_SHA1 or CY_CRYPTO_MODE_SHA256.
 *
 * \return
 * - true  - If calculation is successful.
 * - false - If calculation is unsuccessful.
 *
 *******************************************************************************/
-static bool ComputeSha1(uint32_t address, uint32_t length, uint8_t *result)
+static bool ComputeSha(uint32_t address, uint32_t length, uint8_t *result, cy_en_crypto_sha_mode_t mode)
 {
 
     cy_stc_crypto_context_sha_t cryptoShaContext;
     cy_en_crypto_status_t cryptoStatus;
     bool statusOk = true;
 
-    cryptoStatus = Cy_Crypto_Enable();
+    cryptoStatus = CryptoAcquire();
     if (cryptoStatus == CY_CRYPTO_SUCCESS)
     {
 CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting result operand to uint32_t is safe as calling function use uint32_t pointer.');
-        cryptoStatus = Cy_Crypto_Sha_Run((uint32_t *)address, length, (uint32_t *)result, CY_CRYPTO_MODE_SHA1,
+        cryptoStatus = Cy_Crypto_Sha_Run((uint32_t *)address, length, (uint32_t *)result, mode,
                                           &cryptoShaContext);
         if (cryptoStatus == CY_CRYPTO_SUCCESS)
         {
-            /* Waiting for SHA1 calculation is finished. */
+            /* Waiting for SHA calculation is finished. */
             cryptoStatus = Cy_Crypto_Sync(CY_CRYPTO_SYNC_BLOCKING);
         }
-        (void) Cy_Crypto_Disable();
     }
     if (cryptoStatus != CY_CRYPTO_SUCCESS)
     {
@@ -494,6 +915,43 @@ CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting result operand to uint32
 #endif /* ((CY_DFU_OPT_CRYPTO_HW != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP)) */
 
 
+#if ((CY_DFU_OPT_SHA256 != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP))
+/*******************************************************************************
+* Function Name: ComputeSha256
+****************************************************************************//**
+*
+* This function computes SHA-256 for the message, with the Crypto block if
+* \ref CY_DFU_OPT_CRYPTO_HW is set, in software otherwise.
+*
+* \param address    The pointer to a buffer containing data to compute
+*                   the checksum for. \n
+*                   It must be 4-byte aligned.
+* \param length     The number of bytes in the buffer to compute SHA-256 for.
+* \param result     The pointer to a buffer to store the SHA-256 output.
+*                   It must be 4-byte aligned.
+*
+* \return
+* - true  - If calculation is successful.
+* - false - If calculation is unsuccessful.
+*
+*******************************************************************************/
+static bool ComputeSha256(uint32_t address, uint32_t length, uint8_t *result)
+{
+#if CY_DFU_OPT_CRYPTO_HW != 0
+    return (ComputeSha(address, length, result, CY_CRYPTO_MODE_SHA256));
+#else
+    cy_stc_dfu_sha256_t context;
+
+    Cy_DFU_Sha256Init(&context);
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as it has valid address defined in linker script.');
+    Cy_DFU_Sha256Update(&context, (const uint8_t *)address, length);
+    Cy_DFU_Sha256Final(&context, result);
+    return (true);
+#endif /* CY_DFU_OPT_CRYPTO_HW != 0 */
+}
+#endif /* ((CY_DFU_OPT_SHA256 != 0) && (CY_DFU_APP_FORMAT == CY_DFU_BASIC_APP)) */
+
+
 #if(CY_DFU_APP_FORMAT != CY_DFU_BASIC_APP)
 #if(CY_DFU_SEC_APP_VERIFY_TYPE == CY_DFU_VERIFY_FAST)
 /*******************************************************************************
@@ -612,22 +1070,35 @@ static bool VerifySecureApp(uint32_t verifyStartAddr, uint32_t verifyLength, uin
 * \return See \ref cy_en_dfu_status_t.
 * - \ref CY_DFU_SUCCESS If the application is valid.
 * - \ref CY_DFU_ERROR_VERIFY If the application is invalid.
+* - \ref CY_DFU_ERROR_BAD_PARAM If appId is not less than \ref CY_DFU_MAX_APPS.
 *
 *******************************************************************************/
 __WEAK cy_en_dfu_status_t Cy_DFU_ValidateApp(uint32_t appId, cy_stc_dfu_params_t *params)
 {
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
-    uint32_t appVerifyStartAddress;
-    uint32_t appVerifySize;
+    uint32_t appVerifyStartAddress = 0U;
+    uint32_t appVerifySize = 0U;
+    cy_en_dfu_status_t status = CY_DFU_ERROR_BAD_PARAM;
 
     (void)params;
 
     CY_ASSERT(appId < CY_DFU_MAX_APPS);
 
-    cy_en_dfu_status_t status = Cy_DFU_GetAppMetadata(appId, &appVerifyStartAddress, &appVerifySize);
+    if (appId < CY_DFU_MAX_APPS)
+    {
+        status = Cy_DFU_GetAppMetadata(appId, &appVerifyStartAddress, &appVerifySize);
+    }
 
+#if CY_DFU_OPT_VALID_CACHE != 0
+    uint32_t metadataCrc = ValidCacheKey(appId, appVerifyStartAddress, appVerifySize);
+    bool cached = (status == CY_DFU_SUCCESS) && (appId < CY_DFU_MAX_APPS) && ValidCacheIntact() &&
+                  (cy_dfu_validCache.apps[appId].metadataCrc == metadataCrc) &&
+                  (cy_dfu_validCache.apps[appId].generation == cy_dfu_validCache.generation);
+#else
+    bool cached = false;
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
 
-    if (status == CY_DFU_SUCCESS)
+    if ((status == CY_DFU_SUCCESS) && !cached)
     {
     #if(CY_DFU_APP_FORMAT == CY_DFU_CYPRESS_APP)
         status = (VerifySecureApp(appVerifyStartAddress, appVerifySize, appVerifyStartAddress + appVerifySize))?
@@ -636,10 +1107,23 @@ __WEAK cy_en_dfu_status_t Cy_DFU_ValidateApp(uint32_t appId, cy_stc_dfu_params_t
         status = (VerifySecureApp(appVerifyStartAddress, appVerifySize, appVerifyStartAddress - RSA_CHECKSUM_LENGTH))?
                                   CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
     #else
-        #if(CY_DFU_OPT_CRYPTO_HW != 0)
+        #if(CY_DFU_OPT_SHA256 != 0)
+            uint32_t sha256buf[CY_DFU_SHA256_SIZE / UINT32_SIZE];
+            uint32_t appFooterAddress = appVerifyStartAddress + appVerifySize;
+            if (ComputeSha256(appVerifyStartAddress, appVerifySize, (uint8_t*)&sha256buf))
+            {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as it has valid address defined in linker script.');
+                status = (memcmp((const void *)sha256buf, (const void *)appFooterAddress, CY_DFU_SHA256_SIZE) == 0)?
+                                                                        CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+            }
+            else
+            {
+                status = CY_DFU_ERROR_VERIFY;
+            }
+        #elif(CY_DFU_OPT_CRYPTO_HW != 0)
             uint32_t sha1buf[SHA1_BUF_SIZE_UINT32];
             uint32_t appFooterAddress = appVerifyStartAddress + appVerifySize;
-            if (ComputeSha1(appVerifyStartAddress, appVerifySize, (uint8_t*)&sha1buf))
+            if (ComputeSha(appVerifyStartAddress, appVerifySize, (uint8_t*)&sha1buf, CY_CRYPTO_MODE_SHA1))
             {
 CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as it has valid address defined in linker script.');
                 status = (memcmp((const void *)sha1buf, (const void *)appFooterAddress, SHA1_CHECKSUM_LENGTH) == 0)?
@@ -654,8 +1138,18 @@ CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe a
             uint32_t appCrc = Cy_DFU_DataChecksum((uint8_t *)appVerifyStartAddress, appVerifySize, params);
             uint32_t appFooterAddress = (appVerifyStartAddress + appVerifySize);
             status = (*(uint32_t*)appFooterAddress == appCrc) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
-        #endif/* (CY_DFU_OPT_CRYPTO_HW != 0) */
+        #endif/* (CY_DFU_OPT_SHA256 != 0) */
     #endif /* (CY_DFU_APP_FORMAT == CY_DFU_CYPRESS_APP) */
+
+    #if CY_DFU_OPT_VALID_CACHE != 0
+        /* Only the valid applications are cached, an invalid one is verified each time */
+        if ((status == CY_DFU_SUCCESS) && (appId < CY_DFU_MAX_APPS) && ValidCacheIntact())
+        {
+            cy_dfu_validCache.apps[appId].metadataCrc = metadataCrc;
+            cy_dfu_validCache.apps[appId].generation = cy_dfu_validCache.generation;
+            ValidCacheSeal();
+        }
+    #endif /* CY_DFU_OPT_VALID_CACHE != 0 */
     }
     return (status);
 #else
@@ -691,6 +1185,8 @@ uint32_t Cy_DFU_GetRunningApp(void)
 * destination location in flash. This function is typically called when updating
 * an application used as part of an update process, for example updating
 * a BLE stack.
+* The erase units of the destination that already hold the data are not
+* written, see \ref Cy_DFU_CopyAppProgress.
 * \note This API is only for demonstration purpose, use it only when copying
 * from internal flash to internal flash. For other user cases, implement a
 * custom, more general function.
@@ -709,24 +1205,101 @@ uint32_t Cy_DFU_GetRunningApp(void)
 cy_en_dfu_status_t Cy_DFU_CopyApp(uint32_t destAddress, uint32_t srcAddress, uint32_t length,
                                             uint32_t rowSize, cy_stc_dfu_params_t *params)
 {
-    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
-    uint32_t writeAddr  = destAddress;
-    uint32_t readAddr   = srcAddress;
-    uint32_t endAddress = destAddress + length;
+    return (Cy_DFU_CopyAppProgress(destAddress, srcAddress, length, rowSize, params, NULL));
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_CopyAppProgress
+****************************************************************************//**
+*
+* This function copies an application the same way as \ref Cy_DFU_CopyApp and
+* reports the progress to a handler after each erase unit of the destination.
+*
+* The destination is copied by its erase units, see \ref Cy_DFU_GetEraseSize,
+* or by rows if the rows are erased when written. The rows of the source are
+* read to params->dataBuffer and compared with the destination by
+* \ref Cy_DFU_ReadData with \ref CY_DFU_IOCTL_COMPARE. Only the units that
+* differ are written, from their first row as the write of the first row erases
+* the unit, so a copy interrupted by a reset is resumed by calling this
+* function again with the same arguments: the units already copied are only
+* compared. The rest of the last unit after the copied range is erased.
+*
+* \param destAddress  The start address of the application to copy to, at the
+*                     start of an erase unit.
+* \param srcAddress   The start address of the copy of the application to be
+*                     copied.
+* \param length       The number of bytes to copy.
+* \param rowSize      The size of a flash row in bytes.
+* \param params       The pointer to a DFU parameters structure.
+*                     See \ref cy_stc_dfu_params_t .
+* \param handler      The function called after each erase unit, or NULL.
+*
+* \return See \ref cy_en_dfu_status_t.
+* - \ref CY_DFU_ERROR_BAD_PARAM - the erase unit is not a multiple of rowSize,
+*   or destAddress is not at the start of an erase unit.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_CopyAppProgress(uint32_t destAddress, uint32_t srcAddress, uint32_t length,
+                                          uint32_t rowSize, cy_stc_dfu_params_t *params,
+                                          Cy_DFU_CopyProgressHandler handler)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t unitSize = Cy_DFU_GetEraseSize(destAddress);
+    uint32_t offset = 0U;
 
-    while (writeAddr < endAddress)
+    unitSize = (unitSize > rowSize) ? unitSize : rowSize;
+    if ( (rowSize == 0U) || ((unitSize % rowSize) != 0U) || ((destAddress % unitSize) != 0U) )
     {
-        status = Cy_DFU_ReadData(readAddr, rowSize, CY_DFU_IOCTL_READ, params);
-        if (status == CY_DFU_SUCCESS)
+        status = CY_DFU_ERROR_BAD_PARAM;
+    }
+
+    while ( (status == CY_DFU_SUCCESS) && (offset < length) )
+    {
+        uint32_t unitEnd = ((length - offset) > unitSize) ? (offset + unitSize) : length;
+        uint32_t row = offset;
+        bool differs = false;
+
+        while ( (status == CY_DFU_SUCCESS) && !differs && (row < unitEnd) )
         {
-            status = Cy_DFU_WriteData(writeAddr, rowSize, CY_DFU_IOCTL_WRITE, params);
+            status = Cy_DFU_ReadData(srcAddress + row, rowSize, CY_DFU_IOCTL_READ, params);
+            if (status == CY_DFU_SUCCESS)
+            {
+                differs = (Cy_DFU_ReadData(destAddress + row, rowSize, CY_DFU_IOCTL_COMPARE, params) !=
+                           CY_DFU_SUCCESS);
+            }
+            if (!differs)
+            {
+                row += rowSize;
+            }
         }
-        if (status != CY_DFU_SUCCESS)
+
+        if (differs)
+        {   /* The buffer holds the source of the first row of the unit only if that row differs */
+            bool loaded = (row == offset);
+
+            for (row = offset; (status == CY_DFU_SUCCESS) && (row < unitEnd); row += rowSize)
+            {
+                if (!loaded)
+                {
+                    status = Cy_DFU_ReadData(srcAddress + row, rowSize, CY_DFU_IOCTL_READ, params);
+                }
+                loaded = false;
+                if (status == CY_DFU_SUCCESS)
+                {
+                    status = Cy_DFU_WriteData(destAddress + row, rowSize, CY_DFU_IOCTL_WRITE, params);
+                }
+            }
+        }
+
+        if (status == CY_DFU_SUCCESS)
         {
-            break;
+            offset = unitEnd;
+            if (handler != NULL)
+            {
+                handler(offset, length, params);
+            }
         }
-        writeAddr += rowSize;
-        readAddr  += rowSize;
     }
 
     return (status);
@@ -734,1465 +1307,5435 @@ cy_en_dfu_status_t Cy_DFU_CopyApp(uint32_t destAddress, uint32_t srcAddress, uin
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_OnResetApp0
+* Function Name: Cy_DFU_GetEraseSize
 ****************************************************************************//**
 *
-* This function is used in an App0 firmware image in Reset_Handler() only.
-* Checks if switching to the other application is scheduled with
-* \ref Cy_DFU_ExecuteApp(). \n
-* If the switch is scheduled, then it validates the application and transfers
-* control to it.
+* Returns the erase unit of the NVM at an address: a write at the start of the
+* unit erases the whole unit, as on the sectors of the CY_IP_M7CPUSS flash or a
+* serial NOR. Used by \ref Cy_DFU_CopyApp and the other functions that rewrite
+* the NVM in place. The default implementation returns 0, the rows are erased
+* when written. The dfu_user.c templates return the erase unit of the NVM
+* region of the address, see \ref group_dfu_ucase_nvm_regions.
+*
+* \param address    The address in the NVM.
+*
+* \return The erase unit in bytes, or 0 if the rows are erased when written.
 *
 *******************************************************************************/
-void Cy_DFU_OnResetApp0(void)
+__WEAK uint32_t Cy_DFU_GetEraseSize(uint32_t address)
 {
-    /* Set cy_dfu_appId to ZERO under a non-software reset. This means
-     * that the DFU application is scheduled - the initial clean state.
-     * The value of cy_dfu_appId is valid only under a software reset.
-     */
-    if (Cy_SysLib_GetResetReason() != CY_SYSLIB_RESET_SOFT)
+    CY_UNUSED_PARAMETER(address);
+    return (0U);
+}
+
+
+#if (CY_DFU_OPT_SWAP != 0) || defined(CY_DOXYGEN)
+/*******************************************************************************
+* Function Name: Cy_DFU_GetSwapAddress
+****************************************************************************//**
+*
+* Returns the address of the swap area: \ref CY_DFU_SWAP_STATUS_SLOTS NVM rows
+* of the swap status records followed by the scratch area of
+* \ref CY_DFU_SWAP_BLOCK_SIZE bytes, see \ref group_dfu_ucase_swap. On the
+* memory erased in units larger than a row, see \ref Cy_DFU_GetEraseSize, each
+* status record takes a whole erase unit instead of a row. The default
+* implementation returns 0, the user's code must redefine it to place the swap
+* area outside of the applications and the metadata.
+*
+* \return The address of the swap area, or 0 if there is no swap area.
+*
+*******************************************************************************/
+__WEAK uint32_t Cy_DFU_GetSwapAddress(void)
+{
+    return (0U);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_SwapApp
+****************************************************************************//**
+*
+* Exchanges the contents of two slots block by block through the scratch area,
+* see \ref group_dfu_ucase_swap. A status record is written after each step,
+* so a swap interrupted by a reset is completed by \ref Cy_DFU_SwapResume.
+* After the swap, the primary slot holds the image of the secondary slot, and
+* the secondary slot holds the previous image, see \ref Cy_DFU_SwapRevert.
+* \note This function uses params->dataBuffer for the read and write NVM.
+*
+* \param primaryAddress    The start address of the primary slot, the execute
+*                          slot of the application.
+* \param secondaryAddress  The start address of the secondary slot with the new
+*                          image.
+* \param length            The number of the bytes to exchange, a multiple of
+*                          the NVM row size.
+* \param params            The pointer to a DFU parameters structure.
+*                          See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+* - \ref CY_DFU_ERROR_BAD_PARAM - \ref CY_DFU_SWAP_BLOCK_SIZE is not a multiple
+*   of the erase unit of a slot or of the scratch area, or the swap area or a
+*   slot does not start at an erase unit, see \ref Cy_DFU_GetEraseSize.
+* - \ref CY_DFU_ERROR_ADDRESS - there is no swap area.
+* - \ref CY_DFU_ERROR_DATA - an interrupted swap must be resumed first.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_SwapApp(uint32_t primaryAddress, uint32_t secondaryAddress, uint32_t length,
+                                  cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_stc_dfu_swap_status_t record;
+    uint32_t slot = 0U;
+
+    if ( (params == NULL) || (length == 0U) || ((length % CY_NVM_SIZEOF_ROW) != 0U) )
     {
-        cy_dfu_appId = 0U;
+        status = CY_DFU_ERROR_BAD_PARAM;
+    }
+    else if (Cy_DFU_GetSwapAddress() == 0U)
+    {
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if (!SwapLayoutValid(primaryAddress, secondaryAddress))
+    {
+        status = CY_DFU_ERROR_BAD_PARAM;
+    }
+    else if (SwapLoad(&record, &slot, params) && SWAP_IN_PROGRESS(record))
+    {
+        status = CY_DFU_ERROR_DATA;
     }
     else
     {
-        if ((cy_dfu_appId != 0U) && (cy_dfu_appId < CY_DFU_MAX_APPS))
+        record.primary   = primaryAddress;
+        record.secondary = secondaryAddress;
+        record.length    = length;
+        record.count     = (length + (CY_DFU_SWAP_BLOCK_SIZE - 1U)) / CY_DFU_SWAP_BLOCK_SIZE;
+        record.block     = 0U;
+        record.step      = SWAP_STEP_TO_SCRATCH;
+        record.revert    = 0U;
+        status = SwapSave(&record, &slot, params);
+        if (status == CY_DFU_SUCCESS)
         {
-            (void) Cy_DFU_SwitchToApp((uint32_t) cy_dfu_appId);
+            status = SwapRun(&record, &slot, params);
         }
     }
+    return (status);
 }
-#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_ReadData
+* Function Name: Cy_DFU_SwapResume
 ****************************************************************************//**
 *
-* This function must be implemented in the user's code.
+* Completes a swap interrupted by a reset from the step of the current status
+* record. Call it at the start of App0 before an application is validated.
+* \note This function uses params->dataBuffer for the read and write NVM.
 *
-* Reads \c buffer from flash, QSPI flash, or any other external memory type with
-* custom pre and post read commands.
+* \param params    The pointer to a DFU parameters structure.
+*                  See \ref cy_stc_dfu_params_t .
 *
-* \param address    The address from where to read data, must be aligned to
-*                   a flash row, QSPI flash page, etc.
-* \param length     The length in bytes of data to read, must be multiple of
-*                   a flash row, QSPI flash page, etc.
-* \param ctl        Additional features of the read function:
-* - CY_DFU_IOCTL_READ    - Only read.
-* - CY_DFU_IOCTL_COMPARE - Compare the data in the buffer with the data in
-*                               memory.
-* - CY_DFU_IOCTL_BHP     - Decrypt data before comparing the buffer with
-*                               memory,
-*   if the DFU Host provided encrypted data.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
-* \return See \ref cy_en_dfu_status_t
-* - CY_DFU_SUCCESS - If successful.
-* - CY_DFU_ERROR_LENGTH if \c The length value is invalid.
-* - CY_DFU_ERROR_ADDRESS if \c The address is invalid.
+* \return See \ref cy_en_dfu_status_t.
+* - \ref CY_DFU_SUCCESS - the swap is completed, or no swap is in progress.
 *
 *******************************************************************************/
-__WEAK cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
-                                                     cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_SwapResume(cy_stc_dfu_params_t *params)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
-
-    (void) address;
-    (void) length;
-    (void) ctl;
-    (void) params;
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_stc_dfu_swap_status_t record;
+    uint32_t slot = 0U;
 
-    return (CY_DFU_SUCCESS);
+    if (params == NULL)
+    {
+        status = CY_DFU_ERROR_BAD_PARAM;
+    }
+    else if (SwapLoad(&record, &slot, params) && SWAP_IN_PROGRESS(record))
+    {
+        status = SwapRun(&record, &slot, params);
+    }
+    else
+    {
+        /* No swap is in progress */
+    }
+    return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_WriteData
+* Function Name: Cy_DFU_SwapRevert
 ****************************************************************************//**
 *
-* This function must be implemented in the user's code.
+* Restores the slots to their contents before the last swap, without a new
+* download of the previous image. A complete swap is exchanged back. Of an
+* interrupted swap, the block being exchanged is completed and only the blocks
+* exchanged so far are exchanged back. The revert is recorded with one status
+* record before any data is moved: it is completed by \ref Cy_DFU_SwapResume
+* if it is interrupted, and reverted by another call.
+* \note This function uses params->dataBuffer for the read and write NVM.
 *
-* Writes the \c buffer to flash, QSPI flash, or any other external memory type
-* with custom pre and post write commands.
+* \param params    The pointer to a DFU parameters structure.
+*                  See \ref cy_stc_dfu_params_t .
 *
-* \param address    The address to write data to, must be aligned to a flash
-*                   row, QSPI flash page, etc.
-* \param length     The length in bytes of data to be written, must be multiple
-*                   of a flash row, QSPI flash page, etc.
-* \param ctl        Additional features of the write function:
-* - CY_DFU_IOCTL_WRITE - Only write.
-* - CY_DFU_IOCTL_ERASE - Erase the sector, the sector size can be bigger
-*   than the size of the page to write.
-* - CY_DFU_IOCTL_BHP   - Decrypt data before writing to memory, if
-*   the DFU Host provided encrypted data.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
 * \return See \ref cy_en_dfu_status_t.
-* - CY_DFU_SUCCESS - If successful.
-* - CY_DFU_ERROR_LENGTH if \c The length value is invalid.
-* - CY_DFU_ERROR_ADDRESS if \c The address is invalid.
+* - \ref CY_DFU_ERROR_DATA - there is no swap to revert.
 *
 *******************************************************************************/
-__WEAK cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t ctl,
-                                                     cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_SwapRevert(cy_stc_dfu_params_t *params)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_stc_dfu_swap_status_t record;
+    uint32_t slot = 0U;
 
-    (void) address;
-    (void) length;
-    (void) ctl;
-    (void) params;
-
-    return (CY_DFU_SUCCESS);
+    if (params == NULL)
+    {
+        status = CY_DFU_ERROR_BAD_PARAM;
+    }
+    else if (!SwapLoad(&record, &slot, params))
+    {
+        status = CY_DFU_ERROR_DATA;
+    }
+    else
+    {
+        if (record.block < record.count)
+        {   /* The swap ends with the current block, it is completed if its data is moved already */
+            record.count = (record.step == SWAP_STEP_TO_SCRATCH) ? record.block : (record.block + 1U);
+        }
+        /* The revert is recorded with a single write, before the swap is completed */
+        record.revert = (record.revert == 0U) ? 1U : 0U;
+        status = SwapSave(&record, &slot, params);
+        if (status == CY_DFU_SUCCESS)
+        {
+            status = SwapRun(&record, &slot, params);
+        }
+    }
+    return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_TransportRead
+* Function Name: SwapLoad
 ****************************************************************************//**
-* This function must be implemented in the user's code.
 *
-* This function receives a command packet from the DFU Host via the
-* communication channel. The function waits for a timeout until all bytes are
-* received.
+* This internal function reads the current swap status record, the valid record
+* with the highest sequence number in the swap status area.
+* \note This function uses params->dataBuffer for the read NVM.
 *
-* \param buffer The pointer to a buffer to store a received command.
-* \param size   The number of bytes to read.
-* \param count  The pointer to the variable that contains the number of received
-*               bytes.
-* \param timeout The time to wait before the function returns because of a
-*                timeout, in milliseconds.
+* \param record    The pointer to the record to read to, cleared if there is
+*                  no valid record.
+* \param slot      The pointer to the status row of the record.
+* \param params    The pointer to a DFU parameters structure.
 *
-* \return The status of the transmit operation:
-* - CY_DFU_SUCCESS - If successful.
-* - CY_DFU_ERROR_TIMEOUT - If no data is received.
-* - See \ref cy_en_dfu_status_t.
+* \return true if a valid record is found.
 *
 *******************************************************************************/
-__WEAK cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count,
-                                                         uint32_t timeout)
+static bool SwapLoad(cy_stc_dfu_swap_status_t *record, uint32_t *slot, cy_stc_dfu_params_t *params)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
+    uint32_t areaAddress = Cy_DFU_GetSwapAddress();
+    uint32_t slotSize = SwapSlotSize();
+    bool found = false;
+    uint32_t i;
 
-    (void) buffer;
-    (void) size;
-    (void) count;
-    (void) timeout;
+    (void) memset(record, 0, sizeof(*record));
+    *slot = CY_DFU_SWAP_STATUS_SLOTS - 1U;    /* The first record goes to slot 0 */
 
-    return (CY_DFU_SUCCESS);
+    for (i = 0U; (areaAddress != 0U) && (i < CY_DFU_SWAP_STATUS_SLOTS); i++)
+    {
+        cy_stc_dfu_swap_status_t entry;
+
+        if (Cy_DFU_ReadData(areaAddress + (i * slotSize), CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_READ,
+                            params) == CY_DFU_SUCCESS)
+        {
+            (void) memcpy( (void *)&entry, (const void *)params->dataBuffer, sizeof(entry));
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the record to bytes is safe as it has no padding.');
+            if ( (entry.magic == SWAP_MAGIC) &&
+                 (entry.crc == Cy_DFU_DataChecksum( (const uint8_t *)&entry.sequence, SWAP_CRC_SIZE, params)) &&
+                 ( (!found) || ((int32_t)(entry.sequence - record->sequence) > 0) ) )
+            {   /* The sequence number may wrap around */
+                *record = entry;
+                *slot = i;
+                found = true;
+            }
+        }
+    }
+    return (found);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_TransportWrite
+* Function Name: SwapSave
 ****************************************************************************//**
-* This function must be implemented in the user's code.
 *
-* This function transmits a response packet to the DFU host via the
-* communication channel. The function waits for a timeout until all bytes are
-* sent.
+* This internal function writes the swap status record with the next sequence
+* number to the next slot of the swap status area, so the previous record
+* remains current if the write is interrupted. Each slot is a row, or an erase
+* unit if the swap area is erased in units larger than a row, so the write does
+* not erase the previous record.
+* \note This function uses params->dataBuffer for the write NVM.
 *
-* \param buffer The pointer response packet buffer.
-* \param size   The number of bytes to transmit.
-* \param count  The pointer to the actual number of transmitted bytes.
-* \param timeout The time to wait before the function returns because of a
-*        timeout, in milliseconds
+* \param record    The pointer to the record to write.
+* \param slot      The pointer to the status row of the current record, set to
+*                  the row written.
+* \param params    The pointer to a DFU parameters structure.
 *
 * \return See \ref cy_en_dfu_status_t.
-* The status of the transmit operation:
-* - CY_DFU_SUCCESS - If successful.
-* - CY_DFU_ERROR_TIMEOUT - If no data is transmitted.
 *
 *******************************************************************************/
-__WEAK cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count,
-                                                          uint32_t timeout)
+static cy_en_dfu_status_t SwapSave(cy_stc_dfu_swap_status_t *record, uint32_t *slot,
+                                   cy_stc_dfu_params_t *params)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
+    uint32_t next = (*slot + 1U) % CY_DFU_SWAP_STATUS_SLOTS;
+    uint32_t address = Cy_DFU_GetSwapAddress() + (next * SwapSlotSize());
+    cy_en_dfu_status_t status;
 
-    (void) buffer;
-    (void) size;
-    (void) count;
-    (void) timeout;
+    record->magic = SWAP_MAGIC;
+    ++record->sequence;
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the record to bytes is safe as it has no padding.');
+    record->crc = Cy_DFU_DataChecksum( (const uint8_t *)&record->sequence, SWAP_CRC_SIZE, params);
 
-    return (CY_DFU_SUCCESS);
+    (void) memset(params->dataBuffer, 0, CY_NVM_SIZEOF_ROW);
+    (void) memcpy( (void *)params->dataBuffer, (const void *)record, sizeof(*record));
+    status = Cy_DFU_WriteData(address, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+    if (status == CY_DFU_SUCCESS)
+    {
+        status = Cy_DFU_ReadData(address, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_COMPARE, params);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        *slot = next;
+    }
+    return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_TransportReset
+* Function Name: SwapRun
 ****************************************************************************//**
 *
-* This function must be implemented in the user's code. \n
-* Resets the communication interface with clearing buffers, offsets, length,
-* etc.
+* This internal function exchanges the blocks of the swap from the current step
+* of the record, and writes the record after each step. A step only overwrites
+* the data the next step reads, never the data it reads itself, so the step of
+* the current record is repeated after a reset. The rows that already hold the
+* data are not written again, see \ref Cy_DFU_CopyApp. When the swap of a
+* record to revert is complete, its blocks are exchanged again from block 0.
+*
+* \param record    The pointer to the current record.
+* \param slot      The pointer to the status row of the current record.
+* \param params    The pointer to a DFU parameters structure.
+*
+* \return See \ref cy_en_dfu_status_t.
 *
 *******************************************************************************/
-__WEAK void Cy_DFU_TransportReset(void)
+static cy_en_dfu_status_t SwapRun(cy_stc_dfu_swap_status_t *record, uint32_t *slot,
+                                  cy_stc_dfu_params_t *params)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t scratch = Cy_DFU_GetSwapAddress() + (CY_DFU_SWAP_STATUS_SLOTS * SwapSlotSize());
+
+    while ( (status == CY_DFU_SUCCESS) && SWAP_IN_PROGRESS(*record) )
+    {
+        if (record->block >= record->count)
+        {   /* The swap is complete, the exchanged blocks are exchanged back */
+            record->block  = 0U;
+            record->step   = SWAP_STEP_TO_SCRATCH;
+            record->revert = 0U;
+        }
+        else
+        {
+            uint32_t offset = record->block * CY_DFU_SWAP_BLOCK_SIZE;
+            uint32_t size = ( (record->length - offset) < CY_DFU_SWAP_BLOCK_SIZE ) ?
+                              (record->length - offset) : CY_DFU_SWAP_BLOCK_SIZE;
+
+            if (record->step == SWAP_STEP_TO_SCRATCH)
+            {
+                status = Cy_DFU_CopyApp(scratch, record->secondary + offset, size, CY_NVM_SIZEOF_ROW, params);
+            }
+            else if (record->step == SWAP_STEP_TO_SECONDARY)
+            {
+                status = Cy_DFU_CopyApp(record->secondary + offset, record->primary + offset, size,
+                                        CY_NVM_SIZEOF_ROW, params);
+            }
+            else
+            {
+                status = Cy_DFU_CopyApp(record->primary + offset, scratch, size, CY_NVM_SIZEOF_ROW, params);
+            }
+
+            if (status == CY_DFU_SUCCESS)
+            {
+                if (record->step == SWAP_STEP_TO_PRIMARY)
+                {
+                    record->step = SWAP_STEP_TO_SCRATCH;
+                    ++record->block;
+                }
+                else
+                {
+                    ++record->step;
+                }
+            }
+        }
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            status = SwapSave(record, slot, params);
+        }
+    }
+    return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_TransportStart
+* Function Name: SwapSlotSize
 ****************************************************************************//**
 *
-* This function must be implemented in the user's code. \n
-* Starts the communication interface through which updating will be working.
+* This internal function returns the size of a slot of the swap status area:
+* the erase unit of the swap area, or a row if it is erased in rows.
 *
-* \param transport defines transport interface to use. See
-*           \ref cy_en_dfu_transport_t for available options
+* \return The size of a status slot in bytes.
 *
 *******************************************************************************/
-__WEAK void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
+static uint32_t SwapSlotSize(void)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
-   CY_UNUSED_PARAMETER(transport);
+    uint32_t eraseSize = Cy_DFU_GetEraseSize(Cy_DFU_GetSwapAddress());
+
+    return ((eraseSize > CY_NVM_SIZEOF_ROW) ? eraseSize : CY_NVM_SIZEOF_ROW);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_TransportStop
+* Function Name: SwapLayoutValid
 ****************************************************************************//**
 *
-* This function must be implemented in the user's code. \n
-* Stops the communication interface through which updating will be working.
+* This internal function checks the swap area and the slots against the erase
+* units of the NVM, see \ref Cy_DFU_GetEraseSize: the swap area, the scratch
+* area and the slots start at an erase unit, and a block is a whole number of
+* the erase units of the scratch area and the slots, so a step never erases
+* the data of another block or of the status records.
+*
+* \param primaryAddress    The start address of the primary slot.
+* \param secondaryAddress  The start address of the secondary slot.
+*
+* \return True if the swap can use the slots.
 *
 *******************************************************************************/
-__WEAK void Cy_DFU_TransportStop(void)
+static bool SwapLayoutValid(uint32_t primaryAddress, uint32_t secondaryAddress)
 {
-    /*
-    * This function does nothing, weak implementation.
-    * The purpose of this code is to disable compiler warnings for Non-optimized
-    * builds which do not remove unused functions and require them for the
-    * completeness of the linking step.
-    */
-}
-
+    uint32_t areaAddress = Cy_DFU_GetSwapAddress();
+    uint32_t slotSize = SwapSlotSize();
+    uint32_t addresses[3U];
+    bool valid = ((areaAddress % slotSize) == 0U);
+
+    addresses[0U] = areaAddress + (CY_DFU_SWAP_STATUS_SLOTS * slotSize);
+    addresses[1U] = primaryAddress;
+    addresses[2U] = secondaryAddress;
+    for (uint32_t i = 0U; valid && (i < 3U); i++)
+    {
+        uint32_t eraseSize = Cy_DFU_GetEraseSize(addresses[i]);
 
-/*******************************************************************************
-*        Cy_DFU_Continue related code, till the EOF
-*******************************************************************************/
+        valid = (eraseSize == 0U) ||
+                (((CY_DFU_SWAP_BLOCK_SIZE % eraseSize) == 0U) && ((addresses[i] % eraseSize) == 0U));
+    }
+    return (valid);
+}
+#endif /* (CY_DFU_OPT_SWAP != 0) || defined(CY_DOXYGEN) */
 
 
 /*******************************************************************************
-* Function Name: GetU16
+* Function Name: Cy_DFU_OnResetApp0
 ****************************************************************************//**
 *
-* This function is used to read a uint16_t value from a byte array. \n
-* MISRA is informed with pragma that the function has no side effects.
-*
-* \param array      The pointer to the byte array to get data from.
-*
-* \return The uint16_t value from the \c array parameter.
+* This function is used in an App0 firmware image in Reset_Handler() only.
+* Checks if switching to the other application is scheduled with
+* \ref Cy_DFU_ExecuteApp(). \n
+* If the switch is scheduled, then it validates the application and transfers
+* control to it.
 *
 *******************************************************************************/
-static uint16_t GetU16(uint8_t const array[])
+void Cy_DFU_OnResetApp0(void)
 {
-    uint16_t temp;
-    (void) memcpy( (void*)&temp, (const void*)&array[0], UINT16_SIZE);
-    return (temp);
+    /* Set cy_dfu_appId to ZERO under a non-software reset. This means
+     * that the DFU application is scheduled - the initial clean state.
+     * The value of cy_dfu_appId is valid only under a software reset.
+     */
+    if (Cy_SysLib_GetResetReason() != CY_SYSLIB_RESET_SOFT)
+    {
+        cy_dfu_appId = 0U;
+    #if CY_DFU_OPT_VALID_CACHE != 0
+        /* The NVM may have been changed by a programmer, start with an empty cache */
+        cy_dfu_validCache.magic = 0U;
+    #endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+    }
+    else
+    {
+        if ((cy_dfu_appId != 0U) && (cy_dfu_appId < CY_DFU_MAX_APPS))
+        {
+            (void) Cy_DFU_SwitchToApp((uint32_t) cy_dfu_appId);
+        }
+    }
 }
 
 
+#if (CY_DFU_OPT_VALID_CACHE != 0) || defined(CY_DOXYGEN)
 /*******************************************************************************
-* Function Name: GetU32
+* Function Name: Cy_DFU_ValidCacheInvalidate
 ****************************************************************************//**
 *
-* This function is used to read an uint32_t value from a byte array. \n
-* MISRA is informed with pragma that the function has no side effects.
-*
-* \param array      The pointer to the byte array to get data from.
+* This function advances the write generation of the validity cache, so
+* \ref Cy_DFU_ValidateApp verifies each application again. The implementation
+* of \ref Cy_DFU_WriteData must call it before it modifies the NVM.
 *
-* \return The uint32_t value from the \c array parameter.
+* The validity cache keeps the results of \ref Cy_DFU_ValidateApp for the valid
+* applications in the ".cy_boot_noinit" section, keyed on the application ID,
+* the CRC-32C of its metadata and the write generation. The cache is kept over
+* a software reset, and \ref Cy_DFU_OnResetApp0 clears it after any other
+* reset, because the NVM may have been programmed without the DFU SDK.
 *
 *******************************************************************************/
-static uint32_t GetU32(uint8_t const array[])
+void Cy_DFU_ValidCacheInvalidate(void)
 {
-    uint32_t temp;
-    (void) memcpy( (void*)&temp, (const void*)&array[0], UINT32_SIZE);
-    return (temp);
+    if (ValidCacheIntact())
+    {
+        ++cy_dfu_validCache.generation;
+        if (cy_dfu_validCache.generation == 0U)
+        {
+            /* The generation has wrapped around, the entries of the old generations are cleared */
+            (void) memset(cy_dfu_validCache.apps, 0, sizeof(cy_dfu_validCache.apps));
+            cy_dfu_validCache.generation = 1U;
+        }
+        ValidCacheSeal();
+    }
 }
 
 
 /*******************************************************************************
-* Function Name: PutU16
+* Function Name: ValidCacheIntact
 ****************************************************************************//**
 *
-* This function is used to write an uint16_t value to a byte array.
+* This function checks the magic number and the CRC of the validity cache.
+* If the cache is not initialized or is corrupted, it starts an empty cache.
 *
-* \param array      The pointer to the byte array.
-* \param offset     The offset within the byte array to write data to.
-* \param value      The value to be stored to the byte array.
+* \return True if the cache was intact and its entries can be used.
 *
 *******************************************************************************/
-static void PutU16(uint8_t array[], uint32_t offset, uint32_t value)
+static bool ValidCacheIntact(void)
 {
-    (void) memcpy( (void*)&array[offset], (const void*)&value, UINT16_SIZE);
-}
-
-
-#if (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
-    /*******************************************************************************
-    * Function Name: PutU32
-    ****************************************************************************//**
-    *
-    * This function is used to write an uint32_t value to a byte array.
-    *
-    * \param array      The pointer to the byte array.
-    * \param offset     The offset within the byte array to write data to.
-    * \param value      The value to be stored to the byte array.
-    *
-    *******************************************************************************/
-    static void PutU32(uint8_t array[], uint32_t offset, uint32_t value)
+    bool intact = (cy_dfu_validCache.magic == VALID_CACHE_MAGIC) &&
+                  (cy_dfu_validCache.crc == Cy_DFU_DataChecksum((const uint8_t *)&cy_dfu_validCache.generation,
+                                                                VALID_CACHE_CRC_SIZE, NULL));
+    if (!intact)
     {
-        (void) memcpy( (void*)&array[offset], (const void*)&value, UINT32_SIZE);
+        /* The entries of the generation 0 never match */
+        (void) memset(&cy_dfu_validCache, 0, sizeof(cy_dfu_validCache));
+        cy_dfu_validCache.magic = VALID_CACHE_MAGIC;
+        cy_dfu_validCache.generation = 1U;
+        ValidCacheSeal();
     }
-#endif /* (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)*/
+    return (intact);
+}
 
 
 /*******************************************************************************
-* Function Name: PacketChecksumIndex
+* Function Name: ValidCacheSeal
 ****************************************************************************//**
 *
-* This function returns an index to the checksum field in a received packet
-*
-* \param size The DFU packet size value.
-*
-* \return The index to the checksum.
+* This function updates the CRC of the validity cache after its change.
 *
 *******************************************************************************/
-static uint32_t PacketChecksumIndex(uint32_t size)
+static void ValidCacheSeal(void)
 {
-    return (PACKET_DATA_IDX + size);
+    cy_dfu_validCache.crc = Cy_DFU_DataChecksum((const uint8_t *)&cy_dfu_validCache.generation,
+                                                VALID_CACHE_CRC_SIZE, NULL);
 }
 
 
 /*******************************************************************************
-* Function Name: PacketEopIndex
+* Function Name: ValidCacheKey
 ****************************************************************************//**
 *
-* This function returns an index to the end of the packet field in a received
-* packet.
+* This function returns the CRC-32C of the application ID and its metadata,
+* the key of the application entry in the validity cache.
 *
-* \param size  The DFU packet size value.
+* \param appId          The application number.
+* \param verifyAddress  The application verified area start address.
+* \param verifySize     The size of the application verified area.
 *
-* \return Returns an index to the end of the packet.
+* \return The key of the entry.
 *
 *******************************************************************************/
-static uint32_t PacketEopIndex(uint32_t size)
+static uint32_t ValidCacheKey(uint32_t appId, uint32_t verifyAddress, uint32_t verifySize)
 {
-    return (PACKET_DATA_IDX + size + PACKET_CHECKSUM_LENGTH);
+    uint32_t key[3U];
+
+    key[0U] = appId;
+    key[1U] = verifyAddress;
+    key[2U] = verifySize;
+    return (Cy_DFU_DataChecksum((const uint8_t *)key, sizeof(key), NULL));
 }
+#endif /* (CY_DFU_OPT_VALID_CACHE != 0) || defined(CY_DOXYGEN) */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
 
 /*******************************************************************************
-* Function Name: GetPacketCommand
+* Function Name: Cy_DFU_ReadData
 ****************************************************************************//**
 *
-* This function returns a DFU packet command value for a given \c packet.
+* This function must be implemented in the user's code.
 *
-* \param packet  The pointer to the byte array containing DFU packet
-*                data.
+* Reads \c buffer from flash, QSPI flash, or any other external memory type with
+* custom pre and post read commands.
 *
-* \return A DFU packet command value.
+* The dfu_user.c templates read the NVM region of the address with
+* \ref Cy_DFU_NvmRead, see \ref group_dfu_ucase_nvm_regions.
+*
+* \param address    The address from where to read data, must be aligned to
+*                   a flash row, QSPI flash page, etc.
+* \param length     The length in bytes of data to read, must be multiple of
+*                   a flash row, QSPI flash page, etc.
+* \param ctl        Additional features of the read function:
+* - CY_DFU_IOCTL_READ    - Only read.
+* - CY_DFU_IOCTL_COMPARE - Compare the data in the buffer with the data in
+*                               memory.
+* - CY_DFU_IOCTL_BHP     - Decrypt data before comparing the buffer with
+*                               memory,
+*   if the DFU Host provided encrypted data.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \return See \ref cy_en_dfu_status_t
+* - CY_DFU_SUCCESS - If successful.
+* - CY_DFU_ERROR_LENGTH if \c The length value is invalid.
+* - CY_DFU_ERROR_ADDRESS if \c The address is invalid.
 *
 *******************************************************************************/
-static uint32_t GetPacketCommand(const uint8_t packet[])
+__WEAK cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
+                                                     cy_stc_dfu_params_t *params)
 {
-    return ( (uint32_t) packet[PACKET_CMD_IDX] );
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+
+    (void) address;
+    (void) length;
+    (void) ctl;
+    (void) params;
+
+    return (CY_DFU_SUCCESS);
 }
 
 
 /*******************************************************************************
-* Function Name: GetPacketDSize
+* Function Name: Cy_DFU_WriteData
 ****************************************************************************//**
 *
-* This function returns a data size in the DFU packet. \n
-* MISRA requires this function have no side effects.
+* This function must be implemented in the user's code.
 *
-* \param packet  The pointer to the byte array containing DFU packet
-*                data.
+* Writes the \c buffer to flash, QSPI flash, or any other external memory type
+* with custom pre and post write commands.
 *
-* \return A size of the data in bytes in the packet.
+* The dfu_user.c templates write the NVM region of the address with
+* \ref Cy_DFU_NvmWrite, see \ref group_dfu_ucase_nvm_regions.
+*
+* \param address    The address to write data to, must be aligned to a flash
+*                   row, QSPI flash page, etc.
+* \param length     The length in bytes of data to be written, must be multiple
+*                   of a flash row, QSPI flash page, etc.
+* \param ctl        Additional features of the write function:
+* - CY_DFU_IOCTL_WRITE - Only write.
+* - CY_DFU_IOCTL_ERASE - Erase the sector, the sector size can be bigger
+*   than the size of the page to write.
+* - CY_DFU_IOCTL_BHP   - Decrypt data before writing to memory, if
+*   the DFU Host provided encrypted data.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \return See \ref cy_en_dfu_status_t.
+* - CY_DFU_SUCCESS - If successful.
+* - CY_DFU_ERROR_LENGTH if \c The length value is invalid.
+* - CY_DFU_ERROR_ADDRESS if \c The address is invalid.
 *
 *******************************************************************************/
-static uint32_t GetPacketDSize(const uint8_t packet[])
+__WEAK cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t ctl,
+                                                     cy_stc_dfu_params_t *params)
 {
-    return ( (uint32_t) GetU16( &packet[PACKET_SIZE_IDX] ) );
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+
+    (void) address;
+    (void) length;
+    (void) ctl;
+    (void) params;
+
+    return (CY_DFU_SUCCESS);
 }
 
 
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0)
 /*******************************************************************************
-* Function Name: GetPacketData
+* Function Name: Cy_DFU_GoldenImageInvalidate
 ****************************************************************************//**
+* This function must be implemented in the user's code if
+* \ref Cy_DFU_WriteData caches the golden image checks.
 *
-* This function is used to get packet data.
-*
-* \param packet  The pointer to the byte array containing DFU packet
-*                data.
-* \param offset  The offset within the data bytes in the packet.
-*                E.g. 0 means the first byte of the data.
-*
-* \return A pointer to the data bytes with the offset in the packet.
+* The Enter DFU command calls this function at the start of each update
+* session. \ref Cy_DFU_WriteData refuses to write to a valid golden image and
+* validates it with \ref Cy_DFU_ValidateApp; its implementation may keep the
+* result for the rest of the session instead of validating the golden image
+* before each row, and must drop it here, because the previous session may
+* have completed the golden image.
 *
 *******************************************************************************/
-static uint8_t* GetPacketData(uint8_t packet[], uint32_t offset)
+__WEAK void Cy_DFU_GoldenImageInvalidate(void)
 {
-    return ( &packet[PACKET_DATA_IDX + offset] );
+    /*
+    * This function does nothing, weak implementation.
+    * Cy_DFU_WriteData() that does not cache the golden image checks
+    * does not need it.
+    */
 }
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0) */
 
 
 /*******************************************************************************
-* Function Name: GetPacketChecksum
+* Function Name: Cy_DFU_TransportRead
 ****************************************************************************//**
+* This function must be implemented in the user's code.
 *
-* This function is used to get a DFU packet checksum.
+* This function receives a command packet from the DFU Host via the
+* communication channel. The function waits for a timeout until all bytes are
+* received.
 *
-* \param packet      The pointer to a byte array containing the
-*                    DFU packet data.
-* \param packetSize  The offset within the data bytes in the packet. \n
-*                    E.g. 0 means the first byte of the data.
+* \param buffer The pointer to a buffer to store a received command.
+* \param size   The number of bytes to read.
+* \param count  The pointer to the variable that contains the number of received
+*               bytes.
+* \param timeout The time to wait before the function returns because of a
+*                timeout, in milliseconds.
 *
-* \return The DFU packet checksum.
+* \return The status of the transmit operation:
+* - CY_DFU_SUCCESS - If successful.
+* - CY_DFU_ERROR_TIMEOUT - If no data is received.
+* - See \ref cy_en_dfu_status_t.
 *
 *******************************************************************************/
-static uint32_t GetPacketChecksum(const uint8_t packet[], uint32_t packetSize)
+__WEAK cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count,
+                                                         uint32_t timeout)
 {
-    return ( (uint32_t) GetU16( &packet[ PacketChecksumIndex(packetSize) ] ) );
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+
+    (void) buffer;
+    (void) size;
+    (void) count;
+    (void) timeout;
+
+    return (CY_DFU_SUCCESS);
 }
 
 
 /*******************************************************************************
-* Function Name: ValidatePacketFooter
+* Function Name: Cy_DFU_TransportWrite
 ****************************************************************************//**
+* This function must be implemented in the user's code.
 *
-* This function is used to validate a DFU packet footer.
+* This function transmits a response packet to the DFU host via the
+* communication channel. The function waits for a timeout until all bytes are
+* sent.
 *
-* \param packet      The pointer to a byte array containing the
-*                    DFU packet data.
-* \param packetSize  The offset within the data bytes in the packet. \n
-*                    E.g. 0 means the first byte of the data.
-* \return
-* - 0, if the DFU packet footer is invalid.
-* - 1, if the DFU packet footer is valid.
+* \param buffer The pointer response packet buffer.
+* \param size   The number of bytes to transmit.
+* \param count  The pointer to the actual number of transmitted bytes.
+* \param timeout The time to wait before the function returns because of a
+*        timeout, in milliseconds
+*
+* \return See \ref cy_en_dfu_status_t.
+* The status of the transmit operation:
+* - CY_DFU_SUCCESS - If successful.
+* - CY_DFU_ERROR_TIMEOUT - If no data is transmitted.
 *
 *******************************************************************************/
-static uint32_t ValidatePacketFooter(const uint8_t packet[], uint32_t packetSize)
+__WEAK cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count,
+                                                          uint32_t timeout)
 {
-    return ( (packet[PacketEopIndex(packetSize)] == PACKET_EOP_VALUE)? 1UL : 0UL );
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+
+    (void) buffer;
+    (void) size;
+    (void) count;
+    (void) timeout;
+
+    return (CY_DFU_SUCCESS);
 }
 
 
 /*******************************************************************************
-* Function Name: SetPacketHeader
+* Function Name: Cy_DFU_TransportReset
 ****************************************************************************//**
 *
-* This function is used to set a DFU packet header value.
-*
-* \param packet     The pointer to a byte array containing the DFU packet
-*                   data.
+* This function must be implemented in the user's code. \n
+* Resets the communication interface with clearing buffers, offsets, length,
+* etc.
 *
 *******************************************************************************/
-static void SetPacketHeader(uint8_t packet[])
+__WEAK void Cy_DFU_TransportReset(void)
 {
-    packet[PACKET_SOP_IDX] = PACKET_SOP_VALUE;
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
 }
 
 
 /*******************************************************************************
-* Function Name: SetPacketCmd
+* Function Name: Cy_DFU_TransportStart
 ****************************************************************************//**
 *
-* This function is used to set a DFU packet command value.
+* This function must be implemented in the user's code. \n
+* Starts the communication interface through which updating will be working.
 *
-* \param packet     The pointer to a byte array containing the
-*                   DFU packet data.
-* \param cmd        The command value to be set in the DFU packet.
+* \param transport defines transport interface to use. See
+*           \ref cy_en_dfu_transport_t for available options
 *
 *******************************************************************************/
-static void SetPacketCmd(uint8_t packet[], uint32_t cmd)
+__WEAK void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
 {
-    packet[PACKET_CMD_IDX] = (uint8_t)cmd;
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+   CY_UNUSED_PARAMETER(transport);
 }
 
 
 /*******************************************************************************
-* Function Name: SetPacketDSize
+* Function Name: Cy_DFU_TransportStop
 ****************************************************************************//**
 *
-* This function is used to set a DFU packet size value.
-*
-* \param packet     The pointer to a byte array containing the
-*                   DFU packet data.
-* \param size       The value for the DFU packet size.
+* This function must be implemented in the user's code. \n
+* Stops the communication interface through which updating will be working.
 *
 *******************************************************************************/
-static void SetPacketDSize(uint8_t packet[], uint32_t size)
+__WEAK void Cy_DFU_TransportStop(void)
 {
-    PutU16(packet, PACKET_SIZE_IDX, size);
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
 }
 
 
 /*******************************************************************************
-* Function Name: SetPacketChecksum
+* Function Name: Cy_DFU_TransportGetOps
 ****************************************************************************//**
 *
-* This function is used to set a DFU packet checksum value.
+* This function can be implemented in the user's code. \n
+* Returns the operations and the capabilities of the transport selected with
+* \ref Cy_DFU_TransportStart, see \ref cy_stc_dfu_transport_ops_t.
+* The DFU SDK uses the capabilities to enable the transport specific fast paths.
 *
-* \param packet     The pointer to a byte array containing the
-*                   DFU packet data.
-* \param size       The DFU packet size value.
-* \param checksum   The value for a DFU packet checksum.
+* \return The pointer to the operations of the selected transport, or NULL if the
+* transport capabilities are unknown. NULL disables the transport specific fast
+* paths, the DFU SDK uses only \ref Cy_DFU_TransportRead and
+* \ref Cy_DFU_TransportWrite then.
 *
 *******************************************************************************/
-static void SetPacketChecksum(uint8_t packet[], uint32_t size, uint32_t checksum)
+__WEAK const cy_stc_dfu_transport_ops_t * Cy_DFU_TransportGetOps(void)
 {
-    PutU16(packet, PacketChecksumIndex(size), checksum);
+    return (NULL);
 }
 
 
 /*******************************************************************************
-* Function Name: SetPacketFooter
+* Function Name: Cy_DFU_TransportLock
 ****************************************************************************//**
 *
-* This function is used to set a DFU packet footer value.
-*
-* \param packet     The pointer to a byte array containing the
-*                   DFU packet data.
-* \param size       The DFU packet size value.
+* This function can be implemented in the user's code. \n
+* \ref Cy_DFU_Continue calls it after responding to a valid Enter command.
+* When all the transport interfaces are started with \ref CY_DFU_ALL, the
+* function locks the update session on the interface the Enter command came
+* from and stops the others.
 *
 *******************************************************************************/
-static void SetPacketFooter(uint8_t packet[], uint32_t size)
+__WEAK void Cy_DFU_TransportLock(void)
+{
+    /*
+    * This function does nothing, weak implementation.
+    * The purpose of this code is to disable compiler warnings for Non-optimized
+    * builds which do not remove unused functions and require them for the
+    * completeness of the linking step.
+    */
+}
+
+
+#if (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN)
+/*******************************************************************************
+* Function Name: Cy_DFU_StatsTimestamp
+****************************************************************************//**
+*
+* This function can be implemented in the user's code. \n
+* Returns the current time for the statistics of \ref Cy_DFU_Continue, see
+* \ref group_dfu_ucase_stats. Only the differences between two timestamps are
+* used, so the timer may wrap around. The default implementation returns the
+* DWT cycle counter, and 0 on the devices without it.
+*
+* \return The current time in timer ticks.
+*
+*******************************************************************************/
+__WEAK uint32_t Cy_DFU_StatsTimestamp(void)
+{
+    uint32_t timestamp = 0U;
+
+#if defined(DWT_CTRL_CYCCNTENA_Msk)
+    if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0U)
+    {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0U;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    timestamp = DWT->CYCCNT;
+#endif /* defined(DWT_CTRL_CYCCNTENA_Msk) */
+
+    return (timestamp);
+}
+#endif /* (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN) */
+
+
+#if (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN)
+/*******************************************************************************
+* Function Name: Cy_DFU_GetProgressAddress
+****************************************************************************//**
+*
+* Returns the address of the progress area: \ref CY_DFU_PROGRESS_SLOTS NVM
+* rows that keep the progress record of a resumable update session, see
+* \ref group_dfu_ucase_resume. The default implementation returns the address
+* of the row after the metadata in the Basic Bootloader flow, and 0 in the
+* MCUBoot flow. The user's code can redefine it to place the progress area
+* elsewhere.
+*
+* \return The address of the progress area, or 0 if there is no progress area.
+*
+*******************************************************************************/
+__WEAK uint32_t Cy_DFU_GetProgressAddress(void)
 {
-    packet[PacketEopIndex(size)] = PACKET_EOP_VALUE;
-}
-
-
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    return (ElfSymbolToAddr(&__cy_boot_metadata_addr) + ElfSymbolToAddr(&__cy_boot_metadata_length));
+#else
+    return (0U);
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+}
+#endif /* (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN) */
+
+
+/*******************************************************************************
+*        Cy_DFU_Continue related code, till the EOF
+*******************************************************************************/
+
+
+/*******************************************************************************
+* Function Name: GetU16
+****************************************************************************//**
+*
+* This function is used to read a uint16_t value from a byte array. \n
+* MISRA is informed with pragma that the function has no side effects.
+*
+* \param array      The pointer to the byte array to get data from.
+*
+* \return The uint16_t value from the \c array parameter.
+*
+*******************************************************************************/
+static uint16_t GetU16(uint8_t const array[])
+{
+    uint16_t temp;
+    (void) memcpy( (void*)&temp, (const void*)&array[0], UINT16_SIZE);
+    return (temp);
+}
+
+
+/*******************************************************************************
+* Function Name: GetU32
+****************************************************************************//**
+*
+* This function is used to read an uint32_t value from a byte array. \n
+* MISRA is informed with pragma that the function has no side effects.
+*
+* \param array      The pointer to the byte array to get data from.
+*
+* \return The uint32_t value from the \c array parameter.
+*
+*******************************************************************************/
+static uint32_t GetU32(uint8_t const array[])
+{
+    uint32_t temp;
+    (void) memcpy( (void*)&temp, (const void*)&array[0], UINT32_SIZE);
+    return (temp);
+}
+
+
+/*******************************************************************************
+* Function Name: PutU16
+****************************************************************************//**
+*
+* This function is used to write an uint16_t value to a byte array.
+*
+* \param array      The pointer to the byte array.
+* \param offset     The offset within the byte array to write data to.
+* \param value      The value to be stored to the byte array.
+*
+*******************************************************************************/
+static void PutU16(uint8_t array[], uint32_t offset, uint32_t value)
+{
+    (void) memcpy( (void*)&array[offset], (const void*)&value, UINT16_SIZE);
+}
+
+
+#if ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL == 0)) || \
+    (CY_DFU_OPT_RESUME != 0)
+    /*******************************************************************************
+    * Function Name: PutU32
+    ****************************************************************************//**
+    *
+    * This function is used to write an uint32_t value to a byte array.
+    *
+    * \param array      The pointer to the byte array.
+    * \param offset     The offset within the byte array to write data to.
+    * \param value      The value to be stored to the byte array.
+    *
+    *******************************************************************************/
+    static void PutU32(uint8_t array[], uint32_t offset, uint32_t value)
+    {
+        (void) memcpy( (void*)&array[offset], (const void*)&value, UINT32_SIZE);
+    }
+#endif /* ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL == 0)) ||
+          (CY_DFU_OPT_RESUME != 0) */
+
+
+/*******************************************************************************
+* Function Name: PacketChecksumIndex
+****************************************************************************//**
+*
+* This function returns an index to the checksum field in a received packet
+*
+* \param size The DFU packet size value.
+*
+* \return The index to the checksum.
+*
+*******************************************************************************/
+static uint32_t PacketChecksumIndex(uint32_t size)
+{
+    return (PACKET_DATA_IDX + size);
+}
+
+
+/*******************************************************************************
+* Function Name: PacketEopIndex
+****************************************************************************//**
+*
+* This function returns an index to the end of the packet field in a received
+* packet.
+*
+* \param size  The DFU packet size value.
+*
+* \return Returns an index to the end of the packet.
+*
+*******************************************************************************/
+static uint32_t PacketEopIndex(uint32_t size)
+{
+    return (PACKET_DATA_IDX + size + PACKET_CHECKSUM_LENGTH);
+}
+
+
+/*******************************************************************************
+* Function Name: GetPacketCommand
+****************************************************************************//**
+*
+* This function returns a DFU packet command value for a given \c packet.
+*
+* \param packet  The pointer to the byte array containing DFU packet
+*                data.
+*
+* \return A DFU packet command value.
+*
+*******************************************************************************/
+static uint32_t GetPacketCommand(const uint8_t packet[])
+{
+    return ( (uint32_t) packet[PACKET_CMD_IDX] );
+}
+
+
+/*******************************************************************************
+* Function Name: GetPacketDSize
+****************************************************************************//**
+*
+* This function returns a data size in the DFU packet. \n
+* MISRA requires this function have no side effects.
+*
+* \param packet  The pointer to the byte array containing DFU packet
+*                data.
+*
+* \return A size of the data in bytes in the packet.
+*
+*******************************************************************************/
+static uint32_t GetPacketDSize(const uint8_t packet[])
+{
+    return ( (uint32_t) GetU16( &packet[PACKET_SIZE_IDX] ) );
+}
+
+
+/*******************************************************************************
+* Function Name: GetPacketData
+****************************************************************************//**
+*
+* This function is used to get packet data.
+*
+* \param packet  The pointer to the byte array containing DFU packet
+*                data.
+* \param offset  The offset within the data bytes in the packet.
+*                E.g. 0 means the first byte of the data.
+*
+* \return A pointer to the data bytes with the offset in the packet.
+*
+*******************************************************************************/
+static uint8_t* GetPacketData(uint8_t packet[], uint32_t offset)
+{
+    return ( &packet[PACKET_DATA_IDX + offset] );
+}
+
+
+/*******************************************************************************
+* Function Name: GetPacketChecksum
+****************************************************************************//**
+*
+* This function is used to get a DFU packet checksum.
+*
+* \param packet      The pointer to a byte array containing the
+*                    DFU packet data.
+* \param packetSize  The offset within the data bytes in the packet. \n
+*                    E.g. 0 means the first byte of the data.
+*
+* \return The DFU packet checksum.
+*
+*******************************************************************************/
+static uint32_t GetPacketChecksum(const uint8_t packet[], uint32_t packetSize)
+{
+    return ( (uint32_t) GetU16( &packet[ PacketChecksumIndex(packetSize) ] ) );
+}
+
+
+/*******************************************************************************
+* Function Name: ValidatePacketFooter
+****************************************************************************//**
+*
+* This function is used to validate a DFU packet footer.
+*
+* \param packet      The pointer to a byte array containing the
+*                    DFU packet data.
+* \param packetSize  The offset within the data bytes in the packet. \n
+*                    E.g. 0 means the first byte of the data.
+* \return
+* - 0, if the DFU packet footer is invalid.
+* - 1, if the DFU packet footer is valid.
+*
+*******************************************************************************/
+static uint32_t ValidatePacketFooter(const uint8_t packet[], uint32_t packetSize)
+{
+    return ( (packet[PacketEopIndex(packetSize)] == PACKET_EOP_VALUE)? 1UL : 0UL );
+}
+
+
+/*******************************************************************************
+* Function Name: SetPacketHeader
+****************************************************************************//**
+*
+* This function is used to set a DFU packet header value.
+*
+* \param packet     The pointer to a byte array containing the DFU packet
+*                   data.
+*
+*******************************************************************************/
+static void SetPacketHeader(uint8_t packet[])
+{
+    packet[PACKET_SOP_IDX] = PACKET_SOP_VALUE;
+}
+
+
+/*******************************************************************************
+* Function Name: SetPacketCmd
+****************************************************************************//**
+*
+* This function is used to set a DFU packet command value.
+*
+* \param packet     The pointer to a byte array containing the
+*                   DFU packet data.
+* \param cmd        The command value to be set in the DFU packet.
+*
+*******************************************************************************/
+static void SetPacketCmd(uint8_t packet[], uint32_t cmd)
+{
+    packet[PACKET_CMD_IDX] = (uint8_t)cmd;
+}
+
+
+/*******************************************************************************
+* Function Name: SetPacketDSize
+****************************************************************************//**
+*
+* This function is used to set a DFU packet size value.
+*
+* \param packet     The pointer to a byte array containing the
+*                   DFU packet data.
+* \param size       The value for the DFU packet size.
+*
+*******************************************************************************/
+static void SetPacketDSize(uint8_t packet[], uint32_t size)
+{
+    PutU16(packet, PACKET_SIZE_IDX, size);
+}
+
+
+/*******************************************************************************
+* Function Name: SetPacketChecksum
+****************************************************************************//**
+*
+* This function is used to set a DFU packet checksum value.
+*
+* \param packet     The pointer to a byte array containing the
+*                   DFU packet data.
+* \param size       The DFU packet size value.
+* \param checksum   The value for a DFU packet checksum.
+*
+*******************************************************************************/
+static void SetPacketChecksum(uint8_t packet[], uint32_t size, uint32_t checksum)
+{
+    PutU16(packet, PacketChecksumIndex(size), checksum);
+}
+
+
+/*******************************************************************************
+* Function Name: SetPacketFooter
+****************************************************************************//**
+*
+* This function is used to set a DFU packet footer value.
+*
+* \param packet     The pointer to a byte array containing the
+*                   DFU packet data.
+* \param size       The DFU packet size value.
+*
+*******************************************************************************/
+static void SetPacketFooter(uint8_t packet[], uint32_t size)
+{
+    packet[PacketEopIndex(size)] = PACKET_EOP_VALUE;
+}
+
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+/*******************************************************************************
+* Function Name: Cy_DFU_ValidateMetadata
+****************************************************************************//**
+*
+* The function checks if the DFU metadata is valid. It calculates CRC-32C and
+* compare with stored value at the end of metadata.
+* With \ref CY_DFU_OPT_METADATA_V2, it checks the metadata header and the CRC-32C
+* of each of the \ref CY_DFU_MAX_APPS application records. With
+* \ref CY_DFU_OPT_METADATA_JOURNAL, it builds the journal index again and checks
+* that the journal has a record: the records with a CRC-32C that is not valid
+* are skipped by design, they are left by an interrupted update.
+* With \ref CY_DFU_OPT_METADATA_CACHE, the result for the metadata at
+* __cy_boot_metadata_addr is kept until \ref Cy_DFU_MetadataCacheInvalidate.
+*
+* \param metadataAddress    Start address of the DFU metadata location.
+* \param params             The pointer to a DFU parameters structure.
+*                           See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+* - \ref CY_DFU_SUCCESS - metadata is valid.
+* - \ref CY_DFU_ERROR_VERIFY - metadata is not valid.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_ValidateMetadata(uint32_t metadataAddress, cy_stc_dfu_params_t *params)
+{
+#if CY_DFU_OPT_METADATA_CACHE != 0
+    cy_en_dfu_status_t status;
+
+    if (metadataAddress == ElfSymbolToAddr(&__cy_boot_metadata_addr))
+    {
+        if (!cy_dfu_metadataCache.validated)
+        {
+            cy_dfu_metadataCache.status = MetadataValidate(metadataAddress, params);
+            cy_dfu_metadataCache.validated = true;
+        }
+        status = cy_dfu_metadataCache.status;
+    }
+    else
+    {
+        status = MetadataValidate(metadataAddress, params);
+    }
+    return (status);
+#else
+    return (MetadataValidate(metadataAddress, params));
+#endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+}
+
+
+/*******************************************************************************
+* Function Name: MetadataValidate
+****************************************************************************//**
+*
+* This internal function checks the DFU metadata, see
+* \ref Cy_DFU_ValidateMetadata.
+*
+* \param metadataAddress    Start address of the DFU metadata location.
+* \param params             The pointer to a DFU parameters structure.
+*
+* \return \ref CY_DFU_SUCCESS if the metadata is valid, \ref CY_DFU_ERROR_VERIFY
+*         otherwise.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t MetadataValidate(uint32_t metadataAddress, cy_stc_dfu_params_t *params)
+{
+   const uint32_t metadataLength = ElfSymbolToAddr(&__cy_boot_metadata_length);
+
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+   cy_en_dfu_status_t status = CY_DFU_ERROR_VERIFY;
+
+   (void) params;
+   if ( (metadataAddress == ElfSymbolToAddr(&__cy_boot_metadata_addr)) &&
+        (metadataLength >= CY_DFU_METADATA_LENGTH) )
+   {
+       JournalBuild();
+       if (JournalRowCurrent(cy_dfu_journal.headRow))
+       {
+           status = CY_DFU_SUCCESS;
+       }
+   }
+#elif CY_DFU_OPT_METADATA_V2 != 0
+   cy_en_dfu_status_t status = CY_DFU_ERROR_VERIFY;
+   cy_stc_dfu_metadata_header_t header;
+
+   MetadataHeaderInit(&header, params);
+   if ( (metadataLength >= CY_DFU_METADATA_LENGTH) &&
+        (memcmp( (const void *)metadataAddress, (const void *)&header, sizeof(header)) == 0) )
+   {
+       uint32_t appId;
+       status = CY_DFU_SUCCESS;
+       for (appId = 0U; (status == CY_DFU_SUCCESS) && (appId < CY_DFU_MAX_APPS); appId++)
+       {
+           if (!MetadataRecordValid( (const uint8_t *)(metadataAddress + MetadataRecordOffset(appId)), params))
+           {
+               status = CY_DFU_ERROR_VERIFY;
+           }
+       }
+   }
+#else
+   uint32_t crc = Cy_DFU_DataChecksum( (uint8_t *)metadataAddress, metadataLength - CRC_CHECKSUM_LENGTH, params);
+   uint32_t crcMeta = *(uint32_t *)(metadataAddress + (metadataLength - CRC_CHECKSUM_LENGTH) );
+   cy_en_dfu_status_t status = (crc == crcMeta) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+   return (status);
+}
+
+
+#if (CY_DFU_OPT_METADATA_CACHE != 0) || defined(CY_DOXYGEN)
+/*******************************************************************************
+* Function Name: MetadataCacheData
+****************************************************************************//**
+*
+* This internal function returns the RAM copy of the metadata, and reads it
+* from the NVM first if it is not loaded. The copy holds the whole metadata,
+* or only the first row of it with \ref CY_DFU_OPT_METADATA_JOURNAL.
+* It is read directly from the memory-mapped NVM, params->dataBuffer is
+* not used.
+*
+* \return The pointer to the 4-byte aligned metadata bytes.
+*
+*******************************************************************************/
+static const uint8_t *MetadataCacheData(void)
+{
+    if (!cy_dfu_metadataCache.loaded)
+    {
+        uint32_t length = ElfSymbolToAddr(&__cy_boot_metadata_length);
+
+        (void) memcpy( (void *)cy_dfu_metadataCache.data, (const void *)ElfSymbolToAddr(&__cy_boot_metadata_addr),
+                       (length < METADATA_CACHE_SIZE) ? length : METADATA_CACHE_SIZE);
+        cy_dfu_metadataCache.loaded = true;
+    }
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','The cache words are read as bytes.');
+    return ( (const uint8_t *)cy_dfu_metadataCache.data );
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_MetadataCacheInvalidate
+****************************************************************************//**
+*
+* Drops the RAM copy of the metadata and the result of
+* \ref Cy_DFU_ValidateMetadata kept with \ref CY_DFU_OPT_METADATA_CACHE, and the
+* RAM index of the journal with \ref CY_DFU_OPT_METADATA_JOURNAL. They are read
+* from the NVM again on the next use.
+*
+* \ref Cy_DFU_SetAppMetadata and \ref Cy_DFU_SetAppRecord call this function
+* after they write the metadata. \ref Cy_DFU_WriteData must call it after any
+* other write or erase of the metadata range, for example by the Program Data
+* DFU command, also if the write fails.
+*
+*******************************************************************************/
+void Cy_DFU_MetadataCacheInvalidate(void)
+{
+    cy_dfu_metadataCache.loaded = false;
+    cy_dfu_metadataCache.validated = false;
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+    cy_dfu_journal.built = false;
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+}
+#endif /* (CY_DFU_OPT_METADATA_CACHE != 0) || defined(CY_DOXYGEN) */
+
+
+#if (CY_DFU_OPT_METADATA_V2 != 0) || defined(CY_DOXYGEN)
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+/*******************************************************************************
+* Function Name: JournalRecordValid
+****************************************************************************//**
+*
+* This internal function checks if a row of the metadata journal starts with a
+* record: the journal magic number, a valid application number, and a valid
+* CRC-32C. A record with the sequence number 0 is an initial record of the
+* template without a CRC-32C, it is only accepted in the row of its application
+* number, where the ".cy_boot_metadata" section places it.
+*
+* \param record    The record at the start of a journal row.
+* \param row       The journal row of the record.
+*
+* \return true if the record is valid.
+*
+*******************************************************************************/
+static bool JournalRecordValid(const cy_stc_dfu_app_metadata_t *record, uint32_t row)
+{
+    bool valid = (record->magic == CY_DFU_METADATA_JOURNAL_MAGIC) && (record->appId < CY_DFU_MAX_APPS);
+
+    if (valid && (record->sequence == 0U))
+    {
+        valid = (row == record->appId);
+    }
+    else if (valid)
+    {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the record to bytes is safe as it has no padding.');
+        valid = MetadataRecordValid( (const uint8_t *)record, NULL);
+    }
+    else
+    {
+        /* Not a journal record */
+    }
+    return (valid);
+}
+
+
+/*******************************************************************************
+* Function Name: JournalBuild
+****************************************************************************//**
+*
+* This internal function scans the metadata journal and builds its RAM index:
+* the row and the verified area of the record with the highest sequence number
+* of each application, and the row of the newest record.
+*
+*******************************************************************************/
+static void JournalBuild(void)
+{
+    uint32_t journalAddress = ElfSymbolToAddr(&__cy_boot_metadata_addr);
+    uint32_t rowCount = ElfSymbolToAddr(&__cy_boot_metadata_length) / CY_NVM_SIZEOF_ROW;
+    uint32_t appId;
+    uint32_t row;
+
+    for (appId = 0U; appId < CY_DFU_MAX_APPS; appId++)
+    {
+        cy_dfu_journal.apps[appId].verifyAddress = 0U;
+        cy_dfu_journal.apps[appId].verifySize    = 0U;
+        cy_dfu_journal.apps[appId].row           = JOURNAL_NO_ROW;
+        cy_dfu_journal.apps[appId].sequence      = 0U;
+    }
+    /* Without records, the first record is written to row 0 */
+    cy_dfu_journal.headRow      = rowCount - 1U;
+    cy_dfu_journal.headSequence = 0U;
+
+    for (row = 0U; row < rowCount; row++)
+    {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as it has valid address defined in linker script.');
+        const cy_stc_dfu_app_metadata_t *record = (const cy_stc_dfu_app_metadata_t *)
+                                                  (journalAddress + (row * CY_NVM_SIZEOF_ROW));
+        if (JournalRecordValid(record, row))
+        {
+            cy_stc_dfu_journal_entry_t *entry = &cy_dfu_journal.apps[record->appId];
+
+            /* An initial record is current only while the application has no record with a CRC-32C */
+            if ( (entry->row == JOURNAL_NO_ROW) ||
+                 ( (record->sequence != 0U) && (record->sequence >= entry->sequence) ) )
+            {
+                entry->verifyAddress = record->verifyAddress;
+                entry->verifySize    = record->verifySize;
+                entry->row           = row;
+                entry->sequence      = record->sequence;
+            }
+            if (record->sequence >= cy_dfu_journal.headSequence)
+            {
+                cy_dfu_journal.headRow      = row;
+                cy_dfu_journal.headSequence = record->sequence;
+            }
+        }
+    }
+    cy_dfu_journal.built = true;
+}
+
+
+/*******************************************************************************
+* Function Name: JournalRowCurrent
+****************************************************************************//**
+*
+* This internal function checks if a row of the metadata journal has the
+* current record of an application.
+*
+* \param row   The journal row.
+*
+* \return true if the row must not be written.
+*
+*******************************************************************************/
+static bool JournalRowCurrent(uint32_t row)
+{
+    bool current = false;
+    uint32_t appId;
+
+    for (appId = 0U; (!current) && (appId < CY_DFU_MAX_APPS); appId++)
+    {
+        current = (cy_dfu_journal.apps[appId].row == row);
+    }
+    return (current);
+}
+
+
+#if CY_DFU_METADATA_WRITABLE != 0
+/*******************************************************************************
+* Function Name: JournalAppend
+****************************************************************************//**
+*
+* This internal function writes an application record to the metadata journal:
+* to the first row after the newest record that has no current record of an
+* application. The rows of the superseded records are reused in turn, so the
+* erases are spread over the journal, and the previous record of the
+* application stays current until the new one is written. The rows must be
+* erased singly: on the memory erased in larger units, the write of a row at
+* the start of a unit would erase the current records of the other rows.
+*
+* \note This function uses params->dataBuffer for the write NVM.
+*
+* \param appId     The application number.
+* \param record    The record to write, its appId, sequence, magic and crc fields
+*                  are set by this function.
+* \param params    The pointer to a DFU parameters structure.
+*
+* \return See \ref cy_en_dfu_status_t
+* - \ref CY_DFU_ERROR_LENGTH - the journal has no row to write.
+* - \ref CY_DFU_ERROR_ADDRESS - the journal is in the memory erased in units
+*   larger than a row, see \ref Cy_DFU_GetEraseSize.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t JournalAppend(uint32_t appId, const cy_stc_dfu_app_metadata_t *record,
+                                        cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+    uint32_t rowCount = ElfSymbolToAddr(&__cy_boot_metadata_length) / CY_NVM_SIZEOF_ROW;
+    uint32_t row = cy_dfu_journal.headRow;
+    uint32_t count;
+    /* A row at the start of a larger erase unit is not written alone */
+    bool rowErase = (Cy_DFU_GetEraseSize(ElfSymbolToAddr(&__cy_boot_metadata_addr)) <= CY_NVM_SIZEOF_ROW);
+
+    for (count = 0U; rowErase && (status != CY_DFU_SUCCESS) && (count < rowCount); count++)
+    {
+        row = ( (row + 1U) < rowCount ) ? (row + 1U) : 0U;
+        if (!JournalRowCurrent(row))
+        {
+            status = CY_DFU_SUCCESS;
+        }
+    }
+    if (!rowErase)
+    {
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        cy_stc_dfu_app_metadata_t entry = *record;
+
+        entry.appId    = appId;
+        entry.sequence = cy_dfu_journal.headSequence + 1U;
+        entry.magic    = CY_DFU_METADATA_JOURNAL_MAGIC;
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the record to bytes is safe as it has no padding.');
+        entry.crc      = Cy_DFU_DataChecksum( (const uint8_t *)&entry,
+                                              CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH, params);
+
+        (void) memset(params->dataBuffer, 0, CY_NVM_SIZEOF_ROW);
+        (void) memcpy( (void *)params->dataBuffer, (const void *)&entry, sizeof(entry));
+        status = Cy_DFU_WriteData(ElfSymbolToAddr(&__cy_boot_metadata_addr) + (row * CY_NVM_SIZEOF_ROW),
+                                  CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+        METADATA_CACHE_INVALIDATE();
+        if (status == CY_DFU_SUCCESS)
+        {
+            cy_dfu_journal.apps[appId].verifyAddress = entry.verifyAddress;
+            cy_dfu_journal.apps[appId].verifySize    = entry.verifySize;
+            cy_dfu_journal.apps[appId].row           = row;
+            cy_dfu_journal.apps[appId].sequence      = entry.sequence;
+            cy_dfu_journal.headRow      = row;
+            cy_dfu_journal.headSequence = entry.sequence;
+        }
+    }
+    return (status);
+}
+#endif /* CY_DFU_METADATA_WRITABLE != 0 */
+#else
+/*******************************************************************************
+* Function Name: MetadataRecordOffset
+****************************************************************************//**
+*
+* This internal function returns the offset of the application record in the
+* metadata: the records follow the header row,
+* \ref CY_DFU_METADATA_RECORDS_PER_ROW records in each row.
+*
+* \param appId     The application number.
+*
+* \return The offset in bytes from the metadata start address.
+*
+*******************************************************************************/
+static uint32_t MetadataRecordOffset(uint32_t appId)
+{
+    return ( ((1U + (appId / CY_DFU_METADATA_RECORDS_PER_ROW)) * CY_NVM_SIZEOF_ROW) +
+             ((appId % CY_DFU_METADATA_RECORDS_PER_ROW) * CY_DFU_METADATA_RECORD_SIZE) );
+}
+
+
+/*******************************************************************************
+* Function Name: MetadataHeaderInit
+****************************************************************************//**
+*
+* This internal function fills the metadata header of this build: the format
+* version, the geometry of the records and the header CRC-32C.
+*
+* \param header    The pointer to the header to fill.
+* \param params    The pointer to a DFU parameters structure.
+*
+*******************************************************************************/
+static void MetadataHeaderInit(cy_stc_dfu_metadata_header_t *header, cy_stc_dfu_params_t *params)
+{
+    header->magic      = CY_DFU_METADATA_MAGIC;
+    header->version    = (uint16_t)CY_DFU_METADATA_VERSION;
+    header->recordSize = (uint16_t)CY_DFU_METADATA_RECORD_SIZE;
+    header->appCount   = CY_DFU_MAX_APPS;
+    header->rowSize    = CY_NVM_SIZEOF_ROW;
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the header to bytes is safe as it has no padding.');
+    header->crc        = Cy_DFU_DataChecksum( (const uint8_t *)header,
+                                              (uint32_t)sizeof(*header) - CRC_CHECKSUM_LENGTH, params);
+}
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+
+
+/*******************************************************************************
+* Function Name: MetadataRecordValid
+****************************************************************************//**
+*
+* This internal function checks the CRC-32C at the end of an application
+* record.
+*
+* \param record    The application record, in the NVM or in a buffer.
+* \param params    The pointer to a DFU parameters structure.
+*
+* \return true if the record CRC-32C is valid.
+*
+*******************************************************************************/
+static bool MetadataRecordValid(const uint8_t record[], cy_stc_dfu_params_t *params)
+{
+    uint32_t crc = Cy_DFU_DataChecksum(record, CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH, params);
+    return (crc == GetU32(&record[CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH]));
+}
+
+
+/*******************************************************************************
+* Function Name: MetadataRecordAddress
+****************************************************************************//**
+*
+* This internal function returns the NVM address of the current record of an
+* application: at its fixed offset in the metadata, or at the journal row of
+* the record with \ref CY_DFU_OPT_METADATA_JOURNAL.
+*
+* \param appId     The application number.
+*
+* \return The address of the record, 0 if the application has no record.
+*
+*******************************************************************************/
+static uint32_t MetadataRecordAddress(uint32_t appId)
+{
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+    uint32_t address = 0U;
+
+    if (!cy_dfu_journal.built)
+    {
+        JournalBuild();
+    }
+    if (cy_dfu_journal.apps[appId].row != JOURNAL_NO_ROW)
+    {
+        address = ElfSymbolToAddr(&__cy_boot_metadata_addr) + (cy_dfu_journal.apps[appId].row * CY_NVM_SIZEOF_ROW);
+    }
+    return (address);
+#else
+    return (ElfSymbolToAddr(&__cy_boot_metadata_addr) + MetadataRecordOffset(appId));
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetAppRecord
+****************************************************************************//**
+*
+* Reads the metadata record of an application, see
+* \ref group_dfu_ucase_metadata_v2. The record is read from the metadata
+* address, the metadata is supposed to be located in internal flash.
+*
+* \param appId     The application number.
+* \param record    The pointer to a variable where the record is stored.
+* \param params    The pointer to a DFU parameters structure.
+*                  See \ref cy_stc_dfu_params_t.
+*
+* \return See \ref cy_en_dfu_status_t
+* - \ref CY_DFU_SUCCESS - the record is read and valid.
+* - \ref CY_DFU_ERROR_VERIFY - the record is read, its CRC-32C is not valid, or
+*   the application has no record in the metadata journal and the record is
+*   set to 0.
+* - \ref CY_DFU_ERROR_UNKNOWN - a parameter is not valid.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_GetAppRecord(uint32_t appId, cy_stc_dfu_app_metadata_t *record,
+                                       cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
+
+    if ( (record != NULL) && (params != NULL) && (appId < CY_DFU_MAX_APPS) )
+    {
+        uint32_t address = MetadataRecordAddress(appId);
+
+        status = CY_DFU_ERROR_VERIFY;
+        if (address == 0U)
+        {
+            (void) memset( (void *)record, 0, sizeof(*record));
+        }
+        else
+        {
+            (void) memcpy( (void *)record, (const void *)address, sizeof(*record));
+        #if CY_DFU_OPT_METADATA_JOURNAL != 0
+            /* The current journal records are checked by JournalBuild() */
+            status = CY_DFU_SUCCESS;
+        #else
+            status = MetadataRecordValid( (const uint8_t *)address, params) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+        #endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+        }
+    }
+    return (status);
+}
+
+
+#if (CY_DFU_METADATA_WRITABLE != 0) || defined(CY_DOXYGEN)
+#if CY_DFU_OPT_METADATA_JOURNAL == 0
+/*******************************************************************************
+* Function Name: MetadataFormat
+****************************************************************************//**
+*
+* This internal function writes the metadata header if the one in the NVM is
+* not valid or is for another format version or geometry. The CRC-32C of each
+* record is written first and the header last, so the metadata initialized in
+* the ".cy_boot_metadata" section becomes valid, and an interrupted format is
+* done again.
+*
+* \note This function uses params->dataBuffer for the read and write NVM.
+*
+* \param metadataAddress   The start address of the metadata.
+* \param params            The pointer to a DFU parameters structure.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t MetadataFormat(uint32_t metadataAddress, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_stc_dfu_metadata_header_t header;
+
+    MetadataHeaderInit(&header, params);
+    if (memcmp( (const void *)metadataAddress, (const void *)&header, sizeof(header)) != 0)
+    {
+        uint32_t row;
+
+        for (row = 1U; (status == CY_DFU_SUCCESS) && (row < (CY_DFU_METADATA_LENGTH / CY_NVM_SIZEOF_ROW)); row++)
+        {
+            uint32_t rowAddress = metadataAddress + (row * CY_NVM_SIZEOF_ROW);
+            uint32_t offset;
+
+            status = Cy_DFU_ReadData(rowAddress, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_READ, params);
+            if (status == CY_DFU_SUCCESS)
+            {
+                for (offset = 0U; offset < CY_NVM_SIZEOF_ROW; offset += CY_DFU_METADATA_RECORD_SIZE)
+                {
+                    uint32_t crc = Cy_DFU_DataChecksum(&params->dataBuffer[offset],
+                                                       CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH, params);
+                    PutU32(params->dataBuffer, (offset + CY_DFU_METADATA_RECORD_SIZE) - CRC_CHECKSUM_LENGTH, crc);
+                }
+                status = Cy_DFU_WriteData(rowAddress, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+            }
+        }
+        if (status == CY_DFU_SUCCESS)
+        {
+            (void) memset(params->dataBuffer, 0, CY_NVM_SIZEOF_ROW);
+            (void) memcpy( (void *)params->dataBuffer, (const void *)&header, sizeof(header));
+            status = Cy_DFU_WriteData(metadataAddress, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+        }
+        METADATA_CACHE_INVALIDATE();
+    }
+    return (status);
+}
+#endif /* CY_DFU_OPT_METADATA_JOURNAL == 0 */
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_SetAppRecord
+****************************************************************************//**
+*
+* Writes the metadata record of an application with its CRC-32C, see
+* \ref group_dfu_ucase_metadata_v2. Only the metadata row of the record is
+* rewritten, and only if the record in the NVM is different or not valid.
+* If the metadata header is not valid, it is written first.
+* With \ref CY_DFU_OPT_METADATA_JOURNAL, the record is appended to the journal
+* if its verified area, version, flags or digest are different.
+*
+* \note This function uses params->dataBuffer for the read and write NVM.
+*
+* \param appId     The application number.
+* \param record    The pointer to the record to write, its crc field is ignored,
+*                  and also its appId, sequence and magic fields with
+*                  \ref CY_DFU_OPT_METADATA_JOURNAL.
+* \param params    The pointer to a DFU parameters structure.
+*                  See \ref cy_stc_dfu_params_t.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_SetAppRecord(uint32_t appId, const cy_stc_dfu_app_metadata_t *record,
+                                       cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+    if ( (record == NULL) || (params == NULL) || (appId >= CY_DFU_MAX_APPS) )
+    {
+        status = CY_DFU_ERROR_UNKNOWN;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        uint32_t address = MetadataRecordAddress(appId);
+
+        /* The initial records of the ".cy_boot_metadata" section are written again with a CRC */
+        if ( (address == 0U) || (cy_dfu_journal.apps[appId].sequence == 0U) ||
+             (memcmp( (const void *)address, (const void *)record, JOURNAL_RECORD_DATA_SIZE) != 0) )
+        {
+            status = JournalAppend(appId, record, params);
+        }
+    }
+#else
+    uint32_t metadataAddress = 0U;
+
+    if ( (record == NULL) || (params == NULL) || (appId >= CY_DFU_MAX_APPS) )
+    {
+        status = CY_DFU_ERROR_UNKNOWN;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        metadataAddress = ElfSymbolToAddr(&__cy_boot_metadata_addr);
+        status = MetadataFormat(metadataAddress, params);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        uint32_t offset    = MetadataRecordOffset(appId);
+        uint32_t rowOffset = offset % CY_NVM_SIZEOF_ROW;
+        uint32_t rowAddress = metadataAddress + (offset - rowOffset);
+
+        status = Cy_DFU_ReadData(rowAddress, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_READ, params);
+        if (status == CY_DFU_SUCCESS)
+        {
+            uint8_t *buffer = &params->dataBuffer[rowOffset];
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting the record to bytes is safe as it has no padding.');
+            uint32_t crc = Cy_DFU_DataChecksum( (const uint8_t *)record,
+                                               CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH, params);
+
+            if ( (memcmp( (const void *)buffer, (const void *)record,
+                          CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH) != 0) ||
+                 (GetU32(&buffer[CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH]) != crc) )
+            {
+                (void) memcpy( (void *)buffer, (const void *)record, CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH);
+                PutU32(buffer, CY_DFU_METADATA_RECORD_SIZE - CRC_CHECKSUM_LENGTH, crc);
+                status = Cy_DFU_WriteData(rowAddress, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+                METADATA_CACHE_INVALIDATE();
+            }
+        }
+    }
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+    return (status);
+}
+#endif /* (CY_DFU_METADATA_WRITABLE != 0) || defined(CY_DOXYGEN) */
+#endif /* (CY_DFU_OPT_METADATA_V2 != 0) || defined(CY_DOXYGEN) */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+
+/*******************************************************************************
+* Function Name: PacketChecksumUpdate
+****************************************************************************//**
+*
+* This function accumulates the provided number of bytes contained in the
+* provided buffer into a running DFU packet checksum. Start with
+* \ref PACKET_CHECKSUM_INIT and complete with PacketChecksumFinish().
+*
+* \param checksum   The running checksum.
+* \param buffer     The buffer containing the data to compute the checksum for.
+* \param size       The number of bytes in the buffer to compute the checksum
+* for.
+*
+* \return The updated running checksum.
+*
+*******************************************************************************/
+static uint32_t PacketChecksumUpdate(uint32_t checksum, const uint8_t buffer[], uint32_t size)
+{
+#if (CY_DFU_OPT_PACKET_CRC != 0U)
+    uint16_t crc = (uint16_t)checksum;
+    uint16_t tmp;
+    uint32_t i;
+    uint32_t idx;
+
+    for (idx = 0U; idx < size; idx++)
+    {
+        tmp = buffer[idx];
+
+        for (i = 0U; i < 8U; i++)
+        {
+            if (0U != ((crc & 0x0001U) ^ (tmp & 0x0001U)))
+            {
+                crc = (crc >> 1U) ^ CRC_CCITT_POLYNOMIAL;
+            }
+            else
+            {
+                crc >>= 1U;
+            }
+
+            tmp >>= 1U;
+        }
+    }
+
+    return ((uint32_t)crc);
+#else
+    uint16_t sum = (uint16_t)checksum;
+
+    while (size > 0U)
+    {
+        size--;
+        sum += buffer[size];
+    }
+
+    return ((uint32_t)sum);
+#endif /* CY_DFU_OPT_PACKET_CRC != 0U */
+}
+
+
+/*******************************************************************************
+* Function Name: PacketChecksumFinish
+****************************************************************************//**
+*
+* This function converts a running checksum accumulated with
+* PacketChecksumUpdate() into the 16-bit checksum of a DFU packet.
+*
+* \param checksum   The running checksum.
+*
+* \return A 16-bit checksum for the accumulated data
+*
+*******************************************************************************/
+static uint32_t PacketChecksumFinish(uint32_t checksum)
+{
+#if (CY_DFU_OPT_PACKET_CRC != 0U)
+    uint16_t crc = (uint16_t)~(uint16_t)checksum;
+    uint16_t tmp = crc;
+
+    crc = ((uint16_t)(crc << 8U) | (tmp >> 8U) ) & 0xFFFFU;
+
+    return ((uint32_t)crc);
+#else
+    return ( (1U + ~checksum) & 0xFFFFU );
+#endif /* CY_DFU_OPT_PACKET_CRC != 0U */
+}
+
+
+/*******************************************************************************
+* Function Name: PacketChecksum
+****************************************************************************//**
+*
+* This function computes a 16-bit checksum for the provided number of bytes
+* contained
+* in the provided buffer. \n
+* This function is used to calculate the checksum of DFU packets.
+*
+* MISRA requires this function have no side effects.
+*
+* \param buffer     The buffer containing the data to compute the checksum for.
+* \param size       The number of bytes in the buffer to compute the checksum
+* for.
+*
+* \return A 16-bit checksum for the provided data
+*
+*******************************************************************************/
+static uint32_t PacketChecksum(const uint8_t buffer[], uint32_t size)
+{
+    /* 4 bytes before data in Cypress DFU packet */
+    return (PacketChecksumFinish(PacketChecksumUpdate(PACKET_CHECKSUM_INIT, buffer, size + PACKET_DATA_IDX)));
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_DataChecksum
+****************************************************************************//**
+*
+* This function computes a CRC-32C for the provided number of bytes contained
+* in the provided buffer. \n
+* This function is used to validate the Program Data and Verify Data DFU
+* commands and a metadata row.
+* \note Ensure the Crypto block is properly initialized
+* if \ref CY_DFU_OPT_CRYPTO_HW is set.
+*
+* \param address    The pointer to a buffer containing the data to compute
+*                   the checksum for.
+* \param length     The number of bytes in the buffer to compute the checksum
+*                   for.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return CRC-32C for the provided data.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_DataChecksum(const uint8_t *address, uint32_t length, cy_stc_dfu_params_t *params)
+{
+    /* Note: param is unused by the current implementation */
+    /* but it may be used in the future, if the Crypto API changes */
+    (void)params;
+
+#if CY_DFU_OPT_CRYPTO_HW != 0 /* Use PDL Hardware Crypto API */
+    /* Note that the length will be < 64KB due to the hardware limitation in the Crypto Block. */
+    /* If the block size is bigger, use software implementation instead. */
+
+    uint32_t crcOut = 0U;
+
+    cy_stc_crypto_context_crc_t cryptoCrcContext;
+    cy_en_crypto_status_t cryptoStatus;
+
+    cryptoStatus = CryptoAcquire();
+    if (cryptoStatus == CY_CRYPTO_SUCCESS)
+    {
+        cryptoStatus = Cy_Crypto_Crc_Init( CRC_POLYNOMIAL,     CRC_DATA_REVERSE,
+                                           CRC_DATA_XOR  ,     CRC_REM_REVERSE ,
+                                           CRC_REM_XOR,        &cryptoCrcContext );
+        if (cryptoStatus == CY_CRYPTO_SUCCESS)
+        {
+            cryptoStatus = Cy_Crypto_Sync(CY_CRYPTO_SYNC_BLOCKING);
+        }
+        if (cryptoStatus == CY_CRYPTO_SUCCESS)
+        {
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 11.8',1,'Removing const does not have negative impact as function does not modify data.');
+            cryptoStatus = Cy_Crypto_Crc_Run (
+                /* dataPtr */ (void *)address,          /* length        */ (uint16_t) length,
+                /* crcPtr  */ &crcOut,                  /* lfsrInitState */ CRC_LFSR_SEED,
+                /* cfContext     */ &cryptoCrcContext  );
+        }
+CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.8');
+        if (cryptoStatus == CY_CRYPTO_SUCCESS)
+        {
+            cryptoStatus = Cy_Crypto_Sync(CY_CRYPTO_SYNC_BLOCKING);
+        }
+    }
+    if (cryptoStatus != CY_CRYPTO_SUCCESS)
+    {
+        CY_HALT();
+    }
+
+    return (crcOut);
+#else /* Use software implementation */
+    return (~CrcUpdate(CRC_INIT, address, length));
+#endif /* CY_DFU_OPT_CRYPTO_HW != 0 */
+}
+
+
+#if CY_DFU_OPT_CRYPTO_HW == 0
+/*******************************************************************************
+* Function Name: CrcUpdate
+****************************************************************************//**
+*
+* This function adds the provided bytes to a CRC-32C remainder. The CRC-32C
+* of the data is the bitwise inversion of the remainder after all the data,
+* starting with \c CRC_INIT.
+*
+* \param crc        The CRC-32C remainder of the preceding data.
+* \param address    The pointer to a buffer containing the data.
+* \param length     The number of bytes in the buffer.
+*
+* \return The CRC-32C remainder including the provided data.
+*
+*******************************************************************************/
+static uint32_t CrcUpdate(uint32_t crc, const uint8_t *address, uint32_t length)
+{
+    /* Contains generated values to calculate CRC-32C by 4 bits per iteration*/
+    static const uint32_t crcTable[CRC_TABLE_SIZE] =
+    {
+        0x00000000U, 0x105ec76fU, 0x20bd8edeU, 0x30e349b1U,
+        0x417b1dbcU, 0x5125dad3U, 0x61c69362U, 0x7198540dU,
+        0x82f63b78U, 0x92a8fc17U, 0xa24bb5a6U, 0xb21572c9U,
+        0xc38d26c4U, 0xd3d3e1abU, 0xe330a81aU, 0xf36e6f75U,
+    };
+
+    if (length != 0U)
+    {
+        do
+        {
+            crc = crc ^ *address;
+            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
+            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
+            --length;
+            ++address;
+        } while (length != 0U);
+    }
+    return (crc);
+}
+#else
+
+
+/*******************************************************************************
+* Function Name: CryptoAcquire
+****************************************************************************//**
+*
+* This function enables the Crypto block if it is not enabled yet. The block
+* stays enabled for the following checksum calculations until
+* \ref Cy_DFU_CryptoRelease.
+*
+* \return The status of Cy_Crypto_Enable(), CY_CRYPTO_SUCCESS if the block is
+*         already enabled.
+*
+*******************************************************************************/
+static cy_en_crypto_status_t CryptoAcquire(void)
+{
+    cy_en_crypto_status_t cryptoStatus = CY_CRYPTO_SUCCESS;
+
+    if (!cy_dfu_cryptoEnabled)
+    {
+        cryptoStatus = Cy_Crypto_Enable();
+        cy_dfu_cryptoEnabled = (cryptoStatus == CY_CRYPTO_SUCCESS);
+    }
+    return (cryptoStatus);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_CryptoRelease
+****************************************************************************//**
+*
+* This function disables the Crypto block if the DFU SDK has enabled it.
+*
+* The DFU SDK enables the Crypto block on the first hardware CRC-32C or SHA
+* calculation and keeps it enabled for the following ones, instead of enabling
+* and disabling it for each packet. \ref Cy_DFU_Continue releases it on the
+* Exit DFU command; the user's code calls this function when it has validated
+* the applications outside an update session and no longer needs the block.
+*
+*******************************************************************************/
+void Cy_DFU_CryptoRelease(void)
+{
+    if (cy_dfu_cryptoEnabled)
+    {
+        (void) Cy_Crypto_Disable();
+        cy_dfu_cryptoEnabled = false;
+    }
+}
+#endif /* CY_DFU_OPT_CRYPTO_HW == 0 */
+
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)
+/*******************************************************************************
+* Function Name: Sha256Rotr
+****************************************************************************//**
+*
+* This function rotates a 32-bit word right.
+*
+* \param value  The word to rotate.
+* \param shift  The number of bits to rotate by, 1 to 31.
+*
+* \return The rotated word.
+*
+*******************************************************************************/
+static uint32_t Sha256Rotr(uint32_t value, uint32_t shift)
+{
+    return ((value >> shift) | (value << (32U - shift)));
+}
+
+
+/*******************************************************************************
+* Function Name: Sha256Block
+****************************************************************************//**
+*
+* This function processes one 64-byte message block of SHA-256 (FIPS 180-4).
+*
+* \param state  The hash state, 8 words.
+* \param block  The message block, \ref CY_DFU_SHA256_BLOCK_SIZE bytes.
+*
+*******************************************************************************/
+static void Sha256Block(uint32_t state[], const uint8_t block[])
+{
+    static const uint32_t k[64U] =
+    {
+        0x428a2f98U, 0x71374491U, 0xb5c0fbcfU, 0xe9b5dba5U, 0x3956c25bU, 0x59f111f1U, 0x923f82a4U, 0xab1c5ed5U,
+        0xd807aa98U, 0x12835b01U, 0x243185beU, 0x550c7dc3U, 0x72be5d74U, 0x80deb1feU, 0x9bdc06a7U, 0xc19bf174U,
+        0xe49b69c1U, 0xefbe4786U, 0x0fc19dc6U, 0x240ca1ccU, 0x2de92c6fU, 0x4a7484aaU, 0x5cb0a9dcU, 0x76f988daU,
+        0x983e5152U, 0xa831c66dU, 0xb00327c8U, 0xbf597fc7U, 0xc6e00bf3U, 0xd5a79147U, 0x06ca6351U, 0x14292967U,
+        0x27b70a85U, 0x2e1b2138U, 0x4d2c6dfcU, 0x53380d13U, 0x650a7354U, 0x766a0abbU, 0x81c2c92eU, 0x92722c85U,
+        0xa2bfe8a1U, 0xa81a664bU, 0xc24b8b70U, 0xc76c51a3U, 0xd192e819U, 0xd6990624U, 0xf40e3585U, 0x106aa070U,
+        0x19a4c116U, 0x1e376c08U, 0x2748774cU, 0x34b0bcb5U, 0x391c0cb3U, 0x4ed8aa4aU, 0x5b9cca4fU, 0x682e6ff3U,
+        0x748f82eeU, 0x78a5636fU, 0x84c87814U, 0x8cc70208U, 0x90befffaU, 0xa4506cebU, 0xbef9a3f7U, 0xc67178f2U
+    };
+    uint32_t w[16U];
+    uint32_t v[8U];
+    uint32_t i;
+
+    for (i = 0U; i < 16U; i++)
+    {
+        w[i] = ((uint32_t)block[i * 4U] << 24U) | ((uint32_t)block[(i * 4U) + 1U] << 16U) |
+               ((uint32_t)block[(i * 4U) + 2U] << 8U) | (uint32_t)block[(i * 4U) + 3U];
+    }
+    for (i = 0U; i < 8U; i++)
+    {
+        v[i] = state[i];
+    }
+    for (i = 0U; i < 64U; i++)
+    {
+        uint32_t t1;
+        uint32_t t2;
+
+        if (i >= 16U)
+        {
+            /* The message schedule is kept in a 16-word window */
+            uint32_t w15 = w[(i + 1U) & 15U];
+            uint32_t w2 = w[(i + 14U) & 15U];
+            w[i & 15U] += (Sha256Rotr(w15, 7U) ^ Sha256Rotr(w15, 18U) ^ (w15 >> 3U)) + w[(i + 9U) & 15U] +
+                          (Sha256Rotr(w2, 17U) ^ Sha256Rotr(w2, 19U) ^ (w2 >> 10U));
+        }
+        t1 = v[7U] + (Sha256Rotr(v[4U], 6U) ^ Sha256Rotr(v[4U], 11U) ^ Sha256Rotr(v[4U], 25U)) +
+             ((v[4U] & v[5U]) ^ (~v[4U] & v[6U])) + k[i] + w[i & 15U];
+        t2 = (Sha256Rotr(v[0U], 2U) ^ Sha256Rotr(v[0U], 13U) ^ Sha256Rotr(v[0U], 22U)) +
+             ((v[0U] & v[1U]) ^ (v[0U] & v[2U]) ^ (v[1U] & v[2U]));
+        v[7U] = v[6U];
+        v[6U] = v[5U];
+        v[5U] = v[4U];
+        v[4U] = v[3U] + t1;
+        v[3U] = v[2U];
+        v[2U] = v[1U];
+        v[1U] = v[0U];
+        v[0U] = t1 + t2;
+    }
+    for (i = 0U; i < 8U; i++)
+    {
+        state[i] += v[i];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_Sha256Init
+****************************************************************************//**
+*
+* This function starts a streaming SHA-256 calculation in software.
+*
+* The DFU SDK uses it to validate the applications and for the running digest
+* of the image (\ref CY_DFU_OPT_INLINE_DIGEST) with \ref CY_DFU_OPT_SHA256,
+* and the user's code can use it to hash the data that is not contiguous in
+* the memory-mapped NVM.
+*
+* \param context The pointer to the context of the calculation.
+*
+*******************************************************************************/
+void Cy_DFU_Sha256Init(cy_stc_dfu_sha256_t *context)
+{
+    context->state[0U] = 0x6a09e667U;
+    context->state[1U] = 0xbb67ae85U;
+    context->state[2U] = 0x3c6ef372U;
+    context->state[3U] = 0xa54ff53aU;
+    context->state[4U] = 0x510e527fU;
+    context->state[5U] = 0x9b05688cU;
+    context->state[6U] = 0x1f83d9abU;
+    context->state[7U] = 0x5be0cd19U;
+    context->length = 0U;
+    context->blockSize = 0U;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_Sha256Update
+****************************************************************************//**
+*
+* This function adds data to a streaming SHA-256 calculation.
+*
+* \param context The pointer to the context of the calculation,
+*                started with \ref Cy_DFU_Sha256Init.
+* \param data    The pointer to the data.
+* \param length  The length of the data in bytes.
+*
+*******************************************************************************/
+void Cy_DFU_Sha256Update(cy_stc_dfu_sha256_t *context, const uint8_t *data, uint32_t length)
+{
+    uint32_t offset = 0U;
+
+    context->length += length;
+    if (context->blockSize != 0U)
+    {
+        uint32_t count = CY_DFU_SHA256_BLOCK_SIZE - context->blockSize;
+        if (count > length)
+        {
+            count = length;
+        }
+        (void) memcpy(&context->block[context->blockSize], data, count);
+        context->blockSize += count;
+        offset = count;
+        if (context->blockSize == CY_DFU_SHA256_BLOCK_SIZE)
+        {
+            Sha256Block(context->state, context->block);
+            context->blockSize = 0U;
+        }
+    }
+    /* The whole blocks are hashed in place */
+    while ((length - offset) >= CY_DFU_SHA256_BLOCK_SIZE)
+    {
+        Sha256Block(context->state, &data[offset]);
+        offset += CY_DFU_SHA256_BLOCK_SIZE;
+    }
+    if (offset < length)
+    {
+        (void) memcpy(&context->block[context->blockSize], &data[offset], length - offset);
+        context->blockSize += length - offset;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_Sha256Final
+****************************************************************************//**
+*
+* This function completes a streaming SHA-256 calculation.
+*
+* \param context The pointer to the context of the calculation.
+* \param digest  The buffer for the digest, \ref CY_DFU_SHA256_SIZE bytes.
+*
+*******************************************************************************/
+void Cy_DFU_Sha256Final(cy_stc_dfu_sha256_t *context, uint8_t digest[])
+{
+    uint32_t bits = context->length * 8U;
+    uint32_t i;
+
+    context->block[context->blockSize] = 0x80U;
+    ++context->blockSize;
+    if (context->blockSize > (CY_DFU_SHA256_BLOCK_SIZE - 8U))
+    {
+        (void) memset(&context->block[context->blockSize], 0, CY_DFU_SHA256_BLOCK_SIZE - context->blockSize);
+        Sha256Block(context->state, context->block);
+        context->blockSize = 0U;
+    }
+    (void) memset(&context->block[context->blockSize], 0, CY_DFU_SHA256_BLOCK_SIZE - context->blockSize);
+    /* The message length in bits, big-endian; the high word is 0 for 32-bit lengths */
+    context->block[CY_DFU_SHA256_BLOCK_SIZE - 5U] = (uint8_t)(context->length >> 29U);
+    context->block[CY_DFU_SHA256_BLOCK_SIZE - 4U] = (uint8_t)(bits >> 24U);
+    context->block[CY_DFU_SHA256_BLOCK_SIZE - 3U] = (uint8_t)(bits >> 16U);
+    context->block[CY_DFU_SHA256_BLOCK_SIZE - 2U] = (uint8_t)(bits >> 8U);
+    context->block[CY_DFU_SHA256_BLOCK_SIZE - 1U] = (uint8_t)bits;
+    Sha256Block(context->state, context->block);
+
+    for (i = 0U; i < 8U; i++)
+    {
+        digest[i * 4U]        = (uint8_t)(context->state[i] >> 24U);
+        digest[(i * 4U) + 1U] = (uint8_t)(context->state[i] >> 16U);
+        digest[(i * 4U) + 2U] = (uint8_t)(context->state[i] >> 8U);
+        digest[(i * 4U) + 3U] = (uint8_t)context->state[i];
+    }
+}
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0) */
+
+
+/*******************************************************************************
+* Function Name: VerifyPacket
+****************************************************************************//**
+*
+* This function is used inside DFU_ReadVerifyPacket() to verify if a
+* received packet is correct.
+*
+* \param numberRead     The number of bytes read from the communication
+*                       interface.
+* \param packet         The pointer to the DFU packet buffer.
+* \param payload        The pointer to the trailing part of the packet data
+*                       that was read outside the packet buffer, or NULL.
+* \param payloadSize    The number of bytes in \c payload. The packet buffer
+*                       holds the data before it and the packet footer.
+*
+* \return  See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t VerifyPacket(uint32_t numberRead, const uint8_t packet[],
+                                       const uint8_t payload[], uint32_t payloadSize)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    if ((numberRead < CY_DFU_PACKET_MIN_SIZE) || (packet[PACKET_SOP_IDX] != PACKET_SOP_VALUE))
+    {
+        status = CY_DFU_ERROR_DATA;
+    }
+    else
+    {
+        uint32_t packetSize = GetPacketDSize(packet);
+
+        /*
+         * If the whole packet length exceeds the number of bytes that have
+         * been read by the communication component or the size of
+         * the buffer that is reserved for the packet, then give an error.
+         */
+        if (   ((packetSize + CY_DFU_PACKET_MIN_SIZE) > numberRead)
+            || ((packetSize + CY_DFU_PACKET_MIN_SIZE) > CY_DFU_SIZEOF_CMD_BUFFER)
+            || (payloadSize > packetSize)  )
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+        else /* The packet length is OK */
+        {
+            if ( ValidatePacketFooter(packet, packetSize) == 0U )
+            {
+                status = CY_DFU_ERROR_DATA;
+            }
+            else
+            {
+                uint32_t pktChecksum = GetPacketChecksum(packet, packetSize);
+                uint32_t checksum = PacketChecksumUpdate(PACKET_CHECKSUM_INIT, packet,
+                                                         PACKET_DATA_IDX + packetSize - payloadSize);
+                if (payloadSize != 0U)
+                {
+                    checksum = PacketChecksumUpdate(checksum, payload, payloadSize);
+                }
+                if (pktChecksum != PacketChecksumFinish(checksum) )
+                {
+                    status = CY_DFU_ERROR_CHECKSUM;
+                }
+            }
+        }
+    }
+    return (status);
+}
+
+
+#if CY_DFU_OPT_ZERO_COPY != 0
+/*******************************************************************************
+* Function Name: ReadExact
+****************************************************************************//**
+*
+* This function reads exactly the requested number of bytes from the
+* communication interface, calling Cy_DFU_TransportRead() as many times as
+* required.
+*
+* \param buffer       The pointer to the buffer to store the read bytes.
+* \param size         The number of bytes to read.
+* \param timeout      The timeout in milliseconds to wait for each part.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ReadExact(uint8_t buffer[], uint32_t size, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t total = 0U;
+
+    while ((status == CY_DFU_SUCCESS) && (total < size))
+    {
+        uint32_t numberRead = 0U;
+
+        status = Cy_DFU_TransportRead(&buffer[total], size - total, &numberRead, timeout);
+
+        if ((status == CY_DFU_SUCCESS) && (numberRead == 0U))
+        {
+            status = CY_DFU_ERROR_TIMEOUT;
+        }
+        total += numberRead;
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadPacketZeroCopy
+****************************************************************************//**
+*
+* This function is used inside ReadVerifyPacket() to read and verify a DFU
+* packet from a transport that supports \ref CY_DFU_TRANSPORT_CAP_ZERO_COPY.
+*
+* The packet header is read first. The data of the Send Data and
+* Program Data commands (after the Program Data parameters) is then read
+* straight into \c dataBuffer at \c dataOffset, and
+* \c params->dataReceived is set to its length. The rest of the packet is
+* read into the packet buffer at the usual positions.
+*
+* \param packet       The pointer to the DFU packet buffer.
+* \param params       The pointer to a DFU parameters structure.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ReadPacketZeroCopy(uint8_t packet[], cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status;
+    uint32_t packetSize = 0U;
+    uint32_t prefixSize = 0U;
+    uint32_t payloadSize = 0U;
+
+    STATS_STAGE_BEGIN(params);
+
+    /* The first part waits for the whole timeout, the packet follows */
+    status = ReadExact(packet, PACKET_DATA_IDX, params->timeout);
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        packetSize = GetPacketDSize(packet);
+
+        if (packet[PACKET_SOP_IDX] != PACKET_SOP_VALUE)
+        {
+            status = CY_DFU_ERROR_DATA;
+        }
+        else if ((packetSize + CY_DFU_PACKET_MIN_SIZE) > CY_DFU_SIZEOF_CMD_BUFFER)
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+        else
+        {
+            uint32_t command = GetPacketCommand(packet);
+
+            prefixSize = packetSize;
+
+            if ((command == CY_DFU_CMD_SEND_DATA) || (command == CY_DFU_CMD_SEND_DATA_WR))
+            {
+                prefixSize = 0U;
+            }
+            else if ((command == CY_DFU_CMD_PROGRAM_DATA) && (packetSize >= PARAMS_SIZE))
+            {
+                prefixSize = PARAMS_SIZE;
+            }
+            else
+            {
+                /* All the data goes to the packet buffer */
+            }
+
+            payloadSize = packetSize - prefixSize;
+
+            /* Does not fit into the data buffer, let the command report the error */
+            if ((params->dataOffset + payloadSize) > CY_DFU_SIZEOF_DATA_BUFFER)
+            {
+                prefixSize = packetSize;
+                payloadSize = 0U;
+            }
+        }
+
+        if (status != CY_DFU_SUCCESS)
+        {
+            /* The rest of the packet is unknown, drop it */
+            Cy_DFU_TransportReset();
+        }
+    }
+
+    if ((status == CY_DFU_SUCCESS) && (prefixSize != 0U))
+    {
+        status = ReadExact(GetPacketData(packet, PACKET_DATA_NO_OFFSET), prefixSize, params->timeout);
+    }
+    if ((status == CY_DFU_SUCCESS) && (payloadSize != 0U))
+    {
+        status = ReadExact(&params->dataBuffer[params->dataOffset], payloadSize, params->timeout);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        status = ReadExact(&packet[PacketChecksumIndex(packetSize)],
+                           PACKET_CHECKSUM_LENGTH + 1U /* EOP */, params->timeout);
+    }
+
+    STATS_STAGE_END(params, CY_DFU_STATS_RECEIVE);
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        STATS_STAGE_BEGIN(params);
+        status = VerifyPacket(packetSize + CY_DFU_PACKET_MIN_SIZE, packet,
+                              &params->dataBuffer[params->dataOffset], payloadSize);
+        STATS_STAGE_END(params, CY_DFU_STATS_CHECKSUM);
+    }
+    else if (status == CY_DFU_ERROR_TIMEOUT)
+    {
+        /* A packet that stopped in the middle is not answered */
+        status = (packetSize != 0U) ? CY_DFU_ERROR_DATA : CY_DFU_ERROR_TIMEOUT;
+    }
+    else
+    {
+        /* The status is already an error */
+    }
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        params->dataReceived = payloadSize;
+    }
+    return (status);
+}
+#endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+
+
+/*******************************************************************************
+* Function Name: ReadVerifyPacket
+****************************************************************************//**
+*
+* This function is used inside Cy_DFU_Continue to read and verify
+* a received DFU packet.
+*
+* \param packet       The pointer to the DFU packet buffer.
+* \param noResponse   The pointer to a variable that states whether to send
+*                      a response back to a DFU Host or not.
+* \param params       The pointer to a DFU parameters structure.
+*
+* \return See \ref cy_en_dfu_status_t
+* - \ref CY_DFU_SUCCESS - If a packet is successfully received.
+* - \ref CY_DFU_ERROR_TIMEOUT - If no packet is received during
+*   the timeout period.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ReadVerifyPacket(uint8_t packet[], bool *noResponse, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status;
+    uint32_t numberRead = 0U;
+
+#if CY_DFU_OPT_ZERO_COPY != 0
+    const cy_stc_dfu_transport_ops_t *ops = Cy_DFU_TransportGetOps();
+
+    params->dataReceived = 0U;
+
+    if ((ops != NULL) && ((ops->capabilities & CY_DFU_TRANSPORT_CAP_ZERO_COPY) != 0U))
+    {
+        status = ReadPacketZeroCopy(packet, params);
+    }
+    else
+#endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+    {
+        STATS_STAGE_BEGIN(params);
+        status = Cy_DFU_TransportRead( packet, CY_DFU_SIZEOF_CMD_BUFFER, &numberRead, params->timeout );
+        STATS_STAGE_END(params, CY_DFU_STATS_RECEIVE);
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            status = VerifyPacket(numberRead, packet, NULL, 0U);
+            STATS_STAGE_END(params, CY_DFU_STATS_CHECKSUM);
+        }
+    }
+
+    if (status == CY_DFU_ERROR_TIMEOUT)
+    {
+        *noResponse = true;
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: WritePacket
+****************************************************************************//**
+*
+* This function creates a DFU response packet and transmits it back to
+* the DFU host application over the already established communications
+* protocol.
+*
+* \param status     The error response code of the DFU response packet.
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The number of bytes contained within the \c packet
+*                   to pass back to a DFU Host.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t WritePacket(cy_en_dfu_status_t status, uint8_t *packet, uint32_t rspSize)
+{
+    uint32_t checksum;
+    /*
+    * The DFU Host expects only one byte of the status,
+    * its value must be compatible with the PSoC 3/4/5LP Bootloader Component
+    */
+    uint32_t statusCode = (uint32_t)status & STATUS_BYTE_MSK;
+
+    /* Build a packet */
+    SetPacketHeader(packet);
+    SetPacketCmd   (packet, statusCode);
+    SetPacketDSize (packet, rspSize);
+
+    checksum = PacketChecksum(packet, rspSize);
+    SetPacketChecksum(packet, rspSize, checksum);
+    SetPacketFooter  (packet, rspSize);
+
+    return ( Cy_DFU_TransportWrite(packet, rspSize + CY_DFU_PACKET_MIN_SIZE, &rspSize,
+                                        TRANSPORT_WRITE_TIMEOUT));
+}
+
+
+/*******************************************************************************0
+* Function Name: EnterResponse
+****************************************************************************//**
+*
+* This function is used inside Cy_DFU_ContinueEntr() to add version and
+* size fields.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param state      The pointer to a state variable, that is updated by
+*                   the function. See \ref group_dfu_macro_state.
+*
+*******************************************************************************/
+static void EnterResponse(uint8_t *packet, uint32_t *rspSize, uint32_t *state)
+{
+    static const cy_stc_dfu_enter_t dfuVersion =
+    {
+        CY_DFU_SILICON_ID,
+        (uint8_t) CY_DFU_SILICON_REV,
+        {
+            (uint8_t) CY_DFU_SDK_VERSION_MINOR,
+            (uint8_t) CY_DFU_SDK_VERSION_MAJOR,
+            0x01U /* Used for BWC with the Bootloader component */
+        }
+    };
+    *state = CY_DFU_STATE_UPDATING;
+    *rspSize = sizeof(dfuVersion);
+    (void) memcpy( (void*)GetPacketData(packet, PACKET_DATA_NO_OFFSET),
+                    (const void*)&dfuVersion, *rspSize);
+}
+
+
+/*******************************************************************************
+* Function Name: CommandEnter
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+*
+* This function is called to handle Command Enter, see the DFU Commands
+* section in the DFU SDK User's Guide.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param state      The pointer to a state variable, that is updated by
+*                   the function. See \ref group_dfu_macro_state.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandEnter(uint8_t *packet, uint32_t *rspSize, uint32_t *state,
+                                            cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+     volatile uint32_t productId;
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    productId = ElfSymbolToAddr(&__cy_product_id);
+#else
+    productId = CY_DFU_PRODUCT;
+#endif /*CY_DFU_FLOW == CY_DFU_BASIC_FLOW*/
+    uint32_t packetSize = GetPacketDSize(packet);
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+    if (packetSize == 0U)  /* 'Product ID' not demanded */
+    {
+        status = (productId == 0U)? CY_DFU_SUCCESS : CY_DFU_ERROR_LENGTH;
+        if (status == CY_DFU_SUCCESS)
+        {
+            EnterResponse(packet, rspSize, state);
+        }
+    }
+    else if ( (packetSize == DATA_PACKET_SIZE_4BYTES) || (packetSize == DATA_PACKET_SIZE_6BYTES) )
+    {
+        status = CY_DFU_ERROR_DATA;
+        if (productId == GetU32(GetPacketData(packet, PACKET_DATA_NO_OFFSET) ) )
+        {
+            EnterResponse(packet, rspSize, state);
+            status = CY_DFU_SUCCESS;
+        }
+    }
+    else
+    {
+        /* Empty */
+    }
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0)
+    if (status == CY_DFU_SUCCESS)
+    {   /* The golden image checks of the previous session are outdated */
+        Cy_DFU_GoldenImageInvalidate();
+    }
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0) */
+
+    CY_UNUSED_PARAMETER(params); /* Remove the unused warning */
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: CopyToDataBuffer
+****************************************************************************//**
+*
+* This is a helper function, called in the following functions:
+* - DFU_CommandProgramData
+* - CommandVerifyData
+* - CommandSendData
+*
+* This is used to copy packet data to dataBuffer and increase dataOffset.
+*
+* \param dataBuffer     The pointer to a buffer containing the data to be
+*                       written to an NVM.
+* \param dataOffset     The offset within dataBuffer, indicates the current
+*                       dataBuffer length.
+* \param packet         The pointer to the DFU packet buffer.
+* \param packetSize     The length in bytes of the data in the DFU
+*                       packet buffer.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CopyToDataBuffer(uint8_t dataBuffer[], uint32_t *dataOffset, uint8_t const packet[],
+                                                uint32_t packetSize)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
+    if ( (dataBuffer != NULL) && (dataOffset != NULL) && (packet != NULL) )
+    {
+        status = CY_DFU_ERROR_LENGTH;
+        if ( (*dataOffset + packetSize) <= CY_DFU_SIZEOF_DATA_BUFFER )
+        {
+            status = CY_DFU_SUCCESS;
+            (void) memcpy( &dataBuffer[*dataOffset], packet, packetSize);
+            *dataOffset += packetSize;
+        }
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: CommandProgramData
+****************************************************************************//**
+*
+* This a helper function for Cy_DFU_Continue().
+* This function is used to program data to an NVM.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandProgramData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+    uint8_t  *dataBufferLocal =  params->dataBuffer;
+    uint32_t *dataOffsetLocal = &params->dataOffset;
+    uint32_t  packetSize =  GetPacketDSize(packet);
+
+    *rspSize = CY_DFU_RSP_SIZE_0;
+    if (packetSize >= PARAMS_SIZE)
+    {
+        uint32_t address =  GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+        uint32_t crc = GetU32( GetPacketData(packet, PROGRAM_DATA_CRC_OFFSET) );
+
+    #if CY_DFU_OPT_ZERO_COPY != 0
+        if (params->dataReceived != 0U)
+        {
+            /* The data has been read straight into dataBuffer */
+            *dataOffsetLocal += params->dataReceived;
+            status = CY_DFU_SUCCESS;
+        }
+        else
+    #endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+        {
+            /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
+            status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal, GetPacketData(packet, PARAMS_SIZE),
+                                      packetSize - PARAMS_SIZE );
+        }
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            if (crc != Cy_DFU_DataChecksum(dataBufferLocal, *dataOffsetLocal, params) )
+            {
+                status = CY_DFU_ERROR_CHECKSUM;
+            }
+            STATS_STAGE_END(params, CY_DFU_STATS_CHECKSUM);
+        }
+        if (status == CY_DFU_SUCCESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            status = Cy_DFU_WriteData(address, *dataOffsetLocal, CY_DFU_IOCTL_BHP, params);
+            STATS_STAGE_END(params, CY_DFU_STATS_WRITE);
+        }
+    #if CY_DFU_OPT_NVM_ASYNC != 0
+        if (status == CY_DFU_IN_PROGRESS)
+        {
+            /* Cy_DFU_Continue() polls the write, dataBuffer is kept until it completes */
+            cy_dfu_programPending.address = address;
+            cy_dfu_programPending.length = *dataOffsetLocal;
+            cy_dfu_programPending.active = true;
+        }
+    #endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+        if (status == CY_DFU_SUCCESS)
+        {
+            status = ProgramDataComplete(address, *dataOffsetLocal, params);
+        }
+    } /* if (packetSize >= PARAMS_SIZE) */
+    *dataOffsetLocal = 0U;
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: ProgramDataComplete
+****************************************************************************//**
+*
+* This is a helper function for CommandProgramData().
+* This function compares the written data of the Program Data DFU command with
+* the NVM and adds it to the digest and the progress record.
+*
+* \param address    The address of the data.
+* \param length     The length in bytes of the data in params->dataBuffer.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ProgramDataComplete(uint32_t address, uint32_t length, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status;
+
+    STATS_STAGE_BEGIN(params);
+    status = Cy_DFU_ReadData(address, length, CY_DFU_IOCTL_COMPARE, params);
+    STATS_STAGE_END(params, CY_DFU_STATS_COMPARE);
+    if (status == CY_DFU_SUCCESS)
+    {
+        /* Before the progress record write reuses dataBuffer */
+        DIGEST_UPDATE(params, address, length);
+        PROGRESS_MARK(params, address, length);
+    }
+    return (status);
+}
+
+
+#if CY_DFU_OPT_NVM_ASYNC != 0
+/*******************************************************************************
+* Function Name: ProgramDataPoll
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function polls the NVM write of the Program Data DFU command that
+* returned \ref CY_DFU_IN_PROGRESS, and completes the command when the write
+* completes.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return \ref CY_DFU_IN_PROGRESS while the write continues, the status of the
+* command otherwise.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ProgramDataPoll(cy_stc_dfu_params_t *params)
+{
+    uint32_t address = cy_dfu_programPending.address;
+    uint32_t length = cy_dfu_programPending.length;
+    cy_en_dfu_status_t status;
+
+    STATS_STAGE_BEGIN(params);
+    status = Cy_DFU_WriteData(address, length, CY_DFU_IOCTL_POLL, params);
+    STATS_STAGE_END(params, CY_DFU_STATS_WRITE);
+    if (status != CY_DFU_IN_PROGRESS)
+    {
+        cy_dfu_programPending.active = false;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        status = ProgramDataComplete(address, length, params);
+    }
+    return (status);
+}
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+
+
+#if CY_DFU_OPT_ERASE_DATA != 0
+/*******************************************************************************
+* Function Name: CommandEraseData
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function erases an NVM row or page.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandEraseData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+    *rspSize = CY_DFU_RSP_SIZE_0;
+    if (GetPacketDSize(packet) == DATA_PACKET_SIZE_4BYTES)
+    {
+        uint32_t address = GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+        STATS_STAGE_BEGIN(params);
+        status = Cy_DFU_WriteData(address, 0U, CY_DFU_IOCTL_ERASE, params);
+        STATS_STAGE_END(params, CY_DFU_STATS_WRITE);
+        if (status == CY_DFU_SUCCESS)
+        {
+            PROGRESS_UNMARK(params, address);
+            DIGEST_UPDATE(params, address, 0U);
+        }
+    }
+    params->dataOffset = 0U;
+    return (status);
+}
+#endif /* CY_DFU_OPT_ERASE_DATA != 0 */
+
+
+#if CY_DFU_OPT_VERIFY_DATA != 0
+/*******************************************************************************
+* Function Name: CommandVerifyData
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function verifies an NVM row or page.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandVerifyData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status    = CY_DFU_ERROR_LENGTH;
+    uint8_t  *dataBufferLocal =  params->dataBuffer;
+    uint32_t *dataOffsetLocal = &params->dataOffset;
+
+    uint32_t  packetSize = GetPacketDSize(packet);
+    *rspSize = CY_DFU_RSP_SIZE_0;
+    if (packetSize >= PARAMS_SIZE)
+    {
+        uint32_t address = GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+        uint32_t crc     = GetU32( GetPacketData(packet, VERIFY_DATA_CRC_OFFSET) );
+
+        /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
+        status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal, GetPacketData(packet, PARAMS_SIZE),
+                                  packetSize - PARAMS_SIZE );
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            if (crc != Cy_DFU_DataChecksum(dataBufferLocal, *dataOffsetLocal, params) )
+            {
+                status = CY_DFU_ERROR_CHECKSUM;
+            }
+            STATS_STAGE_END(params, CY_DFU_STATS_CHECKSUM);
+        }
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            status = Cy_DFU_ReadData(address, *dataOffsetLocal, CY_DFU_IOCTL_COMPARE, params);
+            STATS_STAGE_END(params, CY_DFU_STATS_COMPARE);
+            status = (status == CY_DFU_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+        }
+    }
+    *dataOffsetLocal = 0U;
+    return (status);
+}
+#endif /* CY_DFU_OPT_VERIFY_DATA != 0 */
+
+
+#if CY_DFU_OPT_SEND_DATA != 0
+/*******************************************************************************
+* Function Name: CommandSendData
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Send Data DFU command.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandSendData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status;
+    uint32_t packetSize = GetPacketDSize(packet);
+    uint8_t  *dataBufferLocal =  params->dataBuffer;
+    uint32_t *dataOffsetLocal = &params->dataOffset;
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+#if CY_DFU_OPT_ZERO_COPY != 0
+    if (params->dataReceived != 0U)
+    {
+        /* The data has been read straight into dataBuffer */
+        *dataOffsetLocal += params->dataReceived;
+        status = CY_DFU_SUCCESS;
+    }
+    else
+#endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+    {
+        /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
+        status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal,
+                                    GetPacketData(packet, PACKET_DATA_NO_OFFSET),
+                                    packetSize);
+    }
+
+    return (status);
+}
+#endif /* CY_DFU_OPT_SEND_DATA != 0 */
+
+
+#if CY_DFU_OPT_VERIFY_APP != 0
+/*******************************************************************************
+* Function Name: CommandVerifyApp
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Verify Application DFU command.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandVerifyApp(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status  = CY_DFU_ERROR_LENGTH;
+    uint32_t packetSize = GetPacketDSize(packet);
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+
+    if ( (packetSize == sizeof(uint32_t) ) || (packetSize == VERIFY_APP_DATA_SIZE) )
+    {
+        uint32_t app = (uint32_t) *GetPacketData(packet,PACKET_DATA_NO_OFFSET);
+        if (app < CY_DFU_MAX_APPS)
+        {
+            /* The application is validated in the NVM, a unit left in the cache makes it invalid */
+            if (NVM_CACHE_FLUSH(params) != CY_DFU_SUCCESS)
+            {
+                CY_DFU_LOG_ERR("NVM cache write-back failed");
+                status = CY_DFU_ERROR_VERIFY;
+            }
+            else
+            {
+            #if DIGEST_ENABLED != 0
+                status = DigestVerify(app, params);
+                if (status == CY_DFU_ERROR_UNKNOWN)
+            #endif /* DIGEST_ENABLED != 0 */
+                {
+                    status = Cy_DFU_ValidateApp(app, params);
+                }
+            }
+        }
+        else
+        {
+            status = CY_DFU_ERROR_VERIFY;
+        }
+    }
+
+    if ( (status == CY_DFU_SUCCESS) || (status == CY_DFU_ERROR_VERIFY) )
+    {
+        uint8_t *valid = GetPacketData(packet, PACKET_DATA_NO_OFFSET);
+        if (status == CY_DFU_SUCCESS)
+        {
+            PROGRESS_FINISH(params);
+        }
+        *valid = (status == CY_DFU_SUCCESS) ? 1U : 0U;
+        status = CY_DFU_SUCCESS;
+        *rspSize = CY_DFU_RSP_SIZE_VERIFY_APP;
+    }
+    return (status);
+}
+#endif /* CY_DFU_OPT_VERIFY_APP != 0 */
+
+
+#if ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)) || defined(CY_DOXYGEN)
+/*******************************************************************************
+* Function Name: Cy_DFU_SetAppMetadata
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function sets application metadata and updates a metadata checksum.
+* With \ref CY_DFU_OPT_METADATA_V2, it sets the verified area of the application
+* record and keeps its other fields, see \ref Cy_DFU_SetAppRecord.
+* \note If the application metadata is the same as already
+* present in the NVM, then the NVM is not rewritten and this function only exits.
+* \note This function uses params->dataBuffer for the read and write NVM.
+*
+* \param appId           The application number to update metadata for.
+* \param verifyAddress   An application verified area start address
+* \param verifySize      The size of verified application area
+* \param params          The pointer to a DFU parameters structure.
+*                        See \ref cy_stc_dfu_params_t.
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_SetAppMetadata(uint32_t appId, uint32_t verifyAddress, uint32_t verifySize,
+                                                   cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+#if CY_DFU_OPT_METADATA_V2 != 0
+    if ((params == NULL) || (appId >= CY_DFU_MAX_APPS))
+    {
+        status = CY_DFU_ERROR_UNKNOWN;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        cy_stc_dfu_app_metadata_t record;
+
+        (void) Cy_DFU_GetAppRecord(appId, &record, params);
+        record.verifyAddress = verifyAddress;
+        record.verifySize    = verifySize;
+        status = Cy_DFU_SetAppRecord(appId, &record, params);
+    }
+#else
+    uint32_t metadataAddress = 0U;
+    uint32_t metadataLength  = 0U;
+    if ((params == NULL) || (appId >= CY_DFU_MAX_APPS))
+    {
+        status = CY_DFU_ERROR_UNKNOWN;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        metadataAddress = ElfSymbolToAddr(&__cy_boot_metadata_addr  );
+        metadataLength  = ElfSymbolToAddr(&__cy_boot_metadata_length);
+        status = Cy_DFU_ReadData(metadataAddress, metadataLength, CY_DFU_IOCTL_READ, params);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        uint32_t getVerifyAddress = GetU32(params->dataBuffer + (appId * METADATA_BYTES_PER_APP));
+        uint32_t getVerifySize      = GetU32(params->dataBuffer + (appId * METADATA_BYTES_PER_APP) +
+                                            METADATA_APP_LENGTH_OFFSET);
+        if ( (getVerifyAddress != verifyAddress) || ( getVerifySize != verifySize) )
+        {
+            uint32_t crc;
+            PutU32(params->dataBuffer, (appId * METADATA_BYTES_PER_APP)     , verifyAddress);
+            PutU32(params->dataBuffer, (appId * METADATA_BYTES_PER_APP) + METADATA_APP_LENGTH_OFFSET, verifySize);
+            crc = Cy_DFU_DataChecksum(params->dataBuffer, metadataLength - CRC_CHECKSUM_LENGTH, params);
+            PutU32(params->dataBuffer, metadataLength - CRC_CHECKSUM_LENGTH, crc);
+            status = Cy_DFU_WriteData(metadataAddress, metadataLength, CY_DFU_IOCTL_WRITE, params);
+            METADATA_CACHE_INVALIDATE();
+        }
+    }
+#endif /* CY_DFU_OPT_METADATA_V2 != 0 */
+    return (status);
+}
+#endif /* (CY_DFU_METADATA_WRITABLE != 0 CY_DFU_FLOW == CY_DFU_BASIC_FLOW) || defined(CY_DOXYGEN) */
+
+
+/*******************************************************************************
+* Function Name: CommandSetAppMetadata
+****************************************************************************//**
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Set Application Metadata DFU command.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandSetAppMetadata(uint8_t *packet, uint32_t *rspSize,
+                                                     cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+    if (GetPacketDSize(packet) != DATA_LENGTH)
+    {
+        status = CY_DFU_ERROR_LENGTH;
+    }
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        /* Data offsets 0, 1, 5 are defined in the DFU Packet Structure */
+        uint32_t app       =      *( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+
+    #if (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
+        uint32_t verifyAddress = GetU32( GetPacketData(packet, SET_APP_METADATA_OFFSET) );
+        uint32_t verifySize   = GetU32( GetPacketData(packet, SET_APP_METADATA_LENGTH_OFFSET) );
+
+        status = Cy_DFU_SetAppMetadata(app, verifyAddress, verifySize, params);
+    #endif /*(CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)*/
+
+        params->appId = app;
+        if (status == CY_DFU_SUCCESS)
+        {
+            DIGEST_START(params, app);
+        }
+    }
+    return (status);
+}
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+
+#if CY_DFU_OPT_GET_METADATA != 0
+/*******************************************************************************
+* Function Name: CommandGetMetadata
+****************************************************************************//**
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Get Metadata DFU command.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandGetMetadata(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t locRspSize = CY_DFU_RSP_SIZE_0;
+
+    if (packet == NULL)
+    {
+        status = CY_DFU_ERROR_UNKNOWN;
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        if (GetPacketDSize(packet) != DATA_PACKET_SIZE_4BYTES)
+        {
+            status = CY_DFU_ERROR_LENGTH;
+        }
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        uint32_t fromAddr = GetU16( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+        uint32_t toAddr   = GetU16( GetPacketData(packet, GET_METADATA_TO_OFFSET) );
+        uint32_t metadataAddr    = ElfSymbolToAddr(&__cy_boot_metadata_addr  );
+        uint32_t metadataLength  = ElfSymbolToAddr(&__cy_boot_metadata_length);
+        if ( (toAddr < fromAddr) || (toAddr > metadataLength)
+            || ( ( (toAddr - fromAddr) + CY_DFU_PACKET_MIN_SIZE) > CY_DFU_SIZEOF_CMD_BUFFER) )
+        {
+            status  = CY_DFU_ERROR_DATA;
+        }
+        else
+        {
+            uint32_t offset = fromAddr;
+
+            status = Cy_DFU_ValidateMetadata(metadataAddr, params);
+        #if CY_DFU_OPT_METADATA_CACHE != 0
+            if ( (status == CY_DFU_SUCCESS) && (toAddr <= METADATA_CACHE_SIZE) )
+            {   /* The range is copied from RAM, the NVM and params->dataBuffer are not used */
+                (void) memmove( GetPacketData(packet, PACKET_DATA_NO_OFFSET),
+                                &(MetadataCacheData()[fromAddr]), toAddr - fromAddr);
+                offset = toAddr;
+            }
+        #endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+
+            /* The metadata is read one row at a time, it may span several rows */
+            while ( (status == CY_DFU_SUCCESS) && (offset < toAddr) )
+            {
+                uint32_t rowOffset = offset - (offset % CY_NVM_SIZEOF_ROW);
+                uint32_t size = ( (rowOffset + CY_NVM_SIZEOF_ROW) < toAddr ) ?
+                                  ( (rowOffset + CY_NVM_SIZEOF_ROW) - offset ) : (toAddr - offset);
+
+                status = Cy_DFU_ReadData(metadataAddr + rowOffset, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_READ, params);
+                if (status == CY_DFU_SUCCESS)
+                {
+                    (void) memmove( GetPacketData(packet, offset - fromAddr),
+                                    &(params->dataBuffer[offset - rowOffset]),
+                                    size);
+                    offset += size;
+                }
+            }
+            if (status == CY_DFU_SUCCESS)
+            {
+                locRspSize = (toAddr - fromAddr);
+            }
+        }
+    }
+    *rspSize = locRspSize;
+    return (status);
+}
+#endif /* CY_DFU_OPT_GET_METADATA != 0 */
+
+
+#if CY_DFU_OPT_SET_EIVECTOR != 0
+/*******************************************************************************
+* Function Name: CommandSetEIVector
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function copies the Encryption Initial Vector value from the DFU
+* command buffer to the buffer pointed by
+* \code params->encryptionVector \endcode.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandSetEIVector(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+    uint32_t size = GetPacketDSize(packet);
+
+    if (( (size == 0U) ||  (size == DATA_PACKET_SIZE_8BYTES)
+        || (size == DATA_PACKET_SIZE_16BYTES) ) && (params->encryptionVector != NULL))
+    {
+CY_MISRA_FP_LINE('MISRA C-2012 Rule 21.18','Per C99 standard (7.21.1/2) 0 value is allowed with no undefined behaviour. ');
+        (void) memcpy((void*)params->encryptionVector, (const void*)GetPacketData(packet, PACKET_DATA_NO_OFFSET), size);
+    }
+    else
+    {
+        status = CY_DFU_ERROR_DATA;
+    }
+
+    return (status);
+}
+#endif /* CY_DFU_OPT_SET_EIVECTOR != 0 */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+
+#if CY_DFU_OPT_STATS != 0
+/*******************************************************************************
+* Function Name: StatsSlot
+****************************************************************************//**
+*
+* This function returns the index of the statistics record of a DFU command
+* in \ref cy_stc_dfu_stats_t::cmd.
+*
+* \param command    The DFU packet command value, or STATS_NO_COMMAND.
+*
+* \return The index of the record. The last record is shared by the custom
+* commands, the unsupported commands, and the packets that failed verification.
+*
+*******************************************************************************/
+static uint32_t StatsSlot(uint32_t command)
+{
+    static const uint8_t statsCommands[CY_DFU_STATS_CMD_NUM - 1U] =
+    {
+        CY_DFU_CMD_ENTER,       CY_DFU_CMD_EXIT,         CY_DFU_CMD_PROGRAM_DATA,
+        CY_DFU_CMD_VERIFY_DATA, CY_DFU_CMD_ERASE_DATA,   CY_DFU_CMD_VERIFY_APP,
+        CY_DFU_CMD_SEND_DATA,   CY_DFU_CMD_SEND_DATA_WR, CY_DFU_CMD_SYNC,
+        CY_DFU_CMD_SET_APP_META, CY_DFU_CMD_GET_METADATA, CY_DFU_CMD_SET_EIVECTOR,
+        CY_DFU_CMD_GET_STATS,   CY_DFU_CMD_GET_PROGRESS
+    };
+    uint32_t slot = 0U;
+
+    while ((slot < (CY_DFU_STATS_CMD_NUM - 1U)) && (statsCommands[slot] != command))
+    {
+        ++slot;
+    }
+    return (slot);
+}
+
+
+/*******************************************************************************
+* Function Name: StatsPacketBegin
+****************************************************************************//**
+*
+* This function starts measuring a packet in Cy_DFU_Continue().
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+*******************************************************************************/
+static void StatsPacketBegin(cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_stats_t *stats = params->stats;
+
+    if (stats != NULL)
+    {
+        (void) memset(stats->stage, 0, sizeof(stats->stage));
+        stats->packetStart = Cy_DFU_StatsTimestamp();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StatsPacketEnd
+****************************************************************************//**
+*
+* This function adds the measured packet to the statistics of its DFU command.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param command    The DFU packet command value, or STATS_NO_COMMAND if no
+*                   valid packet is received.
+* \param status     The status of the packet processing.
+*
+*******************************************************************************/
+static void StatsPacketEnd(cy_stc_dfu_params_t *params, uint32_t command, cy_en_dfu_status_t status)
+{
+    cy_stc_dfu_stats_t *stats = params->stats;
+
+    /* Nothing is received during the timeout */
+    if ((stats != NULL) && ((command != STATS_NO_COMMAND) || (status != CY_DFU_ERROR_TIMEOUT)))
+    {
+        cy_stc_dfu_cmd_stats_t *record = &stats->cmd[StatsSlot(command)];
+        uint32_t cycles = Cy_DFU_StatsTimestamp() - stats->packetStart;
+        uint32_t value = cycles >> CY_DFU_STATS_HIST_SHIFT;
+        uint32_t bin = 0U;
+        uint32_t i;
+
+        if ((record->count == 0U) || (cycles < record->minCycles))
+        {
+            record->minCycles = cycles;
+        }
+        if (cycles > record->maxCycles)
+        {
+            record->maxCycles = cycles;
+        }
+        ++record->count;
+        if (status != CY_DFU_SUCCESS)
+        {
+            ++record->errors;
+        }
+        record->totalCycles += cycles;
+        for (i = 0U; i < CY_DFU_STATS_STAGE_NUM; i++)
+        {
+            record->stageCycles[i] += stats->stage[i];
+        }
+
+        /* The binary logarithm, limited with the last bin */
+        while ((value > 1U) && (bin < (CY_DFU_STATS_HIST_BINS - 1U)))
+        {
+            value >>= 1U;
+            ++bin;
+        }
+        ++record->histogram[bin];
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StatsStageBegin
+****************************************************************************//**
+*
+* This function starts measuring a stage of the packet processing.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+*******************************************************************************/
+static void StatsStageBegin(cy_stc_dfu_params_t *params)
+{
+    if (params->stats != NULL)
+    {
+        params->stats->stageStart = Cy_DFU_StatsTimestamp();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: StatsStageEnd
+****************************************************************************//**
+*
+* This function adds the time since StatsStageBegin() to a stage of the packet
+* processing.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param stage      The stage, see \ref group_dfu_macro_stats.
+*
+*******************************************************************************/
+static void StatsStageEnd(cy_stc_dfu_params_t *params, uint32_t stage)
+{
+    if (params->stats != NULL)
+    {
+        params->stats->stage[stage] += Cy_DFU_StatsTimestamp() - params->stats->stageStart;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CommandGetStats
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Get Stats DFU command: responds with the
+* \ref cy_stc_dfu_cmd_stats_t record of the DFU command in the one-byte data,
+* or with \ref cy_stc_dfu_nvm_stats_t for \ref CY_DFU_STATS_SEL_NVM.
+* Returns CY_DFU_ERROR_LENGTH if the record does not fit
+* \ref CY_DFU_SIZEOF_CMD_BUFFER.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t CommandGetStats(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+    *rspSize = CY_DFU_RSP_SIZE_0;
+
+    if (params->stats == NULL)
+    {
+        status = CY_DFU_ERROR_CMD;
+    }
+    else if (GetPacketDSize(packet) == GET_STATS_DATA_SIZE)
+    {
+        uint32_t command = (uint32_t) *GetPacketData(packet, PACKET_DATA_NO_OFFSET);
+        const void *record = (const void*)&params->stats->nvm;
+        uint32_t size = sizeof(cy_stc_dfu_nvm_stats_t);
+
+        if (command != CY_DFU_STATS_SEL_NVM)
+        {
+            record = (const void*)&params->stats->cmd[StatsSlot(command)];
+            size = sizeof(cy_stc_dfu_cmd_stats_t);
+        }
+
+        /* The record must fit the packet buffer, for example, on the devices with 64-byte rows */
+        if ((size + CY_DFU_PACKET_MIN_SIZE) <= CY_DFU_SIZEOF_CMD_BUFFER)
+        {
+            *rspSize = size;
+            (void) memcpy((void*)GetPacketData(packet, PACKET_DATA_NO_OFFSET), record, size);
+            status = CY_DFU_SUCCESS;
+        }
+    }
+    else
+    {
+        /* The status is CY_DFU_ERROR_LENGTH */
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetCommandStats
+****************************************************************************//**
+*
+* Returns the statistics of a DFU command collected by \ref Cy_DFU_Continue,
+* see \ref group_dfu_ucase_stats.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t.
+* \param command    The DFU command, see \ref group_dfu_macro_commands. The
+*                   other values return the record shared by the custom
+*                   commands, the unsupported commands, and the packets that
+*                   failed verification.
+*
+* \return The pointer to the statistics, or NULL if
+* \ref cy_stc_dfu_params_t::stats is not set.
+*
+*******************************************************************************/
+const cy_stc_dfu_cmd_stats_t * Cy_DFU_GetCommandStats(const cy_stc_dfu_params_t *params, uint32_t command)
+{
+    const cy_stc_dfu_cmd_stats_t *record = NULL;
+
+    if ((params != NULL) && (params->stats != NULL))
+    {
+        record = &params->stats->cmd[StatsSlot(command)];
+    }
+    return (record);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_StatsNvmBegin
+****************************************************************************//**
+*
+* Starts measuring an NVM operation. Called by \ref Cy_DFU_WriteData and
+* \ref Cy_DFU_ReadData in dfu_user.c before an NVM driver call, see
+* \ref group_dfu_ucase_stats.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t.
+*
+*******************************************************************************/
+void Cy_DFU_StatsNvmBegin(cy_stc_dfu_params_t *params)
+{
+    if ((params != NULL) && (params->stats != NULL))
+    {
+        params->stats->nvmStart = Cy_DFU_StatsTimestamp();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_StatsNvmEnd
+****************************************************************************//**
+*
+* Adds the NVM operation started with \ref Cy_DFU_StatsNvmBegin to
+* \ref cy_stc_dfu_stats_t::nvm.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t.
+* \param operation  The NVM operation, see \ref group_dfu_macro_stats.
+* \param address    The address of the operation.
+* \param length     The number of bytes of the operation.
+* \param result     0 if the operation has succeeded, else the NVM driver status.
+*
+*******************************************************************************/
+void Cy_DFU_StatsNvmEnd(cy_stc_dfu_params_t *params, uint32_t operation, uint32_t address, uint32_t length,
+                        uint32_t result)
+{
+    if ((params != NULL) && (params->stats != NULL) && (operation < CY_DFU_STATS_NVM_OP_NUM))
+    {
+        cy_stc_dfu_nvm_stats_t *nvm = &params->stats->nvm;
+        uint32_t cycles = Cy_DFU_StatsTimestamp() - params->stats->nvmStart;
+
+        ++nvm->count[operation];
+        nvm->cycles[operation] += cycles;
+        if (cycles > nvm->maxCycles[operation])
+        {
+            nvm->maxCycles[operation] = cycles;
+        }
+
+        if (result == 0U)
+        {
+            nvm->bytes[operation] += length;
+        }
+        else
+        {
+            ++nvm->failures[operation];
+            nvm->lastResult = result;
+            nvm->lastAddress = address;
+        }
+    }
+}
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+
+#if CY_DFU_OPT_RESUME != 0
+/*******************************************************************************
+* Function Name: ProgressLoad
+****************************************************************************//**
+*
+* This function reads the current progress record, the valid record with the
+* highest sequence number in the progress area, to
+* \ref cy_stc_dfu_params_t::progress. If there is none, the record is cleared.
+* \note This function uses params->dataBuffer for the read NVM.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+*******************************************************************************/
+static void ProgressLoad(cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+    uint32_t areaAddress = Cy_DFU_GetProgressAddress();
+    bool found = false;
+    uint32_t slot;
+
+    (void) memset(&progress->record, 0, sizeof(progress->record));
+    progress->slot = CY_DFU_PROGRESS_SLOTS - 1U;    /* The first record goes to slot 0 */
+
+    for (slot = 0U; (areaAddress != 0U) && (slot < CY_DFU_PROGRESS_SLOTS); slot++)
+    {
+        uint8_t *row = params->dataBuffer;
+        cy_en_dfu_status_t status = Cy_DFU_ReadData(areaAddress + (slot * CY_NVM_SIZEOF_ROW),
+                                                    CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_READ, params);
+
+        if ( (status == CY_DFU_SUCCESS) && (GetU32(row) == PROGRESS_MAGIC) &&
+             (GetU32(&row[PROGRESS_CRC_OFFSET]) == Cy_DFU_DataChecksum(&row[PROGRESS_SEQUENCE_OFFSET],
+                                                        CY_NVM_SIZEOF_ROW - PROGRESS_SEQUENCE_OFFSET, params)) )
+        {
+            uint32_t sequence = GetU32(&row[PROGRESS_SEQUENCE_OFFSET]);
+
+            /* The sequence number may wrap around */
+            if ((!found) || ((int32_t)(sequence - progress->record.sequence) > 0))
+            {
+                (void) memcpy((void*)&progress->record, (const void*)row, sizeof(progress->record));
+                progress->slot = slot;
+                found = true;
+            }
+        }
+    }
+
+    progress->pending = 0U;
+    progress->loaded = true;
+}
+
+
+/*******************************************************************************
+* Function Name: ProgressSave
+****************************************************************************//**
+*
+* This function writes the progress record to the next row of the progress
+* area with the next sequence number, and compares it.
+* \note This function uses params->dataBuffer for the write NVM.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return See \ref cy_en_dfu_status_t
+*
+*******************************************************************************/
+static cy_en_dfu_status_t ProgressSave(cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+    uint32_t areaAddress = Cy_DFU_GetProgressAddress();
+    cy_en_dfu_status_t status = CY_DFU_ERROR_ADDRESS;
+
+    if (areaAddress != 0U)
+    {
+        uint8_t *row = params->dataBuffer;
+        uint32_t slot = (progress->slot + 1U) % CY_DFU_PROGRESS_SLOTS;
+        uint32_t address = areaAddress + (slot * CY_NVM_SIZEOF_ROW);
+
+        progress->record.magic = PROGRESS_MAGIC;
+        ++progress->record.sequence;
+        (void) memcpy((void*)row, (const void*)&progress->record, sizeof(progress->record));
+        PutU32(row, PROGRESS_CRC_OFFSET, Cy_DFU_DataChecksum(&row[PROGRESS_SEQUENCE_OFFSET],
+                                                    CY_NVM_SIZEOF_ROW - PROGRESS_SEQUENCE_OFFSET, params));
+
+        status = Cy_DFU_WriteData(address, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_WRITE, params);
+        if (status == CY_DFU_SUCCESS)
+        {
+            status = Cy_DFU_ReadData(address, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_COMPARE, params);
+        }
+        if (status == CY_DFU_SUCCESS)
+        {
+            progress->slot = slot;
+            progress->pending = 0U;
+        }
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: ProgressMark
+****************************************************************************//**
+*
+* This function sets the bits of the image rows programmed by the Program
+* Data DFU command, and writes the progress record after
+* \ref CY_DFU_PROGRESS_INTERVAL newly programmed rows. With
+* \ref CY_DFU_OPT_NVM_CACHE, the write waits for the erase unit of the rows to
+* be complete in the basic flow, see ProgressUnitDone().
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param address    The address of the programmed data.
+* \param length     The length in bytes of the programmed data.
+*
+*******************************************************************************/
+static void ProgressMark(cy_stc_dfu_params_t *params, uint32_t address, uint32_t length)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+
+    /* Only the whole rows of the image are programmed */
+    if ( (progress != NULL) && progress->active && (address >= progress->record.startAddress) &&
+         (((address - progress->record.startAddress) % CY_NVM_SIZEOF_ROW) == 0U) &&
+         ((length % CY_NVM_SIZEOF_ROW) == 0U) )
+    {
+        uint32_t row = (address - progress->record.startAddress) / CY_NVM_SIZEOF_ROW;
+        uint32_t end = row + (length / CY_NVM_SIZEOF_ROW);
+
+        for (; (row < end) && (row < progress->record.rowCount); row++)
+        {
+            uint8_t mask = (uint8_t)(1U << (row % 8U));
+
+            if ((progress->record.bitmap[row / 8U] & mask) == 0U)
+            {
+                progress->record.bitmap[row / 8U] |= mask;
+                ++progress->pending;
+            }
+        }
+
+    #if (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
+        if ( (progress->pending >= CY_DFU_PROGRESS_INTERVAL) && ProgressUnitDone(progress, address) )
+    #else
+        if (progress->pending >= CY_DFU_PROGRESS_INTERVAL)
+    #endif /* (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) */
+        {
+            (void) ProgressSave(params);
+        }
+    }
+}
+
+
+#if (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
 /*******************************************************************************
-* Function Name: Cy_DFU_ValidateMetadata
+* Function Name: ProgressUnitDone
 ****************************************************************************//**
 *
-* The function checks if the DFU metadata is valid. It calculates CRC-32C and
-* compare with stored value at the end of metadata.
+* This function checks that all the image rows of the erase unit of a row are
+* programmed. The progress record write flushes the NVM cache, so a record
+* written while the rows of the cached unit still arrive makes the unit erased
+* once more. The check stops delaying the record after the rows of a unit.
 *
-* \param metadataAddress    Start address of the DFU metadata location.
-* \param params             The pointer to a DFU parameters structure.
-*                           See \ref cy_stc_dfu_params_t .
+* \param progress   The resumable update session.
+* \param address    The address of the programmed row.
+*
+* \return True if the progress record can be written.
+*
+*******************************************************************************/
+static bool ProgressUnitDone(const cy_stc_dfu_progress_t *progress, uint32_t address)
+{
+    uint32_t unitSize = Cy_DFU_GetEraseSize(address);
+    bool done = true;
+
+    if ( (unitSize > CY_NVM_SIZEOF_ROW) &&
+         (progress->pending < (CY_DFU_PROGRESS_INTERVAL + (unitSize / CY_NVM_SIZEOF_ROW))) )
+    {
+        uint32_t start = progress->record.startAddress;
+        uint32_t unit = address - (address % unitSize);
+        uint32_t row = (unit > start) ? ((unit - start) / CY_NVM_SIZEOF_ROW) : 0U;
+        uint32_t end = ((unit - start) + unitSize) / CY_NVM_SIZEOF_ROW;
+
+        end = (end < progress->record.rowCount) ? end : progress->record.rowCount;
+        for (; done && (row < end); row++)
+        {
+            done = ((progress->record.bitmap[row / 8U] & (uint8_t)(1U << (row % 8U))) != 0U);
+        }
+    }
+    return (done);
+}
+#endif /* (CY_DFU_OPT_NVM_CACHE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) */
+
+
+/*******************************************************************************
+* Function Name: ProgressUnmark
+****************************************************************************//**
+*
+* This function clears the bit of an image row erased by the Erase Data DFU
+* command, and writes the progress record if the bit was set.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param address    The address of the erased row.
+*
+*******************************************************************************/
+static void ProgressUnmark(cy_stc_dfu_params_t *params, uint32_t address)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+
+    if ((progress != NULL) && progress->active && (address >= progress->record.startAddress))
+    {
+        uint32_t row = (address - progress->record.startAddress) / CY_NVM_SIZEOF_ROW;
+        uint8_t mask = (uint8_t)(1U << (row % 8U));
+
+        if ((row < progress->record.rowCount) && ((progress->record.bitmap[row / 8U] & mask) != 0U))
+        {
+            progress->record.bitmap[row / 8U] &= (uint8_t)~mask;
+            (void) ProgressSave(params);
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProgressFinish
+****************************************************************************//**
+*
+* This function ends the resumable update session after a successful Verify
+* Application DFU command: writes an empty progress record.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+*******************************************************************************/
+static void ProgressFinish(cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+
+    if ((progress != NULL) && progress->active)
+    {
+        progress->record.imageId = 0U;
+        progress->record.startAddress = 0U;
+        progress->record.rowCount = 0U;
+        (void) memset(progress->record.bitmap, 0, sizeof(progress->record.bitmap));
+        (void) ProgressSave(params);
+        progress->active = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ProgressFlush
+****************************************************************************//**
+*
+* This function writes the rows programmed since the last written progress
+* record on the Exit DFU command.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+*******************************************************************************/
+static void ProgressFlush(cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_progress_t *progress = params->progress;
+
+    if ((progress != NULL) && progress->active && (progress->pending != 0U))
+    {
+        (void) ProgressSave(params);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: CommandGetProgress
+****************************************************************************//**
+*
+* This is a helper function for Cy_DFU_Continue().
+* This function handles the Get Progress DFU command: starts or resumes the
+* update session of the image and responds with the row count, the number of
+* the programmed rows and the bitmap from the requested offset, see
+* \ref group_dfu_ucase_resume.
+* \note This function uses params->dataBuffer for the read and write NVM.
+*
+* \param packet     The pointer to the DFU packet buffer.
+* \param rspSize    The pointer to a response packet size.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
 *
 * \return See \ref cy_en_dfu_status_t
-* - \ref CY_DFU_SUCCESS - metadata is valid.
-* - \ref CY_DFU_ERROR_VERIFY - metadata is not valid.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_ValidateMetadata(uint32_t metadataAddress, cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t CommandGetProgress(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
 {
-   const uint32_t metadataLength = ElfSymbolToAddr(&__cy_boot_metadata_length);
+    cy_stc_dfu_progress_t *progress = params->progress;
+    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
+    *rspSize = CY_DFU_RSP_SIZE_0;
 
-   uint32_t crc = Cy_DFU_DataChecksum( (uint8_t *)metadataAddress, metadataLength - CRC_CHECKSUM_LENGTH, params);
-   uint32_t crcMeta = *(uint32_t *)(metadataAddress + (metadataLength - CRC_CHECKSUM_LENGTH) );
-   cy_en_dfu_status_t status = (crc == crcMeta) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
-   return (status);
+    if ((progress == NULL) || (Cy_DFU_GetProgressAddress() == 0U))
+    {
+        status = CY_DFU_ERROR_CMD;
+    }
+    else if (GetPacketDSize(packet) == GET_PROGRESS_DATA_SIZE)
+    {
+        uint8_t *data = GetPacketData(packet, PACKET_DATA_NO_OFFSET);
+        uint32_t imageId = GetU32(data);
+        uint32_t startAddress = GetU32(&data[GET_PROGRESS_START_OFFSET]);
+        uint32_t rowCount = (GetU32(&data[GET_PROGRESS_LENGTH_OFFSET]) + (CY_NVM_SIZEOF_ROW - 1U)) /
+                            CY_NVM_SIZEOF_ROW;
+        uint32_t offset = GetU16(&data[GET_PROGRESS_BITMAP_OFFSET]);
+
+        if ((rowCount != 0U) && (rowCount <= CY_DFU_PROGRESS_MAX_ROWS))
+        {
+            status = CY_DFU_SUCCESS;
+            if (!progress->loaded)
+            {
+                ProgressLoad(params);
+            }
+
+            if ( (progress->record.imageId != imageId) || (progress->record.startAddress != startAddress) ||
+                 (progress->record.rowCount != rowCount) )
+            {
+                /* Another image: the record must not report its rows before they are programmed */
+                progress->record.imageId = imageId;
+                progress->record.startAddress = startAddress;
+                progress->record.rowCount = rowCount;
+                (void) memset(progress->record.bitmap, 0, sizeof(progress->record.bitmap));
+                status = ProgressSave(params);
+            }
+        }
+
+        if (status == CY_DFU_SUCCESS)
+        {
+            uint32_t bitmapSize = (rowCount + 7U) / 8U;
+            uint32_t chunk = 0U;
+            uint32_t done = 0U;
+            uint32_t row;
+
+            for (row = 0U; row < rowCount; row++)
+            {
+                done += ((uint32_t)progress->record.bitmap[row / 8U] >> (row % 8U)) & 1U;
+            }
+            if (offset < bitmapSize)
+            {
+                chunk = bitmapSize - offset;
+                if (chunk > (CY_DFU_SIZEOF_CMD_BUFFER - CY_DFU_PACKET_MIN_SIZE - GET_PROGRESS_RSP_HEADER_SIZE))
+                {
+                    chunk = CY_DFU_SIZEOF_CMD_BUFFER - CY_DFU_PACKET_MIN_SIZE - GET_PROGRESS_RSP_HEADER_SIZE;
+                }
+            }
+
+            progress->active = true;
+            PutU32(data, 0U, rowCount);
+            PutU32(data, UINT32_SIZE, done);
+            (void) memcpy((void*)&data[GET_PROGRESS_RSP_HEADER_SIZE],
+                          (const void*)&progress->record.bitmap[offset], chunk);
+            *rspSize = GET_PROGRESS_RSP_HEADER_SIZE + chunk;
+        }
+    }
+    else
+    {
+        /* The status is CY_DFU_ERROR_LENGTH */
+    }
+    params->dataOffset = 0U;
+    return (status);
 }
-#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+#endif /* CY_DFU_OPT_RESUME != 0 */
 
 
+#if DIGEST_ENABLED != 0
 /*******************************************************************************
-* Function Name: PacketChecksum
+* Function Name: DigestStart
 ****************************************************************************//**
 *
-* This function computes a 16-bit checksum for the provided number of bytes
-* contained
-* in the provided buffer. \n
-* This function is used to calculate the checksum of DFU packets.
+* This function starts the running CRC-32C or SHA-256 of the image for the
+* verified area of the application, see \ref cy_stc_dfu_digest_t.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param appId      The application number.
+*
+*******************************************************************************/
+static void DigestStart(cy_stc_dfu_params_t *params, uint32_t appId)
+{
+    cy_stc_dfu_digest_t *digest = params->digest;
+    uint32_t verifyAddress;
+    uint32_t verifySize;
+
+    if (digest != NULL)
+    {
+        digest->valid = (appId < CY_DFU_MAX_APPS) &&
+                        (Cy_DFU_GetAppMetadata(appId, &verifyAddress, &verifySize) == CY_DFU_SUCCESS);
+        if (digest->valid)
+        {
+            digest->appId = appId;
+            digest->startAddress = verifyAddress;
+            digest->endAddress = verifyAddress + verifySize;
+            digest->nextAddress = verifyAddress;
+        #if CY_DFU_OPT_SHA256 != 0
+            Cy_DFU_Sha256Init(&digest->sha);
+        #else
+            digest->crc = CRC_INIT;
+        #endif /* CY_DFU_OPT_SHA256 != 0 */
+            digest->aheadRows = 0U;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: DigestUpdate
+****************************************************************************//**
+*
+* This function adds the data programmed at the end of the covered part of
+* the verified area to the running digest of the image. Programming or
+* erasing (\c length 0) the covered part stops the digest.
+* \note The programmed data is in params->dataBuffer.
+*
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+* \param address    The address of the programmed or erased row.
+* \param length     The length in bytes of the programmed data, 0 for erase.
+*
+*******************************************************************************/
+static void DigestUpdate(cy_stc_dfu_params_t *params, uint32_t address, uint32_t length)
+{
+    cy_stc_dfu_digest_t *digest = params->digest;
+
+    if ((digest != NULL) && digest->valid)
+    {
+        uint32_t end = address + ((length != 0U) ? length : CY_NVM_SIZEOF_ROW);
+
+        if ((end <= digest->startAddress) || (address >= digest->endAddress))
+        {
+            /* Outside the verified area */
+        }
+        else if (address < digest->nextAddress)
+        {
+            /* The covered part has changed, the digest is not valid anymore */
+            digest->valid = false;
+        }
+        else if ((address == digest->nextAddress) && (length != 0U))
+        {
+            if (end > digest->endAddress)
+            {
+                end = digest->endAddress;
+            }
+        #if CY_DFU_OPT_SHA256 != 0
+            Cy_DFU_Sha256Update(&digest->sha, params->dataBuffer, end - address);
+        #else
+            digest->crc = CrcUpdate(digest->crc, params->dataBuffer, end - address);
+        #endif /* CY_DFU_OPT_SHA256 != 0 */
+            digest->nextAddress = end;
+        }
+        else
+        {
+            /* Verify Application reads the rows after nextAddress from the NVM */
+            ++digest->aheadRows;
+        }
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: DigestVerify
+****************************************************************************//**
+*
+* This function validates the application with the running digest of the
+* image: adds the rest of the verified area from the NVM to it and compares
+* the result with the application checksum, as \ref Cy_DFU_ValidateApp does.
+*
+* \param appId      The application number.
+* \param params     The pointer to a DFU parameters structure.
+*                   See \ref cy_stc_dfu_params_t .
+*
+* \return
+* - \ref CY_DFU_SUCCESS If the application is valid.
+* - \ref CY_DFU_ERROR_VERIFY If the application is invalid.
+* - \ref CY_DFU_ERROR_UNKNOWN If the digest is not for the application or its
+*   current metadata, the application must be validated with
+*   \ref Cy_DFU_ValidateApp.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t DigestVerify(uint32_t appId, cy_stc_dfu_params_t *params)
+{
+    cy_stc_dfu_digest_t *digest = params->digest;
+    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
+    uint32_t verifyAddress;
+    uint32_t verifySize;
+
+    if ( (digest != NULL) && digest->valid && (digest->appId == appId) &&
+         (Cy_DFU_GetAppMetadata(appId, &verifyAddress, &verifySize) == CY_DFU_SUCCESS) &&
+         (verifyAddress == digest->startAddress) && ((verifyAddress + verifySize) == digest->endAddress) )
+    {
+    #if CY_DFU_OPT_SHA256 != 0
+        uint8_t sha[CY_DFU_SHA256_SIZE];
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 11.6',2,'Casting int to pointer is safe as the application is in the memory-mapped NVM.');
+        Cy_DFU_Sha256Update(&digest->sha, (const uint8_t *)digest->nextAddress,
+                            digest->endAddress - digest->nextAddress);
+        Cy_DFU_Sha256Final(&digest->sha, sha);
+        status = (memcmp(sha, (const void *)digest->endAddress, CY_DFU_SHA256_SIZE) == 0) ?
+                                                                        CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.6');
+        /* The context is consumed, a repeated Verify Application reads the NVM */
+        digest->valid = false;
+    #else
+CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 11.6',2,'Casting int to pointer is safe as the application is in the memory-mapped NVM.');
+        uint32_t crc = CrcUpdate(digest->crc, (const uint8_t *)digest->nextAddress,
+                                 digest->endAddress - digest->nextAddress);
+        status = (*(const uint32_t *)digest->endAddress == ~crc) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.6');
+    #endif /* CY_DFU_OPT_SHA256 != 0 */
+    }
+    return (status);
+}
+#endif /* DIGEST_ENABLED != 0 */
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_NvmRegionFind
+****************************************************************************//**
+*
+* Finds the NVM region of an address range, see \ref group_dfu_ucase_nvm_regions.
+*
+* \param regions    The NVM regions, terminated with NULL. The first region
+*                   that contains the range is returned.
+* \param address    The address of the first byte of the range.
+* \param length     The number of the bytes of the range, 0 for the address.
+*
+* \return The region, or NULL if no region contains the whole range.
+*
+*******************************************************************************/
+const cy_stc_dfu_nvm_region_t * Cy_DFU_NvmRegionFind(const cy_stc_dfu_nvm_region_t * const regions[],
+                                                      uint32_t address, uint32_t length)
+{
+    const cy_stc_dfu_nvm_region_t *region = NULL;
+
+    for (uint32_t idx = 0U; (region == NULL) && (regions[idx] != NULL); ++idx)
+    {
+        if (NvmRangeValid(regions[idx], address, length))
+        {
+            region = regions[idx];
+        }
+    }
+    return (region);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_NvmWrite
+****************************************************************************//**
+*
+* Writes \ref cy_stc_dfu_params_t::dataBuffer to an NVM region, see
+* \ref group_dfu_ucase_nvm_regions. Called by \ref Cy_DFU_WriteData after its
+* address checks.
+*
+* The erase units of the region that start in the range are erased first, then
+* the range is programmed with one call of the program function. With
+* \ref CY_DFU_IOCTL_ERASE, the range is erased only; a region without the erase
+* function is programmed with zeros then. With \ref CY_DFU_OPT_NVM_CACHE, the
+* host data of \ref CY_DFU_IOCTL_BHP is merged into the cached erase unit
+* instead, and the other writes write back the cache first.
+*
+* With \ref CY_DFU_OPT_NVM_ASYNC, a write of \ref CY_DFU_IOCTL_BHP returns
+* \ref CY_DFU_IN_PROGRESS if the program function of the region does, and is
+* polled with \ref CY_DFU_IOCTL_POLL for the same range until it completes.
+* The other writes wait for the poll function of the region.
+*
+* \param region     The region of the range, see \ref Cy_DFU_NvmRegionFind.
+* \param address    The address of the first byte, aligned to the program unit
+*                   of the region.
+* \param length     The number of the bytes to write, a multiple of the program
+*                   unit. 0 with \ref CY_DFU_IOCTL_ERASE for a row.
+* \param ctl        \ref CY_DFU_IOCTL_WRITE or \ref CY_DFU_IOCTL_ERASE, with
+*                   \ref CY_DFU_IOCTL_BHP for the host data, or
+*                   \ref CY_DFU_IOCTL_POLL.
+* \param params     The pointer to a DFU parameters structure.
+*
+* \return
+* - \ref CY_DFU_SUCCESS if the range is written.
+* - \ref CY_DFU_IN_PROGRESS if the write continues.
+* - \ref CY_DFU_ERROR_ADDRESS if region is NULL or read-only, or the range is
+*   outside it.
+* - \ref CY_DFU_ERROR_LENGTH if the range is not aligned to the program unit.
+* - The status of the driver function that fails otherwise.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_NvmWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                   uint32_t ctl, cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status;
+    bool eraseOnly = ((ctl & CY_DFU_IOCTL_ERASE) != 0U);
+    /* Only the Program Data command returns before its write completes */
+    bool async = (CY_DFU_OPT_NVM_ASYNC != 0) && ((ctl & CY_DFU_IOCTL_BHP) != 0U);
+    /* The Erase Data command erases a row */
+    uint32_t size = ((length == 0U) && eraseOnly) ? CY_NVM_SIZEOF_ROW : length;
+
+    if ( (region == NULL) || (region->program == NULL) || !NvmRangeValid(region, address, size) )
+    {
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if ((ctl & CY_DFU_IOCTL_POLL) != 0U)
+    {
+        /* The write of the range returned CY_DFU_IN_PROGRESS */
+        status = (region->poll != NULL) ? region->poll(region) : CY_DFU_SUCCESS;
+        if (status != CY_DFU_IN_PROGRESS)
+        {
+            NVM_STATS_END(params, CY_DFU_STATS_NVM_PROGRAM, address, size, status);
+        }
+    }
+    else if ( (size == 0U) || (((address - region->address) % region->programSize) != 0U) ||
+              ((size % region->programSize) != 0U) )
+    {
+        status = CY_DFU_ERROR_LENGTH;
+    }
+#if CY_DFU_OPT_NVM_CACHE != 0
+    else if ( ((ctl & CY_DFU_IOCTL_BHP) != 0U) && !eraseOnly && NvmCacheable(region, address, size) )
+    {
+        /* The host data is programmed when its erase unit is written back */
+        status = NvmCacheWrite(region, address, size, params);
+    }
+    else
+    {
+        /* The other writes are ordered after the cached data */
+        status = Cy_DFU_NvmFlush(params);
+        if (status == CY_DFU_SUCCESS)
+        {
+            status = NvmProgram(region, address, params->dataBuffer, size, eraseOnly, !async, params);
+        }
+    }
+#else
+    else
+    {
+        status = NvmProgram(region, address, params->dataBuffer, size, eraseOnly, !async, params);
+    }
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_NvmRead
+****************************************************************************//**
 *
-* MISRA requires this function have no side effects.
+* Reads an NVM region into \ref cy_stc_dfu_params_t::dataBuffer, or compares
+* it with the buffer, see \ref group_dfu_ucase_nvm_regions. A region without
+* the read or compare function is accessed in place.
 *
-* \param buffer     The buffer containing the data to compute the checksum for.
-* \param size       The number of bytes in the buffer to compute the checksum
-* for.
+* \param region     The region of the range, see \ref Cy_DFU_NvmRegionFind.
+* \param address    The address of the first byte.
+* \param length     The number of the bytes to read or compare.
+* \param ctl        \ref CY_DFU_IOCTL_READ or \ref CY_DFU_IOCTL_COMPARE.
+* \param params     The pointer to a DFU parameters structure.
 *
-* \return A 16-bit checksum for the provided data
+* \return
+* - \ref CY_DFU_SUCCESS if the range is read, or matches the buffer.
+* - \ref CY_DFU_ERROR_VERIFY if the range differs from the buffer.
+* - \ref CY_DFU_ERROR_ADDRESS if region is NULL or the range is outside it.
+* - \ref CY_DFU_ERROR_LENGTH if the range does not fit the buffer.
+* - The status of the driver function that fails otherwise.
 *
 *******************************************************************************/
-static uint32_t PacketChecksum(const uint8_t buffer[], uint32_t size)
+cy_en_dfu_status_t Cy_DFU_NvmRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                  uint32_t ctl, cy_stc_dfu_params_t *params)
 {
-#if (CY_DFU_OPT_PACKET_CRC != 0U)
-    uint16_t crc = CRC_CCITT_INIT;
-    uint16_t tmp;
-    uint32_t i;
-    uint16_t tmpIndex;
-
-    size += PACKET_DATA_IDX; /* 4 bytes before data in Cypress DFU packet */
-
-    tmpIndex = (uint16_t)size;
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
 
-    if(0U == size)
+    if ( (region == NULL) || !NvmRangeValid(region, address, length) )
+    {
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if (length > CY_DFU_SIZEOF_DATA_BUFFER)
     {
-        crc = ~crc;
+        status = CY_DFU_ERROR_LENGTH;
+    }
+#if CY_DFU_OPT_NVM_CACHE != 0
+    else if ( (cy_dfu_nvmCache.region == region) && ((address - cy_dfu_nvmCache.address) < region->eraseSize) &&
+              (length <= (region->eraseSize - (address - cy_dfu_nvmCache.address))) )
+    {
+        /* The range is in the cached erase unit, not in the NVM yet */
+        const uint8_t *data = &((const uint8_t *)cy_dfu_nvmCache.data)[address - cy_dfu_nvmCache.address];
+
+        if ((ctl & CY_DFU_IOCTL_COMPARE) == 0U)
+        {
+            (void) memcpy(params->dataBuffer, data, length);
+        }
+        else
+        {
+            status = (memcmp(params->dataBuffer, data, length) == 0) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+        }
     }
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
     else
     {
-        do
+    #if CY_DFU_OPT_NVM_CACHE != 0
+        if ( (cy_dfu_nvmCache.region == region) && (address < (cy_dfu_nvmCache.address + region->eraseSize)) &&
+             (cy_dfu_nvmCache.address < (address + length)) )
         {
-            tmp = buffer[tmpIndex - size];
-
-            for (i = 0U; i < 8U; i++)
+            /* Part of the range is cached, the whole range is read from the NVM */
+            status = Cy_DFU_NvmFlush(params);
+        }
+        if (status == CY_DFU_SUCCESS)
+    #endif /* CY_DFU_OPT_NVM_CACHE != 0 */
+        {
+            NVM_STATS_BEGIN(params);
+            if ((ctl & CY_DFU_IOCTL_COMPARE) != 0U)
             {
-                if (0U != ((crc & 0x0001U) ^ (tmp & 0x0001U)))
-                {
-                    crc = (crc >> 1U) ^ CRC_CCITT_POLYNOMIAL;
-                }
-                else
-                {
-                    crc >>= 1U;
-                }
-
-                tmp >>= 1U;
+                status = NvmCompare(region, address, params->dataBuffer, length);
             }
-
-            size--;
+            else if (region->read != NULL)
+            {
+                status = region->read(region, address, params->dataBuffer, length);
+            }
+            else
+            {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as the region is memory mapped.');
+                (void) memcpy(params->dataBuffer, (const void *)address, length);
+            }
+            NVM_STATS_END(params, CY_DFU_STATS_NVM_READ, address, length, status);
         }
-        while(0U != size);
-
-        crc = ~crc;
-        tmp = crc;
-        crc = ((uint16_t)(crc << 8U) | (tmp >> 8U) ) & 0xFFFFU;
-    }
-
-    return ((uint32_t)crc);
-#else
-    uint16_t sum = 0U;
-    size += PACKET_DATA_IDX; /* 4 bytes before data in Cypress DFU packet */
-
-    while (size > 0U)
-    {
-        size--;
-        sum += buffer[size];
     }
-
-    return ( (uint32_t) (  (1U + ~(uint32_t)sum) & 0xFFFFU  ) );
-#endif /* CY_DFU_OPT_PACKET_CRC != 0U */
+    return (status);
 }
 
 
+#if CY_DFU_OPT_NVM_CACHE != 0
 /*******************************************************************************
-* Function Name: Cy_DFU_DataChecksum
+* Function Name: Cy_DFU_NvmFlush
 ****************************************************************************//**
 *
-* This function computes a CRC-32C for the provided number of bytes contained
-* in the provided buffer. \n
-* This function is used to validate the Program Data and Verify Data DFU
-* commands and a metadata row.
-* \note Ensure the Crypto block is properly initialized
-* if \ref CY_DFU_OPT_CRYPTO_HW is set.
+* Writes back the erase unit cached by \ref Cy_DFU_NvmWrite with
+* \ref CY_DFU_OPT_NVM_CACHE, see \ref group_dfu_ucase_nvm_regions. The unit
+* is erased and programmed only if it differs from the NVM, and compared after
+* the write. Called by the DFU on the Verify Application and Exit commands:
+* the Verify Application DFU command reports the application invalid, and
+* \ref Cy_DFU_Continue returns the error on the Exit DFU command, if the
+* write-back fails. Call it before the application reads the NVM in place
+* otherwise, for example after a failed update session.
 *
-* \param address    The pointer to a buffer containing the data to compute
-*                   the checksum for.
-* \param length     The number of bytes in the buffer to compute the checksum
-*                   for.
 * \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
 *
-* \return CRC-32C for the provided data.
+* \return
+* - \ref CY_DFU_SUCCESS if the cache is empty or written back.
+* - The status of the driver function that fails otherwise, the unit stays
+*   in the cache then.
 *
 *******************************************************************************/
-uint32_t Cy_DFU_DataChecksum(const uint8_t *address, uint32_t length, cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_NvmFlush(cy_stc_dfu_params_t *params)
 {
-    /* Note: param is unused by the current implementation */
-    /* but it may be used in the future, if the Crypto API changes */
-    (void)params;
-
-#if CY_DFU_OPT_CRYPTO_HW != 0 /* Use PDL Hardware Crypto API */
-    /* Note that the length will be < 64KB due to the hardware limitation in the Crypto Block. */
-    /* If the block size is bigger, use software implementation instead. */
-
-    uint32_t crcOut = 0U;
-
-    cy_stc_crypto_context_crc_t cryptoCrcContext;
-    cy_en_crypto_status_t cryptoStatus;
+    const cy_stc_dfu_nvm_region_t *region = cy_dfu_nvmCache.region;
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
 
-    cryptoStatus = Cy_Crypto_Enable();
-    if (cryptoStatus == CY_CRYPTO_SUCCESS)
+    if (region != NULL)
     {
-        cryptoStatus = Cy_Crypto_Crc_Init( CRC_POLYNOMIAL,     CRC_DATA_REVERSE,
-                                           CRC_DATA_XOR  ,     CRC_REM_REVERSE ,
-                                           CRC_REM_XOR,        &cryptoCrcContext );
-        if (cryptoStatus == CY_CRYPTO_SUCCESS)
+        uint32_t address = cy_dfu_nvmCache.address;
+        uint8_t *data = (uint8_t *)cy_dfu_nvmCache.data;
+
+        NVM_STATS_BEGIN(params);
+        status = NvmCompare(region, address, data, region->eraseSize);
+        /* A difference is expected here rather than a failure */
+        NVM_STATS_END(params, CY_DFU_STATS_NVM_READ, address, region->eraseSize,
+                      (status == CY_DFU_ERROR_VERIFY) ? CY_DFU_SUCCESS : status);
+        if (status == CY_DFU_ERROR_VERIFY)
         {
-            cryptoStatus = Cy_Crypto_Sync(CY_CRYPTO_SYNC_BLOCKING);
-        }
-        if (cryptoStatus == CY_CRYPTO_SUCCESS)
-        {
-CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 11.8',1,'Removing const does not have negative impact as function does not modify data.');
-            cryptoStatus = Cy_Crypto_Crc_Run (
-                /* dataPtr */ (void *)address,          /* length        */ (uint16_t) length,
-                /* crcPtr  */ &crcOut,                  /* lfsrInitState */ CRC_LFSR_SEED,
-                /* cfContext     */ &cryptoCrcContext  );
+            status = NvmProgram(region, address, data, region->eraseSize, false, true, params);
+            if (status == CY_DFU_SUCCESS)
+            {
+                NVM_STATS_BEGIN(params);
+                status = NvmCompare(region, address, data, region->eraseSize);
+                NVM_STATS_END(params, CY_DFU_STATS_NVM_READ, address, region->eraseSize, status);
+            }
         }
-CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.8');
-        if (cryptoStatus == CY_CRYPTO_SUCCESS)
+        if (status == CY_DFU_SUCCESS)
         {
-            cryptoStatus = Cy_Crypto_Sync(CY_CRYPTO_SYNC_BLOCKING);
+            cy_dfu_nvmCache.region = NULL;
         }
-
-        (void) Cy_Crypto_Disable();
-    }
-    if (cryptoStatus != CY_CRYPTO_SUCCESS)
-    {
-        CY_HALT();
     }
+    return (status);
+}
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
 
-    return (crcOut);
-#else /* Use software implementation */
-    /* Contains generated values to calculate CRC-32C by 4 bits per iteration*/
-    static const uint32_t crcTable[CRC_TABLE_SIZE] =
-    {
-        0x00000000U, 0x105ec76fU, 0x20bd8edeU, 0x30e349b1U,
-        0x417b1dbcU, 0x5125dad3U, 0x61c69362U, 0x7198540dU,
-        0x82f63b78U, 0x92a8fc17U, 0xa24bb5a6U, 0xb21572c9U,
-        0xc38d26c4U, 0xd3d3e1abU, 0xe330a81aU, 0xf36e6f75U,
-    };
 
-    uint32_t crc = CRC_INIT;
-    if (length != 0U)
-    {
-        do
-        {
-            crc = crc ^ *address;
-            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
-            crc = (crc >> NIBBLE_POS) ^ crcTable[crc & NIBBLE_MSK];
-            --length;
-            ++address;
-        } while (length != 0U);
-    }
-    return (~crc);
-#endif /* CY_DFU_OPT_CRYPTO_HW != 0 */
+/*******************************************************************************
+* Function Name: NvmRangeValid
+****************************************************************************//**
+*
+* This internal function checks that a range is inside an NVM region.
+*
+* \param region     The NVM region.
+* \param address    The address of the first byte of the range.
+* \param length     The number of the bytes of the range.
+*
+* \return True if the range is inside the region.
+*
+*******************************************************************************/
+static bool NvmRangeValid(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
+{
+    return ( ((address - region->address) < region->size) &&
+             (length <= (region->size - (address - region->address))) );
 }
 
 
 /*******************************************************************************
-* Function Name: VerifyPacket
+* Function Name: NvmCompare
 ****************************************************************************//**
 *
-* This function is used inside DFU_ReadVerifyPacket() to verify if a
-* received packet is correct.
+* This internal function compares an NVM range with data, in place if the
+* region has no compare function.
 *
-* \param numberRead     The number of bytes read from the communication
-*                       interface.
-* \param packet         The pointer to the DFU packet buffer.
+* \param region     The NVM region.
+* \param address    The address of the first byte of the range.
+* \param data       The data to compare with.
+* \param length     The number of the bytes to compare.
 *
-* \return  See \ref cy_en_dfu_status_t.
+* \return \ref CY_DFU_SUCCESS if the range matches, \ref CY_DFU_ERROR_VERIFY if
+* it differs, or the status of the compare function.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t VerifyPacket(uint32_t numberRead, const uint8_t packet[])
+static cy_en_dfu_status_t NvmCompare(const cy_stc_dfu_nvm_region_t *region, uint32_t address, const uint8_t data[],
+                                     uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_en_dfu_status_t status;
 
-    if ((numberRead < CY_DFU_PACKET_MIN_SIZE) || (packet[PACKET_SOP_IDX] != PACKET_SOP_VALUE))
+    if (region->compare != NULL)
     {
-        status = CY_DFU_ERROR_DATA;
+        status = region->compare(region, address, data, length);
     }
     else
     {
-        uint32_t packetSize = GetPacketDSize(packet);
-
-        /*
-         * If the whole packet length exceeds the number of bytes that have
-         * been read by the communication component or the size of
-         * the buffer that is reserved for the packet, then give an error.
-         */
-        if (   ((packetSize + CY_DFU_PACKET_MIN_SIZE) > numberRead)
-            || ((packetSize + CY_DFU_PACKET_MIN_SIZE) > CY_DFU_SIZEOF_CMD_BUFFER)  )
-        {
-            status = CY_DFU_ERROR_LENGTH;
-        }
-        else /* The packet length is OK */
-        {
-            if ( ValidatePacketFooter(packet, packetSize) == 0U )
-            {
-                status = CY_DFU_ERROR_DATA;
-            }
-            else
-            {
-                uint32_t pktChecksum = GetPacketChecksum(packet, packetSize);
-                if (pktChecksum != PacketChecksum(packet, packetSize) )
-                {
-                    status = CY_DFU_ERROR_CHECKSUM;
-                }
-            }
-        }
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as the region is memory mapped.');
+        status = (memcmp(data, (const void *)address, length) == 0) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
     }
     return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: ReadVerifyPacket
+* Function Name: NvmProgram
 ****************************************************************************//**
 *
-* This function is used inside Cy_DFU_Continue to read and verify
-* a received DFU packet.
-*
-* \param packet       The pointer to the DFU packet buffer.
-* \param noResponse   The pointer to a variable that states whether to send
-*                      a response back to a DFU Host or not.
-* \param timeout      The timeout in milliseconds to wait.
+* This internal function erases the erase units of a region that start in an
+* aligned range, then programs the range with one call of the program
+* function, see \ref Cy_DFU_NvmWrite.
+*
+* \param region     The NVM region.
+* \param address    The address of the first byte of the range.
+* \param data       The data to program, zeroed for an erase of a region
+*                   without the erase function.
+* \param length     The number of the bytes of the range.
+* \param eraseOnly  True if the range is erased only.
+* \param wait       True to poll a non-blocking program function until the
+*                   write completes.
+* \param params     The pointer to a DFU parameters structure.
 *
-* \return See \ref cy_en_dfu_status_t
-* - \ref CY_DFU_SUCCESS - If a packet is successfully received.
-* - \ref CY_DFU_ERROR_TIMEOUT - If no packet is received during
-*   the timeout period.
+* \return The status of the driver function that fails, \ref CY_DFU_IN_PROGRESS
+* if the write continues, or \ref CY_DFU_SUCCESS.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t ReadVerifyPacket(uint8_t packet[], bool *noResponse, uint32_t timeout)
+static cy_en_dfu_status_t NvmProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                     uint32_t length, bool eraseOnly, bool wait, cy_stc_dfu_params_t *params)
 {
-    cy_en_dfu_status_t status;
-    uint32_t numberRead = 0U;
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    bool program = !eraseOnly;
 
-    status = Cy_DFU_TransportRead( packet, CY_DFU_SIZEOF_CMD_BUFFER, &numberRead, timeout );
+    CY_UNUSED_PARAMETER(params); /* Without CY_DFU_OPT_STATS */
 
-    if (status == CY_DFU_ERROR_TIMEOUT)
+    if ( (region->eraseSize != 0U) && (region->erase != NULL) )
+    {   /* The erase units that start in the range */
+        uint32_t offset = address - region->address;
+        uint32_t first = ((offset + region->eraseSize - 1U) / region->eraseSize) * region->eraseSize;
+
+        if (first < (offset + length))
+        {
+            uint32_t last = ((offset + length - 1U) / region->eraseSize) * region->eraseSize;
+
+            NVM_STATS_BEGIN(params);
+            status = region->erase(region, region->address + first, (last - first) + region->eraseSize);
+            NVM_STATS_END(params, CY_DFU_STATS_NVM_ERASE, region->address + first,
+                          (last - first) + region->eraseSize, status);
+        }
+    }
+    else if (eraseOnly && (region->erase != NULL))
     {
-        *noResponse = true;
+        NVM_STATS_BEGIN(params);
+        status = region->erase(region, address, length);
+        NVM_STATS_END(params, CY_DFU_STATS_NVM_ERASE, address, length, status);
     }
-    if (status == CY_DFU_SUCCESS)
+    else if (eraseOnly)
+    {   /* The memory has no erase */
+        (void) memset(data, 0, length);
+        program = true;
+    }
+    else
+    {
+        /* Programmed without an erase */
+    }
+
+    if ( (status == CY_DFU_SUCCESS) && program )
     {
-        status = VerifyPacket(numberRead, packet);
+        NVM_STATS_BEGIN(params);
+        status = region->program(region, address, data, length);
+        while (wait && (status == CY_DFU_IN_PROGRESS))
+        {
+            status = (region->poll != NULL) ? region->poll(region) : CY_DFU_ERROR_DATA;
+        }
+        if (status != CY_DFU_IN_PROGRESS)
+        {
+            /* Otherwise the poll of Cy_DFU_NvmWrite() ends the operation */
+            NVM_STATS_END(params, CY_DFU_STATS_NVM_PROGRAM, address, length, status);
+        }
     }
     return (status);
 }
 
 
+#if CY_DFU_OPT_NVM_CACHE != 0
 /*******************************************************************************
-* Function Name: WritePacket
+* Function Name: NvmCacheable
 ****************************************************************************//**
 *
-* This function creates a DFU response packet and transmits it back to
-* the DFU host application over the already established communications
-* protocol.
+* This internal function checks that a range can be written to the NVM cache:
+* the region has the erase function, its erase unit fits the cache, and the
+* range is inside one erase unit and smaller than it.
 *
-* \param status     The error response code of the DFU response packet.
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The number of bytes contained within the \c packet
-*                   to pass back to a DFU Host.
+* \param region     The NVM region.
+* \param address    The address of the first byte of the range.
+* \param length     The number of the bytes of the range, not 0.
 *
-* \return See \ref cy_en_dfu_status_t
+* \return True if the range can be cached.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t WritePacket(cy_en_dfu_status_t status, uint8_t *packet, uint32_t rspSize)
+static bool NvmCacheable(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
 {
-    uint32_t checksum;
-    /*
-    * The DFU Host expects only one byte of the status,
-    * its value must be compatible with the PSoC 3/4/5LP Bootloader Component
-    */
-    uint32_t statusCode = (uint32_t)status & STATUS_BYTE_MSK;
-
-    /* Build a packet */
-    SetPacketHeader(packet);
-    SetPacketCmd   (packet, statusCode);
-    SetPacketDSize (packet, rspSize);
-
-    checksum = PacketChecksum(packet, rspSize);
-    SetPacketChecksum(packet, rspSize, checksum);
-    SetPacketFooter  (packet, rspSize);
+    uint32_t offset = address - region->address;
 
-    return ( Cy_DFU_TransportWrite(packet, rspSize + CY_DFU_PACKET_MIN_SIZE, &rspSize,
-                                        TRANSPORT_WRITE_TIMEOUT));
+    return ( (region->erase != NULL) && (region->eraseSize != 0U) &&
+             (region->eraseSize <= CY_DFU_NVM_CACHE_SIZE) && (length < region->eraseSize) &&
+             ((offset / region->eraseSize) == ((offset + length - 1U) / region->eraseSize)) );
 }
 
 
-/*******************************************************************************0
-* Function Name: EnterResponse
+/*******************************************************************************
+* Function Name: NvmCacheWrite
 ****************************************************************************//**
 *
-* This function is used inside Cy_DFU_ContinueEntr() to add version and
-* size fields.
+* This internal function merges \ref cy_stc_dfu_params_t::dataBuffer into the
+* cached erase unit of a range. The cached unit of another range is written
+* back first, and the unit of the range is loaded from the NVM.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param state      The pointer to a state variable, that is updated by
-*                   the function. See \ref group_dfu_macro_state.
+* \param region     The NVM region.
+* \param address    The address of the first byte of the range.
+* \param length     The number of the bytes of the range.
+* \param params     The pointer to a DFU parameters structure.
+*
+* \return \ref CY_DFU_SUCCESS, or the status of the driver function that fails.
 *
 *******************************************************************************/
-static void EnterResponse(uint8_t *packet, uint32_t *rspSize, uint32_t *state)
+static cy_en_dfu_status_t NvmCacheWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                        cy_stc_dfu_params_t *params)
 {
-    static const cy_stc_dfu_enter_t dfuVersion =
+    uint8_t *data = (uint8_t *)cy_dfu_nvmCache.data;
+    uint32_t unit = address - ((address - region->address) % region->eraseSize);
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    if ( (cy_dfu_nvmCache.region != region) || (cy_dfu_nvmCache.address != unit) )
     {
-        CY_DFU_SILICON_ID,
-        (uint8_t) CY_DFU_SILICON_REV,
+        status = Cy_DFU_NvmFlush(params);
+        if (status == CY_DFU_SUCCESS)
+        {
+            NVM_STATS_BEGIN(params);
+            if (region->read != NULL)
+            {
+                status = region->read(region, unit, data, region->eraseSize);
+            }
+            else
+            {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as the region is memory mapped.');
+                (void) memcpy(data, (const void *)unit, region->eraseSize);
+            }
+            NVM_STATS_END(params, CY_DFU_STATS_NVM_READ, unit, region->eraseSize, status);
+        }
+        if (status == CY_DFU_SUCCESS)
         {
-            (uint8_t) CY_DFU_SDK_VERSION_MINOR,
-            (uint8_t) CY_DFU_SDK_VERSION_MAJOR,
-            0x01U /* Used for BWC with the Bootloader component */
+            cy_dfu_nvmCache.region = region;
+            cy_dfu_nvmCache.address = unit;
         }
-    };
-    *state = CY_DFU_STATE_UPDATING;
-    *rspSize = sizeof(dfuVersion);
-    (void) memcpy( (void*)GetPacketData(packet, PACKET_DATA_NO_OFFSET),
-                    (const void*)&dfuVersion, *rspSize);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        (void) memcpy(&data[address - unit], params->dataBuffer, length);
+    }
+    return (status);
 }
+#endif /* CY_DFU_OPT_NVM_CACHE != 0 */
 
 
+#if CY_DFU_OPT_NOR != 0
 /*******************************************************************************
-* Function Name: CommandEnter
+* Function Name: Cy_DFU_NorInit
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
+* Initializes the driver of a serial NOR device from the SFDP basic flash
+* parameter table of the device, see \ref group_dfu_ucase_nor.
 *
-* This function is called to handle Command Enter, see the DFU Commands
-* section in the DFU SDK User's Guide.
+* Selects the 4-byte addresses for a device larger than 16 MB, and the 1-1-4
+* fast read if the device supports it and its quad enable bit is set. The quad
+* enable bit is set as the SFDP table describes; if it cannot be, the 1-1-1
+* fast read is used.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param state      The pointer to a state variable, that is updated by
-*                   the function. See \ref group_dfu_macro_state.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor    The serial NOR device, with \ref cy_stc_dfu_nor_t::ops,
+*               \ref cy_stc_dfu_nor_t::context and \ref cy_stc_dfu_nor_t::address
+*               set by the caller.
 *
-* \return See \ref cy_en_dfu_status_t.
+* \return
+* - \ref CY_DFU_SUCCESS if the device is ready to use.
+* - \ref CY_DFU_ERROR_BAD_PARAM if nor or its command function is NULL.
+* - \ref CY_DFU_ERROR_DATA if the device has no valid SFDP basic flash parameter
+*   table, or the interface fails.
+* - \ref CY_DFU_ERROR_TIMEOUT if the device stays busy.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandEnter(uint8_t *packet, uint32_t *rspSize, uint32_t *state,
-                                            cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_NorInit(cy_stc_dfu_nor_t *nor)
 {
-    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
-     volatile uint32_t productId;
-#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
-    productId = ElfSymbolToAddr(&__cy_product_id);
-#else
-    productId = CY_DFU_PRODUCT;
-#endif /*CY_DFU_FLOW == CY_DFU_BASIC_FLOW*/
-    uint32_t packetSize = GetPacketDSize(packet);
-    *rspSize = CY_DFU_RSP_SIZE_0;
+    cy_en_dfu_status_t status = CY_DFU_ERROR_BAD_PARAM;
+    uint8_t table[NOR_SFDP_DWORDS * UINT32_SIZE];
+    uint32_t dwords = 0U;
 
-    if (packetSize == 0U)  /* 'Product ID' not demanded */
+    if ( (nor != NULL) && (nor->ops != NULL) && (nor->ops->command != NULL) )
     {
-        status = (productId == 0U)? CY_DFU_SUCCESS : CY_DFU_ERROR_LENGTH;
-        if (status == CY_DFU_SUCCESS)
+        nor->size = 0U;
+        /* The SFDP header and the first parameter header, always the basic flash parameter table */
+        status = NorSfdpRead(nor, 0U, table, 2U * NOR_SFDP_HEADER_SIZE);
+    }
+    if (status == CY_DFU_SUCCESS)
+    {
+        dwords = table[NOR_SFDP_HEADER_SIZE + 3U];
+        if ( (GetU32(table) != NOR_SFDP_SIGNATURE) || (table[NOR_SFDP_HEADER_SIZE] != 0U) || (dwords < 9U) )
         {
-            EnterResponse(packet, rspSize, state);
+            status = CY_DFU_ERROR_DATA;
+        }
+        else
+        {
+            uint32_t pointer = GetU32(&table[NOR_SFDP_HEADER_SIZE + 4U]) & 0x00FFFFFFU;
+
+            dwords = (dwords < NOR_SFDP_DWORDS) ? dwords : NOR_SFDP_DWORDS;
+            status = NorSfdpRead(nor, pointer, table, dwords * UINT32_SIZE);
         }
     }
-    else if ( (packetSize == DATA_PACKET_SIZE_4BYTES) || (packetSize == DATA_PACKET_SIZE_6BYTES) )
+    if (status == CY_DFU_SUCCESS)
     {
-        status = CY_DFU_ERROR_DATA;
-        if (productId == GetU32(GetPacketData(packet, PACKET_DATA_NO_OFFSET) ) )
+        /* DWORD 2: the density in bits, 2^N bits if bit 31 is set */
+        uint32_t density = GetU32(&table[1U * UINT32_SIZE]);
+
+        if ((density & 0x80000000U) == 0U)
         {
-            EnterResponse(packet, rspSize, state);
-            status = CY_DFU_SUCCESS;
+            nor->size = (density >> 3U) + 1U;
+        }
+        else if (((density & 0x7FFFFFFFU) >= 3U) && ((density & 0x7FFFFFFFU) < 35U))
+        {
+            nor->size = 1UL << ((density & 0x7FFFFFFFU) - 3U);
+        }
+        else
+        {
+            status = CY_DFU_ERROR_DATA;
         }
     }
-    else
+    if (status == CY_DFU_SUCCESS)
     {
-        /* Empty */
-    }
+        uint32_t dword1 = GetU32(&table[0U]);
+        uint32_t idx;
 
-    CY_UNUSED_PARAMETER(params); /* Remove the unused warning */
+        /* DWORD 8 and 9: the erase types, the size 2^N and the opcode, sorted ascending */
+        (void) memset(nor->eraseSize, 0, sizeof(nor->eraseSize));
+        (void) memset(nor->eraseOpcode, 0, sizeof(nor->eraseOpcode));
+        for (idx = 0U; idx < CY_DFU_NOR_ERASE_TYPES; ++idx)
+        {
+            uint32_t type = GetU32(&table[(7U + (idx / 2U)) * UINT32_SIZE]) >> ((idx % 2U) * 16U);
+            uint32_t exponent = type & 0xFFU;
+
+            if ((exponent != 0U) && (exponent < 32U))
+            {
+                uint32_t pos = idx;
+                while ( (pos > 0U) && ((nor->eraseSize[pos - 1U] == 0U) ||
+                                       (nor->eraseSize[pos - 1U] > (1UL << exponent))) )
+                {
+                    --pos;
+                }
+                (void) memmove(&nor->eraseSize[pos + 1U], &nor->eraseSize[pos],
+                               (CY_DFU_NOR_ERASE_TYPES - 1U - pos) * sizeof(nor->eraseSize[0]));
+                (void) memmove(&nor->eraseOpcode[pos + 1U], &nor->eraseOpcode[pos],
+                               (CY_DFU_NOR_ERASE_TYPES - 1U - pos) * sizeof(nor->eraseOpcode[0]));
+                nor->eraseSize[pos] = 1UL << exponent;
+                nor->eraseOpcode[pos] = (uint8_t)(type >> 8U);
+            }
+        }
+        if ( (nor->eraseSize[0U] == 0U) && ((dword1 & 0x03U) == 0x01U) )
+        {   /* DWORD 1: the 4 KB erase */
+            nor->eraseSize[0U] = 4096U;
+            nor->eraseOpcode[0U] = (uint8_t)(dword1 >> 8U);
+        }
 
+        /* DWORD 11: the page size 2^N */
+        nor->pageSize = (dwords >= 11U) ? (1UL << ((GetU32(&table[10U * UINT32_SIZE]) >> 4U) & 0x0FU))
+                                        : NOR_DEFAULT_PAGE_SIZE;
+
+        /* DWORD 1: 3-byte only, 3 or 4-byte, 4-byte only addresses */
+        nor->addressSize = 3U;
+        if ( (((dword1 >> 17U) & 0x03U) == 0x02U) ||
+             ((((dword1 >> 17U) & 0x03U) == 0x01U) && (nor->size > 0x01000000U)) )
+        {
+            nor->addressSize = 4U;
+        }
+        if ( (((dword1 >> 17U) & 0x03U) == 0x01U) && (nor->addressSize == 4U) )
+        {
+            cy_stc_dfu_nor_cmd_t cmd;
+            NorCmdInit(&cmd, NOR_CMD_ENTER_4BYTE, 0U, 0U);
+            status = nor->ops->command(&cmd, nor->context);
+        }
+
+        nor->readOpcode = NOR_CMD_FAST_READ;
+        nor->readDummyCycles = NOR_DUMMY_CYCLES;
+        nor->readWidth = 1U;
+        /* DWORD 1: the 1-1-4 fast read, DWORD 3: its opcode, mode and dummy clocks, DWORD 15: the quad enable */
+        if ( (status == CY_DFU_SUCCESS) && ((dword1 & 0x00400000U) != 0U) && (dwords >= 15U) &&
+             (NorQuadEnable(nor, (GetU32(&table[14U * UINT32_SIZE]) >> 20U) & 0x07U) == CY_DFU_SUCCESS) )
+        {
+            uint32_t dword3 = GetU32(&table[2U * UINT32_SIZE]);
+
+            nor->readOpcode = (uint8_t)(dword3 >> 24U);
+            nor->readDummyCycles = (uint8_t)(((dword3 >> 16U) & 0x1FU) + ((dword3 >> 21U) & 0x07U));
+            nor->readWidth = 4U;
+        }
+
+        if ( (nor->eraseSize[0U] == 0U) || (nor->pageSize == 0U) )
+        {
+            status = CY_DFU_ERROR_DATA;
+        }
+    }
+    if ( (status != CY_DFU_SUCCESS) && (status != CY_DFU_ERROR_BAD_PARAM) )
+    {
+        nor->size = 0U;
+        CY_DFU_LOG_ERR("Serial NOR initialization failed");
+    }
     return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: CopyToDataBuffer
+* Function Name: Cy_DFU_NorRead
 ****************************************************************************//**
 *
-* This is a helper function, called in the following functions:
-* - DFU_CommandProgramData
-* - CommandVerifyData
-* - CommandSendData
+* Reads the content of a serial NOR device: directly if it is memory mapped,
+* with the fast read command of \ref Cy_DFU_NorInit otherwise.
 *
-* This is used to copy packet data to dataBuffer and increase dataOffset.
-*
-* \param dataBuffer     The pointer to a buffer containing the data to be
-*                       written to an NVM.
-* \param dataOffset     The offset within dataBuffer, indicates the current
-*                       dataBuffer length.
-* \param packet         The pointer to the DFU packet buffer.
-* \param packetSize     The length in bytes of the data in the DFU
-*                       packet buffer.
+* \param nor        The serial NOR device initialized with \ref Cy_DFU_NorInit.
+* \param address    The address of the first byte, from \ref cy_stc_dfu_nor_t::address.
+* \param data       The buffer for the content.
+* \param length     The number of the bytes to read.
 *
-* \return See \ref cy_en_dfu_status_t
+* \return
+* - \ref CY_DFU_SUCCESS if the content is read.
+* - \ref CY_DFU_ERROR_ADDRESS if the range is outside the device.
+* - \ref CY_DFU_ERROR_DATA if the interface fails.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CopyToDataBuffer(uint8_t dataBuffer[], uint32_t *dataOffset, uint8_t const packet[],
-                                                uint32_t packetSize)
+cy_en_dfu_status_t Cy_DFU_NorRead(const cy_stc_dfu_nor_t *nor, uint32_t address, uint8_t data[], uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
-    if ( (dataBuffer != NULL) && (dataOffset != NULL) && (packet != NULL) )
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+
+    if (!NorRangeValid(nor, address, length))
     {
-        status = CY_DFU_ERROR_LENGTH;
-        if ( (*dataOffset + packetSize) <= CY_DFU_SIZEOF_DATA_BUFFER )
-        {
-            status = CY_DFU_SUCCESS;
-            (void) memcpy( &dataBuffer[*dataOffset], packet, packetSize);
-            *dataOffset += packetSize;
-        }
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if ( (nor->ops->mapped != NULL) && nor->ops->mapped(nor->context) )
+    {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as the device is memory mapped at the address.');
+        (void) memcpy(data, (const void *)address, length);
+    }
+    else
+    {
+        cy_stc_dfu_nor_cmd_t cmd;
+
+        NorCmdInit(&cmd, nor->readOpcode, nor->addressSize, address - nor->address);
+        cmd.dummyCycles = nor->readDummyCycles;
+        cmd.dataWidth = nor->readWidth;
+        cmd.rxData = data;
+        cmd.length = length;
+        status = nor->ops->command(&cmd, nor->context);
     }
     return (status);
 }
 
 
 /*******************************************************************************
-* Function Name: CommandProgramData
+* Function Name: Cy_DFU_NorCompare
 ****************************************************************************//**
 *
-* This a helper function for Cy_DFU_Continue().
-* This function is used to program data to an NVM.
+* Compares the content of a serial NOR device with the data: in place if the
+* device is memory mapped, read in chunks of 64 bytes
+* otherwise.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor        The serial NOR device initialized with \ref Cy_DFU_NorInit.
+* \param address    The address of the first byte, from \ref cy_stc_dfu_nor_t::address.
+* \param data       The data to compare the content with.
+* \param length     The number of the bytes to compare.
 *
-* \return See \ref cy_en_dfu_status_t
+* \return
+* - \ref CY_DFU_SUCCESS if the content matches the data.
+* - \ref CY_DFU_ERROR_VERIFY if it does not.
+* - \ref CY_DFU_ERROR_ADDRESS if the range is outside the device.
+* - \ref CY_DFU_ERROR_DATA if the interface fails.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandProgramData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_NorCompare(const cy_stc_dfu_nor_t *nor, uint32_t address, const uint8_t data[],
+                                     uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
-    uint8_t  *dataBufferLocal =  params->dataBuffer;
-    uint32_t *dataOffsetLocal = &params->dataOffset;
-    uint32_t  packetSize =  GetPacketDSize(packet);
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
 
-    *rspSize = CY_DFU_RSP_SIZE_0;
-    if (packetSize >= PARAMS_SIZE)
+    if (!NorRangeValid(nor, address, length))
     {
-        uint32_t address =  GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
-        uint32_t crc = GetU32( GetPacketData(packet, PROGRAM_DATA_CRC_OFFSET) );
-
-        /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
-        status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal, GetPacketData(packet, PARAMS_SIZE),
-                                  packetSize - PARAMS_SIZE );
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if ( (nor->ops->mapped != NULL) && nor->ops->mapped(nor->context) )
+    {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as the device is memory mapped at the address.');
+        status = (memcmp(data, (const void *)address, length) == 0) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+    }
+    else
+    {
+        uint8_t chunk[NOR_COMPARE_CHUNK];
+        uint32_t offset = 0U;
 
-        if (status == CY_DFU_SUCCESS)
+        while ( (status == CY_DFU_SUCCESS) && (offset < length) )
         {
-            if (crc != Cy_DFU_DataChecksum(dataBufferLocal, *dataOffsetLocal, params) )
+            uint32_t size = ((length - offset) < NOR_COMPARE_CHUNK) ? (length - offset) : NOR_COMPARE_CHUNK;
+
+            status = Cy_DFU_NorRead(nor, address + offset, chunk, size);
+            if ( (status == CY_DFU_SUCCESS) && (memcmp(&data[offset], chunk, size) != 0) )
             {
-                status = CY_DFU_ERROR_CHECKSUM;
+                status = CY_DFU_ERROR_VERIFY;
             }
+            offset += size;
         }
-        if (status == CY_DFU_SUCCESS)
-        {
-            status = Cy_DFU_WriteData(address, *dataOffsetLocal, CY_DFU_IOCTL_BHP, params);
-        }
-        if (status == CY_DFU_SUCCESS)
-        {
-            status = Cy_DFU_ReadData (address, *dataOffsetLocal, CY_DFU_IOCTL_COMPARE, params);
-        }
-    } /* if (packetSize >= PARAMS_SIZE) */
-    *dataOffsetLocal = 0U;
+    }
     return (status);
 }
 
 
-#if CY_DFU_OPT_ERASE_DATA != 0
 /*******************************************************************************
-* Function Name: CommandEraseData
+* Function Name: Cy_DFU_NorProgram
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function erases an NVM row or page.
+* Programs the data to an erased range of a serial NOR device with the page
+* program command, one page at a time, and waits for each page for up to
+* \ref CY_DFU_NOR_PROGRAM_TIMEOUT_MS.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor        The serial NOR device initialized with \ref Cy_DFU_NorInit.
+* \param address    The address of the first byte, from \ref cy_stc_dfu_nor_t::address.
+* \param data       The data to program.
+* \param length     The number of the bytes to program.
 *
-* \return See \ref cy_en_dfu_status_t.
+* \return
+* - \ref CY_DFU_SUCCESS if the data is programmed.
+* - \ref CY_DFU_ERROR_ADDRESS if the range is outside the device.
+* - \ref CY_DFU_ERROR_DATA if the interface fails.
+* - \ref CY_DFU_ERROR_TIMEOUT if the device stays busy.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandEraseData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_NorProgram(const cy_stc_dfu_nor_t *nor, uint32_t address, const uint8_t data[],
+                                     uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_ERROR_LENGTH;
-    *rspSize = CY_DFU_RSP_SIZE_0;
-    if (GetPacketDSize(packet) == DATA_PACKET_SIZE_4BYTES)
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t offset = 0U;
+
+    if (!NorRangeValid(nor, address, length))
     {
-        uint32_t address = GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
-        status = Cy_DFU_WriteData(address, 0U, CY_DFU_IOCTL_ERASE, params);
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    while ( (status == CY_DFU_SUCCESS) && (offset < length) )
+    {
+        cy_stc_dfu_nor_cmd_t cmd;
+        uint32_t deviceAddress = (address + offset) - nor->address;
+        /* A page program wraps around at the end of the page */
+        uint32_t size = nor->pageSize - (deviceAddress % nor->pageSize);
+
+        size = ((length - offset) < size) ? (length - offset) : size;
+        NorCmdInit(&cmd, NOR_CMD_PAGE_PROGRAM, nor->addressSize, deviceAddress);
+        cmd.txData = &data[offset];
+        cmd.length = size;
+        status = NorWrite(nor, &cmd, NOR_PROGRAM_POLLS);
+        offset += size;
     }
-    params->dataOffset = 0U;
     return (status);
 }
-#endif /* CY_DFU_OPT_ERASE_DATA != 0 */
 
 
-#if CY_DFU_OPT_VERIFY_DATA != 0
 /*******************************************************************************
-* Function Name: CommandVerifyData
+* Function Name: Cy_DFU_NorErase
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function verifies an NVM row or page.
+* Erases a range of a serial NOR device with the largest erase type that fits
+* at each address, and waits for each erase for up to
+* \ref CY_DFU_NOR_ERASE_TIMEOUT_MS.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor        The serial NOR device initialized with \ref Cy_DFU_NorInit.
+* \param address    The address of the first byte, from \ref cy_stc_dfu_nor_t::address,
+*                   a multiple of the smallest erase size.
+* \param length     The number of the bytes to erase, a multiple of the smallest
+*                   erase size.
 *
-* \return See \ref cy_en_dfu_status_t
+* \return
+* - \ref CY_DFU_SUCCESS if the range is erased.
+* - \ref CY_DFU_ERROR_ADDRESS if the range is outside the device.
+* - \ref CY_DFU_ERROR_LENGTH if the range is not aligned to the smallest erase size.
+* - \ref CY_DFU_ERROR_DATA if the interface fails.
+* - \ref CY_DFU_ERROR_TIMEOUT if the device stays busy.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandVerifyData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_NorErase(const cy_stc_dfu_nor_t *nor, uint32_t address, uint32_t length)
 {
-    cy_en_dfu_status_t status    = CY_DFU_ERROR_LENGTH;
-    uint8_t  *dataBufferLocal =  params->dataBuffer;
-    uint32_t *dataOffsetLocal = &params->dataOffset;
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t offset = 0U;
 
-    uint32_t  packetSize = GetPacketDSize(packet);
-    *rspSize = CY_DFU_RSP_SIZE_0;
-    if (packetSize >= PARAMS_SIZE)
+    if (!NorRangeValid(nor, address, length))
     {
-        uint32_t address = GetU32( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
-        uint32_t crc     = GetU32( GetPacketData(packet, VERIFY_DATA_CRC_OFFSET) );
-
-        /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
-        status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal, GetPacketData(packet, PARAMS_SIZE),
-                                  packetSize - PARAMS_SIZE );
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    else if ( (((address - nor->address) % nor->eraseSize[0U]) != 0U) || ((length % nor->eraseSize[0U]) != 0U) )
+    {
+        status = CY_DFU_ERROR_LENGTH;
+    }
+    else
+    {
+        /* Empty */
+    }
+    while ( (status == CY_DFU_SUCCESS) && (offset < length) )
+    {
+        cy_stc_dfu_nor_cmd_t cmd;
+        uint32_t deviceAddress = (address + offset) - nor->address;
+        uint32_t type = 0U;
+        uint32_t idx;
 
-        if (status == CY_DFU_SUCCESS)
+        for (idx = 1U; (idx < CY_DFU_NOR_ERASE_TYPES) && (nor->eraseSize[idx] != 0U); ++idx)
         {
-            if (crc != Cy_DFU_DataChecksum(dataBufferLocal, *dataOffsetLocal, params) )
+            if ( ((deviceAddress % nor->eraseSize[idx]) == 0U) && ((length - offset) >= nor->eraseSize[idx]) )
             {
-                status = CY_DFU_ERROR_CHECKSUM;
+                type = idx;
             }
         }
-
-        if (status == CY_DFU_SUCCESS)
-        {
-            status = Cy_DFU_ReadData(address, *dataOffsetLocal, CY_DFU_IOCTL_COMPARE, params);
-            status = (status == CY_DFU_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
-        }
+        NorCmdInit(&cmd, nor->eraseOpcode[type], nor->addressSize, deviceAddress);
+        status = NorWrite(nor, &cmd, NOR_ERASE_POLLS);
+        offset += nor->eraseSize[type];
     }
-    *dataOffsetLocal = 0U;
     return (status);
 }
-#endif /* CY_DFU_OPT_VERIFY_DATA != 0 */
 
 
-#if CY_DFU_OPT_SEND_DATA != 0
 /*******************************************************************************
-* Function Name: CommandSendData
+* Function Name: NorCmdInit
+****************************************************************************//**
+*
+* This internal function initializes a serial NOR command without dummy
+* cycles and data.
+*
+* \param cmd            The command to initialize.
+* \param opcode         The command opcode.
+* \param addressSize    The number of the address bytes, 0 if none.
+* \param address        The address in the device.
+*
+*******************************************************************************/
+static void NorCmdInit(cy_stc_dfu_nor_cmd_t *cmd, uint8_t opcode, uint32_t addressSize, uint32_t address)
+{
+    cmd->opcode = opcode;
+    cmd->addressSize = (uint8_t)addressSize;
+    cmd->dummyCycles = 0U;
+    cmd->dataWidth = 1U;
+    cmd->address = address;
+    cmd->txData = NULL;
+    cmd->rxData = NULL;
+    cmd->length = 0U;
+}
+
+
+/*******************************************************************************
+* Function Name: NorSfdpRead
+****************************************************************************//**
+*
+* This internal function reads the SFDP tables of a serial NOR device.
+*
+* \param nor        The serial NOR device.
+* \param address    The SFDP address.
+* \param data       The buffer for the tables.
+* \param length     The number of the bytes to read.
+*
+* \return The status of the interface.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t NorSfdpRead(const cy_stc_dfu_nor_t *nor, uint32_t address, uint8_t data[],
+                                      uint32_t length)
+{
+    cy_stc_dfu_nor_cmd_t cmd;
+
+    NorCmdInit(&cmd, NOR_CMD_READ_SFDP, 3U, address);
+    cmd.dummyCycles = NOR_DUMMY_CYCLES;
+    cmd.rxData = data;
+    cmd.length = length;
+    return (nor->ops->command(&cmd, nor->context));
+}
+
+
+/*******************************************************************************
+* Function Name: NorRegisterRead
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function handles the Send Data DFU command.
+* This internal function reads a one-byte register of a serial NOR device.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor        The serial NOR device.
+* \param opcode     The read command of the register.
+* \param value      The pointer to the value read.
 *
-* \return See \ref cy_en_dfu_status_t.
+* \return The status of the interface.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandSendData(uint8_t  *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t NorRegisterRead(const cy_stc_dfu_nor_t *nor, uint8_t opcode, uint8_t *value)
 {
-    cy_en_dfu_status_t status;
-    uint32_t packetSize = GetPacketDSize(packet);
-    uint8_t  *dataBufferLocal =  params->dataBuffer;
-    uint32_t *dataOffsetLocal = &params->dataOffset;
-    *rspSize = CY_DFU_RSP_SIZE_0;
-
-    /* Data may be sent with the Program Data DFU command, so copy it to dataBuffer */
-    status = CopyToDataBuffer(dataBufferLocal, dataOffsetLocal,
-                                GetPacketData(packet, PACKET_DATA_NO_OFFSET),
-                                packetSize);
+    cy_stc_dfu_nor_cmd_t cmd;
 
-    return (status);
+    NorCmdInit(&cmd, opcode, 0U, 0U);
+    cmd.rxData = value;
+    cmd.length = 1U;
+    return (nor->ops->command(&cmd, nor->context));
 }
-#endif /* CY_DFU_OPT_SEND_DATA != 0 */
 
 
-#if CY_DFU_OPT_VERIFY_APP != 0
 /*******************************************************************************
-* Function Name: CommandVerifyApp
+* Function Name: NorWaitReady
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function handles the Verify Application DFU command.
+* This internal function polls the status register of a serial NOR device
+* every \ref CY_DFU_NOR_POLL_INTERVAL_US until the write in progress bit is
+* cleared.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* \param nor    The serial NOR device.
+* \param polls  The largest number of the status polls.
 *
-* \return See \ref cy_en_dfu_status_t.
+* \return
+* - \ref CY_DFU_SUCCESS if the device is ready.
+* - \ref CY_DFU_ERROR_DATA if the interface fails.
+* - \ref CY_DFU_ERROR_TIMEOUT if the device is still busy.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandVerifyApp(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t NorWaitReady(const cy_stc_dfu_nor_t *nor, uint32_t polls)
 {
-    cy_en_dfu_status_t status  = CY_DFU_ERROR_LENGTH;
-    uint32_t packetSize = GetPacketDSize(packet);
-    *rspSize = CY_DFU_RSP_SIZE_0;
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    uint8_t value = NOR_STATUS_WIP;
+    uint32_t count = 0U;
 
-
-    if ( (packetSize == sizeof(uint32_t) ) || (packetSize == VERIFY_APP_DATA_SIZE) )
+    while ( (status == CY_DFU_ERROR_TIMEOUT) && (count <= polls) )
     {
-        uint32_t app = (uint32_t) *GetPacketData(packet,PACKET_DATA_NO_OFFSET);
-        if (app < CY_DFU_MAX_APPS)
+        if (NorRegisterRead(nor, NOR_CMD_READ_STATUS, &value) != CY_DFU_SUCCESS)
         {
-            status = Cy_DFU_ValidateApp(app, params);
+            status = CY_DFU_ERROR_DATA;
+        }
+        else if ((value & NOR_STATUS_WIP) == 0U)
+        {
+            status = CY_DFU_SUCCESS;
         }
         else
         {
-            status = CY_DFU_ERROR_VERIFY;
+            Cy_SysLib_DelayUs((uint16_t)CY_DFU_NOR_POLL_INTERVAL_US);
+            ++count;
         }
     }
-
-    if ( (status == CY_DFU_SUCCESS) || (status == CY_DFU_ERROR_VERIFY) )
-    {
-        uint8_t *valid = GetPacketData(packet, PACKET_DATA_NO_OFFSET);
-        *valid = (status == CY_DFU_SUCCESS) ? 1U : 0U;
-        status = CY_DFU_SUCCESS;
-        *rspSize = CY_DFU_RSP_SIZE_VERIFY_APP;
-    }
     return (status);
 }
-#endif /* CY_DFU_OPT_VERIFY_APP != 0 */
 
 
-#if ((CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)) || defined(CY_DOXYGEN)
 /*******************************************************************************
-* Function Name: Cy_DFU_SetAppMetadata
+* Function Name: NorWrite
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function sets application metadata and updates a metadata checksum.
-* \note If the application metadata is the same as already
-* present in the NVM, then the NVM is not rewritten and this function only exits.
-* \note This function uses params->dataBuffer for the read and write NVM.
+* This internal function sends a program, erase or register write command to
+* a serial NOR device after the write enable command, and waits until the
+* device is ready.
 *
-* \param appId           The application number to update metadata for.
-* \param verifyAddress   An application verified area start address
-* \param verifySize      The size of verified application area
-* \param params          The pointer to a DFU parameters structure.
-*                        See \ref cy_stc_dfu_params_t.
+* \param nor    The serial NOR device.
+* \param cmd    The command.
+* \param polls  The largest number of the status polls.
 *
-* \return See \ref cy_en_dfu_status_t
+* \return The status of the interface or \ref NorWaitReady.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_SetAppMetadata(uint32_t appId, uint32_t verifyAddress, uint32_t verifySize,
-                                                   cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t NorWrite(const cy_stc_dfu_nor_t *nor, const cy_stc_dfu_nor_cmd_t *cmd, uint32_t polls)
 {
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
-    uint32_t metadataAddress = 0U;
-    uint32_t metadataLength  = 0U;
-    if ((params == NULL) || (appId >= CY_DFU_MAX_APPS))
+    cy_stc_dfu_nor_cmd_t enable;
+    cy_en_dfu_status_t status;
+
+    NorCmdInit(&enable, NOR_CMD_WRITE_ENABLE, 0U, 0U);
+    status = nor->ops->command(&enable, nor->context);
+    if (status == CY_DFU_SUCCESS)
     {
-        status = CY_DFU_ERROR_UNKNOWN;
+        status = nor->ops->command(cmd, nor->context);
     }
     if (status == CY_DFU_SUCCESS)
     {
-        metadataAddress = ElfSymbolToAddr(&__cy_boot_metadata_addr  );
-        metadataLength  = ElfSymbolToAddr(&__cy_boot_metadata_length);
-        status = Cy_DFU_ReadData(metadataAddress, metadataLength, CY_DFU_IOCTL_READ, params);
+        status = NorWaitReady(nor, polls);
     }
-    if (status == CY_DFU_SUCCESS)
+    if (status != CY_DFU_SUCCESS)
     {
-        uint32_t getVerifyAddress = GetU32(params->dataBuffer + (appId * METADATA_BYTES_PER_APP));
-        uint32_t getVerifySize      = GetU32(params->dataBuffer + (appId * METADATA_BYTES_PER_APP) +
-                                            METADATA_APP_LENGTH_OFFSET);
-        if ( (getVerifyAddress != verifyAddress) || ( getVerifySize != verifySize) )
-        {
-            uint32_t crc;
-            PutU32(params->dataBuffer, (appId * METADATA_BYTES_PER_APP)     , verifyAddress);
-            PutU32(params->dataBuffer, (appId * METADATA_BYTES_PER_APP) + METADATA_APP_LENGTH_OFFSET, verifySize);
-            crc = Cy_DFU_DataChecksum(params->dataBuffer, metadataLength - CRC_CHECKSUM_LENGTH, params);
-            PutU32(params->dataBuffer, metadataLength - CRC_CHECKSUM_LENGTH, crc);
-            status = Cy_DFU_WriteData(metadataAddress, metadataLength, CY_DFU_IOCTL_WRITE, params);
-        }
+        CY_DFU_LOG_ERR("Serial NOR command 0x%X failed at 0x%X", (unsigned int)cmd->opcode,
+                       (unsigned int)cmd->address);
     }
     return (status);
 }
-#endif /* (CY_DFU_METADATA_WRITABLE != 0 CY_DFU_FLOW == CY_DFU_BASIC_FLOW) || defined(CY_DOXYGEN) */
 
 
 /*******************************************************************************
-* Function Name: CommandSetAppMetadata
+* Function Name: NorQuadEnable
 ****************************************************************************//**
-* This is a helper function for Cy_DFU_Continue().
-* This function handles the Set Application Metadata DFU command.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* This internal function sets the quad enable bit of a serial NOR device as
+* the quad enable requirements field of the SFDP basic flash parameter table
+* (JESD216B DWORD 15) describes.
 *
-* \return See \ref cy_en_dfu_status_t
+* \param nor            The serial NOR device.
+* \param requirement    The quad enable requirements field.
+*
+* \return
+* - \ref CY_DFU_SUCCESS if the quad enable bit is set.
+* - \ref CY_DFU_ERROR_DATA if the field is not supported or the interface fails.
+* - \ref CY_DFU_ERROR_TIMEOUT if the device stays busy.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandSetAppMetadata(uint8_t *packet, uint32_t *rspSize,
-                                                     cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t NorQuadEnable(const cy_stc_dfu_nor_t *nor, uint32_t requirement)
 {
     cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    cy_stc_dfu_nor_cmd_t cmd;
+    uint8_t value[2U] = { 0U, 0U };
 
-    *rspSize = CY_DFU_RSP_SIZE_0;
-
-    if (GetPacketDSize(packet) != DATA_LENGTH)
-    {
-        status = CY_DFU_ERROR_LENGTH;
-    }
-
-    if (status == CY_DFU_SUCCESS)
+    switch (requirement)
     {
-        /* Data offsets 0, 1, 5 are defined in the DFU Packet Structure */
-        uint32_t app       =      *( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
+        case 0U:    /* No quad enable bit */
+            break;
 
-    #if (CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)
-        uint32_t verifyAddress = GetU32( GetPacketData(packet, SET_APP_METADATA_OFFSET) );
-        uint32_t verifySize   = GetU32( GetPacketData(packet, SET_APP_METADATA_LENGTH_OFFSET) );
+        case 1U:    /* Bit 1 of status register 2, written with status register 1 */
+        case 4U:
+        case 5U:
+            status = NorRegisterRead(nor, NOR_CMD_READ_STATUS, &value[0U]);
+            if ( (status == CY_DFU_SUCCESS) && (requirement != 1U) )
+            {   /* Status register 2 cannot be read with the requirement 1 */
+                status = NorRegisterRead(nor, NOR_CMD_READ_STATUS2, &value[1U]);
+            }
+            if ( (status == CY_DFU_SUCCESS) && ((value[1U] & 0x02U) == 0U) )
+            {
+                value[1U] |= 0x02U;
+                NorCmdInit(&cmd, NOR_CMD_WRITE_STATUS, 0U, 0U);
+                cmd.txData = value;
+                cmd.length = 2U;
+                status = NorWrite(nor, &cmd, NOR_ERASE_POLLS);
+            }
+            break;
 
-        status = Cy_DFU_SetAppMetadata(app, verifyAddress, verifySize, params);
-    #endif /*(CY_DFU_METADATA_WRITABLE != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW)*/
+        case 3U:    /* Bit 6 of status register 1 */
+            status = NorRegisterRead(nor, NOR_CMD_READ_STATUS, &value[0U]);
+            if ( (status == CY_DFU_SUCCESS) && ((value[0U] & 0x40U) == 0U) )
+            {
+                value[0U] |= 0x40U;
+                NorCmdInit(&cmd, NOR_CMD_WRITE_STATUS, 0U, 0U);
+                cmd.txData = value;
+                cmd.length = 1U;
+                status = NorWrite(nor, &cmd, NOR_ERASE_POLLS);
+            }
+            break;
 
-        params->appId = app;
+        default:    /* Bit 7 of status register 2 with the commands 3Fh/3Eh, or bit 1 with 35h/31h */
+            status = CY_DFU_ERROR_DATA;
+            break;
     }
     return (status);
 }
 
-#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
 
-#if CY_DFU_OPT_GET_METADATA != 0
 /*******************************************************************************
-* Function Name: CommandGetMetadata
+* Function Name: NorRangeValid
 ****************************************************************************//**
-* This is a helper function for Cy_DFU_Continue().
-* This function handles the Get Metadata DFU command.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+* This internal function checks that a range is inside an initialized serial
+* NOR device.
 *
-* \return See \ref cy_en_dfu_status_t
+* \param nor        The serial NOR device.
+* \param address    The address of the first byte of the range.
+* \param length     The number of the bytes of the range.
+*
+* \return True if the range is inside the device.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandGetMetadata(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+static bool NorRangeValid(const cy_stc_dfu_nor_t *nor, uint32_t address, uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
-    uint32_t locRspSize = CY_DFU_RSP_SIZE_0;
+    return ( (nor != NULL) && (nor->size != 0U) && ((address - nor->address) < nor->size) &&
+             (length <= (nor->size - (address - nor->address))) );
+}
 
-    if (packet == NULL)
-    {
-        status = CY_DFU_ERROR_UNKNOWN;
-    }
-    if (status == CY_DFU_SUCCESS)
-    {
-        if (GetPacketDSize(packet) != DATA_PACKET_SIZE_4BYTES)
-        {
-            status = CY_DFU_ERROR_LENGTH;
-        }
-    }
-    if (status == CY_DFU_SUCCESS)
-    {
-        uint32_t fromAddr = GetU16( GetPacketData(packet, PACKET_DATA_NO_OFFSET) );
-        uint32_t toAddr   = GetU16( GetPacketData(packet, GET_METADATA_TO_OFFSET) );
-        if ( (toAddr < fromAddr)
-            || ( ( (toAddr - fromAddr) + CY_DFU_PACKET_MIN_SIZE) > CY_DFU_SIZEOF_CMD_BUFFER) )
-        {
-            status  = CY_DFU_ERROR_DATA;
-        }
-        else
-        {
-            uint32_t metadataAddr    = ElfSymbolToAddr(&__cy_boot_metadata_addr  );
-            uint32_t metadataLength  = ElfSymbolToAddr(&__cy_boot_metadata_length);
 
-            status = Cy_DFU_ValidateMetadata(metadataAddr, params);
-            if (status == CY_DFU_SUCCESS)
-            {
-                status = Cy_DFU_ReadData(metadataAddr, metadataLength, CY_DFU_IOCTL_READ, params);
-            }
-            if (status == CY_DFU_SUCCESS)
-            {
-                locRspSize = (toAddr - fromAddr);
-                (void) memmove( GetPacketData(packet, PACKET_DATA_NO_OFFSET),
-                                &(params->dataBuffer[fromAddr]),
-                                locRspSize);
-                status = CY_DFU_SUCCESS;
-            }
-        }
-    }
-    *rspSize = locRspSize;
-    return (status);
+/*******************************************************************************
+* Function Name: Cy_DFU_NorRegionInit
+****************************************************************************//**
+*
+* Describes an initialized serial NOR device as an NVM region, see
+* \ref group_dfu_ucase_nvm_regions: the program unit is the page, the erase
+* unit is the smallest erase type, and the functions are the serial NOR
+* driver functions. The region is empty if the device is not initialized.
+*
+* \param nor        The serial NOR device initialized with \ref Cy_DFU_NorInit.
+*                   It is the context of the region.
+* \param region     The region to fill.
+*
+*******************************************************************************/
+void Cy_DFU_NorRegionInit(cy_stc_dfu_nor_t *nor, cy_stc_dfu_nvm_region_t *region)
+{
+    region->address = nor->address;
+    region->size = nor->size;
+    region->programSize = (nor->pageSize != 0U) ? nor->pageSize : 1U;
+    region->eraseSize = nor->eraseSize[0U];
+    region->read = &NorRegionRead;
+    region->compare = &NorRegionCompare;
+    region->erase = &NorRegionErase;
+    region->program = &NorRegionProgram;
+    region->poll = NULL;
+    region->context = nor;
 }
-#endif /* CY_DFU_OPT_GET_METADATA != 0 */
 
 
-#if CY_DFU_OPT_SET_EIVECTOR != 0
 /*******************************************************************************
-* Function Name: CommandSetEIVector
+* Function Name: NorRegionRead
 ****************************************************************************//**
 *
-* This is a helper function for Cy_DFU_Continue().
-* This function copies the Encryption Initial Vector value from the DFU
-* command buffer to the buffer pointed by
-* \code params->encryptionVector \endcode.
+* The read function of an NVM region of a serial NOR device, see
+* \ref Cy_DFU_NorRegionInit and \ref Cy_DFU_NorRead.
 *
-* \param packet     The pointer to the DFU packet buffer.
-* \param rspSize    The pointer to a response packet size.
-* \param params     The pointer to a DFU parameters structure.
-*                   See \ref cy_stc_dfu_params_t .
+*******************************************************************************/
+static cy_en_dfu_status_t NorRegionRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                        uint32_t length)
+{
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.5','The context of a serial NOR region is the device.');
+    return (Cy_DFU_NorRead((const cy_stc_dfu_nor_t *)region->context, address, data, length));
+}
+
+
+/*******************************************************************************
+* Function Name: NorRegionCompare
+****************************************************************************//**
 *
-* \return See \ref cy_en_dfu_status_t.
+* The compare function of an NVM region of a serial NOR device, see
+* \ref Cy_DFU_NorRegionInit and \ref Cy_DFU_NorCompare.
 *
 *******************************************************************************/
-static cy_en_dfu_status_t CommandSetEIVector(uint8_t *packet, uint32_t *rspSize, cy_stc_dfu_params_t *params)
+static cy_en_dfu_status_t NorRegionCompare(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                           const uint8_t data[], uint32_t length)
 {
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
-    *rspSize = CY_DFU_RSP_SIZE_0;
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.5','The context of a serial NOR region is the device.');
+    return (Cy_DFU_NorCompare((const cy_stc_dfu_nor_t *)region->context, address, data, length));
+}
 
-    uint32_t size = GetPacketDSize(packet);
 
-    if (( (size == 0U) ||  (size == DATA_PACKET_SIZE_8BYTES)
-        || (size == DATA_PACKET_SIZE_16BYTES) ) && (params->encryptionVector != NULL))
-    {
-CY_MISRA_FP_LINE('MISRA C-2012 Rule 21.18','Per C99 standard (7.21.1/2) 0 value is allowed with no undefined behaviour. ');
-        (void) memcpy((void*)params->encryptionVector, (const void*)GetPacketData(packet, PACKET_DATA_NO_OFFSET), size);
-    }
-    else
-    {
-        status = CY_DFU_ERROR_DATA;
-    }
+/*******************************************************************************
+* Function Name: NorRegionErase
+****************************************************************************//**
+*
+* The erase function of an NVM region of a serial NOR device, see
+* \ref Cy_DFU_NorRegionInit and \ref Cy_DFU_NorErase.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t NorRegionErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
+{
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.5','The context of a serial NOR region is the device.');
+    return (Cy_DFU_NorErase((const cy_stc_dfu_nor_t *)region->context, address, length));
+}
 
-    return (status);
+
+/*******************************************************************************
+* Function Name: NorRegionProgram
+****************************************************************************//**
+*
+* The program function of an NVM region of a serial NOR device, see
+* \ref Cy_DFU_NorRegionInit and \ref Cy_DFU_NorProgram.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t NorRegionProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                           const uint8_t data[], uint32_t length)
+{
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.5','The context of a serial NOR region is the device.');
+    return (Cy_DFU_NorProgram((const cy_stc_dfu_nor_t *)region->context, address, data, length));
 }
-#endif /* CY_DFU_OPT_SET_EIVECTOR != 0 */
-#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+#endif /* CY_DFU_OPT_NOR != 0 */
 
 
 /*******************************************************************************
@@ -2250,6 +6793,8 @@ static cy_en_dfu_status_t ContinueHelper(uint32_t command, uint8_t *packet, uint
     case CY_DFU_CMD_PROGRAM_DATA:
         CY_DFU_LOG_INF("Receive Program command");
         status = CommandProgramData(packet, rspSize, params);
+        /* The response of a non-blocking write is sent when it completes, see ProgramDataPoll() */
+        *noResponse = (status == CY_DFU_IN_PROGRESS);
         break;
 
 #if CY_DFU_OPT_VERIFY_DATA != 0
@@ -2312,6 +6857,20 @@ static cy_en_dfu_status_t ContinueHelper(uint32_t command, uint8_t *packet, uint
         break;
 #endif /* (CY_DFU_OPT_SET_EIVECTOR != 0) && (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) */
 
+#if CY_DFU_OPT_STATS != 0
+    case CY_DFU_CMD_GET_STATS:
+        CY_DFU_LOG_INF("Receive Get Stats command");
+        status = CommandGetStats(packet, rspSize, params);
+        break;
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+#if CY_DFU_OPT_RESUME != 0
+    case CY_DFU_CMD_GET_PROGRESS:
+        CY_DFU_LOG_INF("Receive Get Progress command");
+        status = CommandGetProgress(packet, rspSize, params);
+        break;
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
     default:
     #if CY_DFU_OPT_CUSTOM_CMD != 0
         if((NULL != params->handlerCmd) && (command >= CY_DFU_USER_CMD_START))
@@ -2342,6 +6901,11 @@ static cy_en_dfu_status_t ContinueHelper(uint32_t command, uint8_t *packet, uint
 * back a response if needed. See description of Host Command/Response Protocol
 * in [AN213924](https://www.infineon.com/an213924) DFU SDK User Guide.
 *
+* With \ref CY_DFU_OPT_NVM_ASYNC, the function returns \ref CY_DFU_IN_PROGRESS
+* while the NVM write of a Program Data command continues, and the next calls
+* poll the write and send the response instead of waiting for a packet, see
+* \ref group_dfu_ucase_nvm_regions.
+*
 * \param state      The pointer to a state variable, that is updated by
 *                   the function. See \ref group_dfu_macro_state.
 * \param params     The pointer to a DFU parameters structure.
@@ -2356,28 +6920,56 @@ cy_en_dfu_status_t Cy_DFU_Continue(uint32_t *state, cy_stc_dfu_params_t *params)
     uint8_t *packet = params->packetBuffer; /* Receive/Transmit buffer */
 
     uint32_t rspSize = CY_DFU_RSP_SIZE_0;
+    uint32_t command = STATS_NO_COMMAND;
     bool noResponse = false;        /* Indicates whether to send a response packet back to the Host */
+    bool entered = false;           /* Indicates that a valid Enter command is received */
 
     CY_ASSERT(params->timeout != 0U);
     CY_ASSERT(params->dataBuffer != NULL);
     CY_ASSERT(params->packetBuffer != NULL);
 
 
+#if CY_DFU_OPT_NVM_ASYNC != 0
+    if (cy_dfu_programPending.active)
+    {
+        /* The Program Data command in packetBuffer waits for its write, no packet is read meanwhile */
+        status = ProgramDataPoll(params);
+        if (status != CY_DFU_IN_PROGRESS)
+        {
+            STATS_STAGE_BEGIN(params);
+            (void) WritePacket(status, packet, rspSize);
+            STATS_STAGE_END(params, CY_DFU_STATS_RESPOND);
+            STATS_PACKET_END(params, CY_DFU_CMD_PROGRAM_DATA, status);
+        }
+    }
+    else
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
     if ( (*state == CY_DFU_STATE_NONE) || (*state == CY_DFU_STATE_UPDATING) )
     {
-        status = ReadVerifyPacket(packet, &noResponse, params->timeout);
+        STATS_PACKET_BEGIN(params);
+        status = ReadVerifyPacket(packet, &noResponse, params);
         if (status == CY_DFU_SUCCESS)
         {
-            uint32_t command = GetPacketCommand(packet);
+            command = GetPacketCommand(packet);
 
             if      (command == CY_DFU_CMD_ENTER)
             {
                 CY_DFU_LOG_INF("Receive Start command");
                 status = CommandEnter(packet, &rspSize, state, params);
+                entered = (status == CY_DFU_SUCCESS);
             }
             else if (command == CY_DFU_CMD_EXIT)
             {
                 CY_DFU_LOG_INF("Receive Exit command");
+                status = NVM_CACHE_FLUSH(params);
+                if (status != CY_DFU_SUCCESS)
+                {
+                    CY_DFU_LOG_ERR("NVM cache write-back failed");
+                }
+                PROGRESS_FLUSH(params);
+            #if CY_DFU_OPT_CRYPTO_HW != 0
+                Cy_DFU_CryptoRelease();
+            #endif /* CY_DFU_OPT_CRYPTO_HW != 0 */
                 *state = CY_DFU_STATE_FINISHED;
                 noResponse = true;
             }
@@ -2394,7 +6986,20 @@ cy_en_dfu_status_t Cy_DFU_Continue(uint32_t *state, cy_stc_dfu_params_t *params)
 
         if (!noResponse)
         {
+            STATS_STAGE_BEGIN(params);
             (void) WritePacket(status, packet, rspSize);
+            STATS_STAGE_END(params, CY_DFU_STATS_RESPOND);
+        }
+        if (status != CY_DFU_IN_PROGRESS)
+        {
+            /* A Program Data packet with a non-blocking write ends in its response */
+            STATS_PACKET_END(params, command, status);
+        }
+
+        if (entered)
+        {
+            /* Continue the session through the transport the Enter command came from */
+            Cy_DFU_TransportLock();
         }
     }
     else
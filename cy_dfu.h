@@ -742,6 +742,38 @@
 *    \code COMPONENTS+=SOFTFP \endcode
 *
 ********************************************************************************
+* \subsection group_dfu_ucase_usb_vendor Firmware Update via USB vendor-specific (bulk) transport
+********************************************************************************
+*
+* The vendor-specific class uses a pair of bulk endpoints without the virtual COM
+* port (CDC) or the report (HID) layer on top of them. With whole-row packets,
+* the full-speed bulk transfers are significantly faster than the interrupt
+* endpoints of the HID class.
+* Specific steps for the USB vendor transport support:
+* - Add the USB vendor transport components to the project's Makefile:
+*    \code COMPONENTS+=USBD_BASE \endcode
+*    \code COMPONENTS+=DFU_USB_VENDOR \endcode
+*    \code COMPONENTS+=SOFTFP \endcode
+* - Select the \ref CY_DFU_USB_VENDOR transport in \ref Cy_DFU_TransportStart.
+* - The device reports the Microsoft OS descriptors with the WinUSB compatible
+*   ID, so Windows binds the WinUSB driver without an INF file. On Linux and
+*   macOS the device is accessible with libusb.
+* - The host sends each DFU packet as a bulk OUT transfer and reads the response
+*   from the bulk IN endpoint. A packet may be split between several bulk
+*   transfers, the transport frames the packets using the length field of the
+*   packet header.
+* - The product ID, the endpoint size and the Microsoft OS vendor code can be
+*   configured using the CY_DFU_USB_VENDOR_PRODUCT_ID,
+*   CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET and CY_DFU_USB_VENDOR_MS_VENDOR_CODE
+*   macros, for example:
+*    \code DEFINES+=CY_DFU_USB_VENDOR_PRODUCT_ID=0xF21F \endcode
+* - The default product ID is 0xF21E. The product ID must differ from the one
+*   used by the emUSB CDC and HID transports (0xF21D) and by any other USB
+*   configuration of the device: Windows caches the Microsoft OS descriptor
+*   query per VID/PID, so a VID/PID that has already enumerated without these
+*   descriptors never gets the WinUSB driver.
+*
+********************************************************************************
 * \subsection group_dfu_ucase_canfd Firmware Update via CAN FD transport
 ********************************************************************************
 *
@@ -754,6 +786,151 @@
 *    \code DEFINES+=DFU_CANFD_IRQ_PRIORITY=5 \endcode
 *
 ********************************************************************************
+* \subsection group_dfu_ucase_transport_ops Adding a transport interface
+********************************************************************************
+*
+* Each transport template provides a constant \ref cy_stc_dfu_transport_ops_t
+* structure with its start, stop, reset, read, and write functions, the largest
+* packet it can transfer at once, and its capabilities
+* (\ref group_dfu_macro_transport_caps). The dfu_user.c templates keep a table
+* of the transports enabled with the COMPONENTS variable,
+* \ref Cy_DFU_TransportStart selects one of them by the
+* \ref cy_en_dfu_transport_t value and the rest of the Transport Management
+* functions call the selected transport through the table.
+* To add a transport:
+* - Implement the five transport functions and define the
+*   \ref cy_stc_dfu_transport_ops_t structure for them.
+* - Add a pointer to the structure into the transport table in dfu_user.c.
+*
+* A bootloader built with several transports can listen to all of them: pass
+* \ref CY_DFU_ALL to \ref Cy_DFU_TransportStart. The templates then share the
+* \ref cy_stc_dfu_params_t::timeout between the transports on each read and
+* respond through the transport the packet came from. When a valid Enter command
+* arrives, \ref Cy_DFU_Continue calls \ref Cy_DFU_TransportLock and the rest of
+* the transports are stopped for the rest of the session.
+* The emUSB CDC, emUSB HID and USB vendor transports share the one emUSB-Device
+* stack, so the CAT1 template listens only to the first of them in its
+* transport table; the others can still be selected one at a time.
+*
+* With \ref CY_DFU_OPT_ZERO_COPY enabled, the DFU SDK reads the packets of a
+* transport with \ref CY_DFU_TRANSPORT_CAP_ZERO_COPY in parts: the header, the
+* Program Data parameters, the data, and the footer. The data of the Send Data
+* and Program Data commands lands straight in
+* \ref cy_stc_dfu_params_t::dataBuffer, which removes the copy out of
+* \ref cy_stc_dfu_params_t::packetBuffer. The other commands are received
+* into the packet buffer as before.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_stats Update session statistics
+********************************************************************************
+*
+* With \ref CY_DFU_OPT_STATS enabled, \ref Cy_DFU_Continue measures each
+* received packet and adds it to the \ref cy_stc_dfu_cmd_stats_t record of its
+* command: the number of packets and failures, the shortest, the longest, and
+* the total time, a log2 latency histogram, and the time of each stage
+* (\ref group_dfu_macro_stats). The time of a packet starts with the read from
+* the transport, so the receive stage also includes the time the DFU Host
+* takes to send the packet. Timeouts without a packet are not counted.
+*
+* To collect the statistics, set \ref cy_stc_dfu_params_t::stats to a
+* zero-initialized \ref cy_stc_dfu_stats_t before the update session. The
+* application reads them with \ref Cy_DFU_GetCommandStats, the DFU Host with
+* the Get Stats DFU command (\ref CY_DFU_CMD_GET_STATS): the one-byte data is
+* the command to report, the response is its \ref cy_stc_dfu_cmd_stats_t.
+*
+* The NVM layer in dfu_user.c measures its own operations with
+* \ref Cy_DFU_StatsNvmBegin and \ref Cy_DFU_StatsNvmEnd into
+* \ref cy_stc_dfu_stats_t::nvm: the number, the time and the bytes of the
+* erase, program and read operations, and the failures with the driver status
+* of the last one. Together with the stages of the DFU commands, they tell
+* whether a slow update is limited by the transport or by the NVM. The
+* application reads them from \ref cy_stc_dfu_stats_t::nvm, the DFU Host with
+* the Get Stats DFU command with \ref CY_DFU_STATS_SEL_NVM.
+*
+* The Get Stats DFU command fails with \ref CY_DFU_ERROR_LENGTH when the record
+* and the packet framing do not fit \ref CY_DFU_SIZEOF_CMD_BUFFER:
+* \ref cy_stc_dfu_cmd_stats_t takes 64 + 4 x \ref CY_DFU_STATS_HIST_BINS bytes,
+* more than the default buffer of a device with 64-byte rows. Increase
+* \ref CY_DFU_SIZEOF_CMD_BUFFER or decrease \ref CY_DFU_STATS_HIST_BINS to read
+* the statistics over the transport on such devices.
+*
+* The times are taken with \ref Cy_DFU_StatsTimestamp, by default the DWT
+* cycle counter of the CPU. The user's code can implement it with another
+* timer, for example, on the devices without DWT.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_resume Resumable update sessions
+********************************************************************************
+*
+* With \ref CY_DFU_OPT_RESUME enabled, an update session interrupted by a reset
+* or a broken link can be continued from the rows it has not programmed yet.
+* The progress of the session is kept in a \ref cy_stc_dfu_progress_record_t:
+* the identity of the image and a bitmap of its rows, set when a Program Data
+* DFU command has programmed and compared a row. The record is written to
+* a progress area of \ref CY_DFU_PROGRESS_SLOTS NVM rows, by default the rows
+* right after the metadata row (\ref Cy_DFU_GetProgressAddress), each time to
+* the next row with a higher sequence number. An interrupted write leaves the
+* previous record valid. The shipped linker scripts leave these rows unused;
+* keep them outside of the applications in the user's linker scripts.
+*
+* To enable it, set \ref cy_stc_dfu_params_t::progress to a zero-initialized
+* \ref cy_stc_dfu_progress_t. The DFU Host starts the session with the Get
+* Progress DFU command (\ref CY_DFU_CMD_GET_PROGRESS) after Enter:
+*
+* | Request data        | Size | Description                                        |
+* |---------------------|------|----------------------------------------------------|
+* | Image ID            | 4    | The identity of the image, e.g. its CRC-32         |
+* | Start address       | 4    | The address of the first row of the image          |
+* | Length              | 4    | The length of the image in bytes                   |
+* | Bitmap offset       | 2    | The first bitmap byte to report                    |
+*
+* | Response data       | Size | Description                                        |
+* |---------------------|------|----------------------------------------------------|
+* | Row count           | 4    | The number of the rows of the image                |
+* | Done count          | 4    | The number of the programmed rows                  |
+* | Bitmap              | 0-N  | The bitmap from the offset, as much as fits        |
+*
+* If the image ID, the start address, and the length are the same as in the
+* current record, the session is resumed, and the DFU Host sends only the rows
+* with a clear bit. Otherwise, a new record of the image with an empty bitmap
+* is written first. The record is written after each \ref CY_DFU_PROGRESS_INTERVAL
+* newly programmed rows, on the Erase Data of a programmed row, and on Exit.
+* A successful Verify Application ends the session with an empty record.
+* The values are little-endian.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_binary_log Binary logging
+********************************************************************************
+*
+* The CY_DFU_LOG_ERR/WRN/INF/DBG messages selected by \ref CY_DFU_LOG_LEVEL are
+* formatted with printf() or, with CY_DFU_CUSTOM_LOG defined, with sprintf() and
+* output by the user's Cy_DFU_Log(), where they are written. At
+* \ref CY_DFU_LOG_LEVEL_INFO, it is done for every received packet, which takes
+* milliseconds when the output is a UART.
+*
+* With CY_DFU_BINARY_LOG defined in the compiler options, a log call only stores
+* the address of its format string and up to four integer arguments into
+* cy_dfu_log_ring, a lock-free single-producer, single-consumer RAM ring of
+* CY_DFU_LOG_RING_SIZE records (32 by default, a power of two). When the ring is
+* full, the new messages are dropped and counted. The messages are formatted
+* later:
+*   - by Cy_DFU_LogDrain(), called by the application outside of the update
+*     hot path, for example, when \ref Cy_DFU_Continue returns without a
+*     packet or from a low-priority task. It outputs the messages with printf(),
+*     or with Cy_DFU_Log() when CY_DFU_CUSTOM_LOG is defined;
+*   - on the host, from a dump of cy_dfu_log_ring, by host/dfu_log_decode.py,
+*     which reads the format strings from the ELF file of the application.
+*
+* With CY_DFU_TOKENIZED_LOG defined, the format strings are not placed in the
+* image: each log call is compiled to the 32-bit token of its format string,
+* the 65599 hash computed by the compiler. Cy_DFU_LogToken() outputs the token
+* and the arguments, 5 to 21 bytes per message, with Cy_DFU_LogOutput(), by
+* default to stdout, or records them into cy_dfu_log_ring when
+* CY_DFU_BINARY_LOG is also defined. host/dfu_log_tokens.py generates the
+* dictionary of the tokens from the sources as a post-build step, and
+* host/dfu_log_decode.py --tokens decodes the output or the ring with it.
+*
+********************************************************************************
 * \subsection group_dfu_ucase_checksum Change checksum types
 ********************************************************************************
 *
@@ -789,6 +966,14 @@
 * - Allocate the ".cy_app_signature" section with a 20-byte array in the main
 *   of the loading application.
 *
+* With \ref CY_DFU_OPT_SHA256 set to 1, the application checksum is SHA-256
+* instead: \ref __cy_boot_signature_size = 32 (CY_BOOT_SIGNATURE_SIZE for the
+* ARM compiler), and \<MCUELFTOOL\> --sign app.elf SHA256. SHA-256 is calculated
+* with the crypto hardware block if \ref CY_DFU_OPT_CRYPTO_HW is set, in software
+* otherwise, on any device. The DFU SDK keeps the crypto block enabled between
+* the calculations and disables it on the Exit DFU command, or with
+* \ref Cy_DFU_CryptoRelease.
+*
 ********************************************************************************
 * \subsection group_dfu_ucase_multiapp Multi-application DFU project
 ********************************************************************************
@@ -797,7 +982,8 @@
 * by memory size and metadata size. The maximum size
 * of DFU metadata is limited to the size of the flash row, because metadata
 * should be in a single flash row. For example, the 512-byte metadata supports
-* up to 63 applications.
+* up to 63 applications. The multi-row metadata format removes this limit, see
+* \ref group_dfu_ucase_metadata_v2.
 * An arbitrary number of applications can be protected from overwriting. Such
 * a protected application is called "Golden Image".
 * See \ref section_dfu_quick_start for a steps to setup basic 2 application DFU
@@ -830,6 +1016,187 @@
 * dfu_user.h file of the loader project: \ref CY_DFU_OPT_GOLDEN_IMAGE
 * set to 1 to enable the Golden Image functionality.
 * \ref CY_DFU_GOLDEN_IMAGE_IDS lists the number of images that to be protected.
+* The template Cy_DFU_WriteData() validates a golden image on the first write to
+* it in an update session and keeps the result until the session ends, see
+* \ref Cy_DFU_GoldenImageInvalidate.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_metadata_v2 Multi-row metadata
+********************************************************************************
+*
+* With \ref CY_DFU_OPT_METADATA_V2, the metadata spans
+* \ref CY_DFU_METADATA_LENGTH bytes: a header row with
+* \ref cy_stc_dfu_metadata_header_t, which keeps the format version and the
+* geometry of the records, and the rows of \ref cy_stc_dfu_app_metadata_t
+* records, \ref CY_DFU_METADATA_RECORDS_PER_ROW in each row. Each record has
+* the verified area of an application, its version, flags and digest, and its
+* own CRC-32C. The record of an application is found by its number without
+* reading the header, and \ref Cy_DFU_SetAppRecord and
+* \ref Cy_DFU_SetAppMetadata rewrite only the row of the record.
+*
+* To use it:
+* - Set __cy_boot_metadata_length to \ref CY_DFU_METADATA_LENGTH and increase
+*   the flash_boot_meta region of the linker scripts to the same size (plus
+*   the progress area with \ref CY_DFU_OPT_RESUME).
+* - The template dfu_user.c places the header and the App0 and App1 records
+*   in the ".cy_boot_metadata" section. As with the single-row metadata, their
+*   CRCs are written with the first metadata update: if the header is not
+*   valid, \ref Cy_DFU_SetAppRecord writes the CRC of each record and then the
+*   header.
+*
+* \ref Cy_DFU_ValidateMetadata checks the header and the CRCs of the
+* \ref CY_DFU_MAX_APPS records. The Get Metadata DFU command returns the bytes
+* of the whole multi-row metadata.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_metadata_journal Metadata journal
+********************************************************************************
+*
+* With \ref CY_DFU_OPT_METADATA_JOURNAL, the metadata area of
+* \ref CY_DFU_METADATA_LENGTH bytes is a journal of
+* \ref CY_DFU_METADATA_JOURNAL_ROWS rows instead of the header and the fixed
+* records. Each update of the application metadata writes a
+* \ref cy_stc_dfu_app_metadata_t record with the application number and the
+* next sequence number to the next row of the journal, and never erases a row
+* with the current record of an application: the rows of the superseded
+* records are reused when the journal wraps around. The erases of the metadata
+* rows are spread over the journal, and a reset during an update leaves the
+* previous record of the application current. So the journal must be in the
+* memory that is erased in rows: on the memory erased in larger units, see
+* \ref Cy_DFU_GetEraseSize, such as the sectors of the CY_IP_M7CPUSS flash, the
+* metadata updates fail with \ref CY_DFU_ERROR_ADDRESS, and the template
+* dfu_user.c for CAT1 asserts in \ref Cy_DFU_TransportStart.
+*
+* The newest record with a valid CRC-32C of each application is current. The
+* DFU SDK finds them with one scan of the journal on the first use after
+* \ref Cy_DFU_Init and keeps their rows and verified areas in RAM:
+* \ref Cy_DFU_GetAppMetadata does not read the NVM. The records with the
+* sequence number 0 are the initial records from the ".cy_boot_metadata"
+* section of the template dfu_user.c: they have no CRC-32C, so a record with
+* the sequence number 0 is accepted only in the journal row of its application
+* number, and only while the application has no record with a valid CRC-32C.
+*
+* \ref Cy_DFU_ValidateMetadata checks that each application has a record, and
+* the Get Metadata DFU command returns the bytes of the journal.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_swap Slot swap
+********************************************************************************
+*
+* \ref Cy_DFU_CopyApp overwrites the destination, and the slot is left with a
+* part of each image if a reset interrupts it. With \ref CY_DFU_OPT_SWAP,
+* \ref Cy_DFU_SwapApp exchanges the images of two slots instead: the primary
+* slot the application executes from, and the secondary slot the new image is
+* downloaded to. The previous image remains in the secondary slot, and
+* \ref Cy_DFU_SwapRevert restores it without a new download, for example when
+* the new image fails its self-test.
+*
+* The slots are exchanged in blocks of \ref CY_DFU_SWAP_BLOCK_SIZE bytes through
+* a scratch area of the same size, in three steps for each block: the secondary
+* block to the scratch area, the primary block to the secondary slot, and the
+* scratch area to the primary slot. After each step, a status record with the
+* next step is written to the next of the \ref CY_DFU_SWAP_STATUS_SLOTS rows
+* of the swap status area, with a higher sequence number and a CRC-32C. None of
+* the steps overwrites the data it reads, so after a reset,
+* \ref Cy_DFU_SwapResume repeats the step of the current record and completes
+* the swap. The rows that already hold the data of a step are not written again.
+*
+* The swap area is the status rows followed by the scratch area, at the address
+* returned by the user's \ref Cy_DFU_GetSwapAddress. On the memory erased in
+* units larger than a row, such as the sectors of the CY_IP_M7CPUSS flash, each
+* status record takes a whole erase unit of its own, so writing a record never
+* erases the previous one, and \ref CY_DFU_SWAP_BLOCK_SIZE must be a multiple of
+* the erase units of the slots and of the scratch area: \ref Cy_DFU_SwapApp
+* returns \ref CY_DFU_ERROR_BAD_PARAM otherwise. App0 calls
+* \ref Cy_DFU_SwapResume at the start, before it validates the applications.
+* The metadata is not changed by a swap: the verified area of the primary
+* application must cover both images.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_nor External serial NOR
+********************************************************************************
+*
+* With \ref CY_DFU_OPT_NOR, an image can be downloaded to an external serial
+* NOR device on the SMIF (QSPI) interface, for example a staging slot at the
+* CY_APP1_SMIF_ADDR address of the linker scripts, and the internal flash is
+* left for the slots the applications execute from.
+*
+* The user's code allocates a \ref cy_stc_dfu_nor_t with the
+* \ref cy_stc_dfu_nor_ops_t interface to the device and the address it is
+* mapped at, and calls \ref Cy_DFU_NorInit. It reads the SFDP (JESD216)
+* parameter table of the device: its size, the page size, the erase types
+* (usually 4 KB and 64 KB), the address bytes, and the 1-1-4 fast read with
+* the quad enable bit of the device. \ref Cy_DFU_NorProgram writes pages with
+* the page program command, \ref Cy_DFU_NorErase uses the largest erase type
+* that fits the aligned range, and both poll the status register until the
+* device is ready, for \ref CY_DFU_NOR_PROGRAM_TIMEOUT_MS and
+* \ref CY_DFU_NOR_ERASE_TIMEOUT_MS at most. \ref Cy_DFU_NorRead and
+* \ref Cy_DFU_NorCompare read the memory mapped content directly while the
+* device is in the XIP mode, and with the fast read command otherwise.
+*
+* The template dfu_user.c for CAT1 implements the interface with the SMIF
+* driver, initializes the device in \ref Cy_DFU_TransportStart, and adds it
+* to the NVM regions with \ref Cy_DFU_NorRegionInit: the program unit is the
+* page, and a write at the start of an erase sector of the smallest erase type
+* erases the sector, so an image is written in the ascending order.
+*
+********************************************************************************
+* \subsection group_dfu_ucase_nvm_regions NVM regions
+********************************************************************************
+*
+* The dfu_user.c templates route \ref Cy_DFU_WriteData and
+* \ref Cy_DFU_ReadData by the address through a table of the NVM regions, like
+* the transport table. Each \ref cy_stc_dfu_nvm_region_t describes an address
+* range of a memory: the internal flash, the work flash blocks, the emulated
+* EEPROM, a serial NOR or RAM, with its program and erase units and its read,
+* compare, erase and program functions. \ref Cy_DFU_NvmRegionFind finds the
+* region of an address range, \ref Cy_DFU_NvmWrite checks the alignment to the
+* program unit of the region, erases the erase units that start in the range,
+* and programs the whole range with one call, and \ref Cy_DFU_NvmRead reads or
+* compares in place when the region has no read or compare function. With
+* \ref CY_DFU_OPT_STATS, both measure each NVM operation.
+*
+* So the length of a Program Data command is a multiple of the program unit of
+* its region rather than the row size, and each memory is accessed with its
+* own granularity. The templates still keep the application checks of
+* \ref Cy_DFU_WriteData in their region index, and return the erase unit of
+* the region of an address with \ref Cy_DFU_GetEraseSize: \ref Cy_DFU_CopyApp
+* compares and rewrites the destination by whole erase units. To add a memory, define a
+* region for it and add it to the table in dfu_user.c. A memory that needs no
+* erase, such as RAM, sets eraseSize to 0 and the erase function to NULL.
+*
+* With \ref CY_DFU_OPT_NVM_CACHE, \ref Cy_DFU_NvmWrite collects the Program
+* Data rows of an erase unit in a RAM copy of the unit instead of writing each
+* row: the first row loads the unit from the NVM, the rows are merged into it
+* in any order, and the unit is erased once and programmed as a whole when a
+* row of another unit arrives, before any other write, and on the Verify
+* Application and Exit commands, or when the application calls
+* \ref Cy_DFU_NvmFlush. A unit that already matches the NVM is not erased. So
+* a sector of the CY_IP_M7CPUSS flash or the serial NOR is erased once per
+* update rather than on each row, and a host may send its rows out of order.
+* Reads of the cached unit are served from RAM. Only the regions with the
+* erase function and an erase unit of at most \ref CY_DFU_NVM_CACHE_SIZE are
+* cached. With \ref CY_DFU_OPT_RESUME, each progress record write flushes the
+* cache, so in the basic flow the record waits until the rows of the erase
+* unit being written are all programmed, and \ref CY_DFU_PROGRESS_INTERVAL should be at least the
+* rows of an erase unit. The other writes, such as those of
+* \ref Cy_DFU_CopyApp and the slot swap, are not cached: they write whole
+* erase units in order, and the swap relies on the order of its writes to
+* survive a power loss.
+*
+* A region whose memory is written with start-and-poll functions, such as
+* cyhal_flash_start_write() and cyhal_flash_is_operation_complete(), sets the
+* poll function, and its program function returns \ref CY_DFU_IN_PROGRESS once
+* the first row is started. With \ref CY_DFU_OPT_NVM_ASYNC, the Program Data
+* command returns then: \ref Cy_DFU_Continue returns \ref CY_DFU_IN_PROGRESS
+* without a response, and its next calls poll the write with
+* \ref CY_DFU_IOCTL_POLL instead of reading a packet, until the write completes
+* and the command finishes with the compare and the response. So the loop that
+* calls \ref Cy_DFU_Continue keeps running during the program time, for
+* example to service a watchdog or the other interfaces. The other writes,
+* and the write-back of \ref CY_DFU_OPT_NVM_CACHE, wait for the poll function.
+* The code that runs meanwhile must not read the flash sector being written,
+* as with any non-blocking flash operation of the device.
 *
 ********************************************************************************
 * \subsection group_dfu_ucase_cyacd2 Creation of the CYACD2 file
@@ -1125,6 +1492,8 @@ extern "C"{
 #define CY_DFU_CMD_SET_APP_META    (0x4CU) /**< DFU command: Set Application Metadata   */
 #define CY_DFU_CMD_GET_METADATA    (0x3CU) /**< DFU command: Get Metadata               */
 #define CY_DFU_CMD_SET_EIVECTOR    (0x4DU) /**< DFU command: Set EI Vector              */
+#define CY_DFU_CMD_GET_STATS       (0x4EU) /**< DFU command: Get Statistics             */
+#define CY_DFU_CMD_GET_PROGRESS    (0x4FU) /**< DFU command: Get Progress               */
 
 #define CY_DFU_USER_CMD_START      (0x50U) /**< DFU user commands: min value */
 #define CY_DFU_USER_CMD_END        (0xFFU) /**< DFU user commands: max value */
@@ -1146,7 +1515,9 @@ extern "C"{
 *   * 1, Data received from/to be sent to the DFU Host.
 *        May require encryption/decryption or any other special treatment.
          E.g. read/write a data from/to an address with an offset.
-* - Bit 2: Reserved.
+* - Bit 2:
+*   * 1, Poll the write that returned \ref CY_DFU_IN_PROGRESS, see
+*        \ref CY_DFU_OPT_NVM_ASYNC.
 * - Bit 3: Reserved.
 * - Bit 4 - 31: Unused in DFU SDK. Up to the user to specify it.
 */
@@ -1159,6 +1530,8 @@ extern "C"{
 
 #define CY_DFU_IOCTL_BHP           (0x02U) /**< Data from/to DFU Host. It may require decryption. */
 
+#define CY_DFU_IOCTL_POLL          (0x04U) /**< Poll the write that returned \ref CY_DFU_IN_PROGRESS */
+
 /** \} group_dfu_macro_ioctl */
 
 /**
@@ -1171,6 +1544,57 @@ extern "C"{
 
 /** \} group_dfu_macro_response_size */
 
+/**
+* \defgroup group_dfu_macro_transport_caps Transport Capabilities
+* \{
+* The bits of the \ref cy_stc_dfu_transport_ops_t::capabilities field.
+*/
+
+/** The transport moves the data between the peripheral and the buffers with DMA */
+#define CY_DFU_TRANSPORT_CAP_DMA       (0x01U)
+/**
+* The transport can receive a DFU packet in parts: the read function never returns
+* more bytes than are left in the current DFU packet and keeps the rest of the
+* packet for the next call. The DFU SDK can then place the packet payload
+* straight into the destination buffer.
+*/
+#define CY_DFU_TRANSPORT_CAP_ZERO_COPY (0x02U)
+/** The read and write functions start the transfer and return without waiting for its end */
+#define CY_DFU_TRANSPORT_CAP_ASYNC     (0x04U)
+
+/** \} group_dfu_macro_transport_caps */
+
+/**
+* \defgroup group_dfu_macro_stats Statistics Stages
+* \{
+* The indexes of \ref cy_stc_dfu_cmd_stats_t::stageCycles and of the
+* \ref cy_stc_dfu_nvm_stats_t arrays, see \ref group_dfu_ucase_stats.
+*/
+
+#define CY_DFU_STATS_RECEIVE       (0U)    /**< Receiving the packet, including waiting for the DFU Host */
+#define CY_DFU_STATS_CHECKSUM      (1U)    /**< Verifying the packet checksum and the data checksum */
+#define CY_DFU_STATS_WRITE         (2U)    /**< Writing or erasing the NVM with \ref Cy_DFU_WriteData */
+#define CY_DFU_STATS_COMPARE       (3U)    /**< Comparing the written NVM with the data with \ref Cy_DFU_ReadData */
+#define CY_DFU_STATS_RESPOND       (4U)    /**< Transmitting the response */
+#define CY_DFU_STATS_STAGE_NUM     (5U)    /**< The number of the stages */
+
+/**
+* The number of DFU commands with statistics: every DFU command of
+* \ref group_dfu_macro_commands and one more record for the custom commands,
+* the unsupported commands, and the packets that failed verification.
+*/
+#define CY_DFU_STATS_CMD_NUM       (15U)
+
+#define CY_DFU_STATS_NVM_ERASE     (0U)    /**< NVM operation: erase a row or a sector */
+#define CY_DFU_STATS_NVM_PROGRAM   (1U)    /**< NVM operation: program (or erase and program) a row */
+#define CY_DFU_STATS_NVM_READ      (2U)    /**< NVM operation: read or compare with the data buffer */
+#define CY_DFU_STATS_NVM_OP_NUM    (3U)    /**< The number of the NVM operations */
+
+/** The Get Stats DFU command data to request \ref cy_stc_dfu_nvm_stats_t */
+#define CY_DFU_STATS_SEL_NVM       (0x00U)
+
+/** \} group_dfu_macro_stats */
+
 /** DFU SDK PDL ID */
 #define CY_DFU_ID                  CY_PDL_DRV_ID(0x06U)
 
@@ -1205,7 +1629,9 @@ typedef enum
     /** One or more of input parameters are invalid */
     CY_DFU_ERROR_BAD_PARAM = CY_DFU_ID | CY_PDL_STATUS_ERROR | 0x50U,
     /** An unknown DFU error, this shall not happen */
-    CY_DFU_ERROR_UNKNOWN   = CY_DFU_ID | CY_PDL_STATUS_ERROR | 0x0FU
+    CY_DFU_ERROR_UNKNOWN   = CY_DFU_ID | CY_PDL_STATUS_ERROR | 0x0FU,
+    /** The NVM write is started and continues, see \ref CY_DFU_OPT_NVM_ASYNC */
+    CY_DFU_IN_PROGRESS     = CY_DFU_ID | CY_PDL_STATUS_INFO  | 0x01U
 } cy_en_dfu_status_t;
 
 /** Used to select one of the transport interface for the update session */
@@ -1217,6 +1643,13 @@ typedef enum
     CY_DFU_USB_CDC = 0x04U, /**< USB CDC transport interface */
     CY_DFU_USB_HID = 0x05U, /**< USB HID transport interface */
     CY_DFU_CANFD   = 0x06U, /**< CAN FD transport interface */
+    CY_DFU_USB_VENDOR = 0x07U, /**< USB vendor-specific class (bulk) transport interface */
+    /**
+    * All the transport interfaces compiled into the project. \ref Cy_DFU_TransportStart
+    * starts all of them and the update session locks on the interface that
+    * delivers the first valid Enter command, see \ref Cy_DFU_TransportLock.
+    */
+    CY_DFU_ALL     = 0xFFU,
 } cy_en_dfu_transport_t;
 
 
@@ -1233,6 +1666,336 @@ typedef cy_en_dfu_status_t (*Cy_DFU_CustomCommandHandler) (uint32_t command, uin
                                                             uint32_t *rspSize, struct cy_stc_dfu_params_s *params,
                                                             bool *noResponse);
 
+/**
+* The type for the progress handlers of \ref Cy_DFU_CopyAppProgress, called
+* after each erase unit with the number of the bytes copied so far.
+*/
+typedef void (*Cy_DFU_CopyProgressHandler) (uint32_t copied, uint32_t length, struct cy_stc_dfu_params_s *params);
+
+#if (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN)
+/**
+* The statistics of a DFU command, see \ref group_dfu_ucase_stats.
+* The times are in \ref Cy_DFU_StatsTimestamp ticks. The Get Stats DFU command
+* responds with this structure as is, in little-endian byte order.
+*/
+typedef struct
+{
+    uint64_t totalCycles;                               /**< The total time of the command packets */
+    /** The time of each stage of the command packets, see \ref group_dfu_macro_stats */
+    uint64_t stageCycles[CY_DFU_STATS_STAGE_NUM];
+    uint32_t count;                                     /**< The number of the command packets */
+    uint32_t errors;                                    /**< The number of the command packets that failed */
+    uint32_t minCycles;                                 /**< The shortest time of a command packet */
+    uint32_t maxCycles;                                 /**< The longest time of a command packet */
+    /** The latency histogram, see \ref CY_DFU_STATS_HIST_SHIFT */
+    uint32_t histogram[CY_DFU_STATS_HIST_BINS];
+} cy_stc_dfu_cmd_stats_t;
+
+/**
+* The statistics of the NVM operations of \ref Cy_DFU_WriteData and
+* \ref Cy_DFU_ReadData, indexed with the NVM operations of
+* \ref group_dfu_macro_stats. The times are in \ref Cy_DFU_StatsTimestamp ticks.
+* The Get Stats DFU command with \ref CY_DFU_STATS_SEL_NVM responds with this
+* structure as is, in little-endian byte order.
+*/
+typedef struct
+{
+    uint64_t cycles[CY_DFU_STATS_NVM_OP_NUM];     /**< The total time of the operations */
+    uint32_t count[CY_DFU_STATS_NVM_OP_NUM];      /**< The number of the operations */
+    uint32_t maxCycles[CY_DFU_STATS_NVM_OP_NUM];  /**< The longest time of an operation */
+    /** The number of bytes erased, programmed or read by the successful operations */
+    uint32_t bytes[CY_DFU_STATS_NVM_OP_NUM];
+    uint32_t failures[CY_DFU_STATS_NVM_OP_NUM];   /**< The number of the failed operations */
+    uint32_t lastResult;                          /**< The driver status of the last failed operation */
+    uint32_t lastAddress;                         /**< The address of the last failed operation */
+} cy_stc_dfu_nvm_stats_t;
+
+/**
+* The statistics of \ref Cy_DFU_Continue. Allocated by the user's code,
+* zero-initialized and set to \ref cy_stc_dfu_params_t::stats.
+*/
+typedef struct
+{
+    cy_stc_dfu_cmd_stats_t cmd[CY_DFU_STATS_CMD_NUM];  /**< The statistics of each DFU command */
+    cy_stc_dfu_nvm_stats_t nvm;                        /**< The statistics of the NVM operations */
+    /** \cond INTERNAL */
+    uint32_t nvmStart;
+    uint32_t packetStart;
+    uint32_t stageStart;
+    uint32_t stage[CY_DFU_STATS_STAGE_NUM];
+    /** \endcond */
+} cy_stc_dfu_stats_t;
+#endif /* (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN) */
+
+#if (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN)
+/** The size in bytes of the header of \ref cy_stc_dfu_progress_record_t */
+#define CY_DFU_PROGRESS_HEADER_SIZE    (24U)
+
+/** The largest number of the image rows a progress record tracks */
+#define CY_DFU_PROGRESS_MAX_ROWS       ((CY_NVM_SIZEOF_ROW - CY_DFU_PROGRESS_HEADER_SIZE) * 8U)
+
+/**
+* The progress record of an update session. It is written as is to a row of
+* the progress area, see \ref group_dfu_ucase_resume.
+*/
+typedef struct
+{
+    uint32_t magic;             /**< Marks a progress record */
+    uint32_t crc;               /**< The \ref Cy_DFU_DataChecksum of the record after this field */
+    uint32_t sequence;          /**< Incremented with each write, the record with the highest one is current */
+    uint32_t imageId;           /**< The identity of the image, set by the DFU Host */
+    uint32_t startAddress;      /**< The address of the first row of the image */
+    uint32_t rowCount;          /**< The number of the rows of the image, 0 if there is no update session */
+    /** Bit N (bit N % 8 of byte N / 8) is set if row N of the image is programmed */
+    uint8_t  bitmap[CY_NVM_SIZEOF_ROW - CY_DFU_PROGRESS_HEADER_SIZE];
+} cy_stc_dfu_progress_record_t;
+
+/**
+* The progress of a resumable update session. Allocated by the user's code,
+* zero-initialized and set to \ref cy_stc_dfu_params_t::progress.
+*/
+typedef struct
+{
+    cy_stc_dfu_progress_record_t record;   /**< The current progress record */
+    /** \cond INTERNAL */
+    uint32_t slot;                          /* The progress area row of the last written record */
+    uint32_t pending;                       /* The rows programmed since the last written record */
+    bool     loaded;                        /* The record is read from the progress area */
+    bool     active;                        /* The DFU Host has started or resumed the session */
+    /** \endcond */
+} cy_stc_dfu_progress_t;
+#endif /* (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN) */
+
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || defined(CY_DOXYGEN)
+/** The size in bytes of a SHA-256 digest */
+#define CY_DFU_SHA256_SIZE             (32U)
+
+/** The size in bytes of a SHA-256 message block */
+#define CY_DFU_SHA256_BLOCK_SIZE       (64U)
+
+/**
+* The context of a streaming SHA-256 calculation, see \ref Cy_DFU_Sha256Init.
+*/
+typedef struct
+{
+    /** \cond INTERNAL */
+    uint32_t state[8U];                         /* The intermediate hash value */
+    uint32_t length;                            /* The number of the bytes hashed */
+    uint32_t blockSize;                         /* The number of the bytes in block */
+    uint8_t  block[CY_DFU_SHA256_BLOCK_SIZE];   /* The incomplete message block */
+    /** \endcond */
+} cy_stc_dfu_sha256_t;
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || defined(CY_DOXYGEN) */
+
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_V2 != 0)) || defined(CY_DOXYGEN)
+/** The magic number of the metadata header, "DFUM" */
+#define CY_DFU_METADATA_MAGIC          (0x4D554644UL)
+
+/** The version of the metadata format in the metadata header */
+#define CY_DFU_METADATA_VERSION        (2U)
+
+/** The size in bytes of \ref cy_stc_dfu_app_metadata_t in the NVM */
+#define CY_DFU_METADATA_RECORD_SIZE    (64U)
+
+/** The size in bytes of the application digest in the application metadata */
+#define CY_DFU_METADATA_DIGEST_SIZE    (32U)
+
+/** The magic number of a record of the metadata journal, "DFUJ" */
+#define CY_DFU_METADATA_JOURNAL_MAGIC  (0x4A554644UL)
+
+/** The number of the application metadata records in an NVM row */
+#define CY_DFU_METADATA_RECORDS_PER_ROW    (CY_NVM_SIZEOF_ROW / CY_DFU_METADATA_RECORD_SIZE)
+
+#if (CY_DFU_OPT_METADATA_JOURNAL != 0) || defined(CY_DOXYGEN)
+/** The size in bytes of the metadata journal, \ref CY_DFU_METADATA_JOURNAL_ROWS rows */
+#define CY_DFU_METADATA_LENGTH         (CY_NVM_SIZEOF_ROW * CY_DFU_METADATA_JOURNAL_ROWS)
+#else
+/** The size in bytes of the metadata: the header row and the rows of the application records */
+#define CY_DFU_METADATA_LENGTH         (CY_NVM_SIZEOF_ROW * (1U + \
+                                        ((CY_DFU_MAX_APPS + (CY_DFU_METADATA_RECORDS_PER_ROW - 1U)) / \
+                                         CY_DFU_METADATA_RECORDS_PER_ROW)))
+#endif /* (CY_DFU_OPT_METADATA_JOURNAL != 0) || defined(CY_DOXYGEN) */
+
+/**
+* The metadata header, at the start of the first metadata row, see
+* \ref group_dfu_ucase_metadata_v2.
+*/
+typedef struct
+{
+    uint32_t magic;             /**< \ref CY_DFU_METADATA_MAGIC */
+    uint16_t version;           /**< \ref CY_DFU_METADATA_VERSION */
+    uint16_t recordSize;        /**< \ref CY_DFU_METADATA_RECORD_SIZE */
+    uint32_t appCount;          /**< The number of the application records, \ref CY_DFU_MAX_APPS */
+    uint32_t rowSize;           /**< The size of the metadata rows, CY_NVM_SIZEOF_ROW */
+    uint32_t crc;               /**< The \ref Cy_DFU_DataChecksum of the header before this field */
+} cy_stc_dfu_metadata_header_t;
+
+/**
+* The metadata record of an application. Record N is at offset
+* (N % \ref CY_DFU_METADATA_RECORDS_PER_ROW) * \ref CY_DFU_METADATA_RECORD_SIZE
+* of metadata row 1 + N / \ref CY_DFU_METADATA_RECORDS_PER_ROW, or at the start
+* of a row of the metadata journal with \ref CY_DFU_OPT_METADATA_JOURNAL.
+*/
+typedef struct
+{
+    uint32_t verifyAddress;     /**< The start address of the application verified area */
+    uint32_t verifySize;        /**< The size of the application verified area */
+    uint32_t version;           /**< The application version, not interpreted by the DFU SDK */
+    uint32_t flags;             /**< The application flags, not interpreted by the DFU SDK */
+    uint8_t  digest[CY_DFU_METADATA_DIGEST_SIZE];   /**< The application digest, not interpreted by the DFU SDK */
+    uint32_t appId;             /**< The application number of a journal record */
+    uint32_t sequence;          /**< The sequence number of a journal record, the highest one is current */
+    uint32_t magic;             /**< \ref CY_DFU_METADATA_JOURNAL_MAGIC in a journal record */
+    uint32_t crc;               /**< The \ref Cy_DFU_DataChecksum of the record before this field */
+} cy_stc_dfu_app_metadata_t;
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_V2 != 0)) || defined(CY_DOXYGEN) */
+
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0)) || defined(CY_DOXYGEN)
+/**
+* The running checksum of the image of an update session: CRC-32C, or SHA-256
+* with \ref CY_DFU_OPT_SHA256. Allocated by the user's code and set to
+* \ref cy_stc_dfu_params_t::digest.
+*
+* The Set Application Metadata DFU command starts it for the verified area of
+* the application. The Program Data DFU command adds each row programmed at
+* the end of the covered part; the rows programmed ahead of it are left for
+* the Verify Application DFU command, which reads the rest of the verified
+* area from the NVM and compares the checksum with the application checksum
+* without reading the covered part. Programming or erasing a row of the
+* covered part stops the digest, and the Verify Application DFU command
+* calls \ref Cy_DFU_ValidateApp instead.
+*/
+typedef struct
+{
+    /** \cond INTERNAL */
+    uint32_t appId;             /* The application the digest is for */
+    uint32_t startAddress;      /* The start of the verified area */
+    uint32_t endAddress;        /* The end of the verified area, the checksum is here */
+    uint32_t nextAddress;       /* The CRC covers the verified area up to this address */
+#if CY_DFU_OPT_SHA256 != 0
+    cy_stc_dfu_sha256_t sha;    /* The SHA-256 of the verified area up to nextAddress */
+#else
+    uint32_t crc;               /* The CRC-32C remainder before the final XOR */
+#endif /* CY_DFU_OPT_SHA256 != 0 */
+    uint32_t aheadRows;         /* The rows programmed after nextAddress, read again by Verify Application */
+    bool     valid;             /* The checksum matches the NVM from startAddress up to nextAddress */
+    /** \endcond */
+} cy_stc_dfu_digest_t;
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0)) || defined(CY_DOXYGEN) */
+
+#if (CY_DFU_OPT_NOR != 0) || defined(CY_DOXYGEN)
+/** The largest number of the erase types of a serial NOR device */
+#define CY_DFU_NOR_ERASE_TYPES         (4U)
+
+/**
+* A command to a serial NOR device, see \ref cy_stc_dfu_nor_ops_t::command.
+* The opcode and the address are sent on one data line.
+*/
+typedef struct
+{
+    uint8_t  opcode;            /**< The command opcode */
+    uint8_t  addressSize;       /**< The number of the address bytes, 0 if the command has no address */
+    uint8_t  dummyCycles;       /**< The number of the dummy cycles after the address, with the mode cycles */
+    uint8_t  dataWidth;         /**< The number of the data lines: 1, 2 or 4 */
+    uint32_t address;           /**< The address in the NOR device */
+    const uint8_t *txData;      /**< The data to transmit after the address, or NULL */
+    uint8_t  *rxData;           /**< The buffer for the data to receive after the dummy cycles, or NULL */
+    uint32_t length;            /**< The number of the bytes to transmit or receive */
+} cy_stc_dfu_nor_cmd_t;
+
+/**
+* The interface to a serial NOR device of \ref cy_stc_dfu_nor_t, provided by
+* the user's code, see \ref group_dfu_ucase_nor.
+*/
+typedef struct
+{
+    /**
+    * Sends a command to the NOR device and transmits or receives its data.
+    * Returns \ref CY_DFU_SUCCESS, or \ref CY_DFU_ERROR_DATA if the interface
+    * fails. The memory mapped content must reflect each program and erase
+    * command when the next command is sent, for example the XIP cache is
+    * invalidated.
+    */
+    cy_en_dfu_status_t (*command)(const cy_stc_dfu_nor_cmd_t *cmd, void *context);
+    /**
+    * Returns true if the content of the NOR device can be read at
+    * \ref cy_stc_dfu_nor_t::address, for example in the XIP mode of the SMIF.
+    * NULL if it is never memory mapped.
+    */
+    bool (*mapped)(void *context);
+} cy_stc_dfu_nor_ops_t;
+
+/**
+* A serial NOR device, see \ref Cy_DFU_NorInit. Allocated by the user's code,
+* which sets the first three fields; \ref Cy_DFU_NorInit sets the rest from
+* the SFDP tables of the device.
+*/
+typedef struct
+{
+    const cy_stc_dfu_nor_ops_t *ops;    /**< The interface to the device */
+    void     *context;                  /**< Passed to the interface functions */
+    uint32_t address;                   /**< The address of the device content for the DFU SDK, the XIP address */
+    uint32_t size;                      /**< The size of the device in bytes */
+    uint32_t pageSize;                  /**< The size in bytes of the page program */
+    /** The sizes in bytes of the erase types in ascending order, 0 for the unused ones */
+    uint32_t eraseSize[CY_DFU_NOR_ERASE_TYPES];
+    uint8_t  eraseOpcode[CY_DFU_NOR_ERASE_TYPES];   /**< The opcodes of the erase types */
+    uint8_t  readOpcode;                /**< The opcode of the fast read, quad output if supported */
+    uint8_t  readDummyCycles;           /**< The dummy and mode cycles of the fast read */
+    uint8_t  readWidth;                 /**< The number of the data lines of the fast read */
+    uint8_t  addressSize;               /**< The number of the address bytes of the read, program and erase */
+} cy_stc_dfu_nor_t;
+#endif /* (CY_DFU_OPT_NOR != 0) || defined(CY_DOXYGEN) */
+
+
+/**
+* An NVM region of \ref Cy_DFU_NvmWrite and \ref Cy_DFU_NvmRead: the address
+* range of a memory with its program and erase units and the driver functions,
+* see \ref group_dfu_ucase_nvm_regions. The functions get the region, so one
+* driver serves several regions, and return \ref CY_DFU_SUCCESS, or
+* \ref CY_DFU_ERROR_DATA if the memory fails.
+*/
+typedef struct cy_stc_dfu_nvm_region_s
+{
+    uint32_t address;           /**< The start address of the region */
+    uint32_t size;              /**< The size of the region in bytes */
+    uint32_t programSize;       /**< The program unit in bytes, the writes are aligned to it */
+    /**
+    * The erase unit in bytes. Before a write, the erase units that start in the
+    * written range are erased, so the rows of an erase unit are written in the
+    * ascending order. 0 if the memory is programmed without an erase.
+    */
+    uint32_t eraseSize;
+    /** Reads the content. NULL if the region is memory mapped, it is read in place then */
+    cy_en_dfu_status_t (*read)(const struct cy_stc_dfu_nvm_region_s *region, uint32_t address, uint8_t data[],
+                               uint32_t length);
+    /**
+    * Compares the content with the data, returns \ref CY_DFU_ERROR_VERIFY if
+    * it differs. NULL if the region is memory mapped, it is compared in place then.
+    */
+    cy_en_dfu_status_t (*compare)(const struct cy_stc_dfu_nvm_region_s *region, uint32_t address,
+                                  const uint8_t data[], uint32_t length);
+    /**
+    * Erases the erase units of the range, or the program units if eraseSize is 0.
+    * NULL if the memory has no erase, an erase programs zeros then.
+    */
+    cy_en_dfu_status_t (*erase)(const struct cy_stc_dfu_nvm_region_s *region, uint32_t address, uint32_t length);
+    /**
+    * Programs the program units of the range. NULL if the region is read-only.
+    * May return \ref CY_DFU_IN_PROGRESS if the region has the poll function,
+    * the data must not change until the write completes then.
+    */
+    cy_en_dfu_status_t (*program)(const struct cy_stc_dfu_nvm_region_s *region, uint32_t address,
+                                  const uint8_t data[], uint32_t length);
+    /**
+    * Continues the write that the program function returned
+    * \ref CY_DFU_IN_PROGRESS for: returns \ref CY_DFU_IN_PROGRESS until the
+    * whole range is programmed. NULL if the program function blocks.
+    */
+    cy_en_dfu_status_t (*poll)(const struct cy_stc_dfu_nvm_region_s *region);
+    void *context;              /**< The driver data of the region */
+} cy_stc_dfu_nvm_region_t;
+
 
 /**
  * Working parameters for some DFU SDK APIs to be initialized before calling DFU API.
@@ -1292,6 +2055,38 @@ typedef struct cy_stc_dfu_params_s
     Cy_DFU_CustomCommandHandler handlerCmd; /**< User handler for the custom commands.*/
 #endif /* CY_DFU_OPT_CUSTOM_CMD != 0 */
 
+#if CY_DFU_OPT_ZERO_COPY != 0
+    /**
+     * Internal, the number of data bytes of the received packet that the
+     * transport has placed straight into \c dataBuffer at \c dataOffset.
+     */
+    uint32_t  dataReceived;
+#endif /* CY_DFU_OPT_ZERO_COPY != 0 */
+
+#if CY_DFU_OPT_STATS != 0
+    /**
+     * The pointer to the statistics of \ref Cy_DFU_Continue, or NULL to
+     * not collect them. See \ref group_dfu_ucase_stats.
+     */
+    cy_stc_dfu_stats_t *stats;
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+#if CY_DFU_OPT_RESUME != 0
+    /**
+     * The pointer to the progress of a resumable update session, or NULL to
+     * not record it. See \ref group_dfu_ucase_resume.
+     */
+    cy_stc_dfu_progress_t *progress;
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0)
+    /**
+     * The pointer to the running CRC-32C of the image, or NULL to verify
+     * the whole application. See \ref cy_stc_dfu_digest_t.
+     */
+    cy_stc_dfu_digest_t *digest;
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_INLINE_DIGEST != 0) */
+
 } cy_stc_dfu_params_t;
 
 /**
@@ -1305,6 +2100,32 @@ typedef struct
     uint8_t  enterRevision;              /**< Silicon Revision for a device */
     uint8_t  enterDFUVersion[3];         /**< The DFU SDK version */
 } cy_stc_dfu_enter_t;
+
+/**
+* The operations and the capabilities of a transport interface.
+* Each transport template provides a constant instance of this structure, the
+* user's code selects one of them in \ref Cy_DFU_TransportStart and calls the
+* transport through it. See \ref Cy_DFU_TransportGetOps.
+*/
+typedef struct
+{
+    cy_en_dfu_transport_t transport;   /**< The transport interface the operations belong to */
+    void (*start)(void);               /**< Starts the transport, see \ref Cy_DFU_TransportStart */
+    void (*stop)(void);                /**< Stops the transport, see \ref Cy_DFU_TransportStop */
+    void (*reset)(void);               /**< Resets the transport buffers, see \ref Cy_DFU_TransportReset */
+    /** Receives a packet from the DFU Host, see \ref Cy_DFU_TransportRead */
+    cy_en_dfu_status_t (*read)(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout);
+    /** Transmits a packet to the DFU Host, see \ref Cy_DFU_TransportWrite */
+    cy_en_dfu_status_t (*write)(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout);
+    /**
+    * The largest packet in bytes the transport can receive or transmit with a
+    * single read or write call. 0 if it is limited only by the packet buffer
+    * size (\ref CY_DFU_SIZEOF_CMD_BUFFER).
+    */
+    uint32_t maxPacketSize;
+    /** The transport capabilities, see \ref group_dfu_macro_transport_caps */
+    uint32_t capabilities;
+} cy_stc_dfu_transport_ops_t;
 /** \} group_dfu_data_structs */
 
 
@@ -1395,6 +2216,17 @@ cy_en_dfu_status_t Cy_DFU_ValidateMetadata(uint32_t metadataAddress, cy_stc_dfu_
     cy_en_dfu_status_t Cy_DFU_SetAppMetadata(uint32_t appId, uint32_t verifyAddress,
                                                        uint32_t verifySize, cy_stc_dfu_params_t *params);
 #endif /* (CY_DFU_METADATA_WRITABLE != 0) || defined(CY_DOXYGEN) */
+#if (CY_DFU_OPT_METADATA_V2 != 0) || defined(CY_DOXYGEN)
+    cy_en_dfu_status_t Cy_DFU_GetAppRecord(uint32_t appId, cy_stc_dfu_app_metadata_t *record,
+                                           cy_stc_dfu_params_t *params);
+    #if (CY_DFU_METADATA_WRITABLE != 0) || defined(CY_DOXYGEN)
+        cy_en_dfu_status_t Cy_DFU_SetAppRecord(uint32_t appId, const cy_stc_dfu_app_metadata_t *record,
+                                               cy_stc_dfu_params_t *params);
+    #endif /* (CY_DFU_METADATA_WRITABLE != 0) || defined(CY_DOXYGEN) */
+#endif /* (CY_DFU_OPT_METADATA_V2 != 0) || defined(CY_DOXYGEN) */
+#if (CY_DFU_OPT_METADATA_CACHE != 0) || defined(CY_DOXYGEN)
+    void Cy_DFU_MetadataCacheInvalidate(void);
+#endif /* (CY_DFU_OPT_METADATA_CACHE != 0) || defined(CY_DOXYGEN) */
 /** \} group_dfu_functions_meta */
 
 
@@ -1409,10 +2241,35 @@ uint32_t Cy_DFU_GetRunningApp(void);
 cy_en_dfu_status_t Cy_DFU_SwitchToApp(uint32_t appId);
 cy_en_dfu_status_t Cy_DFU_CopyApp(uint32_t destAddress, uint32_t srcAddress, uint32_t length,
                                             uint32_t rowSize, cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_CopyAppProgress(uint32_t destAddress, uint32_t srcAddress, uint32_t length,
+                                          uint32_t rowSize, cy_stc_dfu_params_t *params,
+                                          Cy_DFU_CopyProgressHandler handler);
+uint32_t Cy_DFU_GetEraseSize(uint32_t address);
+#if (CY_DFU_OPT_VALID_CACHE != 0) || defined(CY_DOXYGEN)
+void Cy_DFU_ValidCacheInvalidate(void);
+#endif /* (CY_DFU_OPT_VALID_CACHE != 0) || defined(CY_DOXYGEN) */
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 cy_en_dfu_status_t Cy_DFU_ValidateApp(uint32_t appId, cy_stc_dfu_params_t *params);
 /** \} group_dfu_functions_app */
 
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || (CY_DFU_OPT_CRYPTO_HW != 0) || \
+    defined(CY_DOXYGEN)
+/**
+* \defgroup group_dfu_functions_hash Hash Calculation
+* \{
+*   DFU functions for the application checksum calculation.
+*/
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || defined(CY_DOXYGEN)
+void Cy_DFU_Sha256Init(cy_stc_dfu_sha256_t *context);
+void Cy_DFU_Sha256Update(cy_stc_dfu_sha256_t *context, const uint8_t *data, uint32_t length);
+void Cy_DFU_Sha256Final(cy_stc_dfu_sha256_t *context, uint8_t digest[]);
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || defined(CY_DOXYGEN) */
+#if (CY_DFU_OPT_CRYPTO_HW != 0) || defined(CY_DOXYGEN)
+void Cy_DFU_CryptoRelease(void);
+#endif /* (CY_DFU_OPT_CRYPTO_HW != 0) || defined(CY_DOXYGEN) */
+/** \} group_dfu_functions_hash */
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SHA256 != 0)) || (CY_DFU_OPT_CRYPTO_HW != 0) */
+
 /**
 * \defgroup group_dfu_functions_mem Memory Operations
 * \{
@@ -1423,6 +2280,9 @@ cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t
                                               cy_stc_dfu_params_t *params);
 cy_en_dfu_status_t Cy_DFU_WriteData(uint32_t address, uint32_t length, uint32_t ctl,
                                               cy_stc_dfu_params_t *params);
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0)) || defined(CY_DOXYGEN)
+void Cy_DFU_GoldenImageInvalidate(void);
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_GOLDEN_IMAGE != 0)) || defined(CY_DOXYGEN) */
 /** \} group_dfu_functions_mem */
 
 
@@ -1437,7 +2297,82 @@ cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32
 void Cy_DFU_TransportReset(void);
 void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport);
 void Cy_DFU_TransportStop(void);
+const cy_stc_dfu_transport_ops_t * Cy_DFU_TransportGetOps(void);
+void Cy_DFU_TransportLock(void);
 /** \} group_dfu_functions_transport */
+
+#if (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN)
+/**
+* \defgroup group_dfu_functions_stats Statistics
+* \{
+*   DFU functions for the per-command statistics, see \ref group_dfu_ucase_stats.
+*/
+uint32_t Cy_DFU_StatsTimestamp(void);
+const cy_stc_dfu_cmd_stats_t * Cy_DFU_GetCommandStats(const cy_stc_dfu_params_t *params, uint32_t command);
+void Cy_DFU_StatsNvmBegin(cy_stc_dfu_params_t *params);
+void Cy_DFU_StatsNvmEnd(cy_stc_dfu_params_t *params, uint32_t operation, uint32_t address, uint32_t length,
+                        uint32_t result);
+/** \} group_dfu_functions_stats */
+#endif /* (CY_DFU_OPT_STATS != 0) || defined(CY_DOXYGEN) */
+
+#if (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN)
+/**
+* \defgroup group_dfu_functions_resume Resumable Update
+* \{
+*   DFU functions for the resumable update sessions, see \ref group_dfu_ucase_resume.
+*/
+uint32_t Cy_DFU_GetProgressAddress(void);
+/** \} group_dfu_functions_resume */
+#endif /* (CY_DFU_OPT_RESUME != 0) || defined(CY_DOXYGEN) */
+
+#if ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SWAP != 0)) || defined(CY_DOXYGEN)
+/**
+* \defgroup group_dfu_functions_swap Slot Swap
+* \{
+*   DFU functions for the power-fail-safe swap of two slots, see \ref group_dfu_ucase_swap.
+*/
+uint32_t Cy_DFU_GetSwapAddress(void);
+cy_en_dfu_status_t Cy_DFU_SwapApp(uint32_t primaryAddress, uint32_t secondaryAddress, uint32_t length,
+                                  cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_SwapResume(cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_SwapRevert(cy_stc_dfu_params_t *params);
+/** \} group_dfu_functions_swap */
+#endif /* ((CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_SWAP != 0)) || defined(CY_DOXYGEN) */
+
+/**
+* \defgroup group_dfu_functions_nvm_regions NVM Regions
+* \{
+*   DFU functions for the NVM regions of \ref Cy_DFU_WriteData and
+*   \ref Cy_DFU_ReadData, see \ref group_dfu_ucase_nvm_regions.
+*/
+const cy_stc_dfu_nvm_region_t * Cy_DFU_NvmRegionFind(const cy_stc_dfu_nvm_region_t * const regions[],
+                                                      uint32_t address, uint32_t length);
+cy_en_dfu_status_t Cy_DFU_NvmWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                   uint32_t ctl, cy_stc_dfu_params_t *params);
+cy_en_dfu_status_t Cy_DFU_NvmRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                  uint32_t ctl, cy_stc_dfu_params_t *params);
+#if (CY_DFU_OPT_NVM_CACHE != 0) || defined(CY_DOXYGEN)
+cy_en_dfu_status_t Cy_DFU_NvmFlush(cy_stc_dfu_params_t *params);
+#endif /* (CY_DFU_OPT_NVM_CACHE != 0) || defined(CY_DOXYGEN) */
+/** \} group_dfu_functions_nvm_regions */
+
+#if (CY_DFU_OPT_NOR != 0) || defined(CY_DOXYGEN)
+/**
+* \defgroup group_dfu_functions_nor Serial NOR
+* \{
+*   DFU functions for an external serial NOR device, see \ref group_dfu_ucase_nor.
+*/
+cy_en_dfu_status_t Cy_DFU_NorInit(cy_stc_dfu_nor_t *nor);
+cy_en_dfu_status_t Cy_DFU_NorRead(const cy_stc_dfu_nor_t *nor, uint32_t address, uint8_t data[], uint32_t length);
+cy_en_dfu_status_t Cy_DFU_NorCompare(const cy_stc_dfu_nor_t *nor, uint32_t address, const uint8_t data[],
+                                     uint32_t length);
+cy_en_dfu_status_t Cy_DFU_NorProgram(const cy_stc_dfu_nor_t *nor, uint32_t address, const uint8_t data[],
+                                     uint32_t length);
+cy_en_dfu_status_t Cy_DFU_NorErase(const cy_stc_dfu_nor_t *nor, uint32_t address, uint32_t length);
+void Cy_DFU_NorRegionInit(cy_stc_dfu_nor_t *nor, cy_stc_dfu_nvm_region_t *region);
+/** \} group_dfu_functions_nor */
+#endif /* (CY_DFU_OPT_NOR != 0) || defined(CY_DOXYGEN) */
+
 /**
 * \defgroup group_dfu_functions_custom_cmd Custom commands
 * \{
@@ -0,0 +1,289 @@
+/***************************************************************************//**
+* \file cy_dfu_logging.c
+* \version 5.2
+*
+* Provides the binary log ring of the DFU logging: the call sites record the
+* format string address and the raw arguments, and the messages are formatted
+* later by Cy_DFU_LogDrain() or on the host from a memory dump. Provides the
+* tokenized log output: the tokens of the format strings and the arguments.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_dfu_logging.h"
+
+#if defined(CY_DFU_BINARY_LOG) || defined(CY_DFU_TOKENIZED_LOG)
+
+#include "cy_syslib.h"
+
+#ifdef CY_DFU_BINARY_LOG
+
+/* The index of a record in the ring */
+#define LOG_RING_MASK                       (CY_DFU_LOG_RING_SIZE - 1U)
+
+/* The ring is a global symbol so that a debugger can dump it */
+cy_stc_dfu_log_ring_t cy_dfu_log_ring =
+{
+#ifdef CY_DFU_TOKENIZED_LOG
+    .magic = CY_DFU_LOG_MAGIC_TOKENS,
+#else
+    .magic = CY_DFU_LOG_MAGIC,
+#endif /* CY_DFU_TOKENIZED_LOG */
+    .size  = CY_DFU_LOG_RING_SIZE,
+};
+
+static void LogPush(uint32_t id, const uint32_t args[], uint32_t argc);
+#endif /* CY_DFU_BINARY_LOG */
+
+#ifdef CY_DFU_TOKENIZED_LOG
+static void LogFrame(uint32_t token, const uint32_t args[], uint32_t argc);
+#endif /* CY_DFU_TOKENIZED_LOG */
+
+
+#ifdef CY_DFU_BINARY_LOG
+/*******************************************************************************
+* Function Name: LogPush
+****************************************************************************//**
+*
+* Appends a record to the binary log ring, or counts it as dropped when the
+* ring is full.
+*
+* \param id    The address of the format string or its token.
+* \param args  The arguments.
+* \param argc  The number of the arguments.
+*
+*******************************************************************************/
+static void LogPush(uint32_t id, const uint32_t args[], uint32_t argc)
+{
+    uint32_t head = cy_dfu_log_ring.head;
+
+    if ((head - cy_dfu_log_ring.tail) >= CY_DFU_LOG_RING_SIZE)
+    {
+        cy_dfu_log_ring.dropped++;
+    }
+    else
+    {
+        cy_stc_dfu_log_record_t *record = &cy_dfu_log_ring.records[head & LOG_RING_MASK];
+        uint32_t count = (argc < CY_DFU_LOG_MAX_ARGS) ? argc : CY_DFU_LOG_MAX_ARGS;
+        uint32_t i;
+
+        record->id = id;
+        record->argc = count;
+        for (i = 0U; i < count; i++)
+        {
+            record->args[i] = args[i];
+        }
+
+        /* The record must be complete before the consumer sees it */
+        __DMB();
+        cy_dfu_log_ring.head = head + 1U;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_LogRecord
+****************************************************************************//**
+*
+* Appends a message to the binary log ring, used by \ref CY_DFU_LOG_WRITE when
+* CY_DFU_BINARY_LOG is defined. Only the address of the format string and the
+* arguments are stored, so the call takes a few cycles. The format string must
+* be a string literal. When the ring is full, the message is dropped and
+* counted in \ref cy_stc_dfu_log_ring_t::dropped.
+*
+* The call sites are the single producer of the ring: do not log from an
+* interrupt that can preempt another log call.
+*
+* \param fmt   The format string, with the integer conversions only.
+* \param args  The arguments.
+* \param argc  The number of the arguments, up to \ref CY_DFU_LOG_MAX_ARGS.
+*
+*******************************************************************************/
+void Cy_DFU_LogRecord(const char *fmt, const uint32_t args[], uint32_t argc)
+{
+    CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting pointer to a int is safe as the addresses are 32-bit.');
+    LogPush((uint32_t) fmt, args, argc);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_LogDrain
+****************************************************************************//**
+*
+* Formats and outputs the messages of the binary log ring in the order they
+* were recorded, with Cy_DFU_Log() when CY_DFU_CUSTOM_LOG is defined and with
+* printf() otherwise. With CY_DFU_TOKENIZED_LOG defined, outputs their frames
+* with Cy_DFU_LogOutput() instead. Call it outside of the update hot path, for
+* example, when \ref Cy_DFU_Continue returns without a packet, or from a
+* low-priority task. Only one context may drain the ring.
+*
+* \param maxRecords The maximum number of the messages to output, 0 outputs
+*                   all the messages in the ring.
+*
+* \return The number of the messages output.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_LogDrain(uint32_t maxRecords)
+{
+    uint32_t tail = cy_dfu_log_ring.tail;
+    uint32_t head = cy_dfu_log_ring.head;
+    uint32_t drained = 0U;
+
+    /* Read the records only after their head index */
+    __DMB();
+
+    while ((tail != head) && ((maxRecords == 0U) || (drained < maxRecords)))
+    {
+        const cy_stc_dfu_log_record_t *record = &cy_dfu_log_ring.records[tail & LOG_RING_MASK];
+    #ifdef CY_DFU_TOKENIZED_LOG
+        LogFrame(record->id, record->args, record->argc);
+    #else
+        uint32_t args[CY_DFU_LOG_MAX_ARGS] = {0U};
+        uint32_t i;
+
+        for (i = 0U; i < record->argc; i++)
+        {
+            args[i] = record->args[i];
+        }
+
+        /* The unused arguments are ignored by the format */
+        CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.6','Casting int to pointer is safe as it is the address of a string literal.');
+    #ifdef CY_DFU_CUSTOM_LOG
+        (void) snprintf(cy_dfu_msg, CY_DFU_LOG_BUF, (const char *) record->id,
+                        (unsigned int) args[0], (unsigned int) args[1],
+                        (unsigned int) args[2], (unsigned int) args[3]);
+        Cy_DFU_Log(cy_dfu_msg);
+    #else
+        (void) printf((const char *) record->id,
+                      (unsigned int) args[0], (unsigned int) args[1],
+                      (unsigned int) args[2], (unsigned int) args[3]);
+    #endif /* CY_DFU_CUSTOM_LOG */
+    #endif /* CY_DFU_TOKENIZED_LOG */
+
+        /* The record is read before the producer may reuse it */
+        __DMB();
+        tail++;
+        cy_dfu_log_ring.tail = tail;
+        drained++;
+    }
+
+    return (drained);
+}
+#endif /* CY_DFU_BINARY_LOG */
+
+
+#ifdef CY_DFU_TOKENIZED_LOG
+/*******************************************************************************
+* Function Name: LogFrame
+****************************************************************************//**
+*
+* Outputs a tokenized message with Cy_DFU_LogOutput(): the header byte
+* (CY_DFU_LOG_FRAME_HEADER ORed with the number of the arguments), the token,
+* and the arguments, 32-bit little-endian.
+*
+*******************************************************************************/
+static void LogFrame(uint32_t token, const uint32_t args[], uint32_t argc)
+{
+    uint8_t frame[1U + (4U * (1U + CY_DFU_LOG_MAX_ARGS))];
+    uint32_t count = (argc < CY_DFU_LOG_MAX_ARGS) ? argc : CY_DFU_LOG_MAX_ARGS;
+    uint32_t size = 1U;
+    uint32_t value = token;
+    uint32_t i;
+    uint32_t j;
+
+    frame[0] = (uint8_t)(CY_DFU_LOG_FRAME_HEADER | count);
+    for (i = 0U; i <= count; i++)
+    {
+        for (j = 0U; j < 4U; j++)
+        {
+            frame[size] = (uint8_t)(value >> (8U * j));
+            size++;
+        }
+        value = (i < count) ? args[i] : 0U;
+    }
+
+    Cy_DFU_LogOutput(frame, size);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_LogToken
+****************************************************************************//**
+*
+* Outputs a message of the tokenized log, used by \ref CY_DFU_LOG_WRITE when
+* CY_DFU_TOKENIZED_LOG is defined: the token of the format string computed by
+* CY_DFU_LOG_TOKEN() and the arguments, 5 to 21 bytes instead of the formatted
+* text. With CY_DFU_BINARY_LOG also defined, the message is recorded into the
+* binary log ring and output later by \ref Cy_DFU_LogDrain.
+*
+* The host decodes the messages with the dictionary of the tokens generated
+* by host/dfu_log_tokens.py from the sources.
+*
+* \param token The token of the format string.
+* \param args  The arguments.
+* \param argc  The number of the arguments, up to \ref CY_DFU_LOG_MAX_ARGS.
+*
+*******************************************************************************/
+void Cy_DFU_LogToken(uint32_t token, const uint32_t args[], uint32_t argc)
+{
+#ifdef CY_DFU_BINARY_LOG
+    LogPush(token, args, argc);
+#else
+    LogFrame(token, args, argc);
+#endif /* CY_DFU_BINARY_LOG */
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_LogOutput
+****************************************************************************//**
+*
+* Outputs a frame of the tokenized log. The default implementation writes it
+* to stdout. The user's code can redefine it to write the frames to another
+* log channel.
+*
+* \param data  The frame.
+* \param size  The size of the frame, in bytes.
+*
+*******************************************************************************/
+__WEAK void Cy_DFU_LogOutput(const uint8_t data[], uint32_t size)
+{
+    (void) fwrite(data, 1U, size, stdout);
+}
+#endif /* CY_DFU_TOKENIZED_LOG */
+
+#endif /* defined(CY_DFU_BINARY_LOG) || defined(CY_DFU_TOKENIZED_LOG) */
+
+
+/* [] END OF FILE */
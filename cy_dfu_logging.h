@@ -75,7 +75,170 @@ extern "C"{
     void Cy_DFU_Log(const char* msg);
 #endif /* CY_DFU_CUSTOM_LOG */
 
-#ifdef CY_DFU_CUSTOM_LOG
+#if defined(CY_DFU_BINARY_LOG) || defined(CY_DFU_TOKENIZED_LOG)
+    #define     CY_DFU_LOG_MAX_ARGS     (4U)    /* Arguments of a message */
+
+    /* Calls func(id, args, argc) with the integer arguments of a log call */
+    #define CY_DFU_LOG_CALL(func, id, ...)                                          \
+        do                                                                          \
+        {                                                                           \
+            const uint32_t cy_dfu_log_args[CY_DFU_LOG_MAX_ARGS + 1U] = { 0U, ##__VA_ARGS__ }; \
+            func((id), &cy_dfu_log_args[1],                                         \
+                (uint32_t)(sizeof((uint32_t[]){ 0U, ##__VA_ARGS__ }) / sizeof(uint32_t)) - 1U); \
+        } while (false)
+#endif /* defined(CY_DFU_BINARY_LOG) || defined(CY_DFU_TOKENIZED_LOG) */
+
+#ifdef CY_DFU_TOKENIZED_LOG
+    #define     CY_DFU_LOG_TOKEN_LENGTH (80U)   /* Characters of a format string in its token */
+    #define     CY_DFU_LOG_FRAME_HEADER (0xC0U) /* The first byte of a frame, ORed with the number of the arguments */
+
+    /* The character i of a string literal multiplied by 65599^(i + 1), 0 past its end */
+    #define CY_DFU_LOG_HASH_CHAR(_str, i, k)                                        \
+        ((uint32_t)((((i) + 1U) < sizeof(_str)) ? (uint32_t)(uint8_t)(_str)[(((i) + 1U) < sizeof(_str)) ? (i) : 0U] : 0U) * (uint32_t)(k))
+
+    /**
+    * The 32-bit token of a format string literal: the 65599 hash of its length
+    * and its first CY_DFU_LOG_TOKEN_LENGTH characters. It is evaluated by the
+    * compiler, the string itself is not placed in the image. host/dfu_log_tokens.py
+    * computes the same tokens for the dictionary.
+    */
+    #define CY_DFU_LOG_TOKEN(_str)                                                  \
+        ((uint32_t)((uint32_t)(sizeof(_str) - 1U) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 0U, 0x0001003FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 1U, 0x007E0F81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 2U, 0x2E86D0BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 3U, 0x43EC5F01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 4U, 0x162C613FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 5U, 0xD62AEE81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 6U, 0xA311B1BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 7U, 0xD319BE01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 8U, 0xB156C23FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 9U, 0x6698CD81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 10U, 0x0D1B92BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 11U, 0xCC881D01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 12U, 0x7280233FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 13U, 0x50C7AC81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 14U, 0x8DA473BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 15U, 0x4F377C01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 16U, 0xFAA8843FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 17U, 0x33B78B81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 18U, 0x45AC54BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 19U, 0x7A27DB01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 20U, 0xEACFE53FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 21U, 0xAE686A81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 22U, 0x563335BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 23U, 0x6C593A01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 24U, 0xE3F6463FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 25U, 0x5FDA4981UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 26U, 0xE03916BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 27U, 0x44CB9901UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 28U, 0x871BA73FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 29U, 0xE70D2881UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 30U, 0x04BDF7BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 31U, 0x227EF801UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 32U, 0x7540083FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 33U, 0xE3010781UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 34U, 0xE4C1D8BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 35U, 0x24735701UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 36U, 0x4F63693FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 37U, 0xF2B5E681UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 38U, 0xA144B9BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 39U, 0x69A8B601UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 40U, 0xB685CA3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 41U, 0xB52BC581UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 42U, 0x5B469ABFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 43U, 0x111F1501UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 44U, 0x4BA72B3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 45U, 0xC962A481UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 46U, 0x33C77BBFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 47U, 0x39D67401UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 48U, 0xAFC78C3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 49U, 0xCE5A8381UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 50U, 0x4BC75CBFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 51U, 0x02CED301UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 52U, 0x83E6ED3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 53U, 0x63136281UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 54U, 0xC4463DBFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 55U, 0x8B083201UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 56U, 0x69054E3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 57U, 0x268D4181UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 58U, 0xBE441EBFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 59U, 0xF1829101UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 60U, 0x0022AF3FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 61U, 0xB7C82081UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 62U, 0x5AC0FFBFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 63U, 0x553DF001UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 64U, 0xEA3F103FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 65U, 0xB5C3FF81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 66U, 0xBABCE0BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 67U, 0xD53A4F01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 68U, 0xC85A713FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 69U, 0xBF80DE81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 70U, 0xFF37C1BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 71U, 0x9077AE01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 72U, 0x3B74D23FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 73U, 0x73FEBD81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 74U, 0x4931A2BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 75U, 0xA5F60D01UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 76U, 0xE48E333FUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 77U, 0x723D9C81UL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 78U, 0xB9AA83BFUL) + \
+        CY_DFU_LOG_HASH_CHAR(_str, 79U, 0x34B56C01UL)))
+
+    void Cy_DFU_LogToken(uint32_t token, const uint32_t args[], uint32_t argc);
+    void Cy_DFU_LogOutput(const uint8_t data[], uint32_t size);
+#endif /* CY_DFU_TOKENIZED_LOG */
+
+#ifdef CY_DFU_BINARY_LOG
+    #ifndef CY_DFU_LOG_RING_SIZE
+        #define     CY_DFU_LOG_RING_SIZE    (32U)   /* Records, a power of two */
+    #endif /* CY_DFU_LOG_RING_SIZE */
+
+    #define     CY_DFU_LOG_MAGIC        (0x4C554644UL) /* "DFUL", marks the ring in a memory dump */
+    #define     CY_DFU_LOG_MAGIC_TOKENS (0x54554644UL) /* "DFUT", the ring of the tokenized log */
+
+    #if ((CY_DFU_LOG_RING_SIZE & (CY_DFU_LOG_RING_SIZE - 1U)) != 0U) || (CY_DFU_LOG_RING_SIZE == 0U)
+        #error "CY_DFU_LOG_RING_SIZE must be a power of two"
+    #endif
+
+    /** A message of the binary log: the format string and the raw arguments */
+    typedef struct
+    {
+        uint32_t id;                            /**< The address of the format string, or its token
+                                                 * with CY_DFU_TOKENIZED_LOG */
+        uint32_t argc;                          /**< The number of the arguments */
+        uint32_t args[CY_DFU_LOG_MAX_ARGS];     /**< The arguments, converted to uint32_t */
+    } cy_stc_dfu_log_record_t;
+
+    /**
+    * The binary log ring. The call sites are the only producer, \ref Cy_DFU_LogDrain
+    * is the only consumer. head and tail count the records written and drained,
+    * the ring holds the records [tail, head).
+    */
+    typedef struct
+    {
+        uint32_t magic;                         /**< \ref CY_DFU_LOG_MAGIC or \ref CY_DFU_LOG_MAGIC_TOKENS */
+        uint32_t size;                          /**< The number of the records in the ring */
+        volatile uint32_t head;                 /**< The records written, updated by the producer */
+        volatile uint32_t tail;                 /**< The records drained, updated by the consumer */
+        volatile uint32_t dropped;              /**< The records lost because the ring was full */
+        cy_stc_dfu_log_record_t records[CY_DFU_LOG_RING_SIZE]; /**< The records */
+    } cy_stc_dfu_log_ring_t;
+
+    extern cy_stc_dfu_log_ring_t cy_dfu_log_ring;
+    void Cy_DFU_LogRecord(const char *fmt, const uint32_t args[], uint32_t argc);
+    uint32_t Cy_DFU_LogDrain(uint32_t maxRecords);
+#endif /* CY_DFU_BINARY_LOG */
+
+#if defined(CY_DFU_TOKENIZED_LOG)
+    /* Outputs, or records with CY_DFU_BINARY_LOG, the token of the format string and the arguments */
+    #define CY_DFU_LOG_WRITE(_fmt, ...)                                             \
+        CY_DFU_LOG_CALL(Cy_DFU_LogToken, CY_DFU_LOG_TOKEN(_fmt), ##__VA_ARGS__)
+#elif defined(CY_DFU_BINARY_LOG)
+    /* Records the format string address and the arguments, formatted later by Cy_DFU_LogDrain() */
+    #define CY_DFU_LOG_WRITE(_fmt, ...)                                             \
+        CY_DFU_LOG_CALL(Cy_DFU_LogRecord, (_fmt), ##__VA_ARGS__)
+#elif defined(CY_DFU_CUSTOM_LOG)
     #define CY_DFU_LOG_WRITE(_fmt, ...)                 \
         do                                              \
         {                                               \
@@ -88,7 +251,7 @@ extern "C"{
         {                                  \
             (void) printf(_fmt, ##__VA_ARGS__);   \
         } while (false)
-#endif /* CY_DFU_CUSTOM_LOG */
+#endif /* defined(CY_DFU_TOKENIZED_LOG) */
 
 
 #if CY_DFU_LOG_LEVEL >= CY_DFU_LOG_LEVEL_ERROR
@@ -327,7 +327,7 @@ cy_en_dfu_status_t CANFD_CanfdCyBtldrCommRead(uint8_t pData[], uint32_t size, ui
 *   \ref cy_en_dfu_status_t description in the API Reference Guide.
 *
 *******************************************************************************/
-cy_en_dfu_status_t CANFD_CanfdCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t* count, uint32_t timeout)
+cy_en_dfu_status_t CANFD_CanfdCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t* count, uint32_t timeout)
 {
     cy_en_dfu_status_t dfuStatus  = CY_DFU_ERROR_BAD_PARAM;
     (void)timeout;
@@ -438,4 +438,20 @@ static uint32_t CANFD_SizeToDlc(uint32_t size)
     return dlc;
 }
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t CANFD_CanfdCyBtldrCommOps =
+{
+    .transport     = CY_DFU_CANFD,
+    .start         = &CANFD_CanfdCyBtldrCommStart,
+    .stop          = &CANFD_CanfdCyBtldrCommStop,
+    .reset         = &CANFD_CanfdCyBtldrCommReset,
+    .read          = &CANFD_CanfdCyBtldrCommRead,
+    .write         = &CANFD_CanfdCyBtldrCommWrite,
+    .maxPacketSize = 64U,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
@@ -53,6 +53,7 @@ extern "C" {
 ***************************************/
 
 extern bool CANFD_initVar;
+extern const cy_stc_dfu_transport_ops_t CANFD_CanfdCyBtldrCommOps;
 
 
 /***************************************
@@ -64,7 +65,7 @@ void CANFD_CanfdCyBtldrCommStart(void);
 void CANFD_CanfdCyBtldrCommStop(void);
 void CANFD_CanfdCyBtldrCommReset(void);
 cy_en_dfu_status_t CANFD_CanfdCyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t* count, uint32_t timeout);
-cy_en_dfu_status_t CANFD_CanfdCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t* count, uint32_t timeout);
+cy_en_dfu_status_t CANFD_CanfdCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t* count, uint32_t timeout);
 
 #if defined(__cplusplus)
 }
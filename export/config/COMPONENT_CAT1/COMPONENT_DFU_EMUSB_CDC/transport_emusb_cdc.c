@@ -316,4 +316,20 @@ cy_en_dfu_status_t USB_CDC_CyBtldrCommWrite(uint8_t pData[], uint32_t size, uint
 }
 
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t USB_CDC_CyBtldrCommOps =
+{
+    .transport     = CY_DFU_USB_CDC,
+    .start         = &USB_CDC_CyBtldrCommStart,
+    .stop          = &USB_CDC_CyBtldrCommStop,
+    .reset         = &USB_CDC_CyBtldrCommReset,
+    .read          = &USB_CDC_CyBtldrCommRead,
+    .write         = &USB_CDC_CyBtldrCommWrite,
+    .maxPacketSize = 0U,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
@@ -54,6 +54,7 @@ extern "C" {
 ***************************************/
 
 extern bool USB_DEV_CDC_initVar;
+extern const cy_stc_dfu_transport_ops_t USB_CDC_CyBtldrCommOps;
 
 
 /***************************************
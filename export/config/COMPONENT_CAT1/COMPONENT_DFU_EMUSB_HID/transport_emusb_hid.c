@@ -348,4 +348,20 @@ cy_en_dfu_status_t USB_HID_CyBtldrCommWrite(uint8_t pData[], uint32_t size, uint
 }
 
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t USB_HID_CyBtldrCommOps =
+{
+    .transport     = CY_DFU_USB_HID,
+    .start         = &USB_HID_CyBtldrCommStart,
+    .stop          = &USB_HID_CyBtldrCommStop,
+    .reset         = &USB_HID_CyBtldrCommReset,
+    .read          = &USB_HID_CyBtldrCommRead,
+    .write         = &USB_HID_CyBtldrCommWrite,
+    .maxPacketSize = CY_DFU_USB_HID_INT_MAX_PACKET,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
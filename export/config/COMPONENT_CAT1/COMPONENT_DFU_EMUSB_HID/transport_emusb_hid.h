@@ -53,6 +53,7 @@ extern "C" {
 ***************************************/
 
 extern bool USB_DEV_HID_initVar;
+extern const cy_stc_dfu_transport_ops_t USB_HID_CyBtldrCommOps;
 
 
 /***************************************
@@ -285,7 +285,7 @@ cy_en_dfu_status_t I2C_I2cCyBtldrCommRead(uint8_t pData[], uint32_t size, uint32
 *   "Return Codes" section of the System Reference Guide.
 *
 *******************************************************************************/
-cy_en_dfu_status_t I2C_I2cCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeOut)
+cy_en_dfu_status_t I2C_I2cCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeOut)
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_BAD_PARAM;
     (void)timeOut;
@@ -349,4 +349,20 @@ static void cyhal_i2c_event_callback(void* callback_arg, cyhal_i2c_event_t event
     }
 }
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t I2C_I2cCyBtldrCommOps =
+{
+    .transport     = CY_DFU_I2C,
+    .start         = &I2C_I2cCyBtldrCommStart,
+    .stop          = &I2C_I2cCyBtldrCommStop,
+    .reset         = &I2C_I2cCyBtldrCommReset,
+    .read          = &I2C_I2cCyBtldrCommRead,
+    .write         = &I2C_I2cCyBtldrCommWrite,
+    .maxPacketSize = DFU_I2C_RX_BUFFER_SIZE,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
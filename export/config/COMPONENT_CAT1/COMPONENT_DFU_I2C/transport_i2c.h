@@ -53,6 +53,7 @@ extern "C" {
 ***************************************/
 
 extern bool I2C_initVar;
+extern const cy_stc_dfu_transport_ops_t I2C_I2cCyBtldrCommOps;
 
 
 /***************************************
@@ -64,7 +65,7 @@ void I2C_I2cCyBtldrCommStart(void);
 void I2C_I2cCyBtldrCommStop (void);
 void I2C_I2cCyBtldrCommReset(void);
 cy_en_dfu_status_t I2C_I2cCyBtldrCommRead (uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
-cy_en_dfu_status_t I2C_I2cCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeOut);
+cy_en_dfu_status_t I2C_I2cCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeOut);
 
 #if defined(__cplusplus)
 }
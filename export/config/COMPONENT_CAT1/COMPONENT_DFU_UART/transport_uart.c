@@ -285,4 +285,20 @@ cy_en_dfu_status_t UART_UartCyBtldrCommWrite(uint8_t pData[], uint32_t size, uin
 }
 
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t UART_UartCyBtldrCommOps =
+{
+    .transport     = CY_DFU_UART,
+    .start         = &UART_UartCyBtldrCommStart,
+    .stop          = &UART_UartCyBtldrCommStop,
+    .reset         = &UART_UartCyBtldrCommReset,
+    .read          = &UART_UartCyBtldrCommRead,
+    .write         = &UART_UartCyBtldrCommWrite,
+    .maxPacketSize = 0U,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
@@ -54,6 +54,7 @@ extern "C" {
 ***************************************/
 
 extern bool UART_initVar;
+extern const cy_stc_dfu_transport_ops_t UART_UartCyBtldrCommOps;
 
 
 /***************************************
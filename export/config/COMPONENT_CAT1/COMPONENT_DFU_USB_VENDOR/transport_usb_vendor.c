@@ -0,0 +1,435 @@
+/***************************************************************************//**
+* \file transport_usb_vendor.c
+* \version 5.2
+*
+* This file provides the source code of the DFU communication API implementation
+* for the emUSB-Device that implements a vendor-specific class with a pair of
+* bulk endpoints (WinUSB / libusb compatible).
+*
+* Note
+* This file supports only the ModusToolbox flow.
+* This file serves as a template and can be modified defining any component
+* name or personality alias.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "USB.h"
+#include "USB_Bulk.h"
+#include "transport_usb_vendor.h"
+
+
+/* USER CONFIGURABLE: The USB device bulk endpoints maximum packet size */
+#ifndef CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET
+    #define CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET   (USB_FS_BULK_MAX_PACKET_SIZE)
+#endif /* #ifndef CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET */
+
+/* USER CONFIGURABLE: The USB device product ID reported in the device descriptor.
+* It must differ from the product ID of the emUSB CDC and HID transports (0xF21D):
+* Windows requests the Microsoft OS descriptors only the first time a VID/PID
+* enumerates, so a PID already seen as CDC or HID never gets WinUSB bound.
+*/
+#ifndef CY_DFU_USB_VENDOR_PRODUCT_ID
+    #define CY_DFU_USB_VENDOR_PRODUCT_ID            (0xF21EU)
+#endif /* #ifndef CY_DFU_USB_VENDOR_PRODUCT_ID */
+
+/* USER CONFIGURABLE: The vendor code the host uses to request the Microsoft OS descriptors */
+#ifndef CY_DFU_USB_VENDOR_MS_VENDOR_CODE
+    #define CY_DFU_USB_VENDOR_MS_VENDOR_CODE        (0x20U)
+#endif /* #ifndef CY_DFU_USB_VENDOR_MS_VENDOR_CODE */
+
+/* The time to wait for the remaining bytes of a started DFU packet, in milliseconds */
+#define USB_VENDOR_PACKET_TIMEOUT_MS    (20U)
+
+/* The DFU packet framing: the start of packet byte, the header and the footer sizes */
+#define USB_VENDOR_PACKET_SOP           (0x01U)
+#define USB_VENDOR_PACKET_HEADER_SIZE   (4U)
+#define USB_VENDOR_PACKET_FOOTER_SIZE   (3U)
+#define USB_VENDOR_PACKET_SIZE_IDX      (2U)
+
+/**
+* USB_DEV_VENDOR_initVar indicates whether the emUSB-Device has been initialized.
+* The variable is initialized to false and set to true the first time
+* \ref USB_VENDOR_CyBtldrCommStart is called. This allows  the driver to restart
+* without re-initialization after the first call to the
+* \ref USB_VENDOR_CyBtldrCommStart routine.
+* For re-initialization set \ref USB_DEV_VENDOR_initVar to false and call
+* \ref USB_VENDOR_CyBtldrCommStart.
+*/
+bool USB_DEV_VENDOR_initVar = false;
+
+/* Data structure for emUSB-Device */
+static const USB_DEVICE_INFO DeviceInfo =
+{
+    0x058B,                         // VendorId
+    CY_DFU_USB_VENDOR_PRODUCT_ID,   // ProductId
+    "Infineon",                     // VendorName
+    "DFU USB Vendor Transport",     // ProductName
+    "0132456789"                    // SerialNumber
+};
+
+/* Microsoft OS extended properties: makes Windows bind WinUSB without an INF file */
+static const USB_MS_OS_EXT_PROP ExtProps[] =
+{
+    {
+        USB_MSOS_EXT_PROPTYPE_REG_MULTI_SZ,         // Property type - a list of strings
+        "DeviceInterfaceGUIDs",                     // Property name
+        "{6F7A9C1B-2C1E-4F43-9F35-1C2B3D4E5F60}\0", // Device interface GUID
+        0U                                          // Size is calculated by the stack
+    }
+};
+
+/* Handle for emUSB bulk instance */
+static USB_BULK_HANDLE hInst;
+
+/* Buffer for store data in OUT direction (Host to Device) */
+static U8 OutBuffer[CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET];
+
+/* The number of bytes of the current DFU packet that were not read yet */
+static uint32_t packetRemaining = 0U;
+
+
+/*******************************************************************************
+* Function Name: USB_DEV_Start
+****************************************************************************//**
+*
+* Starts the USB device operation. It does not wait until USB device is
+* enumerated. It invokes USBD_Start().
+*
+* \globalvars
+* \ref USB_DEV_VENDOR_initVar - Used to check the initial configuration, modified
+*                        on the first function call.
+*
+*******************************************************************************/
+static void USB_DEV_Start(void);
+static void USB_DEV_Start(void)
+{
+    USB_ADD_EP_INFO EPBulkIn;
+    USB_ADD_EP_INFO EPBulkOut;
+    USB_BULK_INIT_DATA InitData;
+
+    if (!USB_DEV_VENDOR_initVar)
+    {
+        memset(&EPBulkIn, 0x0, sizeof(EPBulkIn));
+        memset(&EPBulkOut, 0x0, sizeof(EPBulkOut));
+        memset(&InitData, 0x0, sizeof(InitData));
+
+        /* Initializes the USB device with its settings */
+        USBD_Init();
+
+        /* IN direction (Device to Host) endpoint */
+        EPBulkIn.Flags          = 0;                                     // Flags not used.
+        EPBulkIn.InDir          = USB_DIR_IN;                            // IN direction (Device to Host)
+        EPBulkIn.Interval       = 0;                                     // Interval not used for Bulk endpoints.
+        EPBulkIn.MaxPacketSize  = CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET; // Maximum packet size (64 for Bulk in full-speed and 512 for high-speed).
+        EPBulkIn.TransferType   = USB_TRANSFER_TYPE_BULK;                // Endpoint type - Bulk.
+        InitData.EPIn  = USBD_AddEPEx(&EPBulkIn, NULL, 0);
+
+        /* OUT direction (Host to Device) endpoint */
+        EPBulkOut.Flags         = 0;                                     // Flags not used.
+        EPBulkOut.InDir         = USB_DIR_OUT;                           // OUT direction (Host to Device)
+        EPBulkOut.Interval      = 0;                                     // Interval not used for Bulk endpoints.
+        EPBulkOut.MaxPacketSize = CY_DFU_USB_VENDOR_ENDPOINT_MAX_PACKET; // Maximum packet size (64 for Bulk in full-speed and 512 for high-speed).
+        EPBulkOut.TransferType  = USB_TRANSFER_TYPE_BULK;                // Endpoint type - Bulk.
+        InitData.EPOut = USBD_AddEPEx(&EPBulkOut, OutBuffer, sizeof(OutBuffer));
+
+        /* Adds a vendor-specific (bulk) class to the stack */
+        hInst = USBD_BULK_Add(&InitData);
+
+        /* Report the WinUSB compatible ID and the device interface GUID */
+        USBD_SetMSVendorCode(CY_DFU_USB_VENDOR_MS_VENDOR_CODE);
+        USBD_BULK_SetMSDescInfo(hInst, ExtProps, SEGGER_COUNTOF(ExtProps));
+
+        /* Set data for device enumeration */
+        USBD_SetDeviceInfo(&DeviceInfo);
+
+        USB_DEV_VENDOR_initVar = true;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USB_VENDOR_CyBtldrCommStart
+****************************************************************************//**
+*
+* Starts the USB device operation.
+*
+* \note
+* This function does not configure an infrastructure required for the USB device
+* operation: clocks and pins. For the ModusToolbox flow, the generated files
+* configure clocks and pins. This configuration must be performed by the
+* application when the project uses only PDL.
+*
+*******************************************************************************/
+void USB_VENDOR_CyBtldrCommStart(void)
+{
+    USB_DEV_Start();
+
+    packetRemaining = 0U;
+
+    /* Start the emUSB-Device Core */
+    USBD_Start();
+}
+
+
+/*******************************************************************************
+* Function Name: USB_VENDOR_CyBtldrCommStop
+****************************************************************************//**
+*
+* Disables the USB device component.
+*
+*******************************************************************************/
+void USB_VENDOR_CyBtldrCommStop(void)
+{
+    /* Stop the USB communication with detaching Device from the HOST */
+    USBD_DeInit();
+}
+
+
+/*******************************************************************************
+* Function Name: USB_VENDOR_CyBtldrCommReset
+****************************************************************************//**
+*
+* Resets the receive and transmits communication buffers.
+*
+*******************************************************************************/
+void USB_VENDOR_CyBtldrCommReset(void)
+{
+    packetRemaining = 0U;
+
+    if (USBD_IsConfigured() > 0U)
+    {
+        /* Cancel any read or write operation */
+        USBD_BULK_CancelRead(hInst);
+        USBD_BULK_CancelWrite(hInst);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: USB_VENDOR_CyBtldrCommRead
+****************************************************************************//**
+*
+* Allows the caller to read data from the DFU host (the host writes the
+* data). The function handles polling to allow a block of data to be completely
+* received from the host device.
+*
+* The bulk pipe is a byte stream, so the function frames the DFU packets itself:
+* it reads the packet header first and then waits for the remaining bytes of the
+* packet. It never returns more bytes than the current DFU packet contains, the
+* bytes which do not fit into the buffer are returned by the next call.
+*
+* \param pData   The pointer to a buffer to store a received command.
+* \param size    The number of bytes to be read.
+* \param count   The pointer to the variable that contains the number of received bytes.
+* \param timeout The time to wait before the function returns because of a timeout,
+*                in milliseconds.
+*
+* \return
+* The status of the operation:
+* - \ref CY_DFU_SUCCESS - If successful.
+* - \ref CY_DFU_ERROR_TIMEOUT - If no data has been received.
+* - See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+cy_en_dfu_status_t USB_VENDOR_CyBtldrCommRead(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t retCode = CY_DFU_ERROR_TIMEOUT;
+
+    CY_ASSERT_L1((pData != NULL) && (size > 0U) && (count != NULL));
+
+    /* Check Device enumeration */
+    if ((USBD_GetState() & (USB_STAT_CONFIGURED | USB_STAT_SUSPENDED)) == USB_STAT_CONFIGURED)
+    {
+        uint32_t received = 0U;
+        int32_t retVal;
+
+        if (packetRemaining == 0U)
+        {
+            uint32_t headerSize = (size < USB_VENDOR_PACKET_HEADER_SIZE) ? size : USB_VENDOR_PACKET_HEADER_SIZE;
+
+            /* Wait (blocking with timeout) for the start of a packet */
+            retVal = USBD_BULK_Receive(hInst, pData, size, timeout);
+
+            if (retVal > 0)
+            {
+                received = (uint32_t)retVal;
+
+                /* Complete the packet header */
+                if (received < headerSize)
+                {
+                    retVal = USBD_BULK_Read(hInst, &pData[received], headerSize - received, USB_VENDOR_PACKET_TIMEOUT_MS);
+                    received += (retVal > 0) ? (uint32_t)retVal : 0U;
+                }
+
+                if ((received >= USB_VENDOR_PACKET_HEADER_SIZE) && (pData[0U] == USB_VENDOR_PACKET_SOP))
+                {
+                    uint32_t packetSize = USB_VENDOR_PACKET_HEADER_SIZE + USB_VENDOR_PACKET_FOOTER_SIZE +
+                                          ((uint32_t)pData[USB_VENDOR_PACKET_SIZE_IDX] |
+                                          ((uint32_t)pData[USB_VENDOR_PACKET_SIZE_IDX + 1U] << 8U));
+
+                    packetRemaining = (packetSize > received) ? (packetSize - received) : 0U;
+                }
+            }
+        }
+        else
+        {
+            /* The previous call has not consumed the whole packet */
+            retVal = 0;
+        }
+
+        if (retVal >= 0)
+        {
+            uint32_t toRead = size - received;
+
+            if (toRead > packetRemaining)
+            {
+                toRead = packetRemaining;
+            }
+
+            if (toRead > 0U)
+            {
+                /* Read (blocking with timeout) the rest of the packet that fits into the buffer */
+                retVal = USBD_BULK_Read(hInst, &pData[received], toRead,
+                                        (received == 0U) ? timeout : USB_VENDOR_PACKET_TIMEOUT_MS);
+
+                if (retVal >= 0)
+                {
+                    received += (uint32_t)retVal;
+                    packetRemaining -= (uint32_t)retVal;
+
+                    /* The host stopped in the middle of a packet: resynchronize on the next one */
+                    if ((uint32_t)retVal < toRead)
+                    {
+                        packetRemaining = 0U;
+                    }
+                }
+            }
+        }
+
+        /* Data received successfully */
+        if (received > 0U)
+        {
+            *count = received;
+            retCode = CY_DFU_SUCCESS;
+        }
+
+        /* An error occurred */
+        if (retVal < 0)
+        {
+            packetRemaining = 0U;
+            retCode = CY_DFU_ERROR_UNKNOWN;
+        }
+    }
+
+    return (retCode);
+}
+
+
+/*******************************************************************************
+* Function Name: USB_VENDOR_CyBtldrCommWrite
+****************************************************************************//**
+*
+* Allows the caller to write data to the DFU host (the host reads the
+* data). The function uses a timeout and returns after data has been
+* copied into the transmit buffer. The data transmission starts immediately
+* after the first data element is written into the buffer and lasts until all
+* data elements from the buffer are sent. A zero-length packet terminates the
+* transfer when the size is a multiple of the endpoint size.
+*
+* \param pData     The pointer to the block of data to be written to the DFU
+*                  host.
+* \param size      The number of bytes to be written.
+* \param count     The pointer to the variable to write the number of actually written bytes.
+* \param timeout   The time out to wait for before the data is copied to the transmit buffer.
+*                  The function returns as soon as data is copied into the
+*                  transmit buffer.
+* \return
+* The status of the operation:
+* - \ref CY_DFU_SUCCESS - If successful.
+* - See \ref cy_en_dfu_status_t.
+*
+*******************************************************************************/
+cy_en_dfu_status_t USB_VENDOR_CyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t retCode = CY_DFU_ERROR_TIMEOUT;
+
+    CY_ASSERT_L1((pData != NULL) && (size > 0U) && (count != NULL));
+
+    /* Check Device enumeration */
+    if ((USBD_GetState() & (USB_STAT_CONFIGURED | USB_STAT_SUSPENDED)) == USB_STAT_CONFIGURED)
+    {
+        /* Wait (blocking with timeout) for an endpoint availability for a write */
+        if (USBD_BULK_WaitForTX(hInst, timeout) == 0)
+        {
+            /* Write data to the Host (blocking with timeout) */
+            int32_t retVal = USBD_BULK_Write(hInst, pData, size, 1, (int)timeout);
+            int32_t numBytes = size;
+
+            /* Data sent successfully */
+            if (retVal == numBytes)
+            {
+                *count = size;
+                retCode = CY_DFU_SUCCESS;
+            }
+
+            /* An error occurred */
+            if (retVal < 0)
+            {
+                retCode = CY_DFU_ERROR_UNKNOWN;
+            }
+        }
+    }
+
+    return (retCode);
+}
+
+
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t USB_VENDOR_CyBtldrCommOps =
+{
+    .transport     = CY_DFU_USB_VENDOR,
+    .start         = &USB_VENDOR_CyBtldrCommStart,
+    .stop          = &USB_VENDOR_CyBtldrCommStop,
+    .reset         = &USB_VENDOR_CyBtldrCommReset,
+    .read          = &USB_VENDOR_CyBtldrCommRead,
+    .write         = &USB_VENDOR_CyBtldrCommWrite,
+    .maxPacketSize = 0U,
+    .capabilities  = CY_DFU_TRANSPORT_CAP_ZERO_COPY
+};
+
+
+/* [] END OF FILE */
@@ -0,0 +1,78 @@
+/***************************************************************************//**
+* \file transport_usb_vendor.h
+* \version 5.2
+*
+* This file provides the constants and parameter values of the DFU communication
+* API implementation for the emUSB-Device that implements a vendor-specific
+* class with a pair of bulk endpoints.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if !defined(TRANSPORT_USB_VENDOR_H)
+#define TRANSPORT_USB_VENDOR_H
+
+#include "cy_dfu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/***************************************
+*    Variables with External Linkage
+***************************************/
+
+extern bool USB_DEV_VENDOR_initVar;
+extern const cy_stc_dfu_transport_ops_t USB_VENDOR_CyBtldrCommOps;
+
+
+/***************************************
+*        Function Prototypes
+***************************************/
+
+/* The USB device vendor class DFU physical layer functions */
+void USB_VENDOR_CyBtldrCommStart(void);
+void USB_VENDOR_CyBtldrCommStop (void);
+void USB_VENDOR_CyBtldrCommReset(void);
+cy_en_dfu_status_t USB_VENDOR_CyBtldrCommRead (uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t USB_VENDOR_CyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !defined(TRANSPORT_USB_VENDOR_H) */
+
+
+/* [] END OF FILE */
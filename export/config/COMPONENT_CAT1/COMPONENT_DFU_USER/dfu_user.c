@@ -41,6 +41,7 @@
 * indemnify Cypress against all liability.
 *******************************************************************************/
 
+#include <stddef.h>
 #include <string.h>
 #include "cy_syslib.h"
 #include "cyhal.h"
@@ -71,115 +72,300 @@
     #include "transport_emusb_hid.h"
 #endif  /* COMPONENT_DFU_EMUSB_HID */
 
+#ifdef COMPONENT_DFU_USB_VENDOR
+    #include "transport_usb_vendor.h"
+#endif  /* COMPONENT_DFU_USB_VENDOR */
+
 #ifdef COMPONENT_DFU_CANFD
     #include "transport_canfd.h"
 #endif  /* COMPONENT_DFU_CANFD */
 
+#if CY_DFU_OPT_NOR != 0
+    #include "cy_smif.h"
+#endif /* CY_DFU_OPT_NOR != 0 */
+
 /* Global flash object */
 static cyhal_nvm_t flash_obj;
 
-static cy_en_dfu_transport_t selectedInterface = CY_DFU_UART;
+/* The transports compiled into the project, terminated with NULL */
+static const cy_stc_dfu_transport_ops_t * const transportList[] =
+{
+#ifdef COMPONENT_DFU_I2C
+    &I2C_I2cCyBtldrCommOps,
+#endif /* COMPONENT_DFU_I2C */
+#ifdef COMPONENT_DFU_UART
+    &UART_UartCyBtldrCommOps,
+#endif /* COMPONENT_DFU_UART */
+#ifdef COMPONENT_DFU_SPI
+    &SPI_SpiCyBtldrCommOps,
+#endif /* COMPONENT_DFU_SPI */
+#ifdef COMPONENT_DFU_USB_CDC
+    &USB_CDC_CyBtldrCommOps,
+#endif /* COMPONENT_DFU_USB_CDC */
+#ifdef COMPONENT_DFU_EMUSB_CDC
+    &USB_CDC_CyBtldrCommOps,
+#endif /* COMPONENT_DFU_EMUSB_CDC */
+#ifdef COMPONENT_DFU_EMUSB_HID
+    &USB_HID_CyBtldrCommOps,
+#endif /* COMPONENT_DFU_EMUSB_HID */
+#ifdef COMPONENT_DFU_USB_VENDOR
+    &USB_VENDOR_CyBtldrCommOps,
+#endif /* COMPONENT_DFU_USB_VENDOR */
+#ifdef COMPONENT_DFU_CANFD
+    &CANFD_CanfdCyBtldrCommOps,
+#endif /* COMPONENT_DFU_CANFD */
+    NULL
+};
+
+/* The number of the transports in transportList */
+#define TRANSPORT_COUNT     ((sizeof(transportList) / sizeof(transportList[0])) - 1U)
+
+/* The transport selected with Cy_DFU_TransportStart(), or the one that received
+* the last packet when all the transports are listened to */
+static const cy_stc_dfu_transport_ops_t *selectedTransport = NULL;
+
+/* Indicates that all the transports are listened to until the session locks on one */
+static bool listenAll = false;
+
+/* The transport to poll first on the next read when all the transports are listened to */
+static uint32_t pollIndex = 0U;
+
+/* The number of the transports listened to with CY_DFU_ALL, see TransportListened() */
+static uint32_t listenCount = 0U;
+
+static bool TransportOnEmUsb(const cy_stc_dfu_transport_ops_t *transport);
+static bool TransportListened(uint32_t index);
 
 #ifdef CY_IP_M7CPUSS
     static const cyhal_flash_block_info_t* blocks_info;
     static uint8_t blocks_count;
-    static uint32_t blocks_sector_size;
 #endif
 
+#if CY_DFU_OPT_NOR != 0
+    /* The SMIF block and the slave select of the external serial NOR. The clock
+    * and the pins of the SMIF are configured by the device configurator. */
+    #ifndef NOR_SMIF_HW
+        #define NOR_SMIF_HW             (SMIF0)
+    #endif /* NOR_SMIF_HW */
+    #ifndef NOR_SMIF_SLAVE_SELECT
+        #define NOR_SMIF_SLAVE_SELECT   (CY_SMIF_SLAVE_SELECT_0)
+    #endif /* NOR_SMIF_SLAVE_SELECT */
+    /* The address of the serial NOR content for the DFU SDK, the XIP region */
+    #ifndef NOR_ADDRESS
+        #define NOR_ADDRESS             (CY_XIP_BASE)
+    #endif /* NOR_ADDRESS */
+    /* The timeout in microseconds of the blocking SMIF transfers */
+    #define NOR_SMIF_TIMEOUT_US         (10000U)
+
+    static cy_stc_smif_context_t smifContext;
+    static cy_stc_dfu_nor_t norDevice;
+    /* The NVM region of the serial NOR, empty until NorStart() initializes it */
+    static cy_stc_dfu_nvm_region_t norRegion;
+
+    static void NorStart(void);
+    static cy_en_dfu_status_t NorCommand(const cy_stc_dfu_nor_cmd_t *cmd, void *context);
+    static bool NorMapped(void *context);
+
+    /* The serial NOR interface of the SMIF for the DFU SDK */
+    static const cy_stc_dfu_nor_ops_t norOps = { &NorCommand, &NorMapped };
+
+    #define NVM_REGIONS_NOR             (1U)
+#else
+    #define NVM_REGIONS_NOR             (0U)
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+static cy_en_dfu_status_t FlashRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                    uint32_t length);
+static cy_en_dfu_status_t FlashProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                       const uint8_t data[], uint32_t length);
+
+#if (CY_DFU_OPT_NVM_ASYNC != 0) && !defined(CY_IP_M7CPUSS)
+    /* The rows are written with cyhal_flash_start_write(), FlashPoll() starts the next one */
+    #define FLASH_ASYNC                 (1)
+    #define FLASH_POLL                  (&FlashPoll)
+
+    static cy_en_dfu_status_t FlashPoll(const cy_stc_dfu_nvm_region_t *region);
+
+    /* The row being written, and the end address and the data of the range */
+    static uint32_t flashWriteAddress;
+    static uint32_t flashWriteEnd;
+    static const uint8_t *flashWriteData;
+#else
+    #define FLASH_ASYNC                 (0)
+    #define FLASH_POLL                  (NULL)
+#endif /* (CY_DFU_OPT_NVM_ASYNC != 0) && !defined(CY_IP_M7CPUSS) */
+
+#ifdef CY_IP_M7CPUSS
+    static cy_en_dfu_status_t FlashErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length);
+
+    /* The maximum number of the flash blocks in the NVM regions */
+    #define FLASH_BLOCKS_MAX            (8U)
+    #define NVM_REGIONS_FLASH           (FLASH_BLOCKS_MAX)
+
+    /* The code and work flash blocks, erased in sectors and programmed in pages */
+    static cy_stc_dfu_nvm_region_t flashRegions[FLASH_BLOCKS_MAX];
+#else
+    #if defined(CY_FLASH_BASE)
+        #define FLASH_REGION_ADDRESS    (CY_FLASH_BASE)
+        #define FLASH_REGION_SIZE       (CY_FLASH_SIZE)
+    #else
+        /* The address validation is skipped: the flash region is the whole address space */
+        #define FLASH_REGION_ADDRESS    (0U)
+        #define FLASH_REGION_SIZE       (0xFFFFFFFFU)
+    #endif /* defined(CY_FLASH_BASE) */
+
+    /* The flash, written in rows with cyhal_flash_write() that erases them */
+    static const cy_stc_dfu_nvm_region_t flashRegion =
+    {
+        FLASH_REGION_ADDRESS, FLASH_REGION_SIZE, CY_NVM_SIZEOF_ROW, 0U, &FlashRead, NULL, NULL, &FlashProgram,
+        FLASH_POLL, NULL
+    };
+
+    #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+        /* The emulated EEPROM, written like the flash */
+        static const cy_stc_dfu_nvm_region_t eepromRegion =
+        {
+            CY_EM_EEPROM_BASE, CY_EM_EEPROM_SIZE, CY_NVM_SIZEOF_ROW, 0U, &FlashRead, NULL, NULL, &FlashProgram,
+            FLASH_POLL, NULL
+        };
+
+        #define NVM_REGIONS_FLASH       (2U)
+    #else
+        #define NVM_REGIONS_FLASH       (1U)
+    #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+#endif /* CY_IP_M7CPUSS */
+
+/* The maximum number of the NVM regions */
+#define NVM_REGIONS_MAX                 (NVM_REGIONS_FLASH + NVM_REGIONS_NOR)
+
+/* The NVM regions of Cy_DFU_WriteData() and Cy_DFU_ReadData(), terminated with
+* NULL, built by NvmRegionsBuild(). The regions of other memories, such as RAM,
+* are added there. */
+static const cy_stc_dfu_nvm_region_t *nvmRegions[NVM_REGIONS_MAX + 1U];
+
+static void NvmRegionsBuild(void);
+
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    #if CY_DFU_OPT_METADATA_JOURNAL != 0
+        /* The index in cy_dfu_metadata of a field of the record in a journal row */
+        #define JOURNAL_WORD(row, field)    ( ( ((row) * CY_FLASH_SIZEOF_ROW) + \
+                                                offsetof(cy_stc_dfu_app_metadata_t, field) ) / sizeof(uint32_t) )
+    #endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+
     /*
     * The DFU SDK metadata initial value is placed here
     * Note: the number of elements equal to the number of the app multiplies by 2
     *       because of the two fields per app plus one element for the CRC-32C field.
     */
     CY_SECTION(".cy_boot_metadata") __USED
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+    /* The initial journal records of App0 and App1 in rows 0 and 1, the sequence number 0 needs no CRC
+    * but the row must be the application number */
+    static const uint32_t cy_dfu_metadata[CY_DFU_METADATA_LENGTH / sizeof(uint32_t)] =
+    {
+        [JOURNAL_WORD(0U, verifyAddress)] = CY_DFU_APP0_VERIFY_START, CY_DFU_APP0_VERIFY_LENGTH,
+        [JOURNAL_WORD(0U, appId)]         = 0U, 0U, CY_DFU_METADATA_JOURNAL_MAGIC,
+        [JOURNAL_WORD(1U, verifyAddress)] = CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH,
+        [JOURNAL_WORD(1U, appId)]         = 1U, 0U, CY_DFU_METADATA_JOURNAL_MAGIC
+    };
+#elif CY_DFU_OPT_METADATA_V2 != 0
+    /* The metadata header and the App0 and App1 records, the CRCs are written by the first metadata update */
+    static const uint32_t cy_dfu_metadata[CY_DFU_METADATA_LENGTH / sizeof(uint32_t)] =
+    {
+        CY_DFU_METADATA_MAGIC,                                          /* The metadata header          */
+        CY_DFU_METADATA_VERSION | (CY_DFU_METADATA_RECORD_SIZE << 16U),
+        CY_DFU_MAX_APPS, CY_FLASH_SIZEOF_ROW,
+        0U,                                                             /* The header CRC-32C           */
+        [CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
+            CY_DFU_APP0_VERIFY_START, CY_DFU_APP0_VERIFY_LENGTH,        /* The App0 record              */
+        [(CY_FLASH_SIZEOF_ROW + CY_DFU_METADATA_RECORD_SIZE) / sizeof(uint32_t)] =
+            CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH         /* The App1 record              */
+    };
+#else
     static const uint32_t cy_dfu_metadata[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
     {
         CY_DFU_APP0_VERIFY_START, CY_DFU_APP0_VERIFY_LENGTH, /* The App0 base address and length */
         CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH, /* The App1 base address and length */
         0U                                                             /* The rest does not matter     */
     };
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
 #endif /*CY_DFU_FLOW == CY_DFU_BASIC_FLOW*/
 
 
-static bool IsMultipleOf(uint32_t value, uint32_t multiple);
-static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params);
-
-
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
     static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t *endAddress);
-#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+    /* The golden image check of an application, kept for the update session */
+    typedef enum
+    {
+        GOLDEN_UNKNOWN = 0,     /* Not validated in this session */
+        GOLDEN_VALID,           /* Valid, the writes to it are refused */
+        GOLDEN_INVALID          /* Invalid, the writes to it are allowed */
+    } golden_state_t;
 
-/*******************************************************************************
-* Function Name: IsMultipleOf
-****************************************************************************//**
-*
-* This internal function check if value parameter is a multiple of parameter
-* multiple
-*
-* \param value      value that will be checked
-* \param multiple   value with which value is checked
-*
-* \return True - value is multiple of parameter multiple, else False
-*
-*******************************************************************************/
-static bool IsMultipleOf(uint32_t value, uint32_t multiple)
-{
-    return ((value % multiple) == 0U);
-}
+    typedef struct
+    {
+        uint32_t startAddress;  /* The application range the state is for */
+        uint32_t endAddress;
+        golden_state_t state;
+    } golden_image_t;
 
+    static const uint8_t goldenImages[] = { CY_DFU_GOLDEN_IMAGE_IDS() };
 
-/*******************************************************************************
-* Function Name: AddressValid
-****************************************************************************//**
-*
-* Internal function to validate address
-*
-* \param address    The address to check.
-* \param params     The pointer to a DFU parameters structure, see \ref cy_stc_dfu_params_t.
-*
-* \return True - address valid
-*
-*******************************************************************************/
-static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params)
+    /* The number of the golden images */
+    #define GOLDEN_IMAGE_COUNT  (sizeof(goldenImages) / sizeof(goldenImages[0]))
+
+    static golden_image_t goldenCache[GOLDEN_IMAGE_COUNT];
+
+    static cy_en_dfu_status_t GoldenImageCheck(uint32_t golden, cy_stc_dfu_params_t *params);
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+/* The class of an NVM address range in the region index */
+typedef enum
 {
-    bool addrValid = true;
+    REGION_NONE = 0,        /* Not an NVM the DFU SDK accesses */
+    REGION_WRITABLE,        /* Can be read and written */
+    REGION_RUNNING,         /* The running application, cannot be written */
+    REGION_GOLDEN           /* A golden image, see GoldenImageCheck() */
+} region_type_t;
+
+/* A range of the region index, from startAddress up to the start of the next range */
+typedef struct
+{
+    uint32_t startAddress;
+    region_type_t type;
+    uint32_t golden;        /* The index in goldenImages of a REGION_GOLDEN range */
+    const cy_stc_dfu_nvm_region_t *nvm;     /* The NVM region of the range, NULL for REGION_NONE */
+} region_t;
 
+/* The number of the application bounds in the region index: the end of App0,
+* the running application and the golden images */
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
-    addrValid = ((((CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH)) <= address) &&
-                                (address < (CY_FLASH_BASE + CY_FLASH_SIZE))) ||
-                ((CY_EM_EEPROM_BASE <= address) &&
-                        (address < (CY_EM_EEPROM_BASE + CY_EM_EEPROM_SIZE)));
-    CY_UNUSED_PARAMETER(params);
-#else /* MCUBoot flow*/
-    #ifdef CY_IP_M7CPUSS
-        blocks_sector_size = 0U;
-        for (uint32_t block_num = 0U; block_num < blocks_count; block_num++)
-        {
-            uint32_t flash_start_address = (&blocks_info[block_num])->start_address;
-            uint32_t flash_size = (&blocks_info[block_num])->size;
-            if ((flash_start_address <= address) && (address < flash_start_address + flash_size))
-            {
-                blocks_sector_size = (&blocks_info[0])->sector_size;
-                break;
-            }
-        }
-        addrValid = (blocks_sector_size > 0U);
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+        #define REGION_APP_BOUNDS       (3U + (2U * GOLDEN_IMAGE_COUNT))
     #else
-        #if defined CY_FLASH_BASE
-            addrValid = (CY_FLASH_BASE <= address) &&
-                        (address < (CY_FLASH_BASE + CY_FLASH_SIZE));
-        #else
-            CY_DFU_LOG_WRN("Address validation skipped");
-            CY_UNUSED_PARAMETER(address);
-        #endif /* defined CY_FLASH_BASE */
-        CY_UNUSED_PARAMETER(params);
-    #endif /* CY_IP_M7CPUSS */
+        #define REGION_APP_BOUNDS       (3U)
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+#else
+    #define REGION_APP_BOUNDS           (0U)
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
-    return addrValid;
-}
+/* The maximum number of the ranges in the region index: a range starts at
+* each start and end address of the NVM regions and at each application bound */
+#define REGION_INDEX_SIZE               ((2U * NVM_REGIONS_MAX) + REGION_APP_BOUNDS)
+
+/* The NVM address ranges sorted by the start address, built by RegionIndexBuild() */
+static region_t regionIndex[REGION_INDEX_SIZE];
+
+/* The number of the ranges in regionIndex, 0 if the index must be built again */
+static uint32_t regionCount = 0U;
+
+static void RegionIndexBuild(void);
+static void RegionBoundAdd(uint32_t bounds[], uint32_t *count, uint32_t address);
+static void RegionClassify(uint32_t address, region_t *region);
+static const region_t *RegionFind(uint32_t address);
 
 
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
@@ -211,165 +397,694 @@ static bool AddressValid(uint32_t address, cy_stc_dfu_params_t *params)
         *endAddress = verifyStart + verifySize + CY_DFU_SIGNATURE_SIZE;
     #endif
     }
+
+
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+    /*******************************************************************************
+    * Function Name: GoldenImageCheck
+    ****************************************************************************//**
+    *
+    * This internal function refuses a write to a valid golden image.
+    *
+    * A golden image is validated with Cy_DFU_ValidateApp() on the first write to
+    * its range in an update session, and the result is kept until the session
+    * ends (Cy_DFU_GoldenImageInvalidate()) or the metadata of the golden image
+    * changes (RegionIndexBuild()), instead of validating the whole image before
+    * each row. An invalid golden image stays writable for the rest of the
+    * session, so the DFU Host can restore it.
+    *
+    * \param golden     The index of the golden image in goldenImages.
+    * \param params     The pointer to a DFU parameters structure.
+    *
+    * \return
+    * - CY_DFU_SUCCESS if the golden image is invalid.
+    * - CY_DFU_ERROR_ADDRESS if the golden image is valid.
+    *
+    *******************************************************************************/
+    static cy_en_dfu_status_t GoldenImageCheck(uint32_t golden, cy_stc_dfu_params_t *params)
+    {
+        golden_image_t *image = &goldenCache[golden];
+
+        if (image->state == GOLDEN_UNKNOWN)
+        {
+            image->state = (Cy_DFU_ValidateApp(goldenImages[golden], params) == CY_DFU_SUCCESS) ?
+                           GOLDEN_VALID : GOLDEN_INVALID;
+        }
+
+        return ((image->state == GOLDEN_VALID) ? CY_DFU_ERROR_ADDRESS : CY_DFU_SUCCESS);
+    }
+
+
+    /*******************************************************************************
+    * Function Name: Cy_DFU_GoldenImageInvalidate
+    ****************************************************************************//**
+    *
+    * This function documentation is part of the DFU SDK API, see the
+    * cy_dfu.h file or DFU SDK API Reference Manual for details.
+    *
+    *******************************************************************************/
+    void Cy_DFU_GoldenImageInvalidate(void)
+    {
+        (void) memset(goldenCache, 0, sizeof(goldenCache));
+        /* The index is built again with the current metadata at the session start */
+        regionCount = 0U;
+    }
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
 #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_WriteData
+* Function Name: RegionIndexBuild
 ****************************************************************************//**
 *
-* This function documentation is part of the DFU SDK API, see the
-* cy_dfu.h file or DFU SDK API Reference Manual for details.
+* This internal function builds the region index: the NVM address ranges
+* sorted by the start address, each classified as not accessible, writable,
+* the running application or a golden image, with its NVM region. A range
+* starts at each start and end address of the NVM regions and the application
+* areas, so the class of an address is the class of the last range that starts
+* at or below it.
+*
+* The index is built by Cy_DFU_TransportStart(), and again after the metadata
+* is written, so the validation of each row address is a binary search instead
+* of reading the metadata and scanning the NVM regions.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_WriteData (uint32_t address, uint32_t length, uint32_t ctl,
-                                               cy_stc_dfu_params_t *params)
+static void RegionIndexBuild(void)
 {
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
-
-    /* Check if the address is inside the valid range */
-    if(!AddressValid(address, params))
-    {
-        status = CY_DFU_ERROR_ADDRESS;
-    }
+    uint32_t bounds[REGION_INDEX_SIZE];
+    uint32_t count = 0U;
+    uint32_t idx;
 
-    /* Check if the length is valid
-     * Note Length = 0 is valid for erase command */
-    if ( (IsMultipleOf(address, CY_NVM_SIZEOF_ROW) == 0U) ||
-         ( (length != CY_NVM_SIZEOF_ROW) && ( (ctl & CY_DFU_IOCTL_ERASE) == 0U) ) )
+    for (idx = 0U; nvmRegions[idx] != NULL; ++idx)
     {
-        status = CY_DFU_ERROR_LENGTH;
+        RegionBoundAdd(bounds, &count, nvmRegions[idx]->address);
+        RegionBoundAdd(bounds, &count, nvmRegions[idx]->address + nvmRegions[idx]->size);
     }
 
 #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
-    uint32_t app = Cy_DFU_GetRunningApp();
     uint32_t startAddress;
     uint32_t endAddress;
 
-    GetStartEndAddress(app, &startAddress, &endAddress);
+    RegionBoundAdd(bounds, &count, CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH);
+    GetStartEndAddress(Cy_DFU_GetRunningApp(), &startAddress, &endAddress);
+    RegionBoundAdd(bounds, &count, startAddress);
+    RegionBoundAdd(bounds, &count, endAddress);
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+        for (idx = 0U; idx < GOLDEN_IMAGE_COUNT; ++idx)
+        {
+            golden_image_t *golden = &goldenCache[idx];
+
+            GetStartEndAddress(goldenImages[idx], &startAddress, &endAddress);
+            if ( (golden->startAddress != startAddress) || (golden->endAddress != endAddress) )
+            {   /* The result of the golden image check is for its previous range */
+                golden->startAddress = startAddress;
+                golden->endAddress = endAddress;
+                golden->state = GOLDEN_UNKNOWN;
+            }
+            RegionBoundAdd(bounds, &count, startAddress);
+            RegionBoundAdd(bounds, &count, endAddress);
+        }
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
 
-    /* Refuse to write to a row within a range of the current application */
-    if ( (startAddress <= address) && (address < endAddress) )
-    {   /* It is forbidden to overwrite the currently running application */
-        status = CY_DFU_ERROR_ADDRESS;
+    for (idx = 0U; idx < count; ++idx)
+    {
+        RegionClassify(bounds[idx], &regionIndex[idx]);
     }
+    regionCount = count;
+}
 
-    #if CY_DFU_OPT_GOLDEN_IMAGE
-        if (status == CY_DFU_SUCCESS)
+
+/*******************************************************************************
+* Function Name: RegionBoundAdd
+****************************************************************************//**
+*
+* This internal function inserts an address into the sorted bounds of the
+* region index, unless it is there already.
+*
+* \param bounds     The sorted addresses.
+* \param count      The pointer to the number of the addresses in bounds.
+* \param address    The address to insert.
+*
+*******************************************************************************/
+static void RegionBoundAdd(uint32_t bounds[], uint32_t *count, uint32_t address)
+{
+    uint32_t idx = *count;
+
+    while ( (idx > 0U) && (bounds[idx - 1U] > address) )
+    {
+        --idx;
+    }
+    if ( (idx == 0U) || (bounds[idx - 1U] != address) )
+    {
+        (void) memmove(&bounds[idx + 1U], &bounds[idx], (*count - idx) * sizeof(bounds[0]));
+        bounds[idx] = address;
+        ++(*count);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RegionClassify
+****************************************************************************//**
+*
+* This internal function classifies the range of the region index that starts
+* at the address, by its NVM region and the address checks of
+* Cy_DFU_WriteData().
+*
+* \param address    The start address of the range.
+* \param region     The pointer to the range to fill.
+*
+*******************************************************************************/
+static void RegionClassify(uint32_t address, region_t *region)
+{
+    region->startAddress = address;
+    region->nvm = Cy_DFU_NvmRegionFind(nvmRegions, address, 0U);
+    region->type = (region->nvm != NULL) ? REGION_WRITABLE : REGION_NONE;
+    region->golden = 0U;
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    if ( (CY_FLASH_BASE <= address) && (address < (CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH)) )
+    {   /* Note that App0 is out of range */
+        region->type = REGION_NONE;
+        region->nvm = NULL;
+    }
+    if (region->type == REGION_WRITABLE)
+    {
+        uint32_t startAddress;
+        uint32_t endAddress;
+
+        GetStartEndAddress(Cy_DFU_GetRunningApp(), &startAddress, &endAddress);
+        if ( (startAddress <= address) && (address < endAddress) )
+        {   /* It is forbidden to overwrite the currently running application */
+            region->type = REGION_RUNNING;
+        }
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+        for (uint32_t idx = 0U; (region->type == REGION_WRITABLE) && (idx < GOLDEN_IMAGE_COUNT); ++idx)
         {
-            uint8_t goldenImages[] = { CY_DFU_GOLDEN_IMAGE_IDS() };
-            uint32_t count = sizeof(goldenImages) / sizeof(goldenImages[0]);
-            uint32_t idx;
-            for (idx = 0U; idx < count; ++idx)
+            if ( (goldenCache[idx].startAddress <= address) && (address < goldenCache[idx].endAddress) )
             {
-                app = goldenImages[idx];
-                GetStartEndAddress(app, &startAddress, &endAddress);
-
-                if ( (startAddress <= address) && (address < endAddress) )
-                {
-                    status = Cy_DFU_ValidateApp(app, params);
-                    status = (status == CY_DFU_SUCCESS) ? CY_DFU_ERROR_ADDRESS : CY_DFU_SUCCESS;
-                    break;
-                }
+                region->type = REGION_GOLDEN;
+                region->golden = idx;
             }
         }
-    #endif /* #if CY_DFU_OPT_GOLDEN_IMAGE != 0 */
-#endif /*CY_DFU_FLOW == CY_DFU_BASIC_FLOW*/
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+    }
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+}
 
-    if (status == CY_DFU_SUCCESS)
+
+/*******************************************************************************
+* Function Name: RegionFind
+****************************************************************************//**
+*
+* This internal function finds the range of the region index the address is in,
+* and builds the index if it is not built.
+*
+* \param address    The address to find.
+*
+* \return The pointer to the range, with the REGION_NONE class if the address
+*         is not in an NVM the DFU SDK accesses.
+*
+*******************************************************************************/
+static const region_t *RegionFind(uint32_t address)
+{
+    static const region_t noRegion = { 0U, REGION_NONE, 0U, NULL };
+    const region_t *region = &noRegion;
+    uint32_t low = 0U;
+    uint32_t high;
+
+    if (regionCount == 0U)
+    {
+        RegionIndexBuild();
+    }
+
+    /* The last range that starts at or below the address */
+    high = regionCount;
+    while (low < high)
     {
-        if ((ctl & CY_DFU_IOCTL_ERASE) != 0U)
+        uint32_t mid = (low + high) / 2U;
+        if (regionIndex[mid].startAddress <= address)
+        {
+            low = mid + 1U;
+        }
+        else
         {
-            (void) memset(params->dataBuffer, 0, CY_NVM_SIZEOF_ROW);
+            high = mid;
         }
+    }
+    if (low > 0U)
+    {
+        region = &regionIndex[low - 1U];
+    }
 
-        cy_rslt_t fstatus = CY_RSLT_SUCCESS;
+    return (region);
+}
 
-        #ifdef CY_IP_M7CPUSS
-            uint32_t int_status;
-            int_status = Cy_SysLib_EnterCriticalSection();
-            if(address % blocks_sector_size == 0U)
-            {
-                fstatus = cyhal_flash_erase(&flash_obj, address);
-            }
-            if(fstatus == CY_RSLT_SUCCESS)
-            {
-                fstatus = cyhal_flash_program(&flash_obj, address, (uint32_t*)params->dataBuffer);
-            }
-            else
+
+/*******************************************************************************
+* Function Name: NvmRegionsBuild
+****************************************************************************//**
+*
+* This internal function builds the table of the NVM regions: the serial NOR
+* first, then the flash blocks of the device and the emulated EEPROM.
+*
+*******************************************************************************/
+static void NvmRegionsBuild(void)
+{
+    uint32_t count = 0U;
+
+#if CY_DFU_OPT_NOR != 0
+    nvmRegions[count] = &norRegion;
+    ++count;
+#endif /* CY_DFU_OPT_NOR != 0 */
+#ifdef CY_IP_M7CPUSS
+    for (uint32_t idx = 0U; (idx < blocks_count) && (idx < FLASH_BLOCKS_MAX); ++idx)
+    {
+        cy_stc_dfu_nvm_region_t *region = &flashRegions[idx];
+
+        region->address = (&blocks_info[idx])->start_address;
+        region->size = (&blocks_info[idx])->size;
+        region->programSize = (&blocks_info[idx])->page_size;
+        region->eraseSize = (&blocks_info[idx])->sector_size;
+        region->read = &FlashRead;
+        region->compare = NULL;
+        region->erase = &FlashErase;
+        region->program = &FlashProgram;
+        region->poll = NULL;
+        region->context = NULL;
+        nvmRegions[count] = region;
+        ++count;
+    }
+#else
+    #if !defined(CY_FLASH_BASE)
+        CY_DFU_LOG_WRN("Address validation skipped");
+    #endif /* !defined(CY_FLASH_BASE) */
+    nvmRegions[count] = &flashRegion;
+    ++count;
+    #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+        nvmRegions[count] = &eepromRegion;
+        ++count;
+    #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+#endif /* CY_IP_M7CPUSS */
+    nvmRegions[count] = NULL;
+}
+
+
+/*******************************************************************************
+* Function Name: FlashRead
+****************************************************************************//**
+*
+* This internal function reads the flash, the read function of the flash
+* regions.
+*
+* \param region     The NVM region.
+* \param address    The address of the first byte.
+* \param data       The buffer for the content.
+* \param length     The number of the bytes to read.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the HAL fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint8_t data[],
+                                    uint32_t length)
+{
+    CY_UNUSED_PARAMETER(region);
+
+    cy_rslt_t fstatus = cyhal_flash_read(&flash_obj, address, data, length);
+
+    return ((fstatus == CY_RSLT_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+}
+
+
+#ifdef CY_IP_M7CPUSS
+/*******************************************************************************
+* Function Name: FlashErase
+****************************************************************************//**
+*
+* This internal function erases the sectors of a flash block, the erase
+* function of the flash regions.
+*
+* \param region     The NVM region of the flash block.
+* \param address    The address of the first sector.
+* \param length     The length of the sectors in bytes.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the HAL fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
+{
+    cy_rslt_t fstatus = CY_RSLT_SUCCESS;
+
+    for (uint32_t offset = 0U; (fstatus == CY_RSLT_SUCCESS) && (offset < length); offset += region->eraseSize)
+    {
+        uint32_t int_status = Cy_SysLib_EnterCriticalSection();
+        fstatus = cyhal_flash_erase(&flash_obj, address + offset);
+        Cy_SysLib_ExitCriticalSection(int_status);
+    }
+    if (fstatus != CY_RSLT_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash erase failed: module=0x%X code=0x%X",
+                            (unsigned int)CY_RSLT_GET_MODULE(fstatus),
+                            (unsigned int)CY_RSLT_GET_CODE(fstatus));
+    }
+    return ((fstatus == CY_RSLT_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+}
+#endif /* CY_IP_M7CPUSS */
+
+
+/*******************************************************************************
+* Function Name: FlashProgram
+****************************************************************************//**
+*
+* This internal function programs the flash, the program function of the
+* flash regions: in the pages of a flash block with cyhal_flash_program() on
+* the devices with the M7 core, in the rows with cyhal_flash_write(), which
+* erases them, otherwise. With CY_DFU_OPT_NVM_ASYNC, the devices without the M7
+* core start the first row with cyhal_flash_start_write() instead, and
+* FlashPoll() writes the rest.
+*
+* \param region     The NVM region.
+* \param address    The address of the first page or row.
+* \param data       The data, 4-byte aligned.
+* \param length     The length of the pages or rows in bytes.
+*
+* \return CY_DFU_SUCCESS, CY_DFU_IN_PROGRESS if the first row is started, or
+* CY_DFU_ERROR_DATA if the HAL fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                       const uint8_t data[], uint32_t length)
+{
+    cy_rslt_t fstatus = CY_RSLT_SUCCESS;
+
+#if FLASH_ASYNC != 0
+    CY_UNUSED_PARAMETER(region);
+
+    flashWriteAddress = address;
+    flashWriteEnd = address + length;
+    flashWriteData = data;
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting uint8_t* to uint32_t* is safe as the data buffer is 4-byte aligned.');
+    fstatus = cyhal_flash_start_write(&flash_obj, address, (const uint32_t *)data);
+    if (fstatus != CY_RSLT_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_RSLT_SUCCESS) ? CY_DFU_IN_PROGRESS : CY_DFU_ERROR_DATA);
+#else
+    for (uint32_t offset = 0U; (fstatus == CY_RSLT_SUCCESS) && (offset < length); offset += region->programSize)
+    {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting uint8_t* to uint32_t* is safe as the data buffer is 4-byte aligned.');
+        const uint32_t *words = (const uint32_t *)&data[offset];
+    #ifdef CY_IP_M7CPUSS
+        uint32_t int_status = Cy_SysLib_EnterCriticalSection();
+        fstatus = cyhal_flash_program(&flash_obj, address + offset, words);
+        Cy_SysLib_ExitCriticalSection(int_status);
+    #else
+        fstatus = cyhal_flash_write(&flash_obj, address + offset, words);
+    #endif /* CY_IP_M7CPUSS */
+    }
+    if (fstatus != CY_RSLT_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_RSLT_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+#endif /* FLASH_ASYNC != 0 */
+}
+
+
+#if FLASH_ASYNC != 0
+/*******************************************************************************
+* Function Name: FlashPoll
+****************************************************************************//**
+*
+* This internal function continues the write started by FlashProgram(), the
+* poll function of the flash regions: starts the next row with
+* cyhal_flash_start_write() when the current one completes.
+*
+* \param region     The NVM region.
+*
+* \return CY_DFU_IN_PROGRESS until the last row completes, then
+* CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the HAL fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashPoll(const cy_stc_dfu_nvm_region_t *region)
+{
+    cy_en_dfu_status_t status = CY_DFU_IN_PROGRESS;
+
+    if (cyhal_flash_is_operation_complete(&flash_obj))
+    {
+        flashWriteAddress += region->programSize;
+        flashWriteData = &flashWriteData[region->programSize];
+        if (flashWriteAddress >= flashWriteEnd)
+        {
+            status = CY_DFU_SUCCESS;
+        }
+        else
+        {
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting uint8_t* to uint32_t* is safe as the data buffer is 4-byte aligned.');
+            cy_rslt_t fstatus = cyhal_flash_start_write(&flash_obj, flashWriteAddress, (const uint32_t *)flashWriteData);
+            if (fstatus != CY_RSLT_SUCCESS)
             {
+                CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
                 status = CY_DFU_ERROR_DATA;
-                CY_DFU_LOG_ERR("Flash erase failed: module=0x%X code=0x%X",
-                                    (unsigned int)CY_RSLT_GET_MODULE(fstatus),
-                                    (unsigned int)CY_RSLT_GET_CODE(fstatus));
             }
-            Cy_SysLib_ExitCriticalSection(int_status);
-        #else
-            fstatus = cyhal_flash_write(&flash_obj, address, (uint32_t*)params->dataBuffer);
-        #endif /* CY_IP_M7CPUSS */
-        if((CY_DFU_SUCCESS == status) && (fstatus != CY_RSLT_SUCCESS))
+        }
+    }
+    return (status);
+}
+#endif /* FLASH_ASYNC != 0 */
+
+
+#if CY_DFU_OPT_NOR != 0
+/*******************************************************************************
+* Function Name: NorStart
+****************************************************************************//**
+*
+* This internal function initializes the SMIF block in the normal mode and the
+* serial NOR driver from the SFDP tables of the device. The user's code can map
+* the device in the memory mode after Cy_DFU_TransportStart(), then the serial
+* NOR is read through XIP.
+*
+*******************************************************************************/
+static void NorStart(void)
+{
+    static const cy_stc_smif_config_t smifConfig =
+    {
+        .mode = (uint32_t)CY_SMIF_NORMAL,
+        .deselectDelay = 1U,
+        .rxClockSel = (uint32_t)CY_SMIF_SEL_INV_INTERNAL_CLK,
+        .blockEvent = (uint32_t)CY_SMIF_BUS_ERROR
+    };
+
+    if (norDevice.size == 0U)
+    {
+        if (Cy_SMIF_Init(NOR_SMIF_HW, &smifConfig, NOR_SMIF_TIMEOUT_US, &smifContext) == CY_SMIF_SUCCESS)
         {
-            status = CY_DFU_ERROR_DATA;
-            CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+            Cy_SMIF_SetDataSelect(NOR_SMIF_HW, NOR_SMIF_SLAVE_SELECT, CY_SMIF_DATA_SEL0);
+            Cy_SMIF_Enable(NOR_SMIF_HW, &smifContext);
+
+            norDevice.ops = &norOps;
+            norDevice.context = NULL;
+            norDevice.address = NOR_ADDRESS;
+            if (Cy_DFU_NorInit(&norDevice) == CY_DFU_SUCCESS)
+            {
+                Cy_DFU_NorRegionInit(&norDevice, &norRegion);
+            }
         }
         else
         {
-            status = CY_DFU_SUCCESS;
+            CY_DFU_LOG_ERR("SMIF initialization failed");
         }
     }
+}
 
-    if (CY_DFU_SUCCESS != status)
+
+/*******************************************************************************
+* Function Name: NorCommand
+****************************************************************************//**
+*
+* This internal function sends a command to the serial NOR with the SMIF
+* driver, see \ref cy_stc_dfu_nor_ops_t. In the memory mode, the SMIF is
+* switched to the normal mode for the command, and the XIP cache is
+* invalidated after it.
+*
+* \param cmd        The command.
+* \param context    Not used.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if a SMIF transfer fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t NorCommand(const cy_stc_dfu_nor_cmd_t *cmd, void *context)
+{
+    cy_en_smif_status_t sstatus;
+    bool mapped = NorMapped(context);
+    bool last = ( (cmd->dummyCycles == 0U) && (cmd->length == 0U) );
+    uint8_t address[4U];
+
+    /* The address is sent the most significant byte first */
+    for (uint32_t idx = 0U; idx < cmd->addressSize; ++idx)
     {
-        CY_DFU_LOG_ERR("Write operation failed at address 0x%X", (unsigned int)address);
+        address[idx] = (uint8_t)(cmd->address >> (8U * ((uint32_t)cmd->addressSize - 1U - idx)));
     }
 
-    return (status);
+    if (mapped)
+    {
+        Cy_SMIF_SetMode(NOR_SMIF_HW, CY_SMIF_NORMAL);
+    }
+
+    sstatus = Cy_SMIF_TransmitCommand(NOR_SMIF_HW, cmd->opcode, CY_SMIF_WIDTH_SINGLE, address, cmd->addressSize,
+                                      CY_SMIF_WIDTH_SINGLE, NOR_SMIF_SLAVE_SELECT,
+                                      last ? CY_SMIF_TX_LAST_BYTE : CY_SMIF_TX_NOT_LAST_BYTE, &smifContext);
+    if ( (sstatus == CY_SMIF_SUCCESS) && (cmd->dummyCycles != 0U) )
+    {
+        sstatus = Cy_SMIF_SendDummyCycles(NOR_SMIF_HW, cmd->dummyCycles);
+    }
+    if ( (sstatus == CY_SMIF_SUCCESS) && (cmd->length != 0U) )
+    {
+        cy_en_smif_txfr_width_t width = (cmd->dataWidth == 4U) ? CY_SMIF_WIDTH_QUAD :
+                                        ((cmd->dataWidth == 2U) ? CY_SMIF_WIDTH_DUAL : CY_SMIF_WIDTH_SINGLE);
+
+        if (cmd->rxData != NULL)
+        {
+            sstatus = Cy_SMIF_ReceiveDataBlocking(NOR_SMIF_HW, cmd->rxData, cmd->length, width, &smifContext);
+        }
+        else
+        {
+            sstatus = Cy_SMIF_TransmitDataBlocking(NOR_SMIF_HW, cmd->txData, cmd->length, width, &smifContext);
+        }
+    }
+
+    if (mapped)
+    {   /* The XIP cache may hold the content before a program or erase */
+        (void) Cy_SMIF_CacheInvalidate(NOR_SMIF_HW, CY_SMIF_CACHE_BOTH);
+        Cy_SMIF_SetMode(NOR_SMIF_HW, CY_SMIF_MEMORY);
+    }
+
+    return ((sstatus == CY_SMIF_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_ReadData
+* Function Name: NorMapped
+****************************************************************************//**
+*
+* This internal function reports whether the serial NOR is memory mapped: the
+* SMIF is in the memory (XIP) mode.
+*
+* \param context    Not used.
+*
+* \return True if the serial NOR can be read at NOR_ADDRESS.
+*
+*******************************************************************************/
+static bool NorMapped(void *context)
+{
+    CY_UNUSED_PARAMETER(context);
+
+    return (Cy_SMIF_GetMode(NOR_SMIF_HW) == CY_SMIF_MEMORY);
+}
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_WriteData
 ****************************************************************************//**
 *
 * This function documentation is part of the DFU SDK API, see the
 * cy_dfu.h file or DFU SDK API Reference Manual for details.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
-                                              cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_WriteData (uint32_t address, uint32_t length, uint32_t ctl,
+                                               cy_stc_dfu_params_t *params)
 {
     cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    const region_t *region = RegionFind(address);
 
-    /* Check if the length is valid */
-    if (IsMultipleOf(length, CY_NVM_SIZEOF_ROW) == 0U)
+    /* Check if the address is inside the valid range, the range of a write must not span
+     * the next range. Note Length = 0 is valid for erase command */
+    if ( (region->type == REGION_NONE) || ( (length != 0U) && (RegionFind(address + length - 1U) != region) ) )
     {
-        status = CY_DFU_ERROR_LENGTH;
+        status = CY_DFU_ERROR_ADDRESS;
     }
 
-    /* Check if the address is inside the valid range */
-    if(!AddressValid(address, params))
-    {
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    /* Refuse to write to a row within a range of the current application */
+    if (region->type == REGION_RUNNING)
+    {   /* It is forbidden to overwrite the currently running application */
         status = CY_DFU_ERROR_ADDRESS;
     }
 
-    /* Read or Compare */
-    if (status == CY_DFU_SUCCESS)
-    {
-        if ((ctl & CY_DFU_IOCTL_COMPARE) == 0U)
+    #if CY_DFU_OPT_GOLDEN_IMAGE
+        if ( (status == CY_DFU_SUCCESS) && (region->type == REGION_GOLDEN) )
         {
-            cy_rslt_t fstatus = cyhal_flash_read(&flash_obj, address, params->dataBuffer, length);
-            status = (fstatus == CY_RSLT_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA;
+            status = GoldenImageCheck(region->golden, params);
         }
-        else
-        {
-            status = ( memcmp(params->dataBuffer, (const void *)address, length) == 0 )
-                    ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
+    #endif /* #if CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+    #if CY_DFU_OPT_VALID_CACHE != 0
+        if (status == CY_DFU_SUCCESS)
+        {   /* The cached validity of the applications is outdated by the write */
+            Cy_DFU_ValidCacheInvalidate();
         }
+    #endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+#endif /*CY_DFU_FLOW == CY_DFU_BASIC_FLOW*/
+
+    if (status == CY_DFU_SUCCESS)
+    {   /* Checks the length against the program unit of the NVM region */
+        status = Cy_DFU_NvmWrite(region->nvm, address, length, ctl, params);
     }
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.4','Casting the metadata pointer to uint32_t is safe as it is compared with the NVM address.');
+    if ((address - (uint32_t)cy_dfu_metadata) < sizeof(cy_dfu_metadata))
+    {   /* The application ranges in the region index and the cached metadata may have changed */
+        regionCount = 0U;
+    #if CY_DFU_OPT_METADATA_CACHE != 0
+        Cy_DFU_MetadataCacheInvalidate();
+    #endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+    }
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+    if (CY_DFU_SUCCESS != status)
+    {
+        CY_DFU_LOG_ERR("Write operation failed at address 0x%X", (unsigned int)address);
+    }
+
     return (status);
 }
 
 
+/*******************************************************************************
+* Function Name: Cy_DFU_ReadData
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
+                                              cy_stc_dfu_params_t *params)
+{
+    /* REGION_NONE ranges have no NVM region */
+    return (Cy_DFU_NvmRead(RegionFind(address)->nvm, address, length, ctl, params));
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetEraseSize
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_GetEraseSize(uint32_t address)
+{
+    const cy_stc_dfu_nvm_region_t *nvm = RegionFind(address)->nvm;
+
+    return ((nvm != NULL) ? nvm->eraseSize : 0U);
+}
+
+
 /*******************************************************************************
 * Function Name: Cy_DFU_TransportStart
 ****************************************************************************//**
@@ -380,8 +1095,6 @@ cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t
 *******************************************************************************/
 void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
 {
-    selectedInterface = transport;
-
     /* Initialize flash object */
     cy_rslt_t result = cyhal_nvm_init(&flash_obj);
     if (result != CY_RSLT_SUCCESS)
@@ -401,49 +1114,60 @@ void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
     blocks_count = flash_info.block_count;
 #endif
 
-    switch (transport)
-    {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_HID
-        case CY_DFU_USB_HID:
-            USB_HID_CyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_HID */
-    #ifdef COMPONENT_DFU_CANFD
-        case CY_DFU_CANFD:
-            CANFD_CanfdCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_CANFD */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+#if CY_DFU_OPT_NOR != 0
+    NorStart();
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+    /* The NVM regions and the address ranges for the address validation */
+    NvmRegionsBuild();
+    RegionIndexBuild();
+
+#if (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0)
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.4','Casting the metadata pointer to uint32_t is safe as it is an NVM address.');
+    if (Cy_DFU_GetEraseSize((uint32_t)cy_dfu_metadata) > CY_NVM_SIZEOF_ROW)
+    {   /* The journal rows are written singly, see CY_DFU_OPT_METADATA_JOURNAL */
+        CY_DFU_LOG_ERR("The metadata journal is not in the NVM erased in rows");
+        CY_ASSERT(false);
+    }
+#endif /* (CY_DFU_FLOW == CY_DFU_BASIC_FLOW) && (CY_DFU_OPT_METADATA_JOURNAL != 0) */
+
+    selectedTransport = NULL;
+    listenAll = (transport == CY_DFU_ALL);
+    pollIndex = 0U;
+    listenCount = 0U;
+
+    for (uint32_t i = 0U; transportList[i] != NULL; i++)
+    {
+        if (listenAll)
+        {
+            if (TransportListened(i))
+            {
+                transportList[i]->start();
+                listenCount++;
+            }
+        }
+        else if (transportList[i]->transport == transport)
+        {
+            selectedTransport = transportList[i];
+        }
+        else
+        {
+            /* Not the selected interface */
+        }
+    }
+
+    if (selectedTransport != NULL)
+    {
+        selectedTransport->start();
+    }
+    else if (!listenAll)
+    {
+        /* Selected interface in not applicable */
+        CY_ASSERT(false);
+    }
+    else
+    {
+        /* All the transports are started */
     }
 }
 
@@ -461,49 +1185,23 @@ void Cy_DFU_TransportStop()
     /* Release flash object */
     cyhal_nvm_free(&flash_obj);
 
-    switch (selectedInterface)
-    {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_HID
-        case CY_DFU_USB_HID:
-            USB_HID_CyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_HID */
-    #ifdef COMPONENT_DFU_CANFD
-        case CY_DFU_CANFD:
-            CANFD_CanfdCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_CANFD */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+    if (listenAll)
+    {
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            if (TransportListened(i))
+            {
+                transportList[i]->stop();
+            }
+        }
+    }
+    else if (selectedTransport != NULL)
+    {
+        selectedTransport->stop();
+    }
+    else
+    {
+        /* No transport is started */
     }
 }
 
@@ -518,49 +1216,23 @@ void Cy_DFU_TransportStop()
 *******************************************************************************/
 void Cy_DFU_TransportReset(void)
 {
-    switch (selectedInterface)
-    {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_HID
-        case CY_DFU_USB_HID:
-            USB_HID_CyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_HID */
-    #ifdef COMPONENT_DFU_CANFD
-        case CY_DFU_CANFD:
-            CANFD_CanfdCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_CANFD */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+    if (listenAll)
+    {
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            if (TransportListened(i))
+            {
+                transportList[i]->reset();
+            }
+        }
+    }
+    else if (selectedTransport != NULL)
+    {
+        selectedTransport->reset();
+    }
+    else
+    {
+        /* No transport is started */
     }
 }
 
@@ -577,49 +1249,43 @@ cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
 
-    switch (selectedInterface)
-    {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            status = I2C_I2cCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            status = UART_UartCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            status = SPI_SpiCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_HID
-        case CY_DFU_USB_HID:
-            status = USB_HID_CyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_HID */
-    #ifdef COMPONENT_DFU_CANFD
-        case CY_DFU_CANFD:
-            status = CANFD_CanfdCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_CANFD */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+    if (listenAll)
+    {
+        /* Share the timeout between the transports, so none of them waits for long */
+        uint32_t slice = timeout / ((listenCount > 0U) ? listenCount : 1U);
+
+        if (slice == 0U)
+        {
+            slice = 1U;
+        }
+
+        status = CY_DFU_ERROR_TIMEOUT;
+
+        for (uint32_t i = 0U; (i < TRANSPORT_COUNT) && (status == CY_DFU_ERROR_TIMEOUT); i++)
+        {
+            const cy_stc_dfu_transport_ops_t *transport = transportList[pollIndex];
+            bool listened = TransportListened(pollIndex);
+
+            pollIndex = ((pollIndex + 1U) < TRANSPORT_COUNT) ? (pollIndex + 1U) : 0U;
+
+            if (listened)
+            {
+                status = transport->read(buffer, size, count, slice);
+                if (status != CY_DFU_ERROR_TIMEOUT)
+                {
+                    /* Respond through the transport the packet came from */
+                    selectedTransport = transport;
+                }
+            }
+        }
+    }
+    else if (selectedTransport != NULL)
+    {
+        status = selectedTransport->read(buffer, size, count, timeout);
+    }
+    else
+    {
+        /* No transport is started */
     }
 
     return status;
@@ -638,53 +1304,116 @@ cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
 
-    switch (selectedInterface)
-    {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            status = I2C_I2cCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            status = UART_UartCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            status = SPI_SpiCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_CDC */
-    #ifdef COMPONENT_DFU_EMUSB_HID
-        case CY_DFU_USB_HID:
-            status = USB_HID_CyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_EMUSB_HID */
-    #ifdef COMPONENT_DFU_CANFD
-        case CY_DFU_CANFD:
-            status = CANFD_CanfdCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_CANFD */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+    if (selectedTransport != NULL)
+    {
+        status = selectedTransport->write(buffer, size, count, timeout);
     }
 
     return status;
 }
 
 
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportGetOps
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+const cy_stc_dfu_transport_ops_t * Cy_DFU_TransportGetOps(void)
+{
+    /* The next packet may come from any transport until the session locks on one */
+    return (listenAll ? NULL : selectedTransport);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportLock
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+void Cy_DFU_TransportLock(void)
+{
+    if (listenAll && (selectedTransport != NULL))
+    {
+        /* Stop all the transports except the one the update session goes through */
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            if ((transportList[i] != selectedTransport) && TransportListened(i))
+            {
+                transportList[i]->stop();
+            }
+        }
+
+        listenAll = false;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TransportOnEmUsb
+****************************************************************************//**
+*
+* Internal function that checks whether a transport runs on the emUSB-Device
+* stack. The emUSB CDC, emUSB HID and USB vendor transports each call
+* USBD_Init() to start and USBD_DeInit() to stop, so only one of them can be
+* started at a time.
+*
+* \param transport  The transport operations.
+*
+* \return True if the transport runs on the emUSB-Device stack.
+*
+*******************************************************************************/
+static bool TransportOnEmUsb(const cy_stc_dfu_transport_ops_t *transport)
+{
+    bool emUsb = false;
+
+#ifdef COMPONENT_DFU_EMUSB_CDC
+    emUsb = emUsb || (transport == &USB_CDC_CyBtldrCommOps);
+#endif /* COMPONENT_DFU_EMUSB_CDC */
+#ifdef COMPONENT_DFU_EMUSB_HID
+    emUsb = emUsb || (transport == &USB_HID_CyBtldrCommOps);
+#endif /* COMPONENT_DFU_EMUSB_HID */
+#ifdef COMPONENT_DFU_USB_VENDOR
+    emUsb = emUsb || (transport == &USB_VENDOR_CyBtldrCommOps);
+#endif /* COMPONENT_DFU_USB_VENDOR */
+    CY_UNUSED_PARAMETER(transport); /* Without the emUSB-Device transports */
+
+    return emUsb;
+}
+
+
+/*******************************************************************************
+* Function Name: TransportListened
+****************************************************************************//**
+*
+* Internal function that checks whether a transport of transportList is
+* listened to with CY_DFU_ALL: all of them except the emUSB-Device transports
+* after the first one, which would re-initialize the stack the first one runs on.
+*
+* \param index      The index of the transport in transportList.
+*
+* \return True if the transport is started with CY_DFU_ALL.
+*
+*******************************************************************************/
+static bool TransportListened(uint32_t index)
+{
+    bool listened = true;
+
+    if (TransportOnEmUsb(transportList[index]))
+    {
+        for (uint32_t i = 0U; (i < index) && listened; i++)
+        {
+            listened = !TransportOnEmUsb(transportList[i]);
+        }
+    }
+
+    return listened;
+}
+
+
 /* [] END OF FILE */
@@ -366,7 +366,7 @@ cy_en_dfu_status_t SPI_SpiCyBtldrCommRead(uint8_t pData[], uint32_t size, uint32
 *   "Return Codes" section of the System Reference Guide.
 *
 *******************************************************************************/
-cy_en_dfu_status_t SPI_SpiCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
+cy_en_dfu_status_t SPI_SpiCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout)
 {
     cy_en_dfu_status_t statusLoc = CY_DFU_ERROR_UNKNOWN;
 
@@ -409,4 +409,20 @@ cy_en_dfu_status_t SPI_SpiCyBtldrCommWrite(const uint8_t pData[], uint32_t size,
 }
 
 
+/**
+* The transport operations and capabilities, see \ref cy_stc_dfu_transport_ops_t.
+*/
+const cy_stc_dfu_transport_ops_t SPI_SpiCyBtldrCommOps =
+{
+    .transport     = CY_DFU_SPI,
+    .start         = &SPI_SpiCyBtldrCommStart,
+    .stop          = &SPI_SpiCyBtldrCommStop,
+    .reset         = &SPI_SpiCyBtldrCommReset,
+    .read          = &SPI_SpiCyBtldrCommRead,
+    .write         = &SPI_SpiCyBtldrCommWrite,
+    .maxPacketSize = 0U,
+    .capabilities  = 0U
+};
+
+
 /* [] END OF FILE */
@@ -55,6 +55,7 @@ extern "C" {
 ***************************************/
 
 extern bool SPI_initVar;
+extern const cy_stc_dfu_transport_ops_t SPI_SpiCyBtldrCommOps;
 
 
 /***************************************
@@ -66,7 +67,7 @@ void SPI_SpiCyBtldrCommStart(void);
 void SPI_SpiCyBtldrCommStop (void);
 void SPI_SpiCyBtldrCommReset(void);
 cy_en_dfu_status_t SPI_SpiCyBtldrCommRead (uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
-cy_en_dfu_status_t SPI_SpiCyBtldrCommWrite(const uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
+cy_en_dfu_status_t SPI_SpiCyBtldrCommWrite(uint8_t pData[], uint32_t size, uint32_t *count, uint32_t timeout);
 
 #if defined(__cplusplus)
 }
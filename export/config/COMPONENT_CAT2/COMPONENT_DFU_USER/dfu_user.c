@@ -41,6 +41,7 @@
 * indemnify Cypress against all liability.
 *******************************************************************************/
 
+#include <stddef.h>
 #include <string.h>
 #include "cy_syslib.h"
 #include "cy_dfu.h"
@@ -61,11 +62,43 @@
     #include "transport_usb_cdc.h"
 #endif  /* COMPONENT_DFU_USB_CDC */
 
-#ifdef COMPONENT_DFU_BLE
-    #include "transport_ble.h"
-#endif  /* COMPONENT_DFU_BLE */
 
+/* The transports compiled into the project, terminated with NULL */
+static const cy_stc_dfu_transport_ops_t * const transportList[] =
+{
+#ifdef COMPONENT_DFU_I2C
+    &I2C_I2cCyBtldrCommOps,
+#endif /* COMPONENT_DFU_I2C */
+#ifdef COMPONENT_DFU_UART
+    &UART_UartCyBtldrCommOps,
+#endif /* COMPONENT_DFU_UART */
+#ifdef COMPONENT_DFU_SPI
+    &SPI_SpiCyBtldrCommOps,
+#endif /* COMPONENT_DFU_SPI */
+#ifdef COMPONENT_DFU_USB_CDC
+    &USB_CDC_CyBtldrCommOps,
+#endif /* COMPONENT_DFU_USB_CDC */
+    NULL
+};
+
+/* The number of the transports in transportList */
+#define TRANSPORT_COUNT     ((sizeof(transportList) / sizeof(transportList[0])) - 1U)
 
+/* The transport selected with Cy_DFU_TransportStart(), or the one that received
+* the last packet when all the transports are listened to */
+static const cy_stc_dfu_transport_ops_t *selectedTransport = NULL;
+
+/* Indicates that all the transports are listened to until the session locks on one */
+static bool listenAll = false;
+
+/* The transport to poll first on the next read when all the transports are listened to */
+static uint32_t pollIndex = 0U;
+
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+    /* The index in cy_dfu_metadata of a field of the record in a journal row */
+    #define JOURNAL_WORD(row, field)    ( ( ((row) * CY_FLASH_SIZEOF_ROW) + \
+                                            offsetof(cy_stc_dfu_app_metadata_t, field) ) / sizeof(uint32_t) )
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
 
 /*
 * The DFU SDK metadata initial value is placed here
@@ -74,6 +107,30 @@
 */
 CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 9.3',1,'The rest of the array initialization is not required.');
 CY_SECTION(".cy_boot_metadata") __USED
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+/* The initial journal records of App0 and App1 in rows 0 and 1, the sequence number 0 needs no CRC
+* but the row must be the application number */
+static const uint32_t cy_dfu_metadata[CY_DFU_METADATA_LENGTH / sizeof(uint32_t)] =
+{
+    [JOURNAL_WORD(0U, verifyAddress)] = CY_DFU_APP0_VERIFY_START, CY_DFU_APP0_VERIFY_LENGTH,
+    [JOURNAL_WORD(0U, appId)]         = 0U, 0U, CY_DFU_METADATA_JOURNAL_MAGIC,
+    [JOURNAL_WORD(1U, verifyAddress)] = CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH,
+    [JOURNAL_WORD(1U, appId)]         = 1U, 0U, CY_DFU_METADATA_JOURNAL_MAGIC
+};
+#elif CY_DFU_OPT_METADATA_V2 != 0
+/* The metadata header and the App0 and App1 records, the CRCs are written by the first metadata update */
+static const uint32_t cy_dfu_metadata[CY_DFU_METADATA_LENGTH / sizeof(uint32_t)] =
+{
+    CY_DFU_METADATA_MAGIC,                                          /* The metadata header          */
+    CY_DFU_METADATA_VERSION | (CY_DFU_METADATA_RECORD_SIZE << 16U),
+    CY_DFU_MAX_APPS, CY_FLASH_SIZEOF_ROW,
+    0U,                                                             /* The header CRC-32C           */
+    [CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
+        CY_DFU_APP0_VERIFY_START, CY_DFU_APP0_VERIFY_LENGTH,        /* The App0 record              */
+    [(CY_FLASH_SIZEOF_ROW + CY_DFU_METADATA_RECORD_SIZE) / sizeof(uint32_t)] =
+        CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH         /* The App1 record              */
+};
+#else
 static const uint32_t cy_dfu_metadata[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
 
 {
@@ -81,31 +138,95 @@ static const uint32_t cy_dfu_metadata[CY_FLASH_SIZEOF_ROW / sizeof(uint32_t)] =
     CY_DFU_APP1_VERIFY_START, CY_DFU_APP1_VERIFY_LENGTH, /* The App1 base address and length */
     0U                                                             /* The rest does not matter     */
 };
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
 CY_MISRA_BLOCK_END('MISRA C-2012 Rule 9.3');
 
 
-static uint32_t IsMultipleOf(uint32_t value, uint32_t multiple);
 static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t *endAddress);
-static cy_en_dfu_transport_t selectedInterface = CY_DFU_I2C;
 
+static cy_en_dfu_status_t FlashWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                     const uint8_t data[], uint32_t length);
 
-/*******************************************************************************
-* Function Name: IsMultipleOf
-****************************************************************************//**
-*
-* This internal function check if value parameter is a multiple of parameter
-* multiple
-*
-* \param value      value that will be checked
-* \param multiple   value with which value is checked
-*
-* \return 1 - value is multiple of parameter multiple, else 0
-*
-*******************************************************************************/
-static uint32_t IsMultipleOf(uint32_t value, uint32_t multiple)
+/* The flash, written in rows with Cy_Flash_WriteRow() that erases them, read in place */
+static const cy_stc_dfu_nvm_region_t flashRegion =
 {
-    return ( ((value % multiple) == 0U)? 1UL : 0UL);
-}
+    CY_FLASH_BASE, CY_FLASH_SIZE, CY_FLASH_SIZEOF_ROW, 0U, NULL, NULL, NULL, &FlashWrite, NULL, NULL
+};
+
+/* The NVM regions of Cy_DFU_WriteData() and Cy_DFU_ReadData(), terminated with
+* NULL. The regions of other memories are added here. */
+static const cy_stc_dfu_nvm_region_t * const nvmRegions[] =
+{
+    &flashRegion,
+    NULL
+};
+
+/* The number of the NVM regions in nvmRegions */
+#define NVM_REGIONS_COUNT   ((sizeof(nvmRegions) / sizeof(nvmRegions[0])) - 1U)
+
+#if CY_DFU_OPT_GOLDEN_IMAGE != 0
+/* The golden image check of an application, kept for the update session */
+typedef enum
+{
+    GOLDEN_UNKNOWN = 0,     /* Not validated in this session */
+    GOLDEN_VALID,           /* Valid, the writes to it are refused */
+    GOLDEN_INVALID          /* Invalid, the writes to it are allowed */
+} golden_state_t;
+
+typedef struct
+{
+    uint32_t startAddress;  /* The application range the state is for */
+    uint32_t endAddress;
+    golden_state_t state;
+} golden_image_t;
+
+static const uint8_t goldenImages[] = { CY_DFU_GOLDEN_IMAGE_IDS() };
+
+/* The number of the golden images */
+#define GOLDEN_IMAGE_COUNT  (sizeof(goldenImages) / sizeof(goldenImages[0]))
+
+static golden_image_t goldenCache[GOLDEN_IMAGE_COUNT];
+
+static cy_en_dfu_status_t GoldenImageCheck(uint32_t golden, cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+
+/* The class of an NVM address range in the region index */
+typedef enum
+{
+    REGION_NONE = 0,        /* Not an NVM the DFU SDK accesses */
+    REGION_WRITABLE,        /* Can be read and written */
+    REGION_RUNNING,         /* The running application, cannot be written */
+    REGION_GOLDEN           /* A golden image, see GoldenImageCheck() */
+} region_type_t;
+
+/* A range of the region index, from startAddress up to the start of the next range */
+typedef struct
+{
+    uint32_t startAddress;
+    region_type_t type;
+    uint32_t golden;        /* The index in goldenImages of a REGION_GOLDEN range */
+    const cy_stc_dfu_nvm_region_t *nvm;     /* The NVM region of the range, NULL for REGION_NONE */
+} region_t;
+
+/* The maximum number of the ranges in the region index: a range starts at
+* each start and end address of the NVM regions, the end of App0, and each
+* start and end address of the running application and the golden images */
+#if CY_DFU_OPT_GOLDEN_IMAGE != 0
+    #define REGION_INDEX_SIZE   ((2U * NVM_REGIONS_COUNT) + 3U + (2U * GOLDEN_IMAGE_COUNT))
+#else
+    #define REGION_INDEX_SIZE   ((2U * NVM_REGIONS_COUNT) + 3U)
+#endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+
+/* The NVM address ranges sorted by the start address, built by RegionIndexBuild() */
+static region_t regionIndex[REGION_INDEX_SIZE];
+
+/* The number of the ranges in regionIndex, 0 if the index must be built again */
+static uint32_t regionCount = 0U;
+
+static void RegionIndexBuild(void);
+static void RegionBoundAdd(uint32_t bounds[], uint32_t *count, uint32_t address);
+static void RegionClassify(uint32_t address, region_t *region);
+static const region_t *RegionFind(uint32_t address);
 
 
 /*******************************************************************************
@@ -138,141 +259,362 @@ static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t
 }
 
 
+#if CY_DFU_OPT_GOLDEN_IMAGE != 0
 /*******************************************************************************
-* Function Name: Cy_DFU_WriteData
+* Function Name: GoldenImageCheck
+****************************************************************************//**
+*
+* This internal function refuses a write to a valid golden image.
+*
+* A golden image is validated with Cy_DFU_ValidateApp() on the first write to
+* its range in an update session, and the result is kept until the session
+* ends (Cy_DFU_GoldenImageInvalidate()) or the metadata of the golden image
+* changes (RegionIndexBuild()), instead of validating the whole image before
+* each row. An invalid golden image stays writable for the rest of the
+* session, so the DFU Host can restore it.
+*
+* \param golden     The index of the golden image in goldenImages.
+* \param params     The pointer to a DFU parameters structure.
+*
+* \return
+* - CY_DFU_SUCCESS if the golden image is invalid.
+* - CY_DFU_ERROR_ADDRESS if the golden image is valid.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t GoldenImageCheck(uint32_t golden, cy_stc_dfu_params_t *params)
+{
+    golden_image_t *image = &goldenCache[golden];
+
+    if (image->state == GOLDEN_UNKNOWN)
+    {
+        image->state = (Cy_DFU_ValidateApp(goldenImages[golden], params) == CY_DFU_SUCCESS) ?
+                       GOLDEN_VALID : GOLDEN_INVALID;
+    }
+
+    return ((image->state == GOLDEN_VALID) ? CY_DFU_ERROR_ADDRESS : CY_DFU_SUCCESS);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GoldenImageInvalidate
 ****************************************************************************//**
 *
 * This function documentation is part of the DFU SDK API, see the
 * cy_dfu.h file or DFU SDK API Reference Manual for details.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_WriteData (uint32_t address, uint32_t length, uint32_t ctl,
-                                               cy_stc_dfu_params_t *params)
+void Cy_DFU_GoldenImageInvalidate(void)
 {
-    /* application flash limits */
-    /* Note that App0 is out of range */
-    const uint32_t minUFlashAddress = CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH;
-    const uint32_t maxUFlashAddress = CY_FLASH_BASE + CY_FLASH_SIZE;
+    (void) memset(goldenCache, 0, sizeof(goldenCache));
+    /* The index is built again with the current metadata at the session start */
+    regionCount = 0U;
+}
+#endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
 
-    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
 
-    uint32_t app = Cy_DFU_GetRunningApp();
+/*******************************************************************************
+* Function Name: RegionIndexBuild
+****************************************************************************//**
+*
+* This internal function builds the region index: the NVM address ranges
+* sorted by the start address, each classified as not accessible, writable,
+* the running application or a golden image, with its NVM region. A range
+* starts at each start and end address of the NVM regions and the application
+* areas, so the class of an address is the class of the last range that starts
+* at or below it.
+*
+* The index is built by Cy_DFU_TransportStart(), and again after the metadata
+* is written, so the validation of each row address is a binary search instead
+* of reading the metadata.
+*
+*******************************************************************************/
+static void RegionIndexBuild(void)
+{
+    uint32_t bounds[REGION_INDEX_SIZE];
+    uint32_t count = 0U;
     uint32_t startAddress;
     uint32_t endAddress;
+    uint32_t idx;
 
-    GetStartEndAddress(app, &startAddress, &endAddress);
+    for (idx = 0U; nvmRegions[idx] != NULL; ++idx)
+    {
+        RegionBoundAdd(bounds, &count, nvmRegions[idx]->address);
+        RegionBoundAdd(bounds, &count, nvmRegions[idx]->address + nvmRegions[idx]->size);
+    }
+    RegionBoundAdd(bounds, &count, CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH);
+    GetStartEndAddress(Cy_DFU_GetRunningApp(), &startAddress, &endAddress);
+    RegionBoundAdd(bounds, &count, startAddress);
+    RegionBoundAdd(bounds, &count, endAddress);
+#if CY_DFU_OPT_GOLDEN_IMAGE != 0
+    for (idx = 0U; idx < GOLDEN_IMAGE_COUNT; ++idx)
+    {
+        golden_image_t *golden = &goldenCache[idx];
+
+        GetStartEndAddress(goldenImages[idx], &startAddress, &endAddress);
+        if ( (golden->startAddress != startAddress) || (golden->endAddress != endAddress) )
+        {   /* The result of the golden image check is for its previous range */
+            golden->startAddress = startAddress;
+            golden->endAddress = endAddress;
+            golden->state = GOLDEN_UNKNOWN;
+        }
+        RegionBoundAdd(bounds, &count, startAddress);
+        RegionBoundAdd(bounds, &count, endAddress);
+    }
+#endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
 
-    /* Check if the address  and length are valid
-     * Note Length = 0 is valid for erase command */
-    if ( (IsMultipleOf(address, CY_FLASH_SIZEOF_ROW) == 0U) ||
-         ( (length != CY_FLASH_SIZEOF_ROW) && ( (ctl & CY_DFU_IOCTL_ERASE) == 0U) ) )
+    for (idx = 0U; idx < count; ++idx)
     {
-        status = CY_DFU_ERROR_LENGTH;
+        RegionClassify(bounds[idx], &regionIndex[idx]);
     }
+    regionCount = count;
+}
 
-    /* Refuse to write to a row within a range of the current application */
-    if ( (startAddress <= address) && (address < endAddress) )
-    {   /* It is forbidden to overwrite the currently running application */
-        status = CY_DFU_ERROR_ADDRESS;
+
+/*******************************************************************************
+* Function Name: RegionBoundAdd
+****************************************************************************//**
+*
+* This internal function inserts an address into the sorted bounds of the
+* region index, unless it is there already.
+*
+* \param bounds     The sorted addresses.
+* \param count      The pointer to the number of the addresses in bounds.
+* \param address    The address to insert.
+*
+*******************************************************************************/
+static void RegionBoundAdd(uint32_t bounds[], uint32_t *count, uint32_t address)
+{
+    uint32_t idx = *count;
+
+    while ( (idx > 0U) && (bounds[idx - 1U] > address) )
+    {
+        --idx;
     }
-#if CY_DFU_OPT_GOLDEN_IMAGE
-    if (status == CY_DFU_SUCCESS)
+    if ( (idx == 0U) || (bounds[idx - 1U] != address) )
     {
-        uint8_t goldenImages[] = { CY_DFU_GOLDEN_IMAGE_IDS() };
-        uint32_t count = sizeof(goldenImages) / sizeof(goldenImages[0]);
-        uint32_t idx;
-        for (idx = 0U; idx < count; ++idx)
-        {
-            app = goldenImages[idx];
-            GetStartEndAddress(app, &startAddress, &endAddress);
+        (void) memmove(&bounds[idx + 1U], &bounds[idx], (*count - idx) * sizeof(bounds[0]));
+        bounds[idx] = address;
+        ++(*count);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: RegionClassify
+****************************************************************************//**
+*
+* This internal function classifies the range of the region index that starts
+* at the address, by its NVM region and the address checks of
+* Cy_DFU_WriteData().
+*
+* \param address    The start address of the range.
+* \param region     The pointer to the range to fill.
+*
+*******************************************************************************/
+static void RegionClassify(uint32_t address, region_t *region)
+{
+    region->startAddress = address;
+    region->nvm = Cy_DFU_NvmRegionFind(nvmRegions, address, 0U);
+    region->type = (region->nvm != NULL) ? REGION_WRITABLE : REGION_NONE;
+    region->golden = 0U;
+
+    if ( (CY_FLASH_BASE <= address) && (address < (CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH)) )
+    {   /* Note that App0 is out of range */
+        region->type = REGION_NONE;
+        region->nvm = NULL;
+    }
+    if (region->type == REGION_WRITABLE)
+    {
+        uint32_t startAddress;
+        uint32_t endAddress;
 
-            if ( (startAddress <= address) && (address < endAddress) )
+        GetStartEndAddress(Cy_DFU_GetRunningApp(), &startAddress, &endAddress);
+        if ( (startAddress <= address) && (address < endAddress) )
+        {   /* It is forbidden to overwrite the currently running application */
+            region->type = REGION_RUNNING;
+        }
+    #if CY_DFU_OPT_GOLDEN_IMAGE != 0
+        for (uint32_t idx = 0U; (region->type == REGION_WRITABLE) && (idx < GOLDEN_IMAGE_COUNT); ++idx)
+        {
+            if ( (goldenCache[idx].startAddress <= address) && (address < goldenCache[idx].endAddress) )
             {
-                status = Cy_DFU_ValidateApp(app, params);
-                status = (status == CY_DFU_SUCCESS) ? CY_DFU_ERROR_ADDRESS : CY_DFU_SUCCESS;
-                break;
+                region->type = REGION_GOLDEN;
+                region->golden = idx;
             }
         }
+    #endif /* CY_DFU_OPT_GOLDEN_IMAGE != 0 */
     }
-#endif /* #if CY_DFU_OPT_GOLDEN_IMAGE != 0 */
+}
 
-    /* Check if the address is inside the valid range */
-    if ((minUFlashAddress <= address) && (address < maxUFlashAddress))
-    {   /* Do nothing, this is an allowed memory range to update to */
-    }
-    else
+
+/*******************************************************************************
+* Function Name: RegionFind
+****************************************************************************//**
+*
+* This internal function finds the range of the region index the address is in,
+* and builds the index if it is not built.
+*
+* \param address    The address to find.
+*
+* \return The pointer to the range, with the REGION_NONE class if the address
+*         is not in an NVM the DFU SDK accesses.
+*
+*******************************************************************************/
+static const region_t *RegionFind(uint32_t address)
+{
+    static const region_t noRegion = { 0U, REGION_NONE, 0U, NULL };
+    const region_t *region = &noRegion;
+    uint32_t low = 0U;
+    uint32_t high;
+
+    if (regionCount == 0U)
     {
-        status = CY_DFU_ERROR_ADDRESS;
+        RegionIndexBuild();
     }
 
-    if (status == CY_DFU_SUCCESS)
+    /* The last range that starts at or below the address */
+    high = regionCount;
+    while (low < high)
     {
-        if ((ctl & CY_DFU_IOCTL_ERASE) != 0U)
+        uint32_t mid = (low + high) / 2U;
+        if (regionIndex[mid].startAddress <= address)
         {
-            (void) memset(params->dataBuffer, 0, CY_FLASH_SIZEOF_ROW);
+            low = mid + 1U;
         }
+        else
+        {
+            high = mid;
+        }
+    }
+    if (low > 0U)
+    {
+        region = &regionIndex[low - 1U];
+    }
+
+    return (region);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashWrite
+****************************************************************************//**
+*
+* This internal function writes the rows of the flash, the program function of
+* the flash region.
+*
+* \param region     The NVM region of the flash.
+* \param address    The address of the first row.
+* \param data       The data of the rows, 4-byte aligned.
+* \param length     The length of the rows in bytes.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the flash driver fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                     const uint8_t data[], uint32_t length)
+{
+    cy_en_flashdrv_status_t fstatus = CY_FLASH_DRV_SUCCESS;
+
+    for (uint32_t offset = 0U; (fstatus == CY_FLASH_DRV_SUCCESS) && (offset < length); offset += region->programSize)
+    {
 CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.3','Casting uint8_t* to uint32_t* is safe as input address is always valid and aligned.');
-        cy_en_flashdrv_status_t fstatus =  Cy_Flash_WriteRow(address, (uint32_t*)params->dataBuffer);
-        status = (fstatus == CY_FLASH_DRV_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA;
+        fstatus = Cy_Flash_WriteRow(address + offset, (const uint32_t *)&data[offset]);
     }
-    return (status);
+    return ((fstatus == CY_FLASH_DRV_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
 }
 
 
 /*******************************************************************************
-* Function Name: Cy_DFU_ReadData
+* Function Name: Cy_DFU_WriteData
 ****************************************************************************//**
 *
 * This function documentation is part of the DFU SDK API, see the
 * cy_dfu.h file or DFU SDK API Reference Manual for details.
 *
 *******************************************************************************/
-cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
-                                              cy_stc_dfu_params_t *params)
+cy_en_dfu_status_t Cy_DFU_WriteData (uint32_t address, uint32_t length, uint32_t ctl,
+                                               cy_stc_dfu_params_t *params)
 {
-    /* application flash limits */
-    /* Note that App0 is out of range */
-    const uint32_t minUFlashAddress = CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH;
-    const uint32_t maxUFlashAddress = CY_FLASH_BASE + CY_FLASH_SIZE;
-
     cy_en_dfu_status_t status = CY_DFU_SUCCESS;
 
-    /* Check if the length is valid */
-    if (IsMultipleOf(length, CY_FLASH_SIZEOF_ROW) == 0U)
-    {
-        status = CY_DFU_ERROR_LENGTH;
-    }
+    const region_t *region = RegionFind(address);
 
-    /* Check if the address is inside the valid range */
-    if ((minUFlashAddress <= address) && (address < maxUFlashAddress))
-    {   /* Do nothing, this is an allowed memory range to update to */
+    /* Refuse to write to a row within a range of the current application */
+    if (region->type == REGION_RUNNING)
+    {   /* It is forbidden to overwrite the currently running application */
+        status = CY_DFU_ERROR_ADDRESS;
     }
-    else
+
+    /* Check if the address is inside the valid range, the range of a write must not span
+     * the next range. Note Length = 0 is valid for erase command */
+    if ( (region->type == REGION_NONE) || ( (length != 0U) && (RegionFind(address + length - 1U) != region) ) )
     {
         status = CY_DFU_ERROR_ADDRESS;
     }
+#if CY_DFU_OPT_GOLDEN_IMAGE
+    if ( (status == CY_DFU_SUCCESS) && (region->type == REGION_GOLDEN) )
+    {
+        status = GoldenImageCheck(region->golden, params);
+    }
+#endif /* #if CY_DFU_OPT_GOLDEN_IMAGE != 0 */
 
-    /* Read or Compare */
+#if CY_DFU_OPT_VALID_CACHE != 0
     if (status == CY_DFU_SUCCESS)
-    {
-        if ((ctl & CY_DFU_IOCTL_COMPARE) == 0U)
-        {
-CY_MISRA_DEVIATE_BLOCK_START('MISRA C-2012 Rule 11.6',2,'Cast of uint32_t value\
-to void* is safe as variable always has valid address value');
-            (void) memcpy((void *)params->dataBuffer, (const void *)address, length);
-            status = CY_DFU_SUCCESS;
-        }
-        else
-        {
-            status = ( memcmp((const void *)params->dataBuffer, (const void *)address, length) == 0 )
-                     ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY;
-CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.6');
-        }
+    {   /* The cached validity of the applications is outdated by the write */
+        Cy_DFU_ValidCacheInvalidate();
+    }
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+
+    if (status == CY_DFU_SUCCESS)
+    {   /* Checks the length against the program unit of the NVM region */
+        status = Cy_DFU_NvmWrite(region->nvm, address, length, ctl, params);
+    }
+
+CY_MISRA_DEVIATE_LINE('MISRA C-2012 Rule 11.4','Casting the metadata pointer to uint32_t is safe as it is compared with the NVM address.');
+    if ((address - (uint32_t)cy_dfu_metadata) < sizeof(cy_dfu_metadata))
+    {   /* The application ranges in the region index and the cached metadata may have changed */
+        regionCount = 0U;
+    #if CY_DFU_OPT_METADATA_CACHE != 0
+        Cy_DFU_MetadataCacheInvalidate();
+    #endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
     }
+
     return (status);
 }
 
 
+/*******************************************************************************
+* Function Name: Cy_DFU_ReadData
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
+                                              cy_stc_dfu_params_t *params)
+{
+    /* REGION_NONE ranges have no NVM region */
+    return (Cy_DFU_NvmRead(RegionFind(address)->nvm, address, length, ctl, params));
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetEraseSize
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_GetEraseSize(uint32_t address)
+{
+    const cy_stc_dfu_nvm_region_t *nvm = RegionFind(address)->nvm;
+
+    return ((nvm != NULL) ? nvm->eraseSize : 0U);
+}
+
+
 /*******************************************************************************
 * Function Name: Cy_DFU_TransportStart
 ****************************************************************************//**
@@ -283,43 +625,42 @@ CY_MISRA_BLOCK_END('MISRA C-2012 Rule 11.6');
 *******************************************************************************/
 void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
 {
-    selectedInterface = transport;
+    /* The NVM address ranges for the address validation */
+    RegionIndexBuild();
+
+    selectedTransport = NULL;
+    listenAll = (transport == CY_DFU_ALL);
+    pollIndex = 0U;
 
-    switch (transport)
+    for (uint32_t i = 0U; transportList[i] != NULL; i++)
     {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_BLE
-        case CY_DFU_BLE:
-            CyBLE_CyBtldrCommStart();
-            break;
-    #endif /* COMPONENT_DFU_BLE */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+        if (listenAll)
+        {
+            transportList[i]->start();
+        }
+        else if (transportList[i]->transport == transport)
+        {
+            selectedTransport = transportList[i];
+        }
+        else
+        {
+            /* Not the selected interface */
+        }
     }
 
+    if (selectedTransport != NULL)
+    {
+        selectedTransport->start();
+    }
+    else if (!listenAll)
+    {
+        /* Selected interface in not applicable */
+        CY_ASSERT(false);
+    }
+    else
+    {
+        /* All the transports are started */
+    }
 }
 
 
@@ -333,41 +674,21 @@ void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
 *******************************************************************************/
 void Cy_DFU_TransportStop(void)
 {
-    switch (selectedInterface)
+    if (listenAll)
     {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_BLE
-        case CY_DFU_BLE:
-            CyBLE_CyBtldrCommStop();
-            break;
-    #endif /* COMPONENT_DFU_BLE */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            transportList[i]->stop();
+        }
+    }
+    else if (selectedTransport != NULL)
+    {
+        selectedTransport->stop();
+    }
+    else
+    {
+        /* No transport is started */
     }
-
 }
 
 
@@ -381,39 +702,20 @@ void Cy_DFU_TransportStop(void)
 *******************************************************************************/
 void Cy_DFU_TransportReset(void)
 {
-    switch (selectedInterface)
+    if (listenAll)
     {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            I2C_I2cCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            UART_UartCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            SPI_SpiCyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            USB_CDC_CyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_BLE
-        case CY_DFU_BLE:
-            CyBLE_CyBtldrCommReset();
-            break;
-    #endif /* COMPONENT_DFU_BLE */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            transportList[i]->reset();
+        }
+    }
+    else if (selectedTransport != NULL)
+    {
+        selectedTransport->reset();
+    }
+    else
+    {
+        /* No transport is started */
     }
 }
 
@@ -429,39 +731,39 @@ void Cy_DFU_TransportReset(void)
 cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
-    switch (selectedInterface)
+    if (listenAll)
+    {
+        /* Share the timeout between the transports, so none of them waits for long */
+        uint32_t slice = timeout / ((TRANSPORT_COUNT > 0U) ? TRANSPORT_COUNT : 1U);
+
+        if (slice == 0U)
+        {
+            slice = 1U;
+        }
+
+        status = CY_DFU_ERROR_TIMEOUT;
+
+        for (uint32_t i = 0U; (i < TRANSPORT_COUNT) && (status == CY_DFU_ERROR_TIMEOUT); i++)
+        {
+            const cy_stc_dfu_transport_ops_t *transport = transportList[pollIndex];
+
+            pollIndex = ((pollIndex + 1U) < TRANSPORT_COUNT) ? (pollIndex + 1U) : 0U;
+
+            status = transport->read(buffer, size, count, slice);
+            if (status != CY_DFU_ERROR_TIMEOUT)
+            {
+                /* Respond through the transport the packet came from */
+                selectedTransport = transport;
+            }
+        }
+    }
+    else if (selectedTransport != NULL)
     {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            status = I2C_I2cCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            status = UART_UartCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            status = SPI_SpiCyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_BLE
-        case CY_DFU_BLE:
-            status = CyBLE_CyBtldrCommRead(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_BLE */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+        status = selectedTransport->read(buffer, size, count, timeout);
+    }
+    else
+    {
+        /* No transport is started */
     }
 
     return status;
@@ -479,43 +781,54 @@ cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_
 cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
 {
     cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
-    switch (selectedInterface)
+    if (selectedTransport != NULL)
     {
-    #ifdef COMPONENT_DFU_I2C
-        case CY_DFU_I2C:
-            status = I2C_I2cCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_I2C */
-
-    #ifdef COMPONENT_DFU_UART
-        case CY_DFU_UART:
-            status = UART_UartCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_UART */
-    #ifdef COMPONENT_DFU_SPI
-        case CY_DFU_SPI:
-            status = SPI_SpiCyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_SPI */
-    #ifdef COMPONENT_DFU_USB_CDC
-        case CY_DFU_USB_CDC:
-            status = USB_CDC_CyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_USB_CDC */
-    #ifdef COMPONENT_DFU_BLE
-        case CY_DFU_BLE:
-            status = CyBLE_CyBtldrCommWrite(buffer, size, count, timeout);
-            break;
-    #endif /* COMPONENT_DFU_BLE */
-
-        default:
-            /* Selected interface in not applicable */
-            CY_ASSERT(false);
-            break;
+        status = selectedTransport->write(buffer, size, count, timeout);
     }
 
     return status;
 }
 
 
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportGetOps
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+const cy_stc_dfu_transport_ops_t * Cy_DFU_TransportGetOps(void)
+{
+    /* The next packet may come from any transport until the session locks on one */
+    return (listenAll ? NULL : selectedTransport);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportLock
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+void Cy_DFU_TransportLock(void)
+{
+    if (listenAll && (selectedTransport != NULL))
+    {
+        /* Stop all the transports except the one the update session goes through */
+        for (uint32_t i = 0U; transportList[i] != NULL; i++)
+        {
+            if (transportList[i] != selectedTransport)
+            {
+                transportList[i]->stop();
+            }
+        }
+
+        listenAll = false;
+    }
+}
+
+
 /* [] END OF FILE */
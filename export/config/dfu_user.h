@@ -135,6 +135,69 @@ extern "C" {
     #define CY_DFU_OPT_CUSTOM_CMD      (0)
 #endif /* CY_DFU_OPT_CUSTOM_CMD */
 
+/**
+* A non-zero value enables the zero-copy receive of the Send Data and Program
+* Data DFU commands for the transports with the
+* \ref CY_DFU_TRANSPORT_CAP_ZERO_COPY capability. The DFU SDK reads the packet
+* header first and then reads the data of these commands straight into
+* \c dataBuffer at \c dataOffset, instead of copying it from \c packetBuffer.
+* \c packetBuffer and \c dataBuffer must be non-overlapping.
+*/
+#ifndef CY_DFU_OPT_ZERO_COPY
+    #define CY_DFU_OPT_ZERO_COPY       (0)
+#endif /* CY_DFU_OPT_ZERO_COPY */
+
+/**
+* A non-zero value enables the per-command statistics of \ref Cy_DFU_Continue
+* and the Get Stats DFU command, see \ref group_dfu_ucase_stats.
+*/
+#ifndef CY_DFU_OPT_STATS
+    #define CY_DFU_OPT_STATS           (0)
+#endif /* CY_DFU_OPT_STATS */
+
+/** The number of bins in the latency histogram of a DFU command, up to 32 */
+#ifndef CY_DFU_STATS_HIST_BINS
+    #define CY_DFU_STATS_HIST_BINS     (16U)
+#endif /* CY_DFU_STATS_HIST_BINS */
+
+/**
+* The binary logarithm of the latency histogram resolution in
+* \ref Cy_DFU_StatsTimestamp ticks. Bin N counts the commands that took from
+* 2^(N + CY_DFU_STATS_HIST_SHIFT) to 2^(N + 1 + CY_DFU_STATS_HIST_SHIFT) - 1
+* ticks. The first bin also counts the faster commands, the last bin the slower.
+*/
+#ifndef CY_DFU_STATS_HIST_SHIFT
+    #define CY_DFU_STATS_HIST_SHIFT    (10U)
+#endif /* CY_DFU_STATS_HIST_SHIFT */
+
+/**
+* A non-zero value enables the resumable update sessions: the rows programmed
+* by the Program Data DFU command are recorded in a progress record in the NVM,
+* and the Get Progress DFU command reports them to the DFU Host, see
+* \ref group_dfu_ucase_resume.
+*/
+#ifndef CY_DFU_OPT_RESUME
+    #define CY_DFU_OPT_RESUME          (0)
+#endif /* CY_DFU_OPT_RESUME */
+
+/**
+* The number of the NVM rows of the progress area. The progress record is
+* written to the next row each time, so the previous record remains valid if
+* the write is interrupted.
+*/
+#ifndef CY_DFU_PROGRESS_SLOTS
+    #define CY_DFU_PROGRESS_SLOTS      (2U)
+#endif /* CY_DFU_PROGRESS_SLOTS */
+
+/**
+* The number of the newly programmed rows after which the progress record is
+* written to the NVM. The rows programmed after the last write are programmed
+* again when the update session is resumed.
+*/
+#ifndef CY_DFU_PROGRESS_INTERVAL
+    #define CY_DFU_PROGRESS_INTERVAL   (16U)
+#endif /* CY_DFU_PROGRESS_INTERVAL */
+
 /**
 * The number of applications in the metadata,
 * for 512 bytes in a flash row - 63 is the maximum possible value,
@@ -146,6 +209,55 @@ extern "C" {
     #define CY_DFU_MAX_APPS            (2U)
 #endif /* CY_DFU_MAX_APPS */
 
+/**
+* A non-zero value enables the driver of an external serial NOR device, see
+* \ref group_dfu_ucase_nor.
+*/
+#ifndef CY_DFU_OPT_NOR
+    #define CY_DFU_OPT_NOR             (0)
+#endif /* CY_DFU_OPT_NOR */
+
+/** The longest time in milliseconds of a page program of the serial NOR */
+#ifndef CY_DFU_NOR_PROGRAM_TIMEOUT_MS
+    #define CY_DFU_NOR_PROGRAM_TIMEOUT_MS (10U)
+#endif /* CY_DFU_NOR_PROGRAM_TIMEOUT_MS */
+
+/** The longest time in milliseconds of a sector erase of the serial NOR */
+#ifndef CY_DFU_NOR_ERASE_TIMEOUT_MS
+    #define CY_DFU_NOR_ERASE_TIMEOUT_MS (3000U)
+#endif /* CY_DFU_NOR_ERASE_TIMEOUT_MS */
+
+/** The interval in microseconds of the status polls of the serial NOR */
+#ifndef CY_DFU_NOR_POLL_INTERVAL_US
+    #define CY_DFU_NOR_POLL_INTERVAL_US (20U)
+#endif /* CY_DFU_NOR_POLL_INTERVAL_US */
+
+/**
+* A non-zero value enables the write-back cache of an erase unit of the NVM
+* regions, see \ref group_dfu_ucase_nvm_regions.
+*/
+#ifndef CY_DFU_OPT_NVM_CACHE
+    #define CY_DFU_OPT_NVM_CACHE       (0)
+#endif /* CY_DFU_OPT_NVM_CACHE */
+
+/**
+* The number of the bytes of the NVM cache, a multiple of 4. A region with a
+* larger erase unit is written through.
+*/
+#ifndef CY_DFU_NVM_CACHE_SIZE
+    #define CY_DFU_NVM_CACHE_SIZE      (32768U)
+#endif /* CY_DFU_NVM_CACHE_SIZE */
+
+/**
+* A non-zero value lets \ref Cy_DFU_Continue return during the non-blocking
+* write of a Program Data command, see \ref group_dfu_ucase_nvm_regions. The
+* dfu_user.c template for CAT1 then writes the flash rows with
+* cyhal_flash_start_write() on the devices without the M7 core.
+*/
+#ifndef CY_DFU_OPT_NVM_ASYNC
+    #define CY_DFU_OPT_NVM_ASYNC       (0)
+#endif /* CY_DFU_OPT_NVM_ASYNC */
+
 /* MCUBoot compatibility flow specific constants */
 #if (CY_DFU_FLOW == CY_DFU_MCUBOOT_FLOW) && !defined(CY_DOXYGEN)
     #if !defined CY_DFU_PRODUCT
@@ -200,6 +312,105 @@ extern "C" {
         #define CY_DFU_OPT_CRYPTO_HW       (0)
     #endif /* CY_DFU_OPT_CRYPTO_HW */
 
+    /**
+    * A non-zero value enables the cache of the \ref Cy_DFU_ValidateApp results
+    * in the ".cy_boot_noinit" section, kept over a software reset. A valid
+    * application is not verified again until its metadata changes or
+    * \ref Cy_DFU_WriteData writes the NVM, see \ref Cy_DFU_ValidCacheInvalidate.
+    */
+    #ifndef CY_DFU_OPT_VALID_CACHE
+        #define CY_DFU_OPT_VALID_CACHE     (0)
+    #endif /* CY_DFU_OPT_VALID_CACHE */
+
+    /**
+    * A non-zero value enables the running CRC-32C of the image: the Program
+    * Data DFU command adds the rows programmed in the address order to it, and
+    * the Verify Application DFU command reads only the rest of the application
+    * from the NVM, see \ref cy_stc_dfu_digest_t. Requires the basic application
+    * format with the software CRC-32C.
+    */
+    #ifndef CY_DFU_OPT_INLINE_DIGEST
+        #define CY_DFU_OPT_INLINE_DIGEST   (0)
+    #endif /* CY_DFU_OPT_INLINE_DIGEST */
+
+    /**
+    * A non-zero value selects the SHA-256 application checksum for the basic
+    * application format: \ref CY_DFU_SHA256_SIZE bytes after the verified
+    * area. SHA-256 is calculated with the crypto hardware block if
+    * \ref CY_DFU_OPT_CRYPTO_HW is set, in software otherwise. Also enables
+    * the streaming SHA-256 functions, see \ref Cy_DFU_Sha256Init.
+    */
+    #ifndef CY_DFU_OPT_SHA256
+        #define CY_DFU_OPT_SHA256          (0)
+    #endif /* CY_DFU_OPT_SHA256 */
+
+    /**
+    * A non-zero value selects the multi-row metadata format: a header row
+    * followed by the rows of the \ref CY_DFU_METADATA_RECORD_SIZE byte
+    * application records, see \ref group_dfu_ucase_metadata_v2. Requires
+    * __cy_boot_metadata_length of \ref CY_DFU_METADATA_LENGTH bytes.
+    */
+    #ifndef CY_DFU_OPT_METADATA_V2
+        #define CY_DFU_OPT_METADATA_V2     (0)
+    #endif /* CY_DFU_OPT_METADATA_V2 */
+
+    /**
+    * A non-zero value keeps the application records of
+    * \ref CY_DFU_OPT_METADATA_V2 in an append-only journal of
+    * \ref CY_DFU_METADATA_JOURNAL_ROWS rows, see
+    * \ref group_dfu_ucase_metadata_journal.
+    */
+    #ifndef CY_DFU_OPT_METADATA_JOURNAL
+        #define CY_DFU_OPT_METADATA_JOURNAL (0)
+    #endif /* CY_DFU_OPT_METADATA_JOURNAL */
+
+    /**
+    * The number of the NVM rows of the metadata journal, more than
+    * \ref CY_DFU_MAX_APPS.
+    */
+    #ifndef CY_DFU_METADATA_JOURNAL_ROWS
+        #define CY_DFU_METADATA_JOURNAL_ROWS (8U)
+    #endif /* CY_DFU_METADATA_JOURNAL_ROWS */
+
+    /**
+    * A non-zero value keeps a RAM copy of the metadata and the result of
+    * \ref Cy_DFU_ValidateMetadata: the Get Metadata DFU command and
+    * \ref Cy_DFU_GetAppMetadata do not read the NVM until the metadata is
+    * written, see \ref Cy_DFU_MetadataCacheInvalidate. The copy takes
+    * CY_NVM_SIZEOF_ROW bytes of RAM, \ref CY_DFU_METADATA_LENGTH bytes with
+    * \ref CY_DFU_OPT_METADATA_V2 without the journal.
+    */
+    #ifndef CY_DFU_OPT_METADATA_CACHE
+        #define CY_DFU_OPT_METADATA_CACHE  (0)
+    #endif /* CY_DFU_OPT_METADATA_CACHE */
+
+    /**
+    * A non-zero value enables the power-fail-safe swap of two slots through a
+    * scratch area, see \ref group_dfu_ucase_swap.
+    */
+    #ifndef CY_DFU_OPT_SWAP
+        #define CY_DFU_OPT_SWAP            (0)
+    #endif /* CY_DFU_OPT_SWAP */
+
+    /**
+    * The number of the NVM rows of the swap status area, or of the erase units
+    * on the memory erased in units larger than a row. The status record is
+    * written to the next one three times for each block.
+    */
+    #ifndef CY_DFU_SWAP_STATUS_SLOTS
+        #define CY_DFU_SWAP_STATUS_SLOTS   (4U)
+    #endif /* CY_DFU_SWAP_STATUS_SLOTS */
+
+    /**
+    * The size in bytes of the blocks the slots are exchanged in, and of the
+    * scratch area, a multiple of the NVM row size and of the erase units of
+    * the slots and the scratch area, for example of the 32 KB sectors of the
+    * CY_IP_M7CPUSS flash.
+    */
+    #ifndef CY_DFU_SWAP_BLOCK_SIZE
+        #define CY_DFU_SWAP_BLOCK_SIZE     (8U * CY_NVM_SIZEOF_ROW)
+    #endif /* CY_DFU_SWAP_BLOCK_SIZE */
+
     #if defined(__ARMCC_VERSION)
         #include "dfu_common.h"
 
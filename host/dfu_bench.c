@@ -0,0 +1,344 @@
+/***************************************************************************//**
+* \file dfu_bench.c
+* \version 5.2
+*
+* This file provides the micro-benchmarks of the DFU packet hot paths for the
+* host-native simulator build. It includes cy_dfu.c to reach its static
+* functions and measures VerifyPacket(), PacketChecksum(),
+* Cy_DFU_DataChecksum(), CopyToDataBuffer() and WritePacket() for packet sizes
+* from CY_DFU_PACKET_MIN_SIZE to CY_DFU_SIZEOF_CMD_BUFFER. The results are
+* printed as JSON: ns per packet, cycles per byte, and instructions per packet.
+* The cycles and instructions come from the CPU performance counters when the
+* kernel allows it; otherwise the cycles come from the time stamp counter and
+* the instructions are null.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include "cy_dfu.c"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+#endif
+#include "dfu_sim.h"
+
+#define BENCH_MIN_NS            (20000000ULL)   /* The minimal duration of a measurement */
+#define BENCH_SIZE_COUNT        (sizeof(benchSizes) / sizeof(benchSizes[0]))
+
+/* The measured operation, called with the packet size */
+typedef void (*bench_fn_t)(uint32_t packetSize);
+
+typedef struct
+{
+    uint64_t ns;
+    uint64_t cycles;
+    uint64_t instructions;
+} bench_sample_t;
+
+/* The packet sizes, in bytes, including the header and the footer */
+static const uint32_t benchSizes[] = { CY_DFU_PACKET_MIN_SIZE, 16U, 32U, 64U, 128U, 256U, 512U,
+                                       CY_DFU_SIZEOF_CMD_BUFFER };
+
+CY_ALIGN(4) static uint8_t packetBuf[CY_DFU_SIZEOF_CMD_BUFFER];
+CY_ALIGN(4) static uint8_t dataBuf[CY_DFU_SIZEOF_DATA_BUFFER];
+static cy_stc_dfu_params_t benchParams;
+static volatile uint32_t sink;
+
+static int perfCycles = -1;
+static int perfInstructions = -1;
+static const char *cyclesSource = "none";
+
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec);
+}
+
+
+static int PerfOpen(uint64_t config)
+{
+    struct perf_event_attr attr;
+
+    (void) memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return ((int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+
+static uint64_t PerfRead(int fd)
+{
+    uint64_t value = 0U;
+
+    if ((fd >= 0) && (read(fd, &value, sizeof(value)) != (ssize_t)sizeof(value)))
+    {
+        value = 0U;
+    }
+    return (value);
+}
+
+
+static void PerfControl(unsigned long request)
+{
+    if (perfCycles >= 0)
+    {
+        (void) ioctl(perfCycles, request, 0);
+    }
+    if (perfInstructions >= 0)
+    {
+        (void) ioctl(perfInstructions, request, 0);
+    }
+}
+
+
+static uint64_t TscNow(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return (__rdtsc());
+#else
+    return (0U);
+#endif
+}
+
+
+/*******************************************************************************
+* Function Name: PreparePacket
+****************************************************************************//**
+*
+* Fills the packet buffer with a valid DFU packet of \c packetSize bytes.
+*
+*******************************************************************************/
+static void PreparePacket(uint32_t packetSize)
+{
+    uint32_t size = packetSize - CY_DFU_PACKET_MIN_SIZE;
+    uint32_t i;
+
+    SetPacketHeader(packetBuf);
+    SetPacketCmd(packetBuf, CY_DFU_CMD_SEND_DATA);
+    SetPacketDSize(packetBuf, size);
+    for (i = 0U; i < size; i++)
+    {
+        packetBuf[PACKET_DATA_IDX + i] = (uint8_t)((i * 7U) + 3U);
+    }
+    SetPacketChecksum(packetBuf, size, PacketChecksum(packetBuf, size));
+    SetPacketFooter(packetBuf, size);
+}
+
+
+static void BenchVerifyPacket(uint32_t packetSize)
+{
+    sink += (uint32_t)VerifyPacket(packetSize, packetBuf, NULL, 0U);
+}
+
+
+static void BenchPacketChecksum(uint32_t packetSize)
+{
+    sink += PacketChecksum(packetBuf, packetSize - CY_DFU_PACKET_MIN_SIZE);
+}
+
+
+static void BenchDataChecksum(uint32_t packetSize)
+{
+    sink += Cy_DFU_DataChecksum(&packetBuf[PACKET_DATA_IDX], packetSize - CY_DFU_PACKET_MIN_SIZE, &benchParams);
+}
+
+
+static void BenchCopyToDataBuffer(uint32_t packetSize)
+{
+    uint32_t offset = 0U;
+
+    sink += (uint32_t)CopyToDataBuffer(dataBuf, &offset, &packetBuf[PACKET_DATA_IDX],
+                                       packetSize - CY_DFU_PACKET_MIN_SIZE);
+}
+
+
+static void BenchWritePacket(uint32_t packetSize)
+{
+    uint8_t drain[CY_DFU_SIZEOF_CMD_BUFFER];
+
+    sink += (uint32_t)WritePacket(CY_DFU_SUCCESS, packetBuf, packetSize - CY_DFU_PACKET_MIN_SIZE);
+    sink += SimPipe_HostRead(drain, sizeof(drain));
+}
+
+
+/*******************************************************************************
+* Function Name: Measure
+****************************************************************************//**
+*
+* Runs \c fn until it has taken at least BENCH_MIN_NS and returns the totals.
+*
+*******************************************************************************/
+static uint64_t Measure(bench_fn_t fn, uint32_t packetSize, bench_sample_t *sample)
+{
+    uint64_t iterations = 16U;
+    uint64_t done = 0U;
+
+    (void) memset(sample, 0, sizeof(*sample));
+    for (;;)
+    {
+        uint64_t i;
+        uint64_t start;
+        uint64_t tsc;
+
+        PreparePacket(packetSize);
+        PerfControl(PERF_EVENT_IOC_RESET);
+        PerfControl(PERF_EVENT_IOC_ENABLE);
+        tsc = TscNow();
+        start = NowNs();
+        for (i = 0U; i < iterations; i++)
+        {
+            fn(packetSize);
+        }
+        sample->ns = NowNs() - start;
+        tsc = TscNow() - tsc;
+        PerfControl(PERF_EVENT_IOC_DISABLE);
+
+        sample->cycles = (perfCycles >= 0) ? PerfRead(perfCycles) : tsc;
+        sample->instructions = PerfRead(perfInstructions);
+        done = iterations;
+
+        if (sample->ns >= BENCH_MIN_NS)
+        {
+            break;
+        }
+        iterations *= 2U;
+    }
+    return (done);
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const struct { const char *name; bench_fn_t fn; } benches[] =
+    {
+        { "VerifyPacket",        &BenchVerifyPacket     },
+        { "PacketChecksum",      &BenchPacketChecksum   },
+        { "Cy_DFU_DataChecksum", &BenchDataChecksum     },
+        { "CopyToDataBuffer",    &BenchCopyToDataBuffer },
+        { "WritePacket",         &BenchWritePacket      },
+    };
+    FILE *out = stdout;
+    uint32_t b;
+    uint32_t s;
+    bool first = true;
+
+    if (argc > 1)
+    {
+        out = fopen(argv[1], "w");
+        if (out == NULL)
+        {
+            perror(argv[1]);
+            return (1);
+        }
+    }
+
+    perfCycles = PerfOpen(PERF_COUNT_HW_CPU_CYCLES);
+    perfInstructions = PerfOpen(PERF_COUNT_HW_INSTRUCTIONS);
+#if defined(__x86_64__) || defined(__i386__)
+    cyclesSource = (perfCycles >= 0) ? "pmu" : "tsc";
+#else
+    cyclesSource = (perfCycles >= 0) ? "pmu" : "none";
+#endif
+
+    benchParams.dataBuffer = dataBuf;
+    benchParams.packetBuffer = packetBuf;
+    benchParams.timeout = 1U;
+    (void) SimTransport_Select("pipe");
+    Cy_DFU_TransportStart(CY_DFU_UART);
+
+    (void) fprintf(out, "{\n  \"benchmark\": \"dfu_packet\",\n  \"packet_crc\": %d,\n"
+                        "  \"cmd_buffer\": %u,\n  \"cycles_source\": \"%s\",\n  \"results\": [",
+                   (int)CY_DFU_OPT_PACKET_CRC, (unsigned int)CY_DFU_SIZEOF_CMD_BUFFER, cyclesSource);
+
+    for (b = 0U; b < (sizeof(benches) / sizeof(benches[0])); b++)
+    {
+        for (s = 0U; s < BENCH_SIZE_COUNT; s++)
+        {
+            bench_sample_t sample;
+            uint32_t packetSize = benchSizes[s];
+            uint64_t n = Measure(benches[b].fn, packetSize, &sample);
+            double nsPerOp = (double)sample.ns / (double)n;
+
+            (void) fprintf(out, "%s\n    {\"function\": \"%s\", \"packet_size\": %u, \"iterations\": %llu, "
+                                "\"ns_per_packet\": %.2f, ",
+                           first ? "" : ",", benches[b].name, (unsigned int)packetSize,
+                           (unsigned long long)n, nsPerOp);
+            if (sample.cycles != 0U)
+            {
+                (void) fprintf(out, "\"cycles_per_byte\": %.3f, ",
+                               (double)sample.cycles / ((double)n * (double)packetSize));
+            }
+            else
+            {
+                (void) fprintf(out, "\"cycles_per_byte\": null, ");
+            }
+            if (sample.instructions != 0U)
+            {
+                (void) fprintf(out, "\"instructions_per_packet\": %.1f}",
+                               (double)sample.instructions / (double)n);
+            }
+            else
+            {
+                (void) fprintf(out, "\"instructions_per_packet\": null}");
+            }
+            first = false;
+        }
+    }
+    (void) fprintf(out, "\n  ]\n}\n");
+
+    Cy_DFU_TransportStop();
+    if (out != stdout)
+    {
+        (void) fclose(out);
+    }
+    return ((sink == 0xFFFFFFFFU) ? 1 : 0);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+################################################################################
+# \file dfu_log_decode.py
+# \version 5.2
+#
+# Decodes the DFU binary log ring (CY_DFU_BINARY_LOG) from a memory dump: the
+# records hold the addresses of the format strings, read from the ELF file of
+# the firmware, and the raw arguments. Decodes the DFU tokenized log
+# (CY_DFU_TOKENIZED_LOG), the ring or the frames received from the log
+# channel, with the token dictionary generated by dfu_log_tokens.py.
+#
+#   dfu_log_decode.py FIRMWARE.elf DUMP.bin
+#   dfu_log_decode.py --tokens TOKENS.csv DUMP.bin
+#   dfu_log_decode.py --tokens TOKENS.csv --stream LOG.bin
+#
+# DUMP.bin is a dump of the RAM that contains cy_dfu_log_ring, for example
+# from GDB:
+#
+#   dump binary value ring.bin cy_dfu_log_ring
+#
+# The ring is found in the dump by its magic number. The last records in the
+# ring are printed, including the records already output by Cy_DFU_LogDrain().
+#
+################################################################################
+# \copyright
+# (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+################################################################################
+
+import argparse
+import codecs
+import csv
+import re
+import struct
+import sys
+
+LOG_MAGIC = 0x4C554644          # CY_DFU_LOG_MAGIC
+LOG_MAGIC_TOKENS = 0x54554644   # CY_DFU_LOG_MAGIC_TOKENS
+FRAME_HEADER = 0xC0             # CY_DFU_LOG_FRAME_HEADER
+LOG_MAX_ARGS = 4                # CY_DFU_LOG_MAX_ARGS
+RING_HEADER = struct.Struct('<5I')
+RECORD = struct.Struct('<%dI' % (2 + LOG_MAX_ARGS))
+
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+SUFFIX = '\n\r'
+
+CONVERSION = re.compile(r'%([-+ #0]*\d*(?:\.\d+)?)(?:hh|h|ll|l|j|z|t|L)?([diouxXc%])')
+
+
+def load_sections(path):
+    """Returns (address, bytes) of the allocated sections with contents of an ELF file."""
+    with open(path, 'rb') as elf:
+        data = elf.read()
+    if data[:4] != b'\x7fELF' or data[5] != 1:
+        raise ValueError('%s: not a little-endian ELF file' % path)
+    if data[4] == 1:
+        shoff, = struct.unpack_from('<I', data, 0x20)
+        shentsize, shnum = struct.unpack_from('<HH', data, 0x2E)
+        section = struct.Struct('<IIIIII')
+    else:
+        shoff, = struct.unpack_from('<Q', data, 0x28)
+        shentsize, shnum = struct.unpack_from('<HH', data, 0x3A)
+        section = struct.Struct('<IIQQQQ')
+    sections = []
+    for i in range(shnum):
+        _, sh_type, flags, addr, offset, size = section.unpack_from(data, shoff + i * shentsize)
+        if (flags & SHF_ALLOC) and sh_type != SHT_NOBITS and size != 0:
+            sections.append((addr, data[offset:offset + size]))
+    return sections
+
+
+class ElfStrings:
+    """The format strings at their addresses in the firmware."""
+
+    def __init__(self, path):
+        self.sections = load_sections(path)
+
+    def get(self, address):
+        return read_string(self.sections, address)
+
+
+class TokenStrings:
+    """The format strings of the tokens in the dictionary."""
+
+    def __init__(self, path):
+        self.strings = {}
+        with open(path, newline='') as dictionary:
+            for row in csv.reader(dictionary):
+                if len(row) >= 2:
+                    self.strings[int(row[0], 16)] = codecs.decode(row[1].replace('\\"', '"'), 'unicode_escape')
+
+    def get(self, value):
+        return self.strings.get(value)
+
+
+def read_string(sections, address):
+    for addr, contents in sections:
+        if addr <= address < addr + len(contents):
+            start = address - addr
+            end = contents.find(b'\0', start)
+            return contents[start:end if end >= 0 else len(contents)].decode('ascii', 'replace')
+    return None
+
+
+def format_message(fmt, args):
+    args = list(args)
+
+    def convert(match):
+        flags, conv = match.groups()
+        if conv == '%':
+            return '%'
+        value = args.pop(0) if args else 0
+        if conv in 'di' and value >= 0x80000000:
+            value -= 0x100000000
+        if conv == 'c':
+            return chr(value & 0xFF)
+        return ('%' + flags + ('d' if conv in 'diu' else conv)) % value
+
+    return CONVERSION.sub(convert, fmt).rstrip('\r\n')
+
+
+def message(strings, ident, args):
+    fmt = strings.get(ident)
+    if fmt is None:
+        return '<unknown format 0x%08X> %s' % (ident, ' '.join('0x%X' % a for a in args))
+    return format_message(fmt, args)
+
+
+def decode_ring(strings, dump, magic):
+    offset = dump.find(struct.pack('<I', magic))
+    if offset < 0:
+        raise ValueError('the dump does not contain the DFU log ring')
+    _, size, head, tail, dropped = RING_HEADER.unpack_from(dump, offset)
+    records = offset + RING_HEADER.size
+    first = max(0, head - size)
+    for index in range(first, head):
+        fields = RECORD.unpack_from(dump, records + (index % size) * RECORD.size)
+        line = message(strings, fields[0], fields[2:2 + min(fields[1], LOG_MAX_ARGS)])
+        print('%6u%s %s' % (index, ' ' if index < tail else '*', line))
+    print('records %u, not drained (*) %u, dropped %u' % (head - first, head - tail, dropped))
+
+
+def decode_stream(strings, stream):
+    offset = 0
+    count = 0
+    text = 0
+    while offset < len(stream):
+        header = stream[offset]
+        argc = header & 0x0F
+        size = 5 + 4 * argc
+        if (header & 0xF0) != FRAME_HEADER or argc > LOG_MAX_ARGS or offset + size > len(stream):
+            offset += 1             # Resynchronize on the next header byte
+            continue
+        fields = struct.unpack_from('<%dI' % (1 + argc), stream, offset + 1)
+        line = message(strings, fields[0], fields[1:])
+        print(line)
+        count += 1
+        text += len(line) + len(SUFFIX)
+        offset += size
+    print('messages %u, %u bytes, %u bytes as text' % (count, len(stream), text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodes the DFU binary and tokenized logs.')
+    parser.add_argument('--tokens', help='the token dictionary of a CY_DFU_TOKENIZED_LOG build')
+    parser.add_argument('--stream', action='store_true',
+                        help='the input is the tokenized frames from the log channel, not a ring dump')
+    parser.add_argument('inputs', nargs='+', metavar='FILE',
+                        help='FIRMWARE.elf DUMP.bin, or DUMP.bin / LOG.bin with --tokens')
+    args = parser.parse_args()
+
+    if args.tokens is None and (args.stream or len(args.inputs) != 2):
+        parser.error('a ring dump needs the ELF file, the frames need --tokens')
+    if args.tokens is not None and len(args.inputs) != 1:
+        parser.error('--tokens takes one input file')
+
+    strings = TokenStrings(args.tokens) if args.tokens is not None else ElfStrings(args.inputs[0])
+    with open(args.inputs[-1], 'rb') as data:
+        contents = data.read()
+    if args.stream:
+        decode_stream(strings, contents)
+    else:
+        decode_ring(strings, contents, LOG_MAGIC_TOKENS if args.tokens is not None else LOG_MAGIC)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+################################################################################
+# \file dfu_log_tokens.py
+# \version 5.2
+#
+# Generates the token dictionary of the DFU tokenized log (CY_DFU_TOKENIZED_LOG)
+# from the sources: the CY_DFU_LOG_ERR/WRN/INF/DBG calls and their format
+# strings, with the same 65599 hash as CY_DFU_LOG_TOKEN() in cy_dfu_logging.h.
+#
+#   dfu_log_tokens.py -o TOKENS.csv SOURCE_OR_DIRECTORY...
+#
+# Each line of the dictionary is the token in hexadecimal and the format string
+# with its C escapes, for dfu_log_decode.py --tokens. Run it as a post-build
+# step of the application, on the DFU SDK sources and the application sources
+# that use the DFU log macros.
+#
+################################################################################
+# \copyright
+# (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+# an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+################################################################################
+
+import argparse
+import csv
+import os
+import re
+import sys
+
+TOKEN_LENGTH = 80               # CY_DFU_LOG_TOKEN_LENGTH
+HASH_K = 65599
+
+# The prefix and the suffix added by cy_dfu_logging.h to the format strings
+LEVELS = {'ERR': '[DFU_ERR] ', 'WRN': '[DFU_WRN] ', 'INF': '[DFU_INF] ', 'DBG': '[DFU_DBG] '}
+SUFFIX = '\n\r'
+
+LOG_CALL = re.compile(r'\bCY_DFU_LOG_(ERR|WRN|INF|DBG)\s*\(\s*((?:"(?:[^"\\\n]|\\.)*"\s*)+)')
+LITERAL = re.compile(r'"((?:[^"\\\n]|\\.)*)"')
+ESCAPE = re.compile(r'\\(x[0-9A-Fa-f]+|[0-7]{1,3}|.)')
+SIMPLE_ESCAPES = {'n': '\n', 'r': '\r', 't': '\t', '0': '\0', '\\': '\\', '"': '"', "'": "'", '?': '?',
+                  'a': '\a', 'b': '\b', 'f': '\f', 'v': '\v'}
+
+
+def token(string):
+    """The token of a format string, the same as CY_DFU_LOG_TOKEN()."""
+    data = string.encode('latin-1')
+    result = len(data)
+    coefficient = 1
+    for char in data[:TOKEN_LENGTH]:
+        coefficient = (coefficient * HASH_K) & 0xFFFFFFFF
+        result = (result + char * coefficient) & 0xFFFFFFFF
+    return result
+
+
+def unescape(text):
+    def convert(match):
+        escape = match.group(1)
+        if escape[0] == 'x':
+            return chr(int(escape[1:], 16))
+        if escape[0] in '01234567':
+            return chr(int(escape, 8))
+        return SIMPLE_ESCAPES.get(escape, escape)
+    return ESCAPE.sub(convert, text)
+
+
+def escape(text):
+    return text.encode('unicode_escape').decode('ascii').replace('"', '\\"')
+
+
+def source_files(paths):
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, files in sorted(os.walk(path)):
+                for name in sorted(files):
+                    if name.endswith(('.c', '.h')):
+                        yield os.path.join(root, name)
+        else:
+            yield path
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generates the DFU log token dictionary.')
+    parser.add_argument('-o', '--output', required=True, help='the dictionary CSV file')
+    parser.add_argument('sources', nargs='+', help='the source files or directories')
+    args = parser.parse_args()
+
+    tokens = {}
+    collisions = 0
+    for path in source_files(args.sources):
+        with open(path, encoding='latin-1') as source:
+            text = source.read()
+        for match in LOG_CALL.finditer(text):
+            string = LEVELS[match.group(1)] + unescape(''.join(LITERAL.findall(match.group(2)))) + SUFFIX
+            value = token(string)
+            if tokens.get(value, string) != string:
+                sys.stderr.write('%s: token %08x collides: "%s" and "%s"\n'
+                                 % (path, value, escape(tokens[value]), escape(string)))
+                collisions += 1
+            tokens.setdefault(value, string)
+
+    with open(args.output, 'w', newline='') as output:
+        writer = csv.writer(output, lineterminator='\n')
+        for value in sorted(tokens):
+            writer.writerow(['%08x' % value, escape(tokens[value])])
+
+    return 1 if collisions else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
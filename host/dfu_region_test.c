@@ -0,0 +1,624 @@
+/***************************************************************************//**
+* \file dfu_region_test.c
+* \version 5.2
+*
+* This file provides the test of the address checks of the dfu_user.c
+* templates for the host-native simulator build. It includes the CAT1
+* template, or the CAT2 one with COMPONENT_CAT2, to reach the region index,
+* RegionIndexBuild() and RegionFind(), and replaces the DFU SDK and HAL
+* functions the template calls with random layouts of the applications and
+* the flash blocks. For each layout, the results of Cy_DFU_WriteData(),
+* Cy_DFU_ReadData() and Cy_DFU_GetEraseSize() at the bounds of the layout and
+* at random addresses are compared with the address checks the templates made
+* before the region index: AddressValid(), the running application and the
+* golden images. The writes and the reads are of a row at a row address, the
+* application areas end at row bounds, and the length checks are not compared.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+/* Two golden images among four applications */
+#define CY_DFU_MAX_APPS             (4U)
+#define CY_DFU_OPT_GOLDEN_IMAGE     (1)
+#define CY_DFU_GOLDEN_IMAGE_IDS()   1U, 3U
+
+#include "cy_dfu.h"
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    /* The addresses of the linker symbols are not constant in uint32_t on the host, the metadata
+    * initializer of the template takes the values of the memory map from the Makefile */
+    #undef CY_DFU_APP0_VERIFY_START
+    #undef CY_DFU_APP0_VERIFY_LENGTH
+    #undef CY_DFU_APP1_VERIFY_START
+    #undef CY_DFU_APP1_VERIFY_LENGTH
+    #undef CY_DFU_SIGNATURE_SIZE
+    #define CY_DFU_APP0_VERIFY_START    (TEST_APP0_START)
+    #define CY_DFU_APP0_VERIFY_LENGTH   (TEST_APP0_LENGTH - TEST_SIGNATURE_SIZE)
+    #define CY_DFU_APP1_VERIFY_START    (TEST_APP1_START)
+    #define CY_DFU_APP1_VERIFY_LENGTH   (TEST_APP1_LENGTH - TEST_SIGNATURE_SIZE)
+    #define CY_DFU_SIGNATURE_SIZE       (TEST_SIGNATURE_SIZE)
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+#if defined(COMPONENT_CAT2)
+    #include "COMPONENT_CAT2/COMPONENT_DFU_USER/dfu_user.c"
+#else
+    #include "COMPONENT_CAT1/COMPONENT_DFU_USER/dfu_user.c"
+#endif /* defined(COMPONENT_CAT2) */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define TEST_LAYOUTS            (20000U)    /* The random layouts of a run */
+#define TEST_ADDRESSES          (64U)       /* The random addresses checked in a layout */
+#define TEST_ERRORS_MAX         (10U)       /* The mismatches printed */
+#define TEST_ROW                (CY_NVM_SIZEOF_ROW)
+
+/* The addresses of other memory than the flash, refused by all the templates */
+#define TEST_OTHER_BASE         (0x08000000UL)
+
+#if defined(COMPONENT_CAT2)
+    #define TEST_NAME           "CAT2 basic flow"
+    /* No emulated EEPROM, the addresses there are refused */
+    #define TEST_EEPROM_BASE    (0x14000000UL)
+    #define TEST_EEPROM_SIZE    (0x00008000UL)
+#else
+    #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+        #define TEST_NAME       "CAT1 basic flow"
+    #elif defined(CY_IP_M7CPUSS)
+        #define TEST_NAME       "CAT1 M7 MCUboot flow"
+    #else
+        #define TEST_NAME       "CAT1 MCUboot flow"
+    #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+    #define TEST_EEPROM_BASE    (CY_EM_EEPROM_BASE)
+    #define TEST_EEPROM_SIZE    (CY_EM_EEPROM_SIZE)
+#endif /* defined(COMPONENT_CAT2) */
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    /* The application layout: the verified ranges, the validity and the running application */
+    static uint32_t testVerifyStart[CY_DFU_MAX_APPS];
+    static uint32_t testVerifySize[CY_DFU_MAX_APPS];
+    static bool testValid[CY_DFU_MAX_APPS];
+    static uint32_t testRunningApp;
+    /* The Cy_DFU_ValidateApp() calls of each application since its area was placed */
+    static uint32_t testValidations[CY_DFU_MAX_APPS];
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+#ifdef CY_IP_M7CPUSS
+    /* The sector sizes of the code flash and the work flash */
+    static const uint32_t testSectorSizes[] = { 0x8000U, 0x800U };
+    static cyhal_flash_block_info_t testBlocks[FLASH_BLOCKS_MAX];
+    static uint8_t testBlockCount;
+#endif /* CY_IP_M7CPUSS */
+
+static uint8_t testBuffer[CY_DFU_SIZEOF_DATA_BUFFER];
+static cy_stc_dfu_params_t testParams = { .dataBuffer = testBuffer };
+
+static uint32_t testSeed = 0x12345678U;
+static uint32_t testLayout;
+static uint32_t testChecks;
+static uint32_t testErrors;
+
+
+/* The functions of the DFU SDK the template calls */
+
+static bool TestRangeValid(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
+{
+    return ( ((address - region->address) < region->size) &&
+             (length <= (region->size - (address - region->address))) );
+}
+
+const cy_stc_dfu_nvm_region_t * Cy_DFU_NvmRegionFind(const cy_stc_dfu_nvm_region_t * const regions[],
+                                                      uint32_t address, uint32_t length)
+{
+    const cy_stc_dfu_nvm_region_t *region = NULL;
+
+    for (uint32_t idx = 0U; (region == NULL) && (regions[idx] != NULL); ++idx)
+    {
+        if (TestRangeValid(regions[idx], address, length))
+        {
+            region = regions[idx];
+        }
+    }
+    return (region);
+}
+
+cy_en_dfu_status_t Cy_DFU_NvmWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                   uint32_t ctl, cy_stc_dfu_params_t *params)
+{
+    CY_UNUSED_PARAMETER(ctl);
+    CY_UNUSED_PARAMETER(params);
+
+    return ( ((region != NULL) && TestRangeValid(region, address, length)) ? CY_DFU_SUCCESS : CY_DFU_ERROR_ADDRESS );
+}
+
+cy_en_dfu_status_t Cy_DFU_NvmRead(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length,
+                                  uint32_t ctl, cy_stc_dfu_params_t *params)
+{
+    return (Cy_DFU_NvmWrite(region, address, length, ctl, params));
+}
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+cy_en_dfu_status_t Cy_DFU_GetAppMetadata(uint32_t appId, uint32_t *verifyAddress, uint32_t *verifySize)
+{
+    *verifyAddress = testVerifyStart[appId];
+    *verifySize = testVerifySize[appId];
+    return (CY_DFU_SUCCESS);
+}
+
+uint32_t Cy_DFU_GetRunningApp(void)
+{
+    return (testRunningApp);
+}
+
+cy_en_dfu_status_t Cy_DFU_ValidateApp(uint32_t appId, cy_stc_dfu_params_t *params)
+{
+    CY_UNUSED_PARAMETER(params);
+
+    ++testValidations[appId];
+    return (testValid[appId] ? CY_DFU_SUCCESS : CY_DFU_ERROR_VERIFY);
+}
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+
+/* The flash drivers the template calls, the NVM regions are not accessed */
+
+#if defined(COMPONENT_CAT2)
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t* data)
+{
+    CY_UNUSED_PARAMETER(rowAddr);
+    CY_UNUSED_PARAMETER(data);
+    return (CY_FLASH_DRV_SUCCESS);
+}
+#else
+cy_rslt_t cyhal_nvm_init(cyhal_nvm_t *obj)
+{
+    CY_UNUSED_PARAMETER(obj);
+    return (CY_RSLT_SUCCESS);
+}
+
+void cyhal_nvm_free(cyhal_nvm_t *obj)
+{
+    CY_UNUSED_PARAMETER(obj);
+}
+
+void cyhal_flash_get_info(const cyhal_nvm_t *obj, cyhal_flash_info_t *info)
+{
+    CY_UNUSED_PARAMETER(obj);
+#ifdef CY_IP_M7CPUSS
+    info->block_count = testBlockCount;
+    info->blocks = testBlocks;
+#else
+    info->block_count = 0U;
+    info->blocks = NULL;
+#endif /* CY_IP_M7CPUSS */
+}
+
+cy_rslt_t cyhal_flash_read(cyhal_nvm_t *obj, uint32_t address, uint8_t *data, size_t size)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(address);
+    CY_UNUSED_PARAMETER(data);
+    CY_UNUSED_PARAMETER(size);
+    return (CY_RSLT_SUCCESS);
+}
+
+cy_rslt_t cyhal_flash_erase(cyhal_nvm_t *obj, uint32_t address)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(address);
+    return (CY_RSLT_SUCCESS);
+}
+
+cy_rslt_t cyhal_flash_write(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(address);
+    CY_UNUSED_PARAMETER(data);
+    return (CY_RSLT_SUCCESS);
+}
+
+cy_rslt_t cyhal_flash_program(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data)
+{
+    return (cyhal_flash_write(obj, address, data));
+}
+
+cy_rslt_t cyhal_flash_start_write(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data)
+{
+    return (cyhal_flash_write(obj, address, data));
+}
+
+bool cyhal_flash_is_operation_complete(cyhal_nvm_t *obj)
+{
+    CY_UNUSED_PARAMETER(obj);
+    return (true);
+}
+
+void Cy_Flashc_MainWriteEnable(void)
+{
+}
+#endif /* defined(COMPONENT_CAT2) */
+
+
+/*******************************************************************************
+* Function Name: TestRandom
+****************************************************************************//**
+*
+* Returns a pseudo-random number below the limit, the sequence is the same in
+* each run.
+*
+*******************************************************************************/
+static uint32_t TestRandom(uint32_t limit)
+{
+    testSeed = (testSeed * 1103515245U) + 12345U;
+    return ((testSeed >> 8U) % limit);
+}
+
+
+/*******************************************************************************
+* Function Name: TestAddress
+****************************************************************************//**
+*
+* Returns a random row address in or near the flash, the emulated EEPROM or
+* other memory.
+*
+*******************************************************************************/
+static uint32_t TestAddress(void)
+{
+    static const uint32_t bases[] = { CY_FLASH_BASE, CY_FLASH_BASE, TEST_EEPROM_BASE, TEST_OTHER_BASE };
+    uint32_t span = CY_FLASH_SIZE;
+
+#ifdef CY_IP_M7CPUSS
+    span = testBlocks[testBlockCount - 1U].start_address + testBlocks[testBlockCount - 1U].size - CY_FLASH_BASE;
+#endif /* CY_IP_M7CPUSS */
+
+    return (bases[TestRandom(sizeof(bases) / sizeof(bases[0]))] - (16U * TEST_ROW) +
+            (TestRandom((span / TEST_ROW) + 32U) * TEST_ROW));
+}
+
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+/*******************************************************************************
+* Function Name: TestAppsPlace
+****************************************************************************//**
+*
+* Places the application areas at random row addresses, up to 256 rows long.
+* Also the areas outside the NVM, over the end of App0 or over each other.
+*
+*******************************************************************************/
+static void TestAppsPlace(void)
+{
+    for (uint32_t app = 0U; app < CY_DFU_MAX_APPS; ++app)
+    {
+        uint32_t start = TestAddress();
+        uint32_t size = (1U + TestRandom(256U)) * TEST_ROW;
+
+    #if (CY_DFU_APP_FORMAT == CY_DFU_SIMPLIFIED_APP)
+        testVerifyStart[app] = start + CY_DFU_SIGNATURE_SIZE;
+    #else
+        testVerifyStart[app] = start;
+    #endif /* (CY_DFU_APP_FORMAT == CY_DFU_SIMPLIFIED_APP) */
+        testVerifySize[app] = size - CY_DFU_SIGNATURE_SIZE;
+        testValidations[app] = 0U;
+    }
+}
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+
+/*******************************************************************************
+* Function Name: TestLayoutPlace
+****************************************************************************//**
+*
+* Makes a random layout: the application areas, their validity and the running
+* application, or the flash blocks of the devices with the M7 core, up to
+* FLASH_BLOCKS_MAX blocks of code or work flash with gaps between them.
+*
+*******************************************************************************/
+static void TestLayoutPlace(void)
+{
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    TestAppsPlace();
+    for (uint32_t app = 0U; app < CY_DFU_MAX_APPS; ++app)
+    {
+        testValid[app] = (TestRandom(2U) != 0U);
+    }
+    testRunningApp = TestRandom(CY_DFU_MAX_APPS);
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+#ifdef CY_IP_M7CPUSS
+    uint32_t address = CY_FLASH_BASE;
+
+    testBlockCount = (uint8_t)(1U + TestRandom(FLASH_BLOCKS_MAX));
+    for (uint32_t idx = 0U; idx < testBlockCount; ++idx)
+    {
+        cyhal_flash_block_info_t *block = &testBlocks[idx];
+        uint32_t sectorSize = testSectorSizes[TestRandom(sizeof(testSectorSizes) / sizeof(testSectorSizes[0]))];
+
+        address = ((address + sectorSize - 1U) & ~(sectorSize - 1U)) + (TestRandom(3U) * sectorSize);
+        block->start_address = address;
+        block->size = (1U + TestRandom(16U)) * sectorSize;
+        block->sector_size = sectorSize;
+        block->page_size = TEST_ROW;
+        block->erase_value = 0xFFU;
+        address += block->size;
+    }
+#endif /* CY_IP_M7CPUSS */
+}
+
+
+#ifdef CY_IP_M7CPUSS
+/*******************************************************************************
+* Function Name: BaselineSectorSize
+****************************************************************************//**
+*
+* Returns the sector size of the flash block of the address, or 0 if the
+* address is not in a block. AddressValid() took the sector size of the first
+* block instead, which Cy_DFU_GetEraseSize() fixed.
+*
+*******************************************************************************/
+static uint32_t BaselineSectorSize(uint32_t address)
+{
+    uint32_t sectorSize = 0U;
+
+    for (uint32_t idx = 0U; idx < testBlockCount; ++idx)
+    {
+        if ( (testBlocks[idx].start_address <= address) &&
+             (address < (testBlocks[idx].start_address + testBlocks[idx].size)) )
+        {
+            sectorSize = testBlocks[idx].sector_size;
+            break;
+        }
+    }
+    return (sectorSize);
+}
+#endif /* CY_IP_M7CPUSS */
+
+
+/*******************************************************************************
+* Function Name: BaselineAddressValid
+****************************************************************************//**
+*
+* Returns whether the templates before the region index read the address, the
+* AddressValid() check of the CAT1 template and the range check of the CAT2
+* one.
+*
+*******************************************************************************/
+static bool BaselineAddressValid(uint32_t address)
+{
+    bool addrValid;
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    addrValid = ((((CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH)) <= address) &&
+                                (address < (CY_FLASH_BASE + CY_FLASH_SIZE)));
+    #if !defined(COMPONENT_CAT2)
+        addrValid = addrValid || ((CY_EM_EEPROM_BASE <= address) &&
+                                  (address < (CY_EM_EEPROM_BASE + CY_EM_EEPROM_SIZE)));
+    #endif /* !defined(COMPONENT_CAT2) */
+#elif defined(CY_IP_M7CPUSS)
+    addrValid = (BaselineSectorSize(address) > 0U);
+#else
+    addrValid = (CY_FLASH_BASE <= address) && (address < (CY_FLASH_BASE + CY_FLASH_SIZE));
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+    return (addrValid);
+}
+
+
+/*******************************************************************************
+* Function Name: BaselineWrite
+****************************************************************************//**
+*
+* Returns the result of a row write at the address by the templates before the
+* region index: the address check, then the running application and the first
+* golden image with the address.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t BaselineWrite(uint32_t address)
+{
+    cy_en_dfu_status_t status = BaselineAddressValid(address) ? CY_DFU_SUCCESS : CY_DFU_ERROR_ADDRESS;
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    uint32_t startAddress;
+    uint32_t endAddress;
+
+    GetStartEndAddress(testRunningApp, &startAddress, &endAddress);
+    if ( (startAddress <= address) && (address < endAddress) )
+    {
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+    for (uint32_t idx = 0U; idx < GOLDEN_IMAGE_COUNT; ++idx)
+    {
+        GetStartEndAddress(goldenImages[idx], &startAddress, &endAddress);
+        if ( (startAddress <= address) && (address < endAddress) )
+        {
+            if (testValid[goldenImages[idx]])
+            {
+                status = CY_DFU_ERROR_ADDRESS;
+            }
+            break;
+        }
+    }
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: TestExpect
+****************************************************************************//**
+*
+* Counts a check, and prints the first mismatches.
+*
+*******************************************************************************/
+static void TestExpect(const char *what, uint32_t address, uint32_t value, uint32_t expected)
+{
+    ++testChecks;
+    if (value != expected)
+    {
+        if (testErrors < TEST_ERRORS_MAX)
+        {
+            (void) printf("%s: layout %u, %s at 0x%08X: 0x%X, expected 0x%X\n", TEST_NAME,
+                          (unsigned int)testLayout, what, (unsigned int)address, (unsigned int)value,
+                          (unsigned int)expected);
+        }
+        ++testErrors;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: TestRow
+****************************************************************************//**
+*
+* Checks a write, a read and the erase size at a row address.
+*
+*******************************************************************************/
+static void TestRow(uint32_t address)
+{
+    uint32_t eraseSize = 0U;
+
+    TestExpect("write", address, (uint32_t)Cy_DFU_WriteData(address, TEST_ROW, CY_DFU_IOCTL_WRITE, &testParams),
+               (uint32_t)BaselineWrite(address));
+    TestExpect("read", address, (uint32_t)Cy_DFU_ReadData(address, TEST_ROW, CY_DFU_IOCTL_READ, &testParams),
+               (uint32_t)(BaselineAddressValid(address) ? CY_DFU_SUCCESS : CY_DFU_ERROR_ADDRESS));
+#ifdef CY_IP_M7CPUSS
+    eraseSize = BaselineSectorSize(address);
+#endif /* CY_IP_M7CPUSS */
+    TestExpect("erase size", address, Cy_DFU_GetEraseSize(address), eraseSize);
+}
+
+
+/*******************************************************************************
+* Function Name: TestBound
+****************************************************************************//**
+*
+* Checks the rows before, at and after a bound of the layout.
+*
+*******************************************************************************/
+static void TestBound(uint32_t address)
+{
+    uint32_t row = address & ~(TEST_ROW - 1U);
+
+    TestRow(row - TEST_ROW);
+    TestRow(row);
+    TestRow(row + TEST_ROW);
+}
+
+
+/*******************************************************************************
+* Function Name: TestLayoutCheck
+****************************************************************************//**
+*
+* Checks the bounds of the layout and random addresses, and that each golden
+* image is validated at most once since its area was placed.
+*
+*******************************************************************************/
+static void TestLayoutCheck(void)
+{
+    TestBound(CY_FLASH_BASE);
+    TestBound(CY_FLASH_BASE + CY_FLASH_SIZE);
+    TestBound(TEST_EEPROM_BASE);
+    TestBound(TEST_EEPROM_BASE + TEST_EEPROM_SIZE);
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    TestBound(CY_FLASH_BASE + CY_DFU_APP0_VERIFY_LENGTH);
+    for (uint32_t app = 0U; app < CY_DFU_MAX_APPS; ++app)
+    {
+        uint32_t startAddress;
+        uint32_t endAddress;
+
+        GetStartEndAddress(app, &startAddress, &endAddress);
+        TestBound(startAddress);
+        TestBound(endAddress);
+    }
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+
+#ifdef CY_IP_M7CPUSS
+    for (uint32_t idx = 0U; idx < testBlockCount; ++idx)
+    {
+        TestBound(testBlocks[idx].start_address);
+        TestBound(testBlocks[idx].start_address + testBlocks[idx].size);
+    }
+#endif /* CY_IP_M7CPUSS */
+
+    for (uint32_t idx = 0U; idx < TEST_ADDRESSES; ++idx)
+    {
+        TestRow(TestAddress());
+    }
+
+#if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+    for (uint32_t idx = 0U; idx < GOLDEN_IMAGE_COUNT; ++idx)
+    {
+        uint32_t count = testValidations[goldenImages[idx]];
+
+        TestExpect("validations", testVerifyStart[goldenImages[idx]], count, (count > 1U) ? 1U : count);
+    }
+#endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+}
+
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        testSeed = (uint32_t)strtoul(argv[1], NULL, 0);
+    }
+
+    for (testLayout = 0U; testLayout < TEST_LAYOUTS; ++testLayout)
+    {
+        TestLayoutPlace();
+        Cy_DFU_TransportStart(CY_DFU_ALL);
+    #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+        /* An update session starts */
+        Cy_DFU_GoldenImageInvalidate();
+    #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+        TestLayoutCheck();
+
+    #if CY_DFU_FLOW == CY_DFU_BASIC_FLOW
+        /* The metadata is written in the session: the index is built again with the new areas */
+        TestAppsPlace();
+        (void) Cy_DFU_WriteData((uint32_t)cy_dfu_metadata, TEST_ROW, CY_DFU_IOCTL_WRITE, &testParams);
+        TestLayoutCheck();
+    #endif /* CY_DFU_FLOW == CY_DFU_BASIC_FLOW */
+        Cy_DFU_TransportStop();
+    }
+
+    (void) printf("%s: %u layouts, %u checks, %u mismatches: %s\n", TEST_NAME, (unsigned int)TEST_LAYOUTS,
+                  (unsigned int)testChecks, (unsigned int)testErrors, (testErrors == 0U) ? "PASS" : "FAIL");
+
+    return ((testErrors == 0U) ? 0 : 1);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,1233 @@
+/***************************************************************************//**
+* \file dfu_sim.c
+* \version 5.2
+*
+* This file provides the entry point of the host-native simulator build of the
+* DFU SDK. The simulator runs the unchanged cy_dfu.c on the simulated flash and
+* transports and drives it with a built-in DFU Host that programs App1 with a
+* generated image, then reports the packets/s and bytes/s for each DFU command.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "cy_dfu.h"
+#include "cy_dfu_logging.h"
+#include "dfu_sim.h"
+
+#define SIM_TIMEOUT_MS              (20U)     /* The device read timeout */
+#define SIM_HOST_TIMEOUT_MS         (5000)    /* The DFU Host response timeout */
+#define SIM_PACKET_HEADER_SIZE      (4U)      /* SOP, command, 2 bytes of size */
+#define SIM_PACKET_FOOTER_SIZE      (3U)      /* 2 bytes of checksum, EOP */
+#define SIM_PACKET_SOP              (0x01U)
+#define SIM_PACKET_EOP              (0x17U)
+#define SIM_PROGRAM_PARAMS_SIZE     (8U)      /* The address and CRC of the Program Data command */
+#define SIM_APP_ID                  (1U)      /* The application the DFU Host programs */
+#define SIM_PRODUCT_ID              ((uint32_t)&__cy_product_id)
+
+/* The per-command throughput counters */
+typedef struct
+{
+    uint64_t packets;
+    uint64_t bytes;
+    uint64_t ns;
+} sim_cmd_stats_t;
+
+/* The way the DFU Host reaches the device */
+typedef struct
+{
+    int fd;                 /* The pty or socket to the device, -1 for the in-process device */
+} sim_link_t;
+
+/* The in-process device */
+CY_ALIGN(4) static uint8_t packetBuffer[CY_DFU_SIZEOF_CMD_BUFFER];
+CY_ALIGN(4) static uint8_t dataBuffer[CY_DFU_SIZEOF_DATA_BUFFER];
+static cy_stc_dfu_params_t dfuParams;
+static uint32_t dfuState;
+
+static sim_cmd_stats_t cmdStats[256];
+
+#if CY_DFU_OPT_STATS != 0
+/* The device statistics, the Program Data and NVM records the DFU Host has read with Get Stats */
+static cy_stc_dfu_stats_t dfuStats;
+static cy_stc_dfu_cmd_stats_t programStats;
+static bool programStatsValid;
+static cy_stc_dfu_nvm_stats_t nvmStats;
+static bool nvmStatsValid;
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+#if CY_DFU_OPT_RESUME != 0
+/* The progress record of the device, and the bitmap the DFU Host has read with Get Progress */
+static cy_stc_dfu_progress_t dfuProgress;
+static uint8_t hostBitmap[CY_DFU_PROGRESS_MAX_ROWS / 8U];
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
+#if CY_DFU_OPT_INLINE_DIGEST != 0
+static cy_stc_dfu_digest_t dfuDigest;
+#endif /* CY_DFU_OPT_INLINE_DIGEST != 0 */
+
+static uint64_t NowNs(void);
+static uint32_t HostChecksum(const uint8_t buffer[], uint32_t size);
+static uint32_t BuildPacket(uint8_t packet[], uint8_t cmd, const uint8_t data[], uint32_t size);
+static bool Exchange(sim_link_t *link, const uint8_t packet[], uint32_t size, uint8_t rsp[], bool needRsp);
+static bool HostSession(sim_link_t *link, uint32_t imageSize, uint32_t chunk, uint32_t stopAfter,
+                        uint32_t shuffle);
+static bool ImageMatches(const uint8_t image[], uint32_t address, uint32_t length);
+static uint32_t UnitErases(void);
+static bool CheckImage(const uint8_t image[], uint32_t address, uint32_t imageSize, uint32_t shuffle,
+                       uint32_t units, uint32_t erases);
+static void DeviceInit(void);
+static int  RunDevice(void);
+static bool HostConnect(sim_link_t *link, const char *spec);
+static void PrintReport(uint64_t sessionNs, uint32_t imageSize, bool localFlash);
+static void PutLe32(uint8_t array[], uint32_t value);
+static bool DumpLog(const char *path);
+#if CY_DFU_OPT_VALID_CACHE != 0
+static void ReportValidateApp(void);
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+
+#if defined(CY_DFU_TOKENIZED_LOG)
+static FILE *logStream;
+#endif /* defined(CY_DFU_TOKENIZED_LOG) */
+
+
+/*******************************************************************************
+* Function Name: NowNs
+****************************************************************************//**
+*
+* Returns the monotonic time in nanoseconds.
+*
+*******************************************************************************/
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec);
+}
+
+
+/*******************************************************************************
+* Function Name: PutLe32
+****************************************************************************//**
+*
+* Stores a 32-bit value in little-endian byte order.
+*
+*******************************************************************************/
+static void PutLe32(uint8_t array[], uint32_t value)
+{
+    array[0] = (uint8_t)value;
+    array[1] = (uint8_t)(value >> 8U);
+    array[2] = (uint8_t)(value >> 16U);
+    array[3] = (uint8_t)(value >> 24U);
+}
+
+
+/*******************************************************************************
+* Function Name: HostChecksum
+****************************************************************************//**
+*
+* Computes the DFU packet checksum the way a DFU Host does, independently of
+* the DFU SDK implementation: a basic summation or CRC-16 CCITT, see
+* \ref CY_DFU_OPT_PACKET_CRC.
+*
+*******************************************************************************/
+static uint32_t HostChecksum(const uint8_t buffer[], uint32_t size)
+{
+#if (CY_DFU_OPT_PACKET_CRC != 0U)
+    uint16_t crc = 0xFFFFU;
+    uint32_t i;
+    uint32_t bit;
+
+    for (i = 0U; i < size; i++)
+    {
+        uint16_t tmp = buffer[i];
+
+        for (bit = 0U; bit < 8U; bit++)
+        {
+            crc = (((crc ^ tmp) & 0x0001U) != 0U) ? (uint16_t)((crc >> 1U) ^ 0x8408U) : (uint16_t)(crc >> 1U);
+            tmp >>= 1U;
+        }
+    }
+    crc = (uint16_t)~crc;
+    return ((uint32_t)(uint16_t)((crc << 8U) | (crc >> 8U)));
+#else
+    uint32_t sum = 0U;
+    uint32_t i;
+
+    for (i = 0U; i < size; i++)
+    {
+        sum += buffer[i];
+    }
+    return ((1U + ~sum) & 0xFFFFU);
+#endif /* CY_DFU_OPT_PACKET_CRC != 0U */
+}
+
+
+/*******************************************************************************
+* Function Name: BuildPacket
+****************************************************************************//**
+*
+* Builds a DFU command packet.
+*
+* \return The packet size in bytes.
+*
+*******************************************************************************/
+static uint32_t BuildPacket(uint8_t packet[], uint8_t cmd, const uint8_t data[], uint32_t size)
+{
+    uint32_t checksum;
+
+    packet[0] = SIM_PACKET_SOP;
+    packet[1] = cmd;
+    packet[2] = (uint8_t)size;
+    packet[3] = (uint8_t)(size >> 8U);
+    if (size != 0U)
+    {
+        (void) memcpy(&packet[SIM_PACKET_HEADER_SIZE], data, size);
+    }
+    checksum = HostChecksum(packet, SIM_PACKET_HEADER_SIZE + size);
+    packet[SIM_PACKET_HEADER_SIZE + size]      = (uint8_t)checksum;
+    packet[SIM_PACKET_HEADER_SIZE + size + 1U] = (uint8_t)(checksum >> 8U);
+    packet[SIM_PACKET_HEADER_SIZE + size + 2U] = SIM_PACKET_EOP;
+
+    return (SIM_PACKET_HEADER_SIZE + size + SIM_PACKET_FOOTER_SIZE);
+}
+
+
+/*******************************************************************************
+* Function Name: ReadAll
+****************************************************************************//**
+*
+* Reads exactly \c size bytes from the device link.
+*
+*******************************************************************************/
+static bool ReadAll(int fd, uint8_t buffer[], uint32_t size)
+{
+    uint32_t total = 0U;
+
+    while (total < size)
+    {
+        struct pollfd pfd = { fd, POLLIN, 0 };
+        ssize_t n;
+
+        if (poll(&pfd, 1, SIM_HOST_TIMEOUT_MS) <= 0)
+        {
+            break;
+        }
+        n = read(fd, &buffer[total], size - total);
+        if (n <= 0)
+        {
+            break;
+        }
+        total += (uint32_t)n;
+    }
+    return (total == size);
+}
+
+
+/*******************************************************************************
+* Function Name: Exchange
+****************************************************************************//**
+*
+* Sends a command packet to the device and receives the response, if the
+* command has one, and accounts the time and the bytes to the command.
+*
+* \return True if the command has succeeded.
+*
+*******************************************************************************/
+static bool Exchange(sim_link_t *link, const uint8_t packet[], uint32_t size, uint8_t rsp[], bool needRsp)
+{
+    sim_cmd_stats_t *stats = &cmdStats[packet[1]];
+    uint32_t rspSize = 0U;
+    bool ok = true;
+    uint64_t start = NowNs();
+
+    if (link->fd < 0)
+    {
+        cy_en_dfu_status_t status;
+
+        SimPipe_HostWrite(packet, size);
+        do
+        {
+            /* The device loop runs until the response of a non-blocking write is sent */
+            status = Cy_DFU_Continue(&dfuState, &dfuParams);
+        #ifdef CY_DFU_BINARY_LOG
+            (void) Cy_DFU_LogDrain(0U);
+        #endif /* CY_DFU_BINARY_LOG */
+        } while (status == CY_DFU_IN_PROGRESS);
+        if (needRsp)
+        {
+            rspSize = SimPipe_HostRead(rsp, CY_DFU_SIZEOF_CMD_BUFFER);
+        }
+    }
+    else
+    {
+        ok = (write(link->fd, packet, size) == (ssize_t)size);
+        if (ok && needRsp)
+        {
+            ok = ReadAll(link->fd, rsp, SIM_PACKET_HEADER_SIZE);
+            if (ok)
+            {
+                rspSize = SIM_PACKET_HEADER_SIZE + SIM_PACKET_FOOTER_SIZE + rsp[2] + ((uint32_t)rsp[3] << 8U);
+                ok = (rspSize <= CY_DFU_SIZEOF_CMD_BUFFER) &&
+                     ReadAll(link->fd, &rsp[SIM_PACKET_HEADER_SIZE], rspSize - SIM_PACKET_HEADER_SIZE);
+            }
+        }
+    }
+
+    stats->ns += NowNs() - start;
+    stats->packets++;
+    stats->bytes += size + rspSize;
+
+    if (ok && needRsp)
+    {
+        uint32_t dataSize = rspSize - SIM_PACKET_HEADER_SIZE - SIM_PACKET_FOOTER_SIZE;
+        uint32_t checksum = rsp[SIM_PACKET_HEADER_SIZE + dataSize] |
+                            ((uint32_t)rsp[SIM_PACKET_HEADER_SIZE + dataSize + 1U] << 8U);
+
+        ok = (rspSize >= CY_DFU_PACKET_MIN_SIZE) && (rsp[0] == SIM_PACKET_SOP) && (rsp[1] == 0U) &&
+             (checksum == HostChecksum(rsp, SIM_PACKET_HEADER_SIZE + dataSize));
+        if (!ok)
+        {
+            (void) fprintf(stderr, "Command 0x%02X failed, response status 0x%02X\n",
+                           (unsigned int)packet[1], (unsigned int)rsp[1]);
+        }
+    }
+    return (ok);
+}
+
+
+/*******************************************************************************
+* Function Name: HostSession
+****************************************************************************//**
+*
+* Runs a DFU Host session that programs App1 with a generated image: Enter,
+* Set Application Metadata, Send Data and Program Data for each row, Verify
+* Application, and Exit. Built with CY_DFU_OPT_RESUME, the session starts with
+* Get Progress and skips the rows the device reports as programmed. On the
+* local device, CheckImage() checks the image and the erases of the session.
+*
+* \param link       The link to the device.
+* \param imageSize  The size of the image in bytes, a multiple of the row size.
+* \param chunk      The number of data bytes in a packet.
+* \param stopAfter  The number of rows to program before the session is
+*                   interrupted with Exit, 0 to program the whole image.
+* \param shuffle    The size in bytes of the blocks whose rows are sent in a
+*                   shuffled order, a multiple of the row size, or 0 to send
+*                   the rows in order.
+*
+* \return True if the device has accepted and verified the image, or the
+*         session has been interrupted as requested.
+*
+*******************************************************************************/
+static bool HostSession(sim_link_t *link, uint32_t imageSize, uint32_t chunk, uint32_t stopAfter,
+                        uint32_t shuffle)
+{
+    static uint8_t image[CY_FLASH_SIZE];
+    static uint32_t order[CY_FLASH_SIZE / CY_NVM_SIZEOF_ROW];
+    uint8_t packet[CY_DFU_SIZEOF_CMD_BUFFER];
+    uint8_t rsp[CY_DFU_SIZEOF_CMD_BUFFER];
+    uint8_t data[CY_DFU_SIZEOF_CMD_BUFFER];
+    uint32_t appStart = CY_DFU_APP1_VERIFY_START;
+    uint32_t verifySize = imageSize - CY_DFU_SIGNATURE_SIZE;
+    uint32_t seed = 0x12345678U;
+    uint32_t programmed = 0U;
+    uint32_t units = 0U;
+    uint32_t erases = 0U;
+    uint32_t size;
+    uint32_t row;
+    uint32_t i;
+    bool ok;
+
+    /* A pseudo-random image with the checksum of the verified area at its end */
+    for (row = 0U; row < verifySize; row++)
+    {
+        seed = (seed * 1103515245U) + 12345U;
+        image[row] = (uint8_t)(seed >> 16U);
+    }
+#if CY_DFU_OPT_SHA256 != 0
+    {
+        cy_stc_dfu_sha256_t sha;
+        Cy_DFU_Sha256Init(&sha);
+        Cy_DFU_Sha256Update(&sha, image, verifySize);
+        Cy_DFU_Sha256Final(&sha, &image[verifySize]);
+    }
+#else
+    PutLe32(&image[verifySize], Cy_DFU_DataChecksum(image, verifySize, NULL));
+#endif /* CY_DFU_OPT_SHA256 != 0 */
+
+    /* The rows of each block in a random order, as a host that sends them out of order */
+    for (i = 0U; i < (imageSize / CY_NVM_SIZEOF_ROW); i++)
+    {
+        order[i] = i;
+    }
+    for (i = 0U; (shuffle != 0U) && (i < (imageSize / CY_NVM_SIZEOF_ROW)); i += shuffle / CY_NVM_SIZEOF_ROW)
+    {
+        uint32_t count = ((imageSize / CY_NVM_SIZEOF_ROW) - i);
+        uint32_t j;
+
+        count = (count < (shuffle / CY_NVM_SIZEOF_ROW)) ? count : (shuffle / CY_NVM_SIZEOF_ROW);
+        for (j = count - 1U; j > 0U; j--)
+        {
+            uint32_t k;
+            uint32_t swapped = order[i + j];
+
+            seed = (seed * 1103515245U) + 12345U;
+            k = (seed >> 16U) % (j + 1U);
+            order[i + j] = order[i + k];
+            order[i + k] = swapped;
+        }
+    }
+
+    if (link->fd < 0)
+    {
+        uint32_t eraseSize = Cy_DFU_GetEraseSize(appStart);
+
+        /* The erase units the session must change */
+        for (row = 0U; (eraseSize != 0U) && (row < imageSize); row += size)
+        {
+            size = eraseSize - ((appStart + row) % eraseSize);
+            size = (size < (imageSize - row)) ? size : (imageSize - row);
+            units += ImageMatches(&image[row], appStart + row, size) ? 0U : 1U;
+        }
+        erases = UnitErases();
+    }
+
+    PutLe32(data, SIM_PRODUCT_ID);
+    size = BuildPacket(packet, CY_DFU_CMD_ENTER, data, 4U);
+    ok = Exchange(link, packet, size, rsp, true);
+
+    if (ok)
+    {
+        data[0] = SIM_APP_ID;
+        PutLe32(&data[1], appStart);
+        PutLe32(&data[5], verifySize);
+        size = BuildPacket(packet, CY_DFU_CMD_SET_APP_META, data, 9U);
+        ok = Exchange(link, packet, size, rsp, true);
+    }
+
+#if CY_DFU_OPT_RESUME != 0
+    if (ok)
+    {
+        uint32_t bitmapSize = ((imageSize / CY_NVM_SIZEOF_ROW) + 7U) / 8U;
+        uint32_t offset = 0U;
+        uint32_t done = 0U;
+
+        /* The image is identified by its CRC-32C, the bitmap is read in chunks */
+        (void) memset(hostBitmap, 0, sizeof(hostBitmap));
+        do
+        {
+            PutLe32(data, Cy_DFU_DataChecksum(image, imageSize, NULL));
+            PutLe32(&data[4], appStart);
+            PutLe32(&data[8], imageSize);
+            data[12] = (uint8_t)offset;
+            data[13] = (uint8_t)(offset >> 8U);
+            size = BuildPacket(packet, CY_DFU_CMD_GET_PROGRESS, data, 14U);
+            ok = Exchange(link, packet, size, rsp, true);
+            size = ok ? ((rsp[2] + ((uint32_t)rsp[3] << 8U)) - 8U) : 0U;
+            ok = ok && ((offset + size) <= bitmapSize);
+            if (ok)
+            {
+                done = rsp[SIM_PACKET_HEADER_SIZE + 4U] | ((uint32_t)rsp[SIM_PACKET_HEADER_SIZE + 5U] << 8U);
+                (void) memcpy(&hostBitmap[offset], &rsp[SIM_PACKET_HEADER_SIZE + 8U], size);
+                offset += size;
+            }
+        }
+        while (ok && (size != 0U) && (offset < bitmapSize));
+
+        if (ok && (done != 0U))
+        {
+            (void) printf("Resuming: %u of %u rows already programmed\n",
+                          (unsigned int)done, (unsigned int)(imageSize / CY_NVM_SIZEOF_ROW));
+        }
+    }
+#endif /* CY_DFU_OPT_RESUME != 0 */
+
+    for (i = 0U; ok && (i < (imageSize / CY_NVM_SIZEOF_ROW)) && ((stopAfter == 0U) || (programmed < stopAfter)); i++)
+    {
+        const uint8_t *rowData;
+        uint32_t offset = 0U;
+
+        row = order[i] * CY_NVM_SIZEOF_ROW;
+        rowData = &image[row];
+
+    #if CY_DFU_OPT_RESUME != 0
+        if ((hostBitmap[(row / CY_NVM_SIZEOF_ROW) / 8U] & (1U << ((row / CY_NVM_SIZEOF_ROW) % 8U))) != 0U)
+        {
+            continue;
+        }
+    #endif /* CY_DFU_OPT_RESUME != 0 */
+        ++programmed;
+
+        /* The part of the row that does not fit into the Program Data packet */
+        while (ok && ((CY_NVM_SIZEOF_ROW - offset) > chunk))
+        {
+            size = BuildPacket(packet, CY_DFU_CMD_SEND_DATA, &rowData[offset], chunk);
+            ok = Exchange(link, packet, size, rsp, true);
+            offset += chunk;
+        }
+
+        if (ok)
+        {
+            PutLe32(data, appStart + row);
+            PutLe32(&data[4], Cy_DFU_DataChecksum(rowData, CY_NVM_SIZEOF_ROW, NULL));
+            (void) memcpy(&data[SIM_PROGRAM_PARAMS_SIZE], &rowData[offset], CY_NVM_SIZEOF_ROW - offset);
+            size = BuildPacket(packet, CY_DFU_CMD_PROGRAM_DATA, data,
+                               SIM_PROGRAM_PARAMS_SIZE + CY_NVM_SIZEOF_ROW - offset);
+            ok = Exchange(link, packet, size, rsp, true);
+        }
+    }
+
+    if (ok && (stopAfter != 0U) && (programmed == stopAfter))
+    {
+        /* The update is interrupted: Exit without verifying the image */
+        (void) printf("Interrupted after %u rows\n", (unsigned int)programmed);
+        stopAfter = UINT32_MAX;
+    }
+
+    if (ok && (stopAfter != UINT32_MAX))
+    {
+        data[0] = SIM_APP_ID;
+        size = BuildPacket(packet, CY_DFU_CMD_VERIFY_APP, data, 1U);
+        ok = Exchange(link, packet, size, rsp, true) && (rsp[SIM_PACKET_HEADER_SIZE] == 1U);
+    }
+
+#if CY_DFU_OPT_STATS != 0
+    if (ok && (stopAfter != UINT32_MAX))
+    {
+        data[0] = CY_DFU_CMD_PROGRAM_DATA;
+        size = BuildPacket(packet, CY_DFU_CMD_GET_STATS, data, 1U);
+        programStatsValid = Exchange(link, packet, size, rsp, true) &&
+                            ((rsp[2] + ((uint32_t)rsp[3] << 8U)) == sizeof(programStats));
+        if (programStatsValid)
+        {
+            /* The response is the record in little-endian byte order, as the host */
+            (void) memcpy(&programStats, &rsp[SIM_PACKET_HEADER_SIZE], sizeof(programStats));
+        }
+
+        data[0] = CY_DFU_STATS_SEL_NVM;
+        size = BuildPacket(packet, CY_DFU_CMD_GET_STATS, data, 1U);
+        nvmStatsValid = Exchange(link, packet, size, rsp, true) &&
+                        ((rsp[2] + ((uint32_t)rsp[3] << 8U)) == sizeof(nvmStats));
+        if (nvmStatsValid)
+        {
+            (void) memcpy(&nvmStats, &rsp[SIM_PACKET_HEADER_SIZE], sizeof(nvmStats));
+        }
+    }
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+    if (ok && (stopAfter != UINT32_MAX) && (link->fd < 0))
+    {
+        /* Verify Application has written back the NVM cache */
+        ok = CheckImage(image, appStart, imageSize, shuffle, units, UnitErases() - erases);
+    }
+
+    size = BuildPacket(packet, CY_DFU_CMD_EXIT, NULL, 0U);
+    (void) Exchange(link, packet, size, rsp, false);
+
+    return (ok);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageMatches
+****************************************************************************//**
+*
+* Compares a part of the image with the NVM of the local device through
+* Cy_DFU_ReadData(), a row at a time.
+*
+* \param image      The data of the part.
+* \param address    The address of the part, at the start of a row.
+* \param length     The length of the part in bytes, a multiple of the row size.
+*
+* \return True if the NVM holds the part.
+*
+*******************************************************************************/
+static bool ImageMatches(const uint8_t image[], uint32_t address, uint32_t length)
+{
+    bool match = true;
+
+    for (uint32_t offset = 0U; match && (offset < length); offset += CY_NVM_SIZEOF_ROW)
+    {
+        (void) memcpy(dfuParams.dataBuffer, &image[offset], CY_NVM_SIZEOF_ROW);
+        match = (Cy_DFU_ReadData(address + offset, CY_NVM_SIZEOF_ROW, CY_DFU_IOCTL_COMPARE, &dfuParams) ==
+                 CY_DFU_SUCCESS);
+    }
+    return (match);
+}
+
+
+/*******************************************************************************
+* Function Name: UnitErases
+****************************************************************************//**
+*
+* Returns the number of the erases of the NVM regions erased in units: the
+* region of --erase-unit, and the serial NOR with CY_DFU_OPT_NOR.
+*
+*******************************************************************************/
+static uint32_t UnitErases(void)
+{
+    uint32_t erases = SimUser_GetUnitErases();
+
+#if CY_DFU_OPT_NOR != 0
+    cy_stc_dfu_sim_nor_stats_t nor;
+
+    SimNor_GetStats(&nor);
+    erases += nor.erases[0] + nor.erases[1] + nor.erases[2];
+#endif /* CY_DFU_OPT_NOR != 0 */
+    return (erases);
+}
+
+
+/*******************************************************************************
+* Function Name: CheckImage
+****************************************************************************//**
+*
+* Checks that the NVM of the local device holds the image after a session, and
+* that the session erased each erase unit of the image at most once. With
+* CY_DFU_OPT_NVM_CACHE, exactly the units that differed from the image before
+* the session must be erased if the rows of each unit were sent together, in
+* whatever order. The erases of the rows shuffled across the units are not
+* checked: the cache holds one unit.
+*
+* \param image      The image.
+* \param address    The address of the image.
+* \param imageSize  The size of the image in bytes.
+* \param shuffle    The size of the shuffled blocks of HostSession().
+* \param units      The number of the erase units that differed from the
+*                   image before the session.
+* \param erases     The number of the erases of the session.
+*
+* \return True if the checks pass.
+*
+*******************************************************************************/
+static bool CheckImage(const uint8_t image[], uint32_t address, uint32_t imageSize, uint32_t shuffle,
+                       uint32_t units, uint32_t erases)
+{
+    uint32_t eraseSize = Cy_DFU_GetEraseSize(address);
+    bool ok = ImageMatches(image, address, imageSize);
+
+    if (!ok)
+    {
+        (void) printf("App%u does not hold the image\n", (unsigned int)SIM_APP_ID);
+    }
+    if ( (eraseSize != 0U) && ((shuffle == 0U) || ((eraseSize % shuffle) == 0U)) )
+    {
+        /* Each unit the image touches is erased at most once without the cache */
+        uint32_t total = (((address % eraseSize) + imageSize) + (eraseSize - 1U)) / eraseSize;
+        bool exact = (CY_DFU_OPT_NVM_CACHE != 0) && (eraseSize <= CY_DFU_NVM_CACHE_SIZE);
+
+        if (exact ? (erases != units) : (erases > total))
+        {
+            (void) printf("App%u: %u erases of %u-byte units, expected %s%u\n", (unsigned int)SIM_APP_ID,
+                          (unsigned int)erases, (unsigned int)eraseSize, exact ? "" : "at most ",
+                          (unsigned int)(exact ? units : total));
+            ok = false;
+        }
+    }
+    return (ok);
+}
+
+
+/*******************************************************************************
+* Function Name: DeviceInit
+****************************************************************************//**
+*
+* Initializes the DFU SDK as a bootloader does.
+*
+*******************************************************************************/
+static void DeviceInit(void)
+{
+    (void) memset(&dfuParams, 0, sizeof(dfuParams));
+    dfuParams.timeout = SIM_TIMEOUT_MS;
+    dfuParams.dataBuffer = dataBuffer;
+    dfuParams.packetBuffer = packetBuffer;
+#if CY_DFU_OPT_STATS != 0
+    dfuParams.stats = &dfuStats;
+#endif /* CY_DFU_OPT_STATS != 0 */
+#if CY_DFU_OPT_RESUME != 0
+    /* As after a reset: the record is read from the flash by the first Get Progress */
+    (void) memset(&dfuProgress, 0, sizeof(dfuProgress));
+    dfuParams.progress = &dfuProgress;
+#endif /* CY_DFU_OPT_RESUME != 0 */
+#if CY_DFU_OPT_INLINE_DIGEST != 0
+    (void) memset(&dfuDigest, 0, sizeof(dfuDigest));
+    dfuParams.digest = &dfuDigest;
+#endif /* CY_DFU_OPT_INLINE_DIGEST != 0 */
+    (void) Cy_DFU_Init(&dfuState, &dfuParams);
+}
+
+
+/*******************************************************************************
+* Function Name: RunDevice
+****************************************************************************//**
+*
+* Runs the DFU SDK on the selected transport until an update session ends and
+* App1 is valid, as the DFU examples do.
+*
+*******************************************************************************/
+static int RunDevice(void)
+{
+    int result;
+
+    DeviceInit();
+    Cy_DFU_TransportStart(CY_DFU_UART);
+
+    for (;;)
+    {
+        (void) Cy_DFU_Continue(&dfuState, &dfuParams);
+    #ifdef CY_DFU_BINARY_LOG
+        (void) Cy_DFU_LogDrain(0U);
+    #endif /* CY_DFU_BINARY_LOG */
+
+        if (dfuState == CY_DFU_STATE_FINISHED)
+        {
+            break;
+        }
+        if (dfuState == CY_DFU_STATE_FAILED)
+        {
+            DeviceInit();
+        }
+    }
+
+    Cy_DFU_TransportStop();
+    result = (Cy_DFU_ValidateApp(SIM_APP_ID, &dfuParams) == CY_DFU_SUCCESS) ? 0 : 1;
+    (void) printf("App%u is %s\n", (unsigned int)SIM_APP_ID, (result == 0) ? "valid" : "invalid");
+    return (result);
+}
+
+
+/*******************************************************************************
+* Function Name: HostConnect
+****************************************************************************//**
+*
+* Opens the link to a device started with --device.
+*
+* \param link   The link to open.
+* \param spec   "pty:<slave device>" or "socket:<path>".
+*
+*******************************************************************************/
+static bool HostConnect(sim_link_t *link, const char *spec)
+{
+    if (strncmp(spec, "pty:", 4U) == 0)
+    {
+        struct termios tio;
+
+        link->fd = open(&spec[4], O_RDWR | O_NOCTTY);
+        if ((link->fd >= 0) && (tcgetattr(link->fd, &tio) == 0))
+        {
+            cfmakeraw(&tio);
+            (void) tcsetattr(link->fd, TCSANOW, &tio);
+        }
+    }
+    else if (strncmp(spec, "socket:", 7U) == 0)
+    {
+        struct sockaddr_un addr;
+
+        (void) memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        (void) strncpy(addr.sun_path, &spec[7], sizeof(addr.sun_path) - 1U);
+        link->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if ((link->fd >= 0) && (connect(link->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0))
+        {
+            (void) close(link->fd);
+            link->fd = -1;
+        }
+    }
+    else
+    {
+        link->fd = -1;
+    }
+
+    if (link->fd < 0)
+    {
+        perror(spec);
+    }
+    return (link->fd >= 0);
+}
+
+
+/*******************************************************************************
+* Function Name: PrintReport
+****************************************************************************//**
+*
+* Prints the packets/s and bytes/s for each DFU command of the sessions.
+*
+*******************************************************************************/
+static void PrintReport(uint64_t sessionNs, uint32_t imageSize, bool localFlash)
+{
+    static const struct { uint8_t cmd; const char *name; } names[] =
+    {
+        { CY_DFU_CMD_ENTER,        "Enter"           },
+        { CY_DFU_CMD_SET_APP_META, "Set App Metadata"},
+        { CY_DFU_CMD_SEND_DATA,    "Send Data"       },
+        { CY_DFU_CMD_PROGRAM_DATA, "Program Data"    },
+        { CY_DFU_CMD_VERIFY_APP,   "Verify App"      },
+        { CY_DFU_CMD_GET_STATS,    "Get Stats"       },
+        { CY_DFU_CMD_GET_PROGRESS, "Get Progress"    },
+        { CY_DFU_CMD_EXIT,         "Exit"            },
+    };
+    cy_stc_dfu_sim_flash_stats_t flash;
+    uint32_t i;
+
+    (void) printf("%-18s %10s %12s %12s %14s %16s\n",
+                  "command", "packets", "bytes", "time, ms", "packets/s", "bytes/s");
+    for (i = 0U; i < (sizeof(names) / sizeof(names[0])); i++)
+    {
+        const sim_cmd_stats_t *stats = &cmdStats[names[i].cmd];
+        double seconds = (double)stats->ns / 1e9;
+
+        if (stats->packets != 0U)
+        {
+            (void) printf("%-18s %10llu %12llu %12.3f %14.0f %16.0f\n", names[i].name,
+                          (unsigned long long)stats->packets, (unsigned long long)stats->bytes, seconds * 1e3,
+                          (seconds > 0.0) ? ((double)stats->packets / seconds) : 0.0,
+                          (seconds > 0.0) ? ((double)stats->bytes / seconds) : 0.0);
+        }
+    }
+
+    (void) printf("image: %u bytes in %.3f ms, %.0f bytes/s\n", (unsigned int)imageSize,
+                  (double)sessionNs / 1e6, (double)imageSize * 1e9 / (double)((sessionNs != 0U) ? sessionNs : 1U));
+    if (localFlash)
+    {
+        SimFlash_GetStats(&flash);
+        (void) printf("flash: %u row erases, %u row programs, %u sector erases, max %u erases per row\n",
+                      (unsigned int)flash.rowErases, (unsigned int)flash.rowPrograms,
+                      (unsigned int)flash.sectorErases, (unsigned int)flash.maxRowErases);
+    #if CY_DFU_OPT_NOR != 0
+        {
+            cy_stc_dfu_sim_nor_stats_t nor;
+
+            SimNor_GetStats(&nor);
+            (void) printf("NOR: %u page programs, %u/%u/%u 4K/32K/64K erases, %u status polls, "
+                          "%u bytes read by command, %u errors\n",
+                          (unsigned int)nor.pagePrograms, (unsigned int)nor.erases[0], (unsigned int)nor.erases[1],
+                          (unsigned int)nor.erases[2], (unsigned int)nor.statusPolls, (unsigned int)nor.readBytes,
+                          (unsigned int)nor.errors);
+        }
+    #endif /* CY_DFU_OPT_NOR != 0 */
+    }
+
+#if CY_DFU_OPT_STATS != 0
+    if (programStatsValid && (programStats.count != 0U))
+    {
+        static const char *stages[CY_DFU_STATS_STAGE_NUM] =
+        {
+            "receive", "checksum", "write", "compare", "respond"
+        };
+        double total = (double)((programStats.totalCycles != 0U) ? programStats.totalCycles : 1U);
+
+        (void) printf("device Program Data: %u packets, %u errors, min %.1f us, avg %.1f us, max %.1f us\n",
+                      (unsigned int)programStats.count, (unsigned int)programStats.errors,
+                      (double)programStats.minCycles / 1e3,
+                      (double)programStats.totalCycles / 1e3 / (double)programStats.count,
+                      (double)programStats.maxCycles / 1e3);
+        for (i = 0U; i < CY_DFU_STATS_STAGE_NUM; i++)
+        {
+            (void) printf("  %-10s %12.3f ms %6.1f%%\n", stages[i], (double)programStats.stageCycles[i] / 1e6,
+                          (double)programStats.stageCycles[i] * 100.0 / total);
+        }
+        (void) printf("  latency histogram, us:");
+        for (i = 0U; i < CY_DFU_STATS_HIST_BINS; i++)
+        {
+            if (programStats.histogram[i] != 0U)
+            {
+                (void) printf(" %s%.0f:%u", (i == 0U) ? "<" : ">=",
+                              (double)(1ULL << (i + ((i == 0U) ? 1U : 0U) + CY_DFU_STATS_HIST_SHIFT)) / 1e3,
+                              (unsigned int)programStats.histogram[i]);
+            }
+        }
+        (void) printf("\n");
+    }
+    if (nvmStatsValid)
+    {
+        static const char *operations[CY_DFU_STATS_NVM_OP_NUM] = { "erase", "program", "read" };
+
+        for (i = 0U; i < CY_DFU_STATS_NVM_OP_NUM; i++)
+        {
+            (void) printf("device NVM %-8s %8u ops %12u bytes %12.3f ms, max %9.1f us, %u failures\n",
+                          operations[i], (unsigned int)nvmStats.count[i], (unsigned int)nvmStats.bytes[i],
+                          (double)nvmStats.cycles[i] / 1e6, (double)nvmStats.maxCycles[i] / 1e3,
+                          (unsigned int)nvmStats.failures[i]);
+        }
+        if ((nvmStats.failures[CY_DFU_STATS_NVM_ERASE] + nvmStats.failures[CY_DFU_STATS_NVM_PROGRAM] +
+             nvmStats.failures[CY_DFU_STATS_NVM_READ]) != 0U)
+        {
+            (void) printf("device NVM last failure 0x%08X at 0x%08X\n",
+                          (unsigned int)nvmStats.lastResult, (unsigned int)nvmStats.lastAddress);
+        }
+    }
+#endif /* CY_DFU_OPT_STATS != 0 */
+}
+
+
+#if CY_DFU_OPT_VALID_CACHE != 0
+/*******************************************************************************
+* Function Name: ReportValidateApp
+****************************************************************************//**
+*
+* Prints the time of Cy_DFU_ValidateApp() for App1 after the NVM has been
+* written, and from the validity cache.
+*
+*******************************************************************************/
+static void ReportValidateApp(void)
+{
+    uint64_t start;
+    uint64_t verifyNs;
+    uint64_t cachedNs;
+    cy_en_dfu_status_t status;
+
+    Cy_DFU_ValidCacheInvalidate();
+    start = NowNs();
+    status = Cy_DFU_ValidateApp(SIM_APP_ID, &dfuParams);
+    verifyNs = NowNs() - start;
+    start = NowNs();
+    (void) Cy_DFU_ValidateApp(SIM_APP_ID, &dfuParams);
+    cachedNs = NowNs() - start;
+
+    (void) printf("Validate App1: %s, %.1f us verified, %.3f us cached\n",
+                  (status == CY_DFU_SUCCESS) ? "valid" : "invalid",
+                  (double)verifyNs / 1000.0, (double)cachedNs / 1000.0);
+}
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+
+
+/*******************************************************************************
+* Function Name: DumpLog
+****************************************************************************//**
+*
+* Writes the binary log ring to a file, as a debugger dumps it from a device,
+* for host/dfu_log_decode.py.
+*
+*******************************************************************************/
+static bool DumpLog(const char *path)
+{
+#ifdef CY_DFU_BINARY_LOG
+    FILE *file = fopen(path, "wb");
+    bool ok = (file != NULL);
+
+    if (ok)
+    {
+        ok = (fwrite(&cy_dfu_log_ring, sizeof(cy_dfu_log_ring), 1U, file) == 1U);
+        ok = (fclose(file) == 0) && ok;
+    }
+    if (!ok)
+    {
+        perror(path);
+    }
+    return (ok);
+#else
+    (void) fprintf(stderr, "%s: the simulator is built without CY_DFU_BINARY_LOG\n", path);
+    return (false);
+#endif /* CY_DFU_BINARY_LOG */
+}
+
+
+#if defined(CY_DFU_TOKENIZED_LOG)
+/*******************************************************************************
+* Function Name: Cy_DFU_LogOutput
+****************************************************************************//**
+*
+* Writes the tokenized log frames to the --log-stream file instead of stdout.
+*
+*******************************************************************************/
+void Cy_DFU_LogOutput(const uint8_t data[], uint32_t size)
+{
+    if (logStream != NULL)
+    {
+        (void) fwrite(data, 1U, size, logStream);
+    }
+}
+#endif /* defined(CY_DFU_TOKENIZED_LOG) */
+
+
+static void Usage(const char *name)
+{
+    (void) fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --device pty|socket:PATH  run the DFU SDK on the transport until an update session ends\n"
+        "  --host pty:DEV|socket:PATH drive a device started with --device\n"
+        "  (neither)                 run the device and the DFU Host in-process over the pipe transport\n"
+        "  --flash FILE              keep the simulated flash in FILE instead of RAM\n"
+        "  --nor FILE                keep the simulated serial NOR in FILE instead of RAM (CY_DFU_OPT_NOR)\n"
+        "  --nor-no-xip              read the serial NOR with the read commands instead of XIP\n"
+        "  --image-size BYTES        the App1 image size, a multiple of the row size\n"
+        "  --chunk BYTES             the data bytes per Send Data / Program Data packet\n"
+        "  --row-write-us US         the simulated duration of a row erase or program\n"
+        "  --repeat N                the number of in-process update sessions\n"
+        "  --stop-after ROWS         interrupt the first session after ROWS programmed rows\n"
+        "  --erase-unit BYTES        erase the flash from 0x%08X to 0x%08X in units of BYTES, not in rows\n"
+        "  --shuffle BYTES           send the Program Data rows of each BYTES of the image in a random order\n"
+        "  --copy                    cut the power during each flash operation of Cy_DFU_CopyApp()\n"
+        "  --journal                 update the metadata 100 times, check the erases per row (CY_DFU_OPT_METADATA_JOURNAL)\n"
+        "  --swap                    cut the power during each flash operation of the slot swap (CY_DFU_OPT_SWAP)\n"
+        "  --log-dump FILE           write the binary log ring to FILE at exit (CY_DFU_BINARY_LOG)\n"
+        "  --log-stream FILE         write the tokenized log frames to FILE (CY_DFU_TOKENIZED_LOG)\n", name,
+        (unsigned int)SIM_SECTOR_BASE, (unsigned int)(SIM_SECTOR_BASE + SIM_SECTOR_SIZE));
+}
+
+
+int main(int argc, char *argv[])
+{
+    static const struct option options[] =
+    {
+        { "device",       required_argument, NULL, 'd' },
+        { "host",         required_argument, NULL, 'h' },
+        { "flash",        required_argument, NULL, 'f' },
+        { "nor",          required_argument, NULL, 'n' },
+        { "nor-no-xip",   no_argument,       NULL, 'x' },
+        { "image-size",   required_argument, NULL, 's' },
+        { "chunk",        required_argument, NULL, 'c' },
+        { "row-write-us", required_argument, NULL, 'w' },
+        { "repeat",       required_argument, NULL, 'r' },
+        { "stop-after",   required_argument, NULL, 'i' },
+        { "erase-unit",   required_argument, NULL, 'e' },
+        { "shuffle",      required_argument, NULL, 'u' },
+        { "copy",         no_argument,       NULL, 'o' },
+        { "journal",      no_argument,       NULL, 'j' },
+        { "swap",         no_argument,       NULL, 'p' },
+        { "log-dump",     required_argument, NULL, 'l' },
+        { "log-stream",   required_argument, NULL, 't' },
+        { NULL,           0,                 NULL, 0   }
+    };
+    const char *device = NULL;
+    const char *host = NULL;
+    const char *flashFile = NULL;
+    const char *norFile = NULL;
+    bool norXip = true;
+    bool copy = false;
+    bool journal = false;
+    bool swap = false;
+    const char *logDump = NULL;
+    const char *logStreamFile = NULL;
+    uint32_t imageSize = CY_DFU_APP1_VERIFY_LENGTH + CY_DFU_SIGNATURE_SIZE;
+    uint32_t chunk = CY_NVM_SIZEOF_ROW;
+    uint32_t rowWriteUs = 0U;
+    uint32_t repeat = 1U;
+    uint32_t stopAfter = 0U;
+    uint32_t eraseUnit = 0U;
+    uint32_t shuffle = 0U;
+    sim_link_t link = { -1 };
+    int result = 0;
+    int opt;
+
+    while ((opt = getopt_long(argc, argv, "", options, NULL)) != -1)
+    {
+        switch (opt)
+        {
+            case 'd': device = optarg; break;
+            case 'h': host = optarg; break;
+            case 'f': flashFile = optarg; break;
+            case 'n': norFile = optarg; break;
+            case 'x': norXip = false; break;
+            case 's': imageSize = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'c': chunk = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'w': rowWriteUs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'r': repeat = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'i': stopAfter = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'e': eraseUnit = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'u': shuffle = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'o': copy = true; break;
+            case 'j': journal = true; break;
+            case 'p': swap = true; break;
+            case 'l': logDump = optarg; break;
+            case 't': logStreamFile = optarg; break;
+            default:  Usage(argv[0]); return (2);
+        }
+    }
+
+    if ((imageSize == 0U) || ((imageSize % CY_NVM_SIZEOF_ROW) != 0U) ||
+        (imageSize > (CY_DFU_APP1_VERIFY_LENGTH + CY_DFU_SIGNATURE_SIZE)) ||
+        (chunk == 0U) || (chunk > CY_NVM_SIZEOF_ROW) || (repeat == 0U) ||
+        ((eraseUnit % CY_NVM_SIZEOF_ROW) != 0U) || (eraseUnit > SIM_SECTOR_SIZE) ||
+        ((eraseUnit != 0U) && ((((SIM_SECTOR_BASE - CY_FLASH_BASE) % eraseUnit) != 0U) ||
+                               ((SIM_SECTOR_SIZE % eraseUnit) != 0U))) ||
+        ((shuffle % CY_NVM_SIZEOF_ROW) != 0U) ||
+        ((swap || copy || journal) && ((device != NULL) || (host != NULL) || (shuffle != 0U))) ||
+        (((swap ? 1 : 0) + (copy ? 1 : 0) + (journal ? 1 : 0)) > 1))
+    {
+        Usage(argv[0]);
+        return (2);
+    }
+
+    if (logStreamFile != NULL)
+    {
+    #if defined(CY_DFU_TOKENIZED_LOG)
+        logStream = fopen(logStreamFile, "wb");
+        if (logStream == NULL)
+        {
+            perror(logStreamFile);
+            return (1);
+        }
+    #else
+        (void) fprintf(stderr, "%s: the simulator is built without CY_DFU_TOKENIZED_LOG\n", logStreamFile);
+        return (2);
+    #endif /* defined(CY_DFU_TOKENIZED_LOG) */
+    }
+
+#if CY_DFU_OPT_SWAP == 0
+    if (swap)
+    {
+        (void) fprintf(stderr, "--swap: the simulator is built without CY_DFU_OPT_SWAP\n");
+        return (2);
+    }
+#endif /* CY_DFU_OPT_SWAP == 0 */
+#if CY_DFU_OPT_METADATA_JOURNAL == 0
+    if (journal)
+    {
+        (void) fprintf(stderr, "--journal: the simulator is built without CY_DFU_OPT_METADATA_JOURNAL\n");
+        return (2);
+    }
+#endif /* CY_DFU_OPT_METADATA_JOURNAL == 0 */
+
+    if ((host == NULL) && !SimFlash_Init(flashFile, rowWriteUs))
+    {
+        return (1);
+    }
+#if CY_DFU_OPT_NOR != 0
+    if ((host == NULL) && !SimNor_Init(norFile, norXip))
+    {
+        return (1);
+    }
+#else
+    CY_UNUSED_PARAMETER(norFile);
+    CY_UNUSED_PARAMETER(norXip);
+#endif /* CY_DFU_OPT_NOR != 0 */
+    if ((host == NULL) && (eraseUnit != 0U))
+    {
+        SimUser_SetEraseUnit(SIM_SECTOR_BASE, SIM_SECTOR_SIZE, eraseUnit);
+    }
+
+    if (copy)
+    {
+        DeviceInit();
+        result = SimCopy_Run(&dfuParams) ? 0 : 1;
+        (void) printf("%s\n", (result == 0) ? "PASS" : "FAIL");
+    }
+    else if (journal)
+    {
+    #if CY_DFU_OPT_METADATA_JOURNAL != 0
+        DeviceInit();
+        result = SimJournal_Run(&dfuParams) ? 0 : 1;
+        (void) printf("%s\n", (result == 0) ? "PASS" : "FAIL");
+    #endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+    }
+    else if (swap)
+    {
+    #if CY_DFU_OPT_SWAP != 0
+        DeviceInit();
+        result = SimSwap_Run(&dfuParams) ? 0 : 1;
+        (void) printf("%s\n", (result == 0) ? "PASS" : "FAIL");
+    #endif /* CY_DFU_OPT_SWAP != 0 */
+    }
+    else if (device != NULL)
+    {
+        result = SimTransport_Select(device) ? RunDevice() : 2;
+    }
+    else
+    {
+        uint64_t start;
+        uint32_t i;
+
+        if (host != NULL)
+        {
+            result = HostConnect(&link, host) ? 0 : 1;
+        }
+        else
+        {
+            (void) SimTransport_Select("pipe");
+            DeviceInit();
+            Cy_DFU_TransportStart(CY_DFU_UART);
+        }
+
+        start = NowNs();
+        for (i = 0U; (result == 0) && (i < repeat); i++)
+        {
+            if (!HostSession(&link, imageSize, chunk, (i == 0U) ? stopAfter : 0U, shuffle))
+            {
+                result = 1;
+            }
+            if (link.fd < 0)
+            {
+                DeviceInit();
+            }
+        }
+        PrintReport(NowNs() - start, imageSize * repeat, (host == NULL));
+        if ( (host == NULL) &&
+             (Cy_DFU_ValidateMetadata((uint32_t)&__cy_boot_metadata_addr, &dfuParams) != CY_DFU_SUCCESS) )
+        {
+            (void) printf("The metadata is not valid\n");
+            result = 1;
+        }
+    #if CY_DFU_OPT_VALID_CACHE != 0
+        if (host == NULL)
+        {
+            ReportValidateApp();
+        }
+    #endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+        (void) printf("%s\n", (result == 0) ? "PASS" : "FAIL");
+    }
+
+    if ((logDump != NULL) && !DumpLog(logDump))
+    {
+        result = 1;
+    }
+
+#if defined(CY_DFU_TOKENIZED_LOG)
+    if ((logStream != NULL) && (fclose(logStream) != 0))
+    {
+        result = 1;
+    }
+#endif /* defined(CY_DFU_TOKENIZED_LOG) */
+
+#if CY_DFU_OPT_NOR != 0
+    SimNor_Deinit();
+#endif /* CY_DFU_OPT_NOR != 0 */
+    SimFlash_Deinit();
+    return (result);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,162 @@
+/***************************************************************************//**
+* \file dfu_sim.h
+* \version 5.2
+*
+* This file provides the declarations shared by the modules of the host-native
+* simulator of the DFU SDK: the simulated flash, the simulated transports, and
+* the DFU Host packet generator.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if !defined(DFU_SIM_H)
+#define DFU_SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_dfu.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/***************************************
+*        Simulated flash
+***************************************/
+
+/** The operation counters of the simulated flash */
+typedef struct
+{
+    uint32_t sectorErases;      /**< The number of sector erase operations */
+    uint32_t rowErases;         /**< The number of row erase operations */
+    uint32_t rowPrograms;       /**< The number of row program operations */
+    uint32_t maxRowErases;      /**< The largest number of erases of a single row */
+} cy_stc_dfu_sim_flash_stats_t;
+
+bool SimFlash_Init(const char *fileName, uint32_t rowWriteUs);
+void SimFlash_Deinit(void);
+void SimFlash_GetStats(cy_stc_dfu_sim_flash_stats_t *stats);
+void SimFlash_PowerCut(uint32_t operations);
+
+
+/***************************************
+*        NVM regions of the simulator
+***************************************/
+
+/** The range of the simulated flash the --erase-unit option erases in units */
+#define SIM_SECTOR_BASE             (0x10040000UL)
+/** The size in bytes of the range, up to the metadata */
+#define SIM_SECTOR_SIZE             (0x000B0000UL)
+
+void SimUser_SetEraseUnit(uint32_t address, uint32_t size, uint32_t eraseSize);
+uint32_t SimUser_GetUnitErases(void);
+
+
+/***************************************
+*        Simulated serial NOR
+***************************************/
+
+/** The address the simulated serial NOR is mapped at, the XIP region of the SMIF */
+#define SIM_NOR_BASE                (0x18000000UL)
+/** The size in bytes of the simulated serial NOR, 64 Mbit */
+#define SIM_NOR_SIZE                (0x00800000UL)
+
+#if CY_DFU_OPT_NOR != 0
+/** The operation counters of the simulated serial NOR */
+typedef struct
+{
+    uint32_t pagePrograms;      /**< The number of page program commands */
+    uint32_t erases[3];         /**< The number of 4 KB, 32 KB and 64 KB erase commands */
+    uint32_t statusPolls;       /**< The number of status register reads */
+    uint32_t readBytes;         /**< The number of bytes read with the read commands */
+    uint32_t errors;            /**< The number of commands that failed, see Command() */
+} cy_stc_dfu_sim_nor_stats_t;
+
+bool SimNor_Init(const char *fileName, bool xip);
+void SimNor_Deinit(void);
+void SimNor_GetStats(cy_stc_dfu_sim_nor_stats_t *stats);
+
+extern const cy_stc_dfu_nor_ops_t SimNor_Ops;
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+
+/***************************************
+*        Copy test
+***************************************/
+
+bool SimCopy_Run(cy_stc_dfu_params_t *params);
+
+
+/***************************************
+*        Metadata journal test
+***************************************/
+
+#if CY_DFU_OPT_METADATA_JOURNAL != 0
+bool SimJournal_Run(cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_METADATA_JOURNAL != 0 */
+
+
+/***************************************
+*        Slot swap power-cut test
+***************************************/
+
+#if CY_DFU_OPT_SWAP != 0
+bool SimSwap_Run(cy_stc_dfu_params_t *params);
+#endif /* CY_DFU_OPT_SWAP != 0 */
+
+
+/***************************************
+*        Simulated transports
+***************************************/
+
+bool SimTransport_Select(const char *spec);
+const cy_stc_dfu_transport_ops_t * SimTransport_Get(void);
+
+/* The DFU Host side of the in-process pipe transport */
+void     SimPipe_HostWrite(const uint8_t data[], uint32_t size);
+uint32_t SimPipe_HostRead(uint8_t data[], uint32_t size);
+
+extern const cy_stc_dfu_transport_ops_t SimPipe_Ops;
+extern const cy_stc_dfu_transport_ops_t SimPty_Ops;
+extern const cy_stc_dfu_transport_ops_t SimSocket_Ops;
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !defined(DFU_SIM_H) */
+
+
+/* [] END OF FILE */
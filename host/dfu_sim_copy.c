@@ -0,0 +1,274 @@
+/***************************************************************************//**
+* \file dfu_sim_copy.c
+* \version 5.2
+*
+* This file provides the test of Cy_DFU_CopyApp() of the host-native simulator
+* build. It copies an image to a destination that differs from it in all its
+* rows, and to one whose first row of each erase unit already matches, cuts the
+* power during each erase and program operation of the copy (see
+* SimFlash_PowerCut()), copies again as after a reset, and checks the
+* destination. Run it with --erase-unit for the memory that is erased in units
+* larger than a row.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "cy_flash.h"
+#include "dfu_sim.h"
+
+/* The source and the destination, in the simulated flash between App1 and the metadata */
+#define COPY_SIM_DEST           (0x10080000UL)
+#define COPY_SIM_SRC            (0x100C0000UL)
+
+/* The seeds of the source image and of the image the destination starts with */
+#define COPY_SIM_IMAGE_SRC      (0xA5A5A5A5UL)
+#define COPY_SIM_IMAGE_DEST     (0x3C3C3C3CUL)
+
+/* The destination the copy starts from */
+typedef enum
+{
+    COPY_SIM_DIFFERENT,         /* All the rows differ from the source */
+    COPY_SIM_FIRST_ROW_MATCHES  /* The first row of each erase unit matches the source */
+} copy_sim_case_t;
+
+static uint32_t ImageWord(uint32_t offset, uint32_t seed);
+static void ImageFill(uint32_t address, uint32_t length, uint32_t seed, uint32_t unitSize);
+static bool ImageHolds(uint32_t address, uint32_t length, uint32_t seed);
+static void CopySetup(copy_sim_case_t copyCase, uint32_t length, uint32_t unitSize);
+static uint32_t FlashOperations(void);
+static bool CopyCase(copy_sim_case_t copyCase, uint32_t cut, uint32_t length, uint32_t unitSize,
+                     cy_stc_dfu_params_t *params);
+
+
+/*******************************************************************************
+* Function Name: SimCopy_Run
+****************************************************************************//**
+*
+* Copies an image of two erase units and two rows to each destination of
+* copy_sim_case_t with the power cut at each erase and program operation, then
+* copies again over the destination that holds the image already, which must
+* not erase or program the flash.
+*
+* \param params The DFU parameters of the simulated device.
+*
+* \return True if all the copies end with the image in the destination.
+*
+*******************************************************************************/
+bool SimCopy_Run(cy_stc_dfu_params_t *params)
+{
+    static const char * const names[] = { "copy over a different image", "copy over a matching first row" };
+    uint32_t unitSize = Cy_DFU_GetEraseSize(COPY_SIM_DEST);
+    uint32_t length;
+    uint32_t operations;
+    bool pass = true;
+    uint32_t copyCase;
+
+    unitSize = (unitSize > CY_NVM_SIZEOF_ROW) ? unitSize : CY_NVM_SIZEOF_ROW;
+    /* The last erase unit is copied in part */
+    length = (2U * unitSize) + (2U * CY_NVM_SIZEOF_ROW);
+    (void) printf("copy: %u bytes in erase units of %u bytes\n", (unsigned int)length, (unsigned int)unitSize);
+
+    for (copyCase = (uint32_t)COPY_SIM_DIFFERENT; copyCase <= (uint32_t)COPY_SIM_FIRST_ROW_MATCHES; copyCase++)
+    {
+        uint32_t cut;
+        uint32_t failed = 0U;
+
+        /* The operations of the copy without a power cut, the cut after the last one does not happen */
+        CopySetup((copy_sim_case_t)copyCase, length, unitSize);
+        operations = FlashOperations();
+        (void) Cy_DFU_CopyApp(COPY_SIM_DEST, COPY_SIM_SRC, length, CY_NVM_SIZEOF_ROW, params);
+        operations = FlashOperations() - operations;
+
+        for (cut = 1U; cut <= (operations + 1U); cut++)
+        {
+            if (!CopyCase((copy_sim_case_t)copyCase, cut, length, unitSize, params))
+            {
+                if (failed == 0U)
+                {
+                    (void) printf("copy: %s fails with the power cut at operation %u\n",
+                                  names[copyCase], (unsigned int)cut);
+                }
+                failed++;
+            }
+        }
+        (void) printf("copy: %-30s %5u power cuts, %u failed\n", names[copyCase],
+                      (unsigned int)(operations + 1U), (unsigned int)failed);
+        pass = pass && (failed == 0U);
+    }
+
+    /* The destination holds the image after the last case */
+    operations = FlashOperations();
+    pass = pass && (Cy_DFU_CopyApp(COPY_SIM_DEST, COPY_SIM_SRC, length, CY_NVM_SIZEOF_ROW, params) ==
+                    CY_DFU_SUCCESS);
+    operations = FlashOperations() - operations;
+    (void) printf("copy: %-30s %5u flash operations\n", "copy over the same image", (unsigned int)operations);
+    return (pass && (operations == 0U));
+}
+
+
+/*******************************************************************************
+* Function Name: CopyCase
+****************************************************************************//**
+*
+* Runs a copy with the power cut at an operation, then copies again with the
+* power restored, as the application does after a reset.
+*
+* \param copyCase   The destination the copy starts from.
+* \param cut        The erase or program operation the power is cut at.
+* \param length     The number of the bytes to copy.
+* \param unitSize   The erase unit of the destination.
+* \param params     The DFU parameters of the simulated device.
+*
+* \return True if the destination ends with the source image.
+*
+*******************************************************************************/
+static bool CopyCase(copy_sim_case_t copyCase, uint32_t cut, uint32_t length, uint32_t unitSize,
+                     cy_stc_dfu_params_t *params)
+{
+    CopySetup(copyCase, length, unitSize);
+    SimFlash_PowerCut(cut);
+    (void) Cy_DFU_CopyApp(COPY_SIM_DEST, COPY_SIM_SRC, length, CY_NVM_SIZEOF_ROW, params);
+    SimFlash_PowerCut(0U);
+
+    return ( (Cy_DFU_CopyApp(COPY_SIM_DEST, COPY_SIM_SRC, length, CY_NVM_SIZEOF_ROW, params) == CY_DFU_SUCCESS) &&
+             ImageHolds(COPY_SIM_DEST, length, COPY_SIM_IMAGE_SRC) );
+}
+
+
+/*******************************************************************************
+* Function Name: CopySetup
+****************************************************************************//**
+*
+* Restores the power, writes the source image, and the destination image of
+* the case.
+*
+*******************************************************************************/
+static void CopySetup(copy_sim_case_t copyCase, uint32_t length, uint32_t unitSize)
+{
+    SimFlash_PowerCut(0U);
+    ImageFill(COPY_SIM_SRC, length, COPY_SIM_IMAGE_SRC, 0U);
+    ImageFill(COPY_SIM_DEST, length, COPY_SIM_IMAGE_DEST, 0U);
+    if (copyCase == COPY_SIM_FIRST_ROW_MATCHES)
+    {
+        ImageFill(COPY_SIM_DEST, length, COPY_SIM_IMAGE_SRC, unitSize);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ImageWord
+****************************************************************************//**
+*
+* Returns the word of an image at an offset: derived from the offset and the
+* seed of the image, so no two rows are the same.
+*
+*******************************************************************************/
+static uint32_t ImageWord(uint32_t offset, uint32_t seed)
+{
+    return ((offset * 2654435761U) ^ seed);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageFill
+****************************************************************************//**
+*
+* Writes the rows of an image, see ImageWord(), or only the first row of each
+* erase unit.
+*
+* \param address    The address of the image.
+* \param length     The length of the image in bytes.
+* \param seed       The seed of the image.
+* \param unitSize   The erase unit to write the first rows of, or 0 for all
+*                   the rows.
+*
+*******************************************************************************/
+static void ImageFill(uint32_t address, uint32_t length, uint32_t seed, uint32_t unitSize)
+{
+    uint32_t row[CY_NVM_SIZEOF_ROW / sizeof(uint32_t)];
+    uint32_t step = (unitSize != 0U) ? unitSize : CY_NVM_SIZEOF_ROW;
+    uint32_t offset;
+    uint32_t i;
+
+    for (offset = 0U; offset < length; offset += step)
+    {
+        for (i = 0U; i < (CY_NVM_SIZEOF_ROW / sizeof(uint32_t)); i++)
+        {
+            row[i] = ImageWord(offset + (i * (uint32_t)sizeof(uint32_t)), seed);
+        }
+        (void) Cy_Flash_WriteRow(address + offset, row);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: ImageHolds
+****************************************************************************//**
+*
+* Checks that a range holds an image, see ImageFill().
+*
+*******************************************************************************/
+static bool ImageHolds(uint32_t address, uint32_t length, uint32_t seed)
+{
+    const uint32_t *image = (const uint32_t *)(uintptr_t)address;
+    bool holds = true;
+    uint32_t i;
+
+    for (i = 0U; holds && (i < (length / sizeof(uint32_t))); i++)
+    {
+        holds = (image[i] == ImageWord(i * (uint32_t)sizeof(uint32_t), seed));
+    }
+    return (holds);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashOperations
+****************************************************************************//**
+*
+* Returns the number of the erase and program operations of the simulated
+* flash so far.
+*
+*******************************************************************************/
+static uint32_t FlashOperations(void)
+{
+    cy_stc_dfu_sim_flash_stats_t stats;
+
+    SimFlash_GetStats(&stats);
+    return (stats.sectorErases + stats.rowErases + stats.rowPrograms);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,563 @@
+/***************************************************************************//**
+* \file dfu_sim_flash.c
+* \version 5.2
+*
+* This file provides the simulated flash of the host-native simulator build.
+* The flash is mapped at CY_FLASH_BASE, so the addresses the DFU SDK takes from
+* the ELF symbols and the metadata point straight into it. The memory is
+* read-only outside the flash driver functions, is backed by RAM or by a file,
+* and follows the row and sector erase semantics of the device: an erase sets
+* the bytes to CY_FLASH_ERASED_VALUE, a program can only set bits.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "cy_flash.h"
+#include "dfu_sim.h"
+
+#define ROW_COUNT               (CY_FLASH_SIZE / CY_FLASH_SIZEOF_ROW)
+
+static uint8_t *flashMem = NULL;
+static int flashFd = -1;
+static uint32_t writeDelayUs = 0U;
+static uint32_t rowEraseCount[ROW_COUNT];
+static cy_stc_dfu_sim_flash_stats_t flashStats;
+
+/* The row write started with Cy_Flash_StartWrite(), done by Cy_Flash_IsOperationComplete() */
+static bool startedWrite = false;
+static uint32_t startedRow;
+static const uint32_t *startedData;
+static uint64_t startedEndNs;
+
+/* The erase and program operations until the power cut, 0 if the power is not cut,
+* UINT32_MAX after the cut */
+static uint32_t powerOperations = 0U;
+
+/* The power state of the next erase or program operation, see SimFlash_PowerCut() */
+typedef enum
+{
+    SIM_POWER_ON,       /* The operation completes */
+    SIM_POWER_CUT,      /* The power is cut during the operation, half of it is done */
+    SIM_POWER_OFF       /* The power is cut, the operation fails */
+} sim_power_t;
+
+static sim_power_t PowerStep(void);
+static bool RowValid(uint32_t rowAddr);
+static cy_en_flashdrv_status_t RowErase(uint32_t rowAddr);
+static cy_en_flashdrv_status_t RowProgram(uint32_t rowAddr, const uint32_t* data);
+static void SetWritable(bool writable);
+static void EraseRange(uint32_t addr, uint32_t size);
+static void WriteDelay(void);
+static uint64_t NowNs(void);
+
+
+/*******************************************************************************
+* Function Name: SimFlash_Init
+****************************************************************************//**
+*
+* Maps the simulated flash at CY_FLASH_BASE.
+*
+* \param fileName   The file to keep the flash content in, or NULL to keep it
+*                   in RAM. A new file starts erased.
+* \param rowWriteUs The time in microseconds a row erase or program takes.
+*
+* \return True if the flash is mapped.
+*
+*******************************************************************************/
+bool SimFlash_Init(const char *fileName, uint32_t rowWriteUs)
+{
+    void *addr = (void *)(uintptr_t)CY_FLASH_BASE;
+    int flags = MAP_FIXED_NOREPLACE;
+
+    if (fileName != NULL)
+    {
+        flashFd = open(fileName, O_RDWR | O_CREAT, 0644);
+        if ((flashFd < 0) || (ftruncate(flashFd, (off_t)CY_FLASH_SIZE) != 0))
+        {
+            perror(fileName);
+            return (false);
+        }
+        flags |= MAP_SHARED;
+    }
+    else
+    {
+        flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+    }
+
+    flashMem = mmap(addr, CY_FLASH_SIZE, PROT_READ, flags, flashFd, 0);
+    if ((flashMem == MAP_FAILED) || (flashMem != addr))
+    {
+        perror("mmap flash");
+        flashMem = NULL;
+        return (false);
+    }
+
+#if (CY_FLASH_ERASED_VALUE != 0U)
+    if (fileName == NULL)
+    {
+        SetWritable(true);
+        EraseRange(CY_FLASH_BASE, CY_FLASH_SIZE);
+        SetWritable(false);
+    }
+#endif /* CY_FLASH_ERASED_VALUE != 0U */
+
+    writeDelayUs = rowWriteUs;
+    (void) memset(rowEraseCount, 0, sizeof(rowEraseCount));
+    (void) memset(&flashStats, 0, sizeof(flashStats));
+    return (true);
+}
+
+
+/*******************************************************************************
+* Function Name: SimFlash_Deinit
+****************************************************************************//**
+*
+* Unmaps the simulated flash and flushes it to the file, if any.
+*
+*******************************************************************************/
+void SimFlash_Deinit(void)
+{
+    if (flashMem != NULL)
+    {
+        (void) msync(flashMem, CY_FLASH_SIZE, MS_SYNC);
+        (void) munmap(flashMem, CY_FLASH_SIZE);
+        flashMem = NULL;
+    }
+    if (flashFd >= 0)
+    {
+        (void) close(flashFd);
+        flashFd = -1;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimFlash_GetStats
+****************************************************************************//**
+*
+* Returns the operation counters of the simulated flash.
+*
+* \param stats The pointer to the structure to store the counters in.
+*
+*******************************************************************************/
+void SimFlash_GetStats(cy_stc_dfu_sim_flash_stats_t *stats)
+{
+    *stats = flashStats;
+}
+
+
+/*******************************************************************************
+* Function Name: SimFlash_PowerCut
+****************************************************************************//**
+*
+* Cuts the power of the simulated flash during a later operation, as a reset
+* does on the device. The erase or program operation number \c operations
+* from now is done in half: the first half of the row or sector is erased or
+* programmed. The operations after it fail with CY_FLASH_DRV_ERR_UNC until
+* the power is restored with 0.
+*
+* \param operations The number of the erase and program operations until the
+*                   cut, including the cut one, or 0 to restore the power.
+*
+*******************************************************************************/
+void SimFlash_PowerCut(uint32_t operations)
+{
+    powerOperations = operations;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_EraseSector
+****************************************************************************//**
+*
+* Erases the flash sector that starts at \c sectorAddr.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_EraseSector(uint32_t sectorAddr)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_INVALID_FLASH_ADDR;
+
+    if ((flashMem != NULL) && (sectorAddr >= CY_FLASH_BASE) &&
+        (sectorAddr < (CY_FLASH_BASE + CY_FLASH_SIZE)) &&
+        (((sectorAddr - CY_FLASH_BASE) % CY_FLASH_SIZEOF_SECTOR) == 0U))
+    {
+        sim_power_t power = PowerStep();
+        uint32_t size = CY_FLASH_SIZEOF_SECTOR;
+        uint32_t row;
+
+        if ((sectorAddr - CY_FLASH_BASE + size) > CY_FLASH_SIZE)
+        {
+            size = CY_FLASH_SIZE - (sectorAddr - CY_FLASH_BASE);
+        }
+
+        if (power != SIM_POWER_OFF)
+        {
+            SetWritable(true);
+            EraseRange(sectorAddr, (power == SIM_POWER_CUT) ? (size / 2U) : size);
+            SetWritable(false);
+
+            for (row = (sectorAddr - CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+                 row < ((sectorAddr - CY_FLASH_BASE + size) / CY_FLASH_SIZEOF_ROW); row++)
+            {
+                rowEraseCount[row]++;
+                if (rowEraseCount[row] > flashStats.maxRowErases)
+                {
+                    flashStats.maxRowErases = rowEraseCount[row];
+                }
+            }
+            flashStats.sectorErases++;
+            WriteDelay();
+        }
+        status = (power == SIM_POWER_ON) ? CY_FLASH_DRV_SUCCESS : CY_FLASH_DRV_ERR_UNC;
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_EraseRow
+****************************************************************************//**
+*
+* Erases the flash row that starts at \c rowAddr.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_EraseRow(uint32_t rowAddr)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_INVALID_FLASH_ADDR;
+
+    if (RowValid(rowAddr))
+    {
+        status = RowErase(rowAddr);
+        WriteDelay();
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_ProgramRow
+****************************************************************************//**
+*
+* Programs the flash row that starts at \c rowAddr. The row is not erased, so
+* the bits that are already programmed stay programmed.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_ProgramRow(uint32_t rowAddr, const uint32_t* data)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_INVALID_INPUT_PARAMETERS;
+
+    if ((data != NULL) && RowValid(rowAddr))
+    {
+        status = RowProgram(rowAddr, data);
+        WriteDelay();
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_WriteRow
+****************************************************************************//**
+*
+* Erases and then programs the flash row that starts at \c rowAddr.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t* data)
+{
+    cy_en_flashdrv_status_t status = Cy_Flash_EraseRow(rowAddr);
+
+    if (status == CY_FLASH_DRV_SUCCESS)
+    {
+        status = Cy_Flash_ProgramRow(rowAddr, data);
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_StartWrite
+****************************************************************************//**
+*
+* Starts the erase and the program of the flash row that starts at
+* \c rowAddr, as the non-blocking write of the device does. The row is
+* written from \c data when Cy_Flash_IsOperationComplete() finds the operation
+* complete, so the data must not change meanwhile.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_StartWrite(uint32_t rowAddr, const uint32_t* data)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_INVALID_INPUT_PARAMETERS;
+
+    if (startedWrite)
+    {
+        status = CY_FLASH_DRV_OPCODE_BUSY;
+    }
+    else if ((data != NULL) && RowValid(rowAddr))
+    {
+        startedWrite = true;
+        startedRow = rowAddr;
+        startedData = data;
+        /* The erase and the program */
+        startedEndNs = NowNs() + (2U * (uint64_t)writeDelayUs * 1000U);
+        status = CY_FLASH_DRV_OPERATION_STARTED;
+    }
+    else
+    {
+        /* Invalid parameters */
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_Flash_IsOperationComplete
+****************************************************************************//**
+*
+* Returns CY_FLASH_DRV_OPCODE_BUSY until the duration of the write started
+* with Cy_Flash_StartWrite() passes, then writes the row and returns
+* CY_FLASH_DRV_SUCCESS.
+*
+*******************************************************************************/
+cy_en_flashdrv_status_t Cy_Flash_IsOperationComplete(void)
+{
+    cy_en_flashdrv_status_t status = CY_FLASH_DRV_SUCCESS;
+
+    if (startedWrite)
+    {
+        if (NowNs() < startedEndNs)
+        {
+            status = CY_FLASH_DRV_OPCODE_BUSY;
+        }
+        else
+        {
+            status = RowErase(startedRow);
+            if (status == CY_FLASH_DRV_SUCCESS)
+            {
+                status = RowProgram(startedRow, startedData);
+            }
+            startedWrite = false;
+        }
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: PowerStep
+****************************************************************************//**
+*
+* Counts an erase or program operation down to the power cut of
+* SimFlash_PowerCut() and returns the power state of the operation.
+*
+*******************************************************************************/
+static sim_power_t PowerStep(void)
+{
+    sim_power_t power = SIM_POWER_ON;
+
+    if (powerOperations == 1U)
+    {
+        power = SIM_POWER_CUT;
+        powerOperations = UINT32_MAX;
+    }
+    else if (powerOperations == UINT32_MAX)
+    {
+        power = SIM_POWER_OFF;
+    }
+    else if (powerOperations != 0U)
+    {
+        powerOperations--;
+    }
+    else
+    {
+        /* The power is not cut */
+    }
+    return (power);
+}
+
+
+/*******************************************************************************
+* Function Name: RowValid
+****************************************************************************//**
+*
+* Checks that \c rowAddr is the start of a row of the mapped flash.
+*
+*******************************************************************************/
+static bool RowValid(uint32_t rowAddr)
+{
+    return ((flashMem != NULL) && (rowAddr >= CY_FLASH_BASE) &&
+            (rowAddr < (CY_FLASH_BASE + CY_FLASH_SIZE)) &&
+            (((rowAddr - CY_FLASH_BASE) % CY_FLASH_SIZEOF_ROW) == 0U));
+}
+
+
+/*******************************************************************************
+* Function Name: RowErase
+****************************************************************************//**
+*
+* Erases a valid flash row and counts the erase. Only the first half of the
+* row is erased if the power is cut during the erase, see SimFlash_PowerCut().
+*
+*******************************************************************************/
+static cy_en_flashdrv_status_t RowErase(uint32_t rowAddr)
+{
+    uint32_t row = (rowAddr - CY_FLASH_BASE) / CY_FLASH_SIZEOF_ROW;
+    sim_power_t power = PowerStep();
+
+    if (power != SIM_POWER_OFF)
+    {
+        SetWritable(true);
+        EraseRange(rowAddr, (power == SIM_POWER_CUT) ? (CY_FLASH_SIZEOF_ROW / 2U) : CY_FLASH_SIZEOF_ROW);
+        SetWritable(false);
+
+        rowEraseCount[row]++;
+        if (rowEraseCount[row] > flashStats.maxRowErases)
+        {
+            flashStats.maxRowErases = rowEraseCount[row];
+        }
+        flashStats.rowErases++;
+    }
+    return ((power == SIM_POWER_ON) ? CY_FLASH_DRV_SUCCESS : CY_FLASH_DRV_ERR_UNC);
+}
+
+
+/*******************************************************************************
+* Function Name: RowProgram
+****************************************************************************//**
+*
+* Programs a valid flash row and counts the program. The row is not erased,
+* so the bits that are already programmed stay programmed. Only the first half
+* of the row is programmed if the power is cut during the program, see
+* SimFlash_PowerCut().
+*
+*******************************************************************************/
+static cy_en_flashdrv_status_t RowProgram(uint32_t rowAddr, const uint32_t* data)
+{
+    const uint8_t *src = (const uint8_t *)data;
+    uint8_t *dst = &flashMem[rowAddr - CY_FLASH_BASE];
+    sim_power_t power = PowerStep();
+    uint32_t size = (power == SIM_POWER_ON) ? CY_FLASH_SIZEOF_ROW : (CY_FLASH_SIZEOF_ROW / 2U);
+    uint32_t i;
+
+    if (power == SIM_POWER_OFF)
+    {
+        size = 0U;
+    }
+
+    SetWritable(true);
+    for (i = 0U; i < size; i++)
+    {
+    #if (CY_FLASH_ERASED_VALUE == 0U)
+        dst[i] |= src[i];
+    #else
+        dst[i] &= src[i];
+    #endif /* CY_FLASH_ERASED_VALUE == 0U */
+    }
+    SetWritable(false);
+
+    if (power != SIM_POWER_OFF)
+    {
+        flashStats.rowPrograms++;
+    }
+    return ((power == SIM_POWER_ON) ? CY_FLASH_DRV_SUCCESS : CY_FLASH_DRV_ERR_UNC);
+}
+
+
+/*******************************************************************************
+* Function Name: SetWritable
+****************************************************************************//**
+*
+* Allows the flash driver functions to modify the flash memory. The rest of
+* the time a store into the flash faults, as on the device.
+*
+*******************************************************************************/
+static void SetWritable(bool writable)
+{
+    (void) mprotect(flashMem, CY_FLASH_SIZE, writable ? (PROT_READ | PROT_WRITE) : PROT_READ);
+}
+
+
+/*******************************************************************************
+* Function Name: EraseRange
+****************************************************************************//**
+*
+* Sets the flash bytes to the erased value.
+*
+*******************************************************************************/
+static void EraseRange(uint32_t addr, uint32_t size)
+{
+    (void) memset(&flashMem[addr - CY_FLASH_BASE], CY_FLASH_ERASED_VALUE, size);
+}
+
+
+/*******************************************************************************
+* Function Name: WriteDelay
+****************************************************************************//**
+*
+* Waits for the configured duration of a flash operation.
+*
+*******************************************************************************/
+static void WriteDelay(void)
+{
+    if (writeDelayUs != 0U)
+    {
+        struct timespec delay = { (time_t)(writeDelayUs / 1000000U), (long)(writeDelayUs % 1000000U) * 1000L };
+        (void) nanosleep(&delay, NULL);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: NowNs
+****************************************************************************//**
+*
+* Returns the monotonic time in nanoseconds.
+*
+*******************************************************************************/
+static uint64_t NowNs(void)
+{
+    struct timespec now;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &now);
+    return (((uint64_t)now.tv_sec * 1000000000U) + (uint64_t)now.tv_nsec);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,169 @@
+/***************************************************************************//**
+* \file dfu_sim_journal.c
+* \version 5.2
+*
+* This file provides the test of the metadata journal of the host-native
+* simulator build (CY_DFU_OPT_METADATA_JOURNAL). It updates the metadata of
+* App0 and App1 in turn, and checks that the erases are spread over the rows
+* of the journal and that the last records are current. Then it makes the
+* journal part of an NVM region erased in units larger than a row, see
+* SimUser_SetEraseUnit(), and checks that the update is refused and the
+* journal is not written.
+*
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "cy_flash.h"
+#include "dfu_sim.h"
+
+/* The number of the metadata updates */
+#define JOURNAL_SIM_UPDATES     (100U)
+
+/* The erase unit the journal is refused in, and the units it covers */
+#define JOURNAL_SIM_UNIT        (0x1000UL)
+#define JOURNAL_SIM_UNIT_BASE   (JOURNAL_SIM_ADDRESS & ~(JOURNAL_SIM_UNIT - 1U))
+#define JOURNAL_SIM_UNIT_SIZE   ((((JOURNAL_SIM_ADDRESS + JOURNAL_SIM_LENGTH) - JOURNAL_SIM_UNIT_BASE) + \
+                                  (JOURNAL_SIM_UNIT - 1U)) & ~(JOURNAL_SIM_UNIT - 1U))
+
+#define JOURNAL_SIM_ADDRESS     ((uint32_t)&__cy_boot_metadata_addr)
+#define JOURNAL_SIM_LENGTH      ((uint32_t)&__cy_boot_metadata_length)
+
+/* The verified area of the update number of an application */
+#define JOURNAL_SIM_SIZE(update)    (0x1000U + ((update) * CY_NVM_SIZEOF_ROW))
+
+static bool JournalUpdates(cy_stc_dfu_params_t *params);
+static bool JournalRefused(cy_stc_dfu_params_t *params);
+
+
+/*******************************************************************************
+* Function Name: SimJournal_Run
+****************************************************************************//**
+*
+* Runs the update and the refusal test of the metadata journal.
+*
+* \param params The DFU parameters of the simulated device.
+*
+* \return True if both tests pass.
+*
+*******************************************************************************/
+bool SimJournal_Run(cy_stc_dfu_params_t *params)
+{
+    bool pass = JournalUpdates(params);
+
+    return (JournalRefused(params) && pass);
+}
+
+
+/*******************************************************************************
+* Function Name: JournalUpdates
+****************************************************************************//**
+*
+* Updates the verified area of App0 and App1 in turn, JOURNAL_SIM_UPDATES
+* times in all. Each update writes one row, and no row is erased more often
+* than the updates spread evenly over the journal.
+*
+*******************************************************************************/
+static bool JournalUpdates(cy_stc_dfu_params_t *params)
+{
+    uint32_t rows = JOURNAL_SIM_LENGTH / CY_NVM_SIZEOF_ROW;
+    uint32_t limit = (JOURNAL_SIM_UPDATES + (rows - 1U)) / rows;
+    cy_stc_dfu_sim_flash_stats_t before;
+    cy_stc_dfu_sim_flash_stats_t after;
+    bool pass = true;
+    uint32_t update;
+
+    SimFlash_GetStats(&before);
+    for (update = 0U; pass && (update < JOURNAL_SIM_UPDATES); update++)
+    {
+        uint32_t appId = update % CY_DFU_MAX_APPS;
+
+        pass = (Cy_DFU_SetAppMetadata(appId, CY_FLASH_BASE, JOURNAL_SIM_SIZE(update), params) == CY_DFU_SUCCESS);
+    }
+    SimFlash_GetStats(&after);
+
+    for (update = JOURNAL_SIM_UPDATES - CY_DFU_MAX_APPS; pass && (update < JOURNAL_SIM_UPDATES); update++)
+    {
+        uint32_t verifyAddress;
+        uint32_t verifySize;
+
+        pass = (Cy_DFU_GetAppMetadata(update % CY_DFU_MAX_APPS, &verifyAddress, &verifySize) == CY_DFU_SUCCESS) &&
+               (verifySize == JOURNAL_SIM_SIZE(update));
+    }
+    pass = pass && (Cy_DFU_ValidateMetadata(JOURNAL_SIM_ADDRESS, params) == CY_DFU_SUCCESS);
+
+    (void) printf("journal: %u updates over %u rows, %u row erases, max %u erases per row (limit %u)\n",
+                  (unsigned int)JOURNAL_SIM_UPDATES, (unsigned int)rows,
+                  (unsigned int)(after.rowErases - before.rowErases), (unsigned int)after.maxRowErases,
+                  (unsigned int)limit);
+    return (pass && ((after.rowErases - before.rowErases) == JOURNAL_SIM_UPDATES) && (after.maxRowErases <= limit));
+}
+
+
+/*******************************************************************************
+* Function Name: JournalRefused
+****************************************************************************//**
+*
+* Makes the journal part of a region erased in units of JOURNAL_SIM_UNIT bytes
+* and checks that an update is refused with CY_DFU_ERROR_ADDRESS without a
+* write to the journal.
+*
+*******************************************************************************/
+static bool JournalRefused(cy_stc_dfu_params_t *params)
+{
+    static uint8_t journal[CY_DFU_METADATA_JOURNAL_ROWS * CY_NVM_SIZEOF_ROW];
+    cy_stc_dfu_sim_flash_stats_t before;
+    cy_stc_dfu_sim_flash_stats_t after;
+    cy_en_dfu_status_t status;
+    bool pass;
+
+    (void) memcpy(journal, (const void *)(uintptr_t)JOURNAL_SIM_ADDRESS, JOURNAL_SIM_LENGTH);
+    SimUser_SetEraseUnit(JOURNAL_SIM_UNIT_BASE, JOURNAL_SIM_UNIT_SIZE, JOURNAL_SIM_UNIT);
+    SimFlash_GetStats(&before);
+    status = Cy_DFU_SetAppMetadata(1U, CY_FLASH_BASE, JOURNAL_SIM_SIZE(JOURNAL_SIM_UPDATES), params);
+    SimFlash_GetStats(&after);
+    SimUser_SetEraseUnit(0U, 0U, 0U);
+
+    pass = (status == CY_DFU_ERROR_ADDRESS) && (after.rowErases == before.rowErases) &&
+           (after.rowPrograms == before.rowPrograms) &&
+           (memcmp(journal, (const void *)(uintptr_t)JOURNAL_SIM_ADDRESS, JOURNAL_SIM_LENGTH) == 0);
+    (void) printf("journal: update in erase units of %u bytes %s\n", (unsigned int)JOURNAL_SIM_UNIT,
+                  pass ? "refused" : "not refused");
+    return (pass);
+}
+
+
+/* [] END OF FILE */
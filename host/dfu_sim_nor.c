@@ -0,0 +1,455 @@
+/***************************************************************************//**
+* \file dfu_sim_nor.c
+* \version 5.2
+*
+* This file provides the simulated serial NOR device of the host-native
+* simulator build, for the serial NOR driver of the DFU SDK
+* (CY_DFU_OPT_NOR). The device executes the commands of the
+* cy_stc_dfu_nor_ops_t interface: it has the SFDP tables of a 64 Mbit device
+* with the 4 KB, 32 KB and 64 KB erase types and the 1-1-4 fast read with a
+* quad enable bit, the page program wraps around at the end of the 256-byte
+* page and can only clear bits, and the device stays busy for a few status
+* polls after each program, erase and status write. Its content is mapped
+* read-only at SIM_NOR_BASE as the XIP view of the SMIF.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "cy_syslib.h"
+#include "dfu_sim.h"
+
+/* The commands of the simulated device */
+#define NOR_WRITE_STATUS        (0x01U)
+#define NOR_PAGE_PROGRAM        (0x02U)
+#define NOR_READ                (0x03U)
+#define NOR_READ_STATUS         (0x05U)
+#define NOR_WRITE_ENABLE        (0x06U)
+#define NOR_FAST_READ           (0x0BU)
+#define NOR_ERASE_4K            (0x20U)
+#define NOR_READ_STATUS2        (0x35U)
+#define NOR_ERASE_32K           (0x52U)
+#define NOR_READ_SFDP           (0x5AU)
+#define NOR_QUAD_READ           (0x6BU)
+#define NOR_ERASE_64K           (0xD8U)
+
+/* The status register bits */
+#define NOR_STATUS_WIP          (0x01U)
+#define NOR_STATUS_WEL          (0x02U)
+#define NOR_STATUS2_QE          (0x02U)
+
+#define NOR_PAGE_SIZE           (256U)
+
+/* The number of the status polls the device is busy for after each operation */
+#define NOR_PROGRAM_POLLS       (2U)
+#define NOR_ERASE_POLLS         (8U)
+#define NOR_STATUS_POLLS        (4U)
+
+/* The SFDP header, the basic flash parameter header, and the basic flash parameter table at 0x10 */
+static const uint32_t sfdpTable[] =
+{
+    0x50444653U,    /* "SFDP" */
+    0xFF000106U,    /* JESD216B, one parameter header, the legacy SPI mode */
+    0x10010600U,    /* The basic flash parameter table, JESD216B, 16 DWORDs... */
+    0xFF000010U,    /* ...at 0x10 */
+    0xFFC02005U,    /* 1: 1-1-4 fast read, 3-byte addresses, the 4 KB erase 20h */
+    0x03FFFFFFU,    /* 2: 64 Mbit */
+    0x6B080000U,    /* 3: the 1-1-4 fast read 6Bh with 8 dummy cycles */
+    0x00000000U,    /* 4 */
+    0x00000000U,    /* 5 */
+    0x00000000U,    /* 6 */
+    0x00000000U,    /* 7 */
+    0x520F200CU,    /* 8: the 4 KB erase 20h and the 32 KB erase 52h */
+    0x0000D810U,    /* 9: the 64 KB erase D8h */
+    0x00000000U,    /* 10 */
+    0x00000080U,    /* 11: the 256-byte page */
+    0x00000000U,    /* 12 */
+    0x00000000U,    /* 13 */
+    0x00000000U,    /* 14 */
+    0x00500000U,    /* 15: the quad enable bit 1 of status register 2, written with 01h */
+    0x00000000U,    /* 16 */
+};
+
+static uint8_t *norMem = NULL;
+static int norFd = -1;
+static bool norXip = true;
+static uint8_t status1 = 0U;
+static uint8_t status2 = 0U;
+static uint32_t busyPolls = 0U;
+static cy_stc_dfu_sim_nor_stats_t norStats;
+
+static cy_en_dfu_status_t Command(const cy_stc_dfu_nor_cmd_t *cmd, void *context);
+static bool Mapped(void *context);
+static bool CommandValid(const cy_stc_dfu_nor_cmd_t *cmd, uint32_t addressSize, uint32_t dummyCycles,
+                         uint32_t dataWidth);
+static void Erase(uint32_t address, uint32_t size);
+static void SetBusy(uint32_t polls);
+static void SetWritable(bool writable);
+
+/* The serial NOR interface of the simulated device for the DFU SDK */
+const cy_stc_dfu_nor_ops_t SimNor_Ops = { &Command, &Mapped };
+
+
+/*******************************************************************************
+* Function Name: SimNor_Init
+****************************************************************************//**
+*
+* Maps the simulated serial NOR device at SIM_NOR_BASE.
+*
+* \param fileName   The file to keep the device content in, or NULL to keep it
+*                   in RAM. A new file starts erased.
+* \param xip        True if the DFU SDK may read the mapped content (the XIP
+*                   mode of the SMIF), false if it must use the read commands.
+*
+* \return True if the device is mapped.
+*
+*******************************************************************************/
+bool SimNor_Init(const char *fileName, bool xip)
+{
+    void *addr = (void *)(uintptr_t)SIM_NOR_BASE;
+    int flags = MAP_FIXED_NOREPLACE;
+    bool erase = true;
+
+    if (fileName != NULL)
+    {
+        struct stat st;
+
+        norFd = open(fileName, O_RDWR | O_CREAT, 0644);
+        if ((norFd < 0) || (fstat(norFd, &st) != 0) || (ftruncate(norFd, (off_t)SIM_NOR_SIZE) != 0))
+        {
+            perror(fileName);
+            return (false);
+        }
+        erase = (st.st_size == 0);
+        flags |= MAP_SHARED;
+    }
+    else
+    {
+        flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+    }
+
+    norMem = mmap(addr, SIM_NOR_SIZE, PROT_READ, flags, norFd, 0);
+    if ((norMem == MAP_FAILED) || (norMem != addr))
+    {
+        perror("mmap NOR");
+        norMem = NULL;
+        return (false);
+    }
+    if (erase)
+    {
+        Erase(0U, SIM_NOR_SIZE);
+    }
+
+    norXip = xip;
+    status1 = 0U;
+    status2 = 0U;
+    busyPolls = 0U;
+    (void) memset(&norStats, 0, sizeof(norStats));
+    return (true);
+}
+
+
+/*******************************************************************************
+* Function Name: SimNor_Deinit
+****************************************************************************//**
+*
+* Unmaps the simulated serial NOR device and flushes it to the file, if any.
+*
+*******************************************************************************/
+void SimNor_Deinit(void)
+{
+    if (norMem != NULL)
+    {
+        (void) msync(norMem, SIM_NOR_SIZE, MS_SYNC);
+        (void) munmap(norMem, SIM_NOR_SIZE);
+        norMem = NULL;
+    }
+    if (norFd >= 0)
+    {
+        (void) close(norFd);
+        norFd = -1;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SimNor_GetStats
+****************************************************************************//**
+*
+* Returns the operation counters of the simulated serial NOR device.
+*
+* \param stats The pointer to the structure to store the counters in.
+*
+*******************************************************************************/
+void SimNor_GetStats(cy_stc_dfu_sim_nor_stats_t *stats)
+{
+    *stats = norStats;
+}
+
+
+/*******************************************************************************
+* Function Name: Command
+****************************************************************************//**
+*
+* Executes a command of the serial NOR interface. A command with the wrong
+* address, dummy cycles or data lines, a program or erase without the write
+* enable, and any command but the status read while the device is busy fail
+* and are counted as protocol errors. The 1-1-4 fast read returns 0xFF bytes
+* unless the quad enable bit is set, as on a device that leaves the IO2 and
+* IO3 lines to the WP# and HOLD# functions.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t Command(const cy_stc_dfu_nor_cmd_t *cmd, void *context)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    bool writeEnabled = ((status1 & NOR_STATUS_WEL) != 0U);
+    uint32_t i;
+
+    CY_UNUSED_PARAMETER(context);
+
+    if ((norMem == NULL) || ((busyPolls != 0U) && (cmd->opcode != NOR_READ_STATUS)))
+    {
+        status = CY_DFU_ERROR_DATA;
+    }
+    else
+    {
+        switch (cmd->opcode)
+        {
+            case NOR_WRITE_ENABLE:
+                status1 |= NOR_STATUS_WEL;
+                break;
+
+            case NOR_READ_STATUS:
+                norStats.statusPolls++;
+                if ((busyPolls != 0U) && (--busyPolls == 0U))
+                {
+                    status1 &= (uint8_t)~(NOR_STATUS_WIP | NOR_STATUS_WEL);
+                }
+                for (i = 0U; (cmd->rxData != NULL) && (i < cmd->length); i++)
+                {
+                    cmd->rxData[i] = status1;
+                }
+                break;
+
+            case NOR_READ_STATUS2:
+                for (i = 0U; (cmd->rxData != NULL) && (i < cmd->length); i++)
+                {
+                    cmd->rxData[i] = status2;
+                }
+                break;
+
+            case NOR_WRITE_STATUS:
+                if (!writeEnabled || (cmd->txData == NULL) || (cmd->length != 2U))
+                {
+                    status = CY_DFU_ERROR_DATA;
+                }
+                else
+                {
+                    status2 = cmd->txData[1];
+                    SetBusy(NOR_STATUS_POLLS);
+                }
+                break;
+
+            case NOR_READ_SFDP:
+                if (!CommandValid(cmd, 3U, 8U, 1U) || (cmd->rxData == NULL))
+                {
+                    status = CY_DFU_ERROR_DATA;
+                }
+                for (i = 0U; (status == CY_DFU_SUCCESS) && (i < cmd->length); i++)
+                {
+                    uint32_t offset = cmd->address + i;
+                    cmd->rxData[i] = (offset < sizeof(sfdpTable)) ?
+                                     (uint8_t)(sfdpTable[offset / 4U] >> ((offset % 4U) * 8U)) : 0xFFU;
+                }
+                break;
+
+            case NOR_READ:
+            case NOR_FAST_READ:
+            case NOR_QUAD_READ:
+                if (!CommandValid(cmd, 3U, (cmd->opcode == NOR_READ) ? 0U : 8U,
+                                  (cmd->opcode == NOR_QUAD_READ) ? 4U : 1U) ||
+                    (cmd->rxData == NULL) || (cmd->address >= SIM_NOR_SIZE))
+                {
+                    status = CY_DFU_ERROR_DATA;
+                }
+                else if ((cmd->opcode == NOR_QUAD_READ) && ((status2 & NOR_STATUS2_QE) == 0U))
+                {
+                    (void) memset(cmd->rxData, 0xFF, cmd->length);
+                }
+                else
+                {   /* The read wraps around at the end of the device */
+                    for (i = 0U; i < cmd->length; i++)
+                    {
+                        cmd->rxData[i] = norMem[(cmd->address + i) % SIM_NOR_SIZE];
+                    }
+                    norStats.readBytes += cmd->length;
+                }
+                break;
+
+            case NOR_PAGE_PROGRAM:
+                if (!writeEnabled || !CommandValid(cmd, 3U, 0U, 1U) || (cmd->txData == NULL) ||
+                    (cmd->address >= SIM_NOR_SIZE))
+                {
+                    status = CY_DFU_ERROR_DATA;
+                }
+                else
+                {   /* The program wraps around at the end of the page */
+                    uint32_t page = cmd->address - (cmd->address % NOR_PAGE_SIZE);
+
+                    SetWritable(true);
+                    for (i = 0U; i < cmd->length; i++)
+                    {
+                        norMem[page + ((cmd->address + i) % NOR_PAGE_SIZE)] &= cmd->txData[i];
+                    }
+                    SetWritable(false);
+                    norStats.pagePrograms++;
+                    SetBusy(NOR_PROGRAM_POLLS);
+                }
+                break;
+
+            case NOR_ERASE_4K:
+            case NOR_ERASE_32K:
+            case NOR_ERASE_64K:
+                if (!writeEnabled || !CommandValid(cmd, 3U, 0U, 1U) || (cmd->length != 0U) ||
+                    (cmd->address >= SIM_NOR_SIZE))
+                {
+                    status = CY_DFU_ERROR_DATA;
+                }
+                else
+                {   /* The erase of the block the address is in */
+                    uint32_t size = (cmd->opcode == NOR_ERASE_4K) ? 0x1000U :
+                                    ((cmd->opcode == NOR_ERASE_32K) ? 0x8000U : 0x10000U);
+
+                    Erase(cmd->address - (cmd->address % size), size);
+                    norStats.erases[(size == 0x1000U) ? 0U : ((size == 0x8000U) ? 1U : 2U)]++;
+                    SetBusy(NOR_ERASE_POLLS);
+                }
+                break;
+
+            default:
+                status = CY_DFU_ERROR_DATA;
+                break;
+        }
+    }
+
+    if (status != CY_DFU_SUCCESS)
+    {
+        norStats.errors++;
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Mapped
+****************************************************************************//**
+*
+* Reports whether the DFU SDK may read the mapped content of the device.
+*
+*******************************************************************************/
+static bool Mapped(void *context)
+{
+    CY_UNUSED_PARAMETER(context);
+
+    return (norXip);
+}
+
+
+/*******************************************************************************
+* Function Name: CommandValid
+****************************************************************************//**
+*
+* Checks the address bytes, the dummy cycles and the data lines of a command.
+*
+*******************************************************************************/
+static bool CommandValid(const cy_stc_dfu_nor_cmd_t *cmd, uint32_t addressSize, uint32_t dummyCycles,
+                         uint32_t dataWidth)
+{
+    return ((cmd->addressSize == addressSize) && (cmd->dummyCycles == dummyCycles) &&
+            ((cmd->length == 0U) || (cmd->dataWidth == dataWidth)));
+}
+
+
+/*******************************************************************************
+* Function Name: Erase
+****************************************************************************//**
+*
+* Sets the bytes of a range of the device to 0xFF.
+*
+*******************************************************************************/
+static void Erase(uint32_t address, uint32_t size)
+{
+    SetWritable(true);
+    (void) memset(&norMem[address], 0xFF, size);
+    SetWritable(false);
+}
+
+
+/*******************************************************************************
+* Function Name: SetBusy
+****************************************************************************//**
+*
+* Starts an operation: the device reports the write in progress for the given
+* number of the status polls, and then clears the write enable latch.
+*
+*******************************************************************************/
+static void SetBusy(uint32_t polls)
+{
+    status1 |= NOR_STATUS_WIP;
+    busyPolls = polls;
+}
+
+
+/*******************************************************************************
+* Function Name: SetWritable
+****************************************************************************//**
+*
+* Allows the device commands to modify the mapped memory. The rest of the time
+* a store into it faults, as into the XIP region of the SMIF.
+*
+*******************************************************************************/
+static void SetWritable(bool writable)
+{
+    (void) mprotect(norMem, SIM_NOR_SIZE, writable ? (PROT_READ | PROT_WRITE) : PROT_READ);
+}
+
+
+/* [] END OF FILE */
@@ -0,0 +1,397 @@
+/***************************************************************************//**
+* \file dfu_sim_swap.c
+* \version 5.2
+*
+* This file provides the power-cut test of the slot swap of the host-native
+* simulator build (CY_DFU_OPT_SWAP). It places the swap area and two slots in
+* the simulated flash, cuts the power during each erase and program operation
+* of a swap, of a revert, and of a revert of an interrupted swap in turn (see
+* SimFlash_PowerCut()), cuts it again during the resume, then resumes as App0
+* does after a reset and checks the contents of the slots. With --erase-unit,
+* the swap area and the slots are erased in units larger than a row.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "cy_flash.h"
+#include "dfu_sim.h"
+
+/* The swap area and the slots, in the simulated flash between App1 and the metadata */
+#define SWAP_SIM_AREA           (0x100C0000UL)
+#define SWAP_SIM_PRIMARY        (0x10080000UL)
+#define SWAP_SIM_SECONDARY      (0x100A0000UL)
+
+/* Two blocks and a row, so the last block is exchanged in part */
+#define SWAP_SIM_LENGTH         ((2U * CY_DFU_SWAP_BLOCK_SIZE) + CY_NVM_SIZEOF_ROW)
+
+/* The seeds of the images the slots start with */
+#define SWAP_SIM_IMAGE_A        (0xA5A5A5A5UL)
+#define SWAP_SIM_IMAGE_B        (0x3C3C3C3CUL)
+
+/* The operation interrupted by the power cuts */
+typedef enum
+{
+    SWAP_SIM_SWAP,              /* A swap */
+    SWAP_SIM_REVERT,            /* A revert of a complete swap */
+    SWAP_SIM_REVERT_INTERRUPTED /* A revert of a swap interrupted by a power cut */
+} swap_sim_case_t;
+
+static uint32_t ImageWord(uint32_t offset, uint32_t seed);
+static void SlotFill(uint32_t address, uint32_t seed);
+static bool SlotHolds(uint32_t address, uint32_t seed);
+static bool SlotsHold(uint32_t primarySeed, uint32_t secondarySeed);
+static void SwapSetup(void);
+static uint32_t FlashOperations(void);
+static uint32_t SecondCut(uint32_t cut);
+static bool SwapCase(swap_sim_case_t swapCase, uint32_t cut, cy_stc_dfu_params_t *params);
+static uint32_t SwapCaseOperations(swap_sim_case_t swapCase, cy_stc_dfu_params_t *params);
+static uint32_t EraseUnit(void);
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetSwapAddress
+****************************************************************************//**
+*
+* Places the swap area of the DFU SDK in the simulated flash.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_GetSwapAddress(void)
+{
+    return (SWAP_SIM_AREA);
+}
+
+
+/*******************************************************************************
+* Function Name: SimSwap_Run
+****************************************************************************//**
+*
+* Cuts the power during each erase and program operation of a swap, of a
+* revert, and of a revert of an interrupted swap in turn, and checks that the
+* slots end with the expected images after the resume. If the erase unit of
+* the simulated flash is larger than CY_DFU_SWAP_BLOCK_SIZE, checks that the
+* swap is refused instead.
+*
+* \param params The DFU parameters of the simulated device.
+*
+* \return True if all the cases end with the expected images.
+*
+*******************************************************************************/
+bool SimSwap_Run(cy_stc_dfu_params_t *params)
+{
+    static const char * const names[] = { "swap", "revert", "revert of an interrupted swap" };
+    bool pass = true;
+    uint32_t swapCase;
+
+    (void) printf("swap: blocks of %u bytes, erase units of %u bytes\n", (unsigned int)CY_DFU_SWAP_BLOCK_SIZE,
+                  (unsigned int)EraseUnit());
+    if ((CY_DFU_SWAP_BLOCK_SIZE % EraseUnit()) != 0U)
+    {
+        SwapSetup();
+        pass = (Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params) ==
+                CY_DFU_ERROR_BAD_PARAM) && SlotsHold(SWAP_SIM_IMAGE_A, SWAP_SIM_IMAGE_B);
+        (void) printf("swap: %-30s %s\n", "a block smaller than the unit", pass ? "refused" : "not refused");
+    }
+
+    for (swapCase = (uint32_t)SWAP_SIM_SWAP;
+         ((CY_DFU_SWAP_BLOCK_SIZE % EraseUnit()) == 0U) && (swapCase <= (uint32_t)SWAP_SIM_REVERT_INTERRUPTED);
+         swapCase++)
+    {
+        /* The operations of the case without a power cut, the cut after the last one does not happen */
+        uint32_t operations = SwapCaseOperations((swap_sim_case_t)swapCase, params);
+        uint32_t cut;
+        uint32_t failed = 0U;
+
+        for (cut = 1U; cut <= (operations + 1U); cut++)
+        {
+            if (!SwapCase((swap_sim_case_t)swapCase, cut, params))
+            {
+                if (failed == 0U)
+                {
+                    (void) printf("swap: %s fails with the power cut at operation %u\n",
+                                  names[swapCase], (unsigned int)cut);
+                }
+                failed++;
+            }
+        }
+        (void) printf("swap: %-30s %5u power cuts, %u failed\n", names[swapCase],
+                      (unsigned int)(operations + 1U), (unsigned int)failed);
+        pass = pass && (failed == 0U);
+    }
+    return (pass);
+}
+
+
+/*******************************************************************************
+* Function Name: SwapCase
+****************************************************************************//**
+*
+* Runs a case with the power cut at an operation, then resumes with another
+* power cut, and resumes again as App0 does after a reset. A swap or a revert
+* cut before its first status record is complete is not recorded, it is
+* started again as the application would.
+*
+* \param swapCase   The operation interrupted by the power cut.
+* \param cut        The erase or program operation the power is cut at.
+* \param params     The DFU parameters of the simulated device.
+*
+* \return True if the slots end with the expected images.
+*
+*******************************************************************************/
+static bool SwapCase(swap_sim_case_t swapCase, uint32_t cut, cy_stc_dfu_params_t *params)
+{
+    bool pass = true;
+
+    SwapSetup();
+    if (swapCase == SWAP_SIM_REVERT)
+    {
+        pass = (Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params) == CY_DFU_SUCCESS);
+    }
+
+    SimFlash_PowerCut(cut);
+    if (swapCase == SWAP_SIM_REVERT)
+    {
+        (void) Cy_DFU_SwapRevert(params);
+    }
+    else
+    {
+        (void) Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params);
+    }
+    if (swapCase == SWAP_SIM_REVERT_INTERRUPTED)
+    {
+        /* The revert after the reset is cut too */
+        SimFlash_PowerCut(SecondCut(cut));
+        (void) Cy_DFU_SwapRevert(params);
+    }
+
+    /* The reset: the resume is cut once more, then runs to the end */
+    SimFlash_PowerCut(SecondCut(cut));
+    (void) Cy_DFU_SwapResume(params);
+    SimFlash_PowerCut(0U);
+    pass = pass && (Cy_DFU_SwapResume(params) == CY_DFU_SUCCESS);
+
+    if (swapCase == SWAP_SIM_SWAP)
+    {
+        if (pass && SlotsHold(SWAP_SIM_IMAGE_A, SWAP_SIM_IMAGE_B))
+        {   /* The swap was not recorded */
+            pass = (Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params) == CY_DFU_SUCCESS);
+        }
+        pass = pass && SlotsHold(SWAP_SIM_IMAGE_B, SWAP_SIM_IMAGE_A);
+    }
+    else
+    {
+        if (pass && SlotsHold(SWAP_SIM_IMAGE_B, SWAP_SIM_IMAGE_A))
+        {   /* The revert was not recorded, or the swap was completed by the resume */
+            pass = (Cy_DFU_SwapRevert(params) == CY_DFU_SUCCESS);
+        }
+        pass = pass && SlotsHold(SWAP_SIM_IMAGE_A, SWAP_SIM_IMAGE_B);
+    }
+    return (pass);
+}
+
+
+/*******************************************************************************
+* Function Name: SwapCaseOperations
+****************************************************************************//**
+*
+* Returns the number of the erase and program operations of a case without a
+* power cut: of the swap, or of the revert.
+*
+*******************************************************************************/
+static uint32_t SwapCaseOperations(swap_sim_case_t swapCase, cy_stc_dfu_params_t *params)
+{
+    uint32_t start;
+
+    SwapSetup();
+    if (swapCase == SWAP_SIM_REVERT)
+    {
+        (void) Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params);
+    }
+    start = FlashOperations();
+    if (swapCase == SWAP_SIM_REVERT)
+    {
+        (void) Cy_DFU_SwapRevert(params);
+    }
+    else
+    {
+        (void) Cy_DFU_SwapApp(SWAP_SIM_PRIMARY, SWAP_SIM_SECONDARY, SWAP_SIM_LENGTH, params);
+    }
+    return (FlashOperations() - start);
+}
+
+
+/*******************************************************************************
+* Function Name: SecondCut
+****************************************************************************//**
+*
+* Returns the operation of the second power cut of a case, spread over the
+* first operations of the resume.
+*
+*******************************************************************************/
+static uint32_t SecondCut(uint32_t cut)
+{
+    return (1U + ((cut * 7U) % 29U));
+}
+
+
+/*******************************************************************************
+* Function Name: SwapSetup
+****************************************************************************//**
+*
+* Restores the power, writes image A to the primary slot and image B to the
+* secondary slot, and erases the swap area: a status slot of an erase unit for
+* each record, and the scratch area.
+*
+*******************************************************************************/
+static void SwapSetup(void)
+{
+    uint32_t offset;
+
+    SimFlash_PowerCut(0U);
+    SlotFill(SWAP_SIM_PRIMARY, SWAP_SIM_IMAGE_A);
+    SlotFill(SWAP_SIM_SECONDARY, SWAP_SIM_IMAGE_B);
+    for (offset = 0U; offset < ((CY_DFU_SWAP_STATUS_SLOTS * EraseUnit()) + CY_DFU_SWAP_BLOCK_SIZE);
+         offset += CY_NVM_SIZEOF_ROW)
+    {
+        (void) Cy_Flash_EraseRow(SWAP_SIM_AREA + offset);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: EraseUnit
+****************************************************************************//**
+*
+* Returns the erase unit of the swap area, a row if the flash is erased in
+* rows, see SimUser_SetEraseUnit().
+*
+*******************************************************************************/
+static uint32_t EraseUnit(void)
+{
+    uint32_t eraseSize = Cy_DFU_GetEraseSize(SWAP_SIM_AREA);
+
+    return ((eraseSize > CY_NVM_SIZEOF_ROW) ? eraseSize : CY_NVM_SIZEOF_ROW);
+}
+
+
+/*******************************************************************************
+* Function Name: ImageWord
+****************************************************************************//**
+*
+* Returns the word of an image at an offset: derived from the offset and the
+* seed of the image, so no two rows are the same.
+*
+*******************************************************************************/
+static uint32_t ImageWord(uint32_t offset, uint32_t seed)
+{
+    return ((offset * 2654435761U) ^ seed);
+}
+
+
+/*******************************************************************************
+* Function Name: SlotFill
+****************************************************************************//**
+*
+* Writes an image to a slot, see ImageWord().
+*
+*******************************************************************************/
+static void SlotFill(uint32_t address, uint32_t seed)
+{
+    uint32_t row[CY_NVM_SIZEOF_ROW / sizeof(uint32_t)];
+    uint32_t offset;
+    uint32_t i;
+
+    for (offset = 0U; offset < SWAP_SIM_LENGTH; offset += CY_NVM_SIZEOF_ROW)
+    {
+        for (i = 0U; i < (CY_NVM_SIZEOF_ROW / sizeof(uint32_t)); i++)
+        {
+            row[i] = ImageWord(offset + (i * (uint32_t)sizeof(uint32_t)), seed);
+        }
+        (void) Cy_Flash_WriteRow(address + offset, row);
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: SlotHolds
+****************************************************************************//**
+*
+* Checks that a slot holds the image of a seed, see SlotFill().
+*
+*******************************************************************************/
+static bool SlotHolds(uint32_t address, uint32_t seed)
+{
+    const uint32_t *slot = (const uint32_t *)(uintptr_t)address;
+    bool holds = true;
+    uint32_t i;
+
+    for (i = 0U; holds && (i < (SWAP_SIM_LENGTH / sizeof(uint32_t))); i++)
+    {
+        holds = (slot[i] == ImageWord(i * (uint32_t)sizeof(uint32_t), seed));
+    }
+    return (holds);
+}
+
+
+/*******************************************************************************
+* Function Name: SlotsHold
+****************************************************************************//**
+*
+* Checks that the primary and the secondary slots hold the images of the seeds.
+*
+*******************************************************************************/
+static bool SlotsHold(uint32_t primarySeed, uint32_t secondarySeed)
+{
+    return (SlotHolds(SWAP_SIM_PRIMARY, primarySeed) && SlotHolds(SWAP_SIM_SECONDARY, secondarySeed));
+}
+
+
+/*******************************************************************************
+* Function Name: FlashOperations
+****************************************************************************//**
+*
+* Returns the number of the erase and program operations of the simulated
+* flash so far.
+*
+*******************************************************************************/
+static uint32_t FlashOperations(void)
+{
+    cy_stc_dfu_sim_flash_stats_t stats;
+
+    SimFlash_GetStats(&stats);
+    return (stats.sectorErases + stats.rowErases + stats.rowPrograms);
+}
+
+
+/* [] END OF FILE */
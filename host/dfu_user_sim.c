@@ -0,0 +1,557 @@
+/***************************************************************************//**
+* \file dfu_user_sim.c
+* \version 5.2
+*
+* This file provides the DFU SDK user functions of the host-native simulator
+* build: the NVM read and write on the simulated flash and the transport
+* management on the simulated transports.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "cy_syslib.h"
+#include "cy_flash.h"
+#include "cy_dfu.h"
+#include "cy_dfu_logging.h"
+#include "dfu_sim.h"
+
+/* The transport started with Cy_DFU_TransportStart() */
+static const cy_stc_dfu_transport_ops_t *selectedTransport = NULL;
+
+static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t *endAddress);
+static cy_en_dfu_status_t FlashErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length);
+static cy_en_dfu_status_t FlashWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                     const uint8_t data[], uint32_t length);
+static cy_en_dfu_status_t FlashProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                       const uint8_t data[], uint32_t length);
+
+#if CY_DFU_OPT_NVM_ASYNC != 0
+    /* The rows are written with Cy_Flash_StartWrite(), FlashPoll() starts the next one */
+    static cy_en_dfu_status_t FlashPoll(const cy_stc_dfu_nvm_region_t *region);
+
+    #define FLASH_POLL          (&FlashPoll)
+
+    /* The row being written, and the end address and the data of the range */
+    static uint32_t flashWriteAddress;
+    static uint32_t flashWriteEnd;
+    static const uint8_t *flashWriteData;
+#else
+    #define FLASH_POLL          (NULL)
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+
+/* The simulated flash: written in rows, read in place */
+static const cy_stc_dfu_nvm_region_t flashRegion =
+{
+    CY_FLASH_BASE, CY_FLASH_SIZE, CY_NVM_SIZEOF_ROW, 0U, NULL, NULL, &FlashErase, &FlashWrite, FLASH_POLL, NULL
+};
+
+/* The part of the simulated flash that is erased in units, as the sectors of the
+* CY_IP_M7CPUSS flash: the rows are programmed without an erase. Empty until
+* SimUser_SetEraseUnit() */
+static cy_stc_dfu_nvm_region_t sectorRegion =
+{
+    0U, 0U, CY_NVM_SIZEOF_ROW, 0U, NULL, NULL, &FlashErase, &FlashProgram, NULL, NULL
+};
+
+/* The number of the units of sectorRegion erased, see SimUser_GetUnitErases() */
+static uint32_t sectorUnitErases;
+
+#if CY_DFU_OPT_NOR != 0
+    /* The simulated serial NOR and its NVM region, initialized by Cy_DFU_TransportStart() */
+    static cy_stc_dfu_nor_t norDevice;
+    static cy_stc_dfu_nvm_region_t norRegion;
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+/* The NVM regions of the simulator, terminated with NULL */
+static const cy_stc_dfu_nvm_region_t * const nvmRegions[] =
+{
+#if CY_DFU_OPT_NOR != 0
+    &norRegion,
+#endif /* CY_DFU_OPT_NOR != 0 */
+    &sectorRegion,
+    &flashRegion,
+    NULL
+};
+
+
+/*******************************************************************************
+* Function Name: GetStartEndAddress
+****************************************************************************//**
+*
+* This internal function returns start and end address of application
+*
+* \param appId          The application number
+* \param startAddress   The pointer to a variable where an application start
+*                       address is stored
+* \param endAddress     The pointer to a variable where a size of application
+*                       area is stored.
+*
+*******************************************************************************/
+static void GetStartEndAddress(uint32_t appId, uint32_t *startAddress, uint32_t *endAddress)
+{
+    uint32_t verifyStart;
+    uint32_t verifySize;
+
+    (void)Cy_DFU_GetAppMetadata(appId, &verifyStart, &verifySize);
+
+    *startAddress = verifyStart;
+    *endAddress = verifyStart + verifySize + CY_DFU_SIGNATURE_SIZE;
+}
+
+
+/*******************************************************************************
+* Function Name: SimUser_SetEraseUnit
+****************************************************************************//**
+*
+* Makes a range of the simulated flash erased in units: a write at the start of
+* a unit erases the whole unit, and the other rows are programmed without an
+* erase. The rest of the flash is erased in rows.
+*
+* \param address    The start address of the range, at the start of a unit.
+* \param size       The size of the range in bytes, a multiple of eraseSize,
+*                   or 0 to erase the whole flash in rows.
+* \param eraseSize  The erase unit in bytes, a multiple of the row size.
+*
+*******************************************************************************/
+void SimUser_SetEraseUnit(uint32_t address, uint32_t size, uint32_t eraseSize)
+{
+    sectorRegion.address = address;
+    sectorRegion.size = size;
+    sectorRegion.eraseSize = eraseSize;
+}
+
+
+/*******************************************************************************
+* Function Name: SimUser_GetUnitErases
+****************************************************************************//**
+*
+* Returns the number of the units erased in the range of
+* SimUser_SetEraseUnit() since the start of the simulator.
+*
+*******************************************************************************/
+uint32_t SimUser_GetUnitErases(void)
+{
+    return (sectorUnitErases);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashErase
+****************************************************************************//**
+*
+* Internal function to erase the rows of the simulated flash, the erase
+* function of its NVM regions. Counts the units erased in the region of
+* SimUser_SetEraseUnit().
+*
+* \param region     The NVM region of the simulated flash.
+* \param address    The address of the first row.
+* \param length     The length of the rows in bytes.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the flash driver fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashErase(const cy_stc_dfu_nvm_region_t *region, uint32_t address, uint32_t length)
+{
+    cy_en_flashdrv_status_t fstatus = CY_FLASH_DRV_SUCCESS;
+
+    if (region->eraseSize != 0U)
+    {
+        sectorUnitErases += length / region->eraseSize;
+    }
+
+    for (uint32_t offset = 0U; (fstatus == CY_FLASH_DRV_SUCCESS) && (offset < length); offset += region->programSize)
+    {
+        fstatus = Cy_Flash_EraseRow(address + offset);
+    }
+    if (fstatus != CY_FLASH_DRV_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash erase failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_FLASH_DRV_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+}
+
+
+/*******************************************************************************
+* Function Name: FlashWrite
+****************************************************************************//**
+*
+* Internal function to write the rows of the simulated flash, the program
+* function of its NVM region. Cy_Flash_WriteRow() erases each row. With
+* CY_DFU_OPT_NVM_ASYNC, the first row is started with Cy_Flash_StartWrite()
+* instead, and FlashPoll() writes the rest.
+*
+* \param region     The NVM region of the simulated flash.
+* \param address    The address of the first row.
+* \param data       The data of the rows, 4-byte aligned.
+* \param length     The length of the rows in bytes.
+*
+* \return CY_DFU_SUCCESS, CY_DFU_IN_PROGRESS if the first row is started, or
+* CY_DFU_ERROR_DATA if the flash driver fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashWrite(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                     const uint8_t data[], uint32_t length)
+{
+#if CY_DFU_OPT_NVM_ASYNC != 0
+    CY_UNUSED_PARAMETER(region);
+
+    flashWriteAddress = address;
+    flashWriteEnd = address + length;
+    flashWriteData = data;
+
+    cy_en_flashdrv_status_t fstatus = Cy_Flash_StartWrite(address, (const uint32_t *)data);
+
+    if (fstatus != CY_FLASH_DRV_OPERATION_STARTED)
+    {
+        CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_FLASH_DRV_OPERATION_STARTED) ? CY_DFU_IN_PROGRESS : CY_DFU_ERROR_DATA);
+#else
+    cy_en_flashdrv_status_t fstatus = CY_FLASH_DRV_SUCCESS;
+
+    for (uint32_t offset = 0U; (fstatus == CY_FLASH_DRV_SUCCESS) && (offset < length); offset += region->programSize)
+    {
+        fstatus = Cy_Flash_WriteRow(address + offset, (const uint32_t *)&data[offset]);
+    }
+    if (fstatus != CY_FLASH_DRV_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_FLASH_DRV_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+}
+
+
+/*******************************************************************************
+* Function Name: FlashProgram
+****************************************************************************//**
+*
+* Internal function to program the rows of the simulated flash without an
+* erase, the program function of the region of SimUser_SetEraseUnit().
+*
+* \param region     The NVM region of the range.
+* \param address    The address of the first row.
+* \param data       The data of the rows, 4-byte aligned.
+* \param length     The length of the rows in bytes.
+*
+* \return CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the flash driver fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashProgram(const cy_stc_dfu_nvm_region_t *region, uint32_t address,
+                                       const uint8_t data[], uint32_t length)
+{
+    cy_en_flashdrv_status_t fstatus = CY_FLASH_DRV_SUCCESS;
+
+    for (uint32_t offset = 0U; (fstatus == CY_FLASH_DRV_SUCCESS) && (offset < length); offset += region->programSize)
+    {
+        fstatus = Cy_Flash_ProgramRow(address + offset, (const uint32_t *)&data[offset]);
+    }
+    if (fstatus != CY_FLASH_DRV_SUCCESS)
+    {
+        CY_DFU_LOG_ERR("Flash program failed: fstatus 0x%X ", (unsigned int)fstatus);
+    }
+    return ((fstatus == CY_FLASH_DRV_SUCCESS) ? CY_DFU_SUCCESS : CY_DFU_ERROR_DATA);
+}
+
+
+#if CY_DFU_OPT_NVM_ASYNC != 0
+/*******************************************************************************
+* Function Name: FlashPoll
+****************************************************************************//**
+*
+* Internal function to continue the write started by FlashWrite(), the poll
+* function of the NVM region of the simulated flash: starts the next row when
+* the current one completes.
+*
+* \param region     The NVM region of the simulated flash.
+*
+* \return CY_DFU_IN_PROGRESS until the last row completes, then
+* CY_DFU_SUCCESS, or CY_DFU_ERROR_DATA if the flash driver fails.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FlashPoll(const cy_stc_dfu_nvm_region_t *region)
+{
+    cy_en_dfu_status_t status = CY_DFU_IN_PROGRESS;
+    cy_en_flashdrv_status_t fstatus = Cy_Flash_IsOperationComplete();
+
+    if (fstatus == CY_FLASH_DRV_SUCCESS)
+    {
+        flashWriteAddress += region->programSize;
+        flashWriteData = &flashWriteData[region->programSize];
+        if (flashWriteAddress >= flashWriteEnd)
+        {
+            status = CY_DFU_SUCCESS;
+        }
+        else
+        {
+            fstatus = Cy_Flash_StartWrite(flashWriteAddress, (const uint32_t *)flashWriteData);
+        }
+    }
+    if ((fstatus != CY_FLASH_DRV_SUCCESS) && (fstatus != CY_FLASH_DRV_OPCODE_BUSY) &&
+        (fstatus != CY_FLASH_DRV_OPERATION_STARTED))
+    {
+        CY_DFU_LOG_ERR("Flash write failed: fstatus 0x%X ", (unsigned int)fstatus);
+        status = CY_DFU_ERROR_DATA;
+    }
+    return (status);
+}
+#endif /* CY_DFU_OPT_NVM_ASYNC != 0 */
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_WriteData
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_WriteData (uint32_t address, uint32_t length, uint32_t ctl,
+                                               cy_stc_dfu_params_t *params)
+{
+    cy_en_dfu_status_t status = CY_DFU_SUCCESS;
+    uint32_t size = (length != 0U) ? length : CY_NVM_SIZEOF_ROW;
+    uint32_t startAddress;
+    uint32_t endAddress;
+
+    GetStartEndAddress(Cy_DFU_GetRunningApp(), &startAddress, &endAddress);
+
+    /* Refuse to write to a row within a range of the current application */
+    if ( (address < endAddress) && (startAddress < (address + size)) )
+    {   /* It is forbidden to overwrite the currently running application */
+        status = CY_DFU_ERROR_ADDRESS;
+    }
+
+#if CY_DFU_OPT_VALID_CACHE != 0
+    if (status == CY_DFU_SUCCESS)
+    {   /* The cached validity of the applications is outdated by the write */
+        Cy_DFU_ValidCacheInvalidate();
+    }
+#endif /* CY_DFU_OPT_VALID_CACHE != 0 */
+
+    if (status == CY_DFU_SUCCESS)
+    {
+        status = Cy_DFU_NvmWrite(Cy_DFU_NvmRegionFind(nvmRegions, address, size), address, length, ctl, params);
+    }
+
+#if CY_DFU_OPT_METADATA_CACHE != 0
+    if ((address - (uint32_t)&__cy_boot_metadata_addr) < (uint32_t)&__cy_boot_metadata_length)
+    {   /* The cached metadata is outdated by the write */
+        Cy_DFU_MetadataCacheInvalidate();
+    }
+#endif /* CY_DFU_OPT_METADATA_CACHE != 0 */
+
+    if (CY_DFU_SUCCESS != status)
+    {
+        CY_DFU_LOG_ERR("Write operation failed at address 0x%X", (unsigned int)address);
+    }
+
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_ReadData
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_ReadData (uint32_t address, uint32_t length, uint32_t ctl,
+                                              cy_stc_dfu_params_t *params)
+{
+    return (Cy_DFU_NvmRead(Cy_DFU_NvmRegionFind(nvmRegions, address, length), address, length, ctl, params));
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_GetEraseSize
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_GetEraseSize(uint32_t address)
+{
+    const cy_stc_dfu_nvm_region_t *nvm = Cy_DFU_NvmRegionFind(nvmRegions, address, 0U);
+
+    return ((nvm != NULL) ? nvm->eraseSize : 0U);
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportStart
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+* The simulator starts the transport selected with SimTransport_Select(),
+* \c transport is ignored.
+*
+*******************************************************************************/
+void Cy_DFU_TransportStart(cy_en_dfu_transport_t transport)
+{
+    CY_UNUSED_PARAMETER(transport);
+
+#if CY_DFU_OPT_NOR != 0
+    if (norDevice.size == 0U)
+    {
+        norDevice.ops = &SimNor_Ops;
+        norDevice.context = NULL;
+        norDevice.address = SIM_NOR_BASE;
+        (void) Cy_DFU_NorInit(&norDevice);
+        Cy_DFU_NorRegionInit(&norDevice, &norRegion);
+    }
+#endif /* CY_DFU_OPT_NOR != 0 */
+
+    selectedTransport = SimTransport_Get();
+    CY_ASSERT(selectedTransport != NULL);
+    selectedTransport->start();
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportStop
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+void Cy_DFU_TransportStop(void)
+{
+    if (selectedTransport != NULL)
+    {
+        selectedTransport->stop();
+        selectedTransport = NULL;
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportReset
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+void Cy_DFU_TransportReset(void)
+{
+    if (selectedTransport != NULL)
+    {
+        selectedTransport->reset();
+    }
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportRead
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_TransportRead(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
+
+    if (selectedTransport != NULL)
+    {
+        status = selectedTransport->read(buffer, size, count, timeout);
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportWrite
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+cy_en_dfu_status_t Cy_DFU_TransportWrite(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_UNKNOWN;
+
+    if (selectedTransport != NULL)
+    {
+        status = selectedTransport->write(buffer, size, count, timeout);
+    }
+    return status;
+}
+
+
+/*******************************************************************************
+* Function Name: Cy_DFU_TransportGetOps
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+*
+*******************************************************************************/
+const cy_stc_dfu_transport_ops_t * Cy_DFU_TransportGetOps(void)
+{
+    return (selectedTransport);
+}
+
+
+#if CY_DFU_OPT_STATS != 0
+/*******************************************************************************
+* Function Name: Cy_DFU_StatsTimestamp
+****************************************************************************//**
+*
+* This function documentation is part of the DFU SDK API, see the
+* cy_dfu.h file or DFU SDK API Reference Manual for details.
+* The simulator counts in nanoseconds of the monotonic clock.
+*
+*******************************************************************************/
+uint32_t Cy_DFU_StatsTimestamp(void)
+{
+    struct timespec ts;
+
+    (void) clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint32_t)(((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec));
+}
+#endif /* CY_DFU_OPT_STATS != 0 */
+
+
+/* [] END OF FILE */
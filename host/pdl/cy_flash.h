@@ -0,0 +1,98 @@
+/***************************************************************************//**
+* \file cy_flash.h
+* \version 5.2
+*
+* This file provides the subset of the PDL flash driver used by the DFU SDK
+* and the host-native simulator. The functions are implemented on top of the
+* simulated flash in dfu_sim_flash.c.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if !defined(CY_FLASH_H)
+#define CY_FLASH_H
+
+#include "cy_syslib.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/* The simulated flash geometry, the same as the CAT1A linker scripts use */
+#ifndef CY_FLASH_BASE
+    #define CY_FLASH_BASE                   (0x10000000UL)
+#endif /* CY_FLASH_BASE */
+#ifndef CY_FLASH_SIZE
+    #define CY_FLASH_SIZE                   (0x00100000UL)
+#endif /* CY_FLASH_SIZE */
+#ifndef CY_FLASH_SIZEOF_ROW
+    #define CY_FLASH_SIZEOF_ROW             (512UL)
+#endif /* CY_FLASH_SIZEOF_ROW */
+#ifndef CY_FLASH_SIZEOF_SECTOR
+    #define CY_FLASH_SIZEOF_SECTOR          (0x00040000UL)
+#endif /* CY_FLASH_SIZEOF_SECTOR */
+
+/** The value of an erased flash byte */
+#define CY_FLASH_ERASED_VALUE               (0x00U)
+
+#define CY_FLASH_ID                         CY_PDL_DRV_ID(0x14U)
+
+/** The flash driver error codes */
+typedef enum
+{
+    CY_FLASH_DRV_SUCCESS                  = 0x00UL,
+    CY_FLASH_DRV_INV_PROT                 = ( CY_FLASH_ID | CY_PDL_STATUS_ERROR | 0x0UL ),
+    CY_FLASH_DRV_INVALID_FM_PL            = ( CY_FLASH_ID | CY_PDL_STATUS_ERROR | 0x1UL ),
+    CY_FLASH_DRV_INVALID_FLASH_ADDR       = ( CY_FLASH_ID | CY_PDL_STATUS_ERROR | 0x2UL ),
+    CY_FLASH_DRV_INVALID_INPUT_PARAMETERS = ( CY_FLASH_ID | CY_PDL_STATUS_ERROR | 0x6UL ),
+    CY_FLASH_DRV_ERR_UNC                  = ( CY_FLASH_ID | CY_PDL_STATUS_ERROR | 0x7UL ),
+    CY_FLASH_DRV_OPERATION_STARTED        = ( CY_FLASH_ID | CY_PDL_STATUS_INFO  | 0x1UL ),
+    CY_FLASH_DRV_OPCODE_BUSY              = ( CY_FLASH_ID | CY_PDL_STATUS_INFO  | 0x2UL ),
+} cy_en_flashdrv_status_t;
+
+cy_en_flashdrv_status_t Cy_Flash_EraseSector(uint32_t sectorAddr);
+cy_en_flashdrv_status_t Cy_Flash_EraseRow(uint32_t rowAddr);
+cy_en_flashdrv_status_t Cy_Flash_ProgramRow(uint32_t rowAddr, const uint32_t* data);
+cy_en_flashdrv_status_t Cy_Flash_WriteRow(uint32_t rowAddr, const uint32_t* data);
+cy_en_flashdrv_status_t Cy_Flash_StartWrite(uint32_t rowAddr, const uint32_t* data);
+cy_en_flashdrv_status_t Cy_Flash_IsOperationComplete(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !defined(CY_FLASH_H) */
+
+
+/* [] END OF FILE */
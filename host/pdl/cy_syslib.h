@@ -0,0 +1,144 @@
+/***************************************************************************//**
+* \file cy_syslib.h
+* \version 5.2
+*
+* This file provides the subset of the PDL system library used by the DFU SDK,
+* for the host-native simulator build.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if !defined(CY_SYSLIB_H)
+#define CY_SYSLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+
+/***************************************
+*        Compiler macros
+***************************************/
+
+#define __WEAK                              __attribute__((weak))
+#define __USED                              __attribute__((used))
+#define __NO_RETURN                         __attribute__((noreturn))
+#define CY_SECTION(name)                    __attribute__((section(name)))
+#define CY_ALIGN(align)                     __attribute__((aligned(align)))
+#define CY_UNUSED_PARAMETER(param)          (void)(param)
+
+#define CY_MISRA_DEVIATE_LINE(rule, reason)
+#define CY_MISRA_FP_LINE(rule, reason)
+#define CY_MISRA_DEVIATE_BLOCK_START(rule, count, reason)
+#define CY_MISRA_BLOCK_END(rule)
+
+
+/***************************************
+*        Assertions
+***************************************/
+
+#define CY_ASSERT(x)                        do { if (!(x)) { abort(); } } while (false)
+#define CY_ASSERT_L1(x)                     CY_ASSERT(x)
+#define CY_ASSERT_L2(x)                     CY_ASSERT(x)
+#define CY_ASSERT_L3(x)                     CY_ASSERT(x)
+#define CY_HALT()                           abort()
+
+
+/***************************************
+*        Status codes
+***************************************/
+
+#define CY_PDL_STATUS_CODE_Pos              (0U)
+#define CY_PDL_STATUS_TYPE_Pos              (16U)
+#define CY_PDL_MODULE_ID_Pos                (18U)
+#define CY_PDL_STATUS_INFO                  (0UL << CY_PDL_STATUS_TYPE_Pos)
+#define CY_PDL_STATUS_WARNING               (1UL << CY_PDL_STATUS_TYPE_Pos)
+#define CY_PDL_STATUS_ERROR                 (2UL << CY_PDL_STATUS_TYPE_Pos)
+#define CY_PDL_DRV_ID(id)                   ((uint32_t)((uint32_t)(id) << CY_PDL_MODULE_ID_Pos))
+
+
+/***************************************
+*        Reset and core
+***************************************/
+
+#define CY_SYSLIB_RESET_HWWDT               (0x0001U)
+#define CY_SYSLIB_RESET_SOFT                (0x0010U)
+
+/* The simulator always starts from a power-on reset */
+static inline uint32_t Cy_SysLib_GetResetReason(void)
+{
+    return (0U);
+}
+
+/* A software reset ends the simulated device */
+static inline __NO_RETURN void NVIC_SystemReset(void)
+{
+    exit(0);
+}
+
+static inline void __set_MSP(uint32_t topOfMainStack)
+{
+    (void) topOfMainStack;
+}
+
+#define __DMB()                             __sync_synchronize()
+
+static inline uint32_t Cy_SysLib_EnterCriticalSection(void)
+{
+    return (0U);
+}
+
+static inline void Cy_SysLib_ExitCriticalSection(uint32_t savedIntrStatus)
+{
+    (void) savedIntrStatus;
+}
+
+static inline void Cy_SysLib_DelayUs(uint16_t microseconds)
+{
+    (void) microseconds;
+}
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !defined(CY_SYSLIB_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,112 @@
+/***************************************************************************//**
+* \file cyhal.h
+* \version 5.2
+*
+* This file provides the subset of the HAL used by the CAT1 dfu_user.c
+* template, for the host-native test of the template, dfu_region_test.c. The
+* test implements the functions.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#if !defined(CYHAL_H)
+#define CYHAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "cy_syslib.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/** The result of a HAL function */
+typedef uint32_t cy_rslt_t;
+
+#define CY_RSLT_SUCCESS                     ((cy_rslt_t)0x00000000U)
+#define CY_RSLT_GET_MODULE(x)               (((x) >> 16U) & 0x3FFFU)
+#define CY_RSLT_GET_CODE(x)                 ((x) & 0xFFFFU)
+
+/* The emulated EEPROM of the CAT1A devices */
+#ifndef CY_EM_EEPROM_BASE
+    #define CY_EM_EEPROM_BASE               (0x14000000UL)
+#endif /* CY_EM_EEPROM_BASE */
+#ifndef CY_EM_EEPROM_SIZE
+    #define CY_EM_EEPROM_SIZE               (0x00008000UL)
+#endif /* CY_EM_EEPROM_SIZE */
+
+/** The NVM object */
+typedef struct
+{
+    uint32_t reserved;
+} cyhal_nvm_t;
+
+/** A flash block */
+typedef struct
+{
+    uint32_t start_address;
+    uint32_t size;
+    uint32_t sector_size;
+    uint32_t page_size;
+    uint8_t  erase_value;
+} cyhal_flash_block_info_t;
+
+/** The flash blocks of the device */
+typedef struct
+{
+    uint8_t block_count;
+    const cyhal_flash_block_info_t *blocks;
+} cyhal_flash_info_t;
+
+cy_rslt_t cyhal_nvm_init(cyhal_nvm_t *obj);
+void cyhal_nvm_free(cyhal_nvm_t *obj);
+void cyhal_flash_get_info(const cyhal_nvm_t *obj, cyhal_flash_info_t *info);
+cy_rslt_t cyhal_flash_read(cyhal_nvm_t *obj, uint32_t address, uint8_t *data, size_t size);
+cy_rslt_t cyhal_flash_erase(cyhal_nvm_t *obj, uint32_t address);
+cy_rslt_t cyhal_flash_write(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data);
+cy_rslt_t cyhal_flash_program(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data);
+cy_rslt_t cyhal_flash_start_write(cyhal_nvm_t *obj, uint32_t address, const uint32_t *data);
+bool cyhal_flash_is_operation_complete(cyhal_nvm_t *obj);
+
+/* The flash controller of the devices with the M7 core */
+void Cy_Flashc_MainWriteEnable(void);
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* !defined(CYHAL_H) */
+
+
+/* [] END OF FILE */
@@ -0,0 +1,474 @@
+/***************************************************************************//**
+* \file transport_sim.c
+* \version 5.2
+*
+* This file provides the transports of the host-native simulator build:
+* - pipe   - an in-process byte queue, the DFU Host side is driven with
+*            SimPipe_HostWrite() and SimPipe_HostRead();
+* - pty    - a pseudo terminal, the DFU Host opens the printed slave device as
+*            a serial port;
+* - socket - a Unix domain stream socket at the given path.
+*
+********************************************************************************
+* \copyright
+* (c) (2016-2024), Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation. All rights reserved.
+********************************************************************************
+* This software, including source code, documentation and related materials
+* ("Software") is owned by Cypress Semiconductor Corporation or one of its
+* affiliates ("Cypress") and is protected by and subject to worldwide patent
+* protection (United States and foreign), United States copyright laws and
+* international treaty provisions. Therefore, you may use this Software only
+* as provided in the license agreement accompanying the software package from
+* which you obtained this Software ("EULA").
+*
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software source
+* code solely for use in connection with Cypress's integrated circuit products.
+* Any reproduction, modification, translation, compilation, or representation
+* of this Software except as specified above is prohibited without the express
+* written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer of such
+* system or application assumes all risk of such use and in doing so agrees to
+* indemnify Cypress against all liability.
+*******************************************************************************/
+
+#define _GNU_SOURCE
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "dfu_sim.h"
+
+/* The size of the pipe queue, enough for one packet and its response */
+#define PIPE_SIZE               (2U * CY_DFU_SIZEOF_CMD_BUFFER)
+
+static const cy_stc_dfu_transport_ops_t *simTransport = NULL;
+
+/* Pipe state: the bytes from the DFU Host to the device and back */
+static uint8_t  pipeRx[PIPE_SIZE];
+static uint32_t pipeRxHead;
+static uint32_t pipeRxTail;
+static uint8_t  pipeTx[PIPE_SIZE];
+static uint32_t pipeTxCount;
+
+/* Pty and socket state */
+static int ptyMaster = -1;
+static int ptySlave = -1;
+static char socketPath[sizeof(((struct sockaddr_un *)NULL)->sun_path)];
+static int socketListen = -1;
+static int socketClient = -1;
+
+static cy_en_dfu_status_t FdRead(int fd, uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout);
+static cy_en_dfu_status_t FdWrite(int fd, const uint8_t buffer[], uint32_t size, uint32_t *count);
+
+
+/*******************************************************************************
+* Function Name: SimTransport_Select
+****************************************************************************//**
+*
+* Selects the transport Cy_DFU_TransportStart() starts.
+*
+* \param spec "pipe", "pty", or "socket:<path>".
+*
+* \return True if the specification is valid.
+*
+*******************************************************************************/
+bool SimTransport_Select(const char *spec)
+{
+    bool valid = true;
+
+    if (strcmp(spec, "pipe") == 0)
+    {
+        simTransport = &SimPipe_Ops;
+    }
+    else if (strcmp(spec, "pty") == 0)
+    {
+        simTransport = &SimPty_Ops;
+    }
+    else if ((strncmp(spec, "socket:", 7U) == 0) && (strlen(&spec[7]) < sizeof(socketPath)))
+    {
+        (void) strcpy(socketPath, &spec[7]);
+        simTransport = &SimSocket_Ops;
+    }
+    else
+    {
+        valid = false;
+    }
+    return (valid);
+}
+
+
+/*******************************************************************************
+* Function Name: SimTransport_Get
+****************************************************************************//**
+*
+* Returns the transport selected with SimTransport_Select().
+*
+*******************************************************************************/
+const cy_stc_dfu_transport_ops_t * SimTransport_Get(void)
+{
+    return (simTransport);
+}
+
+
+/*******************************************************************************
+* Function Name: FdRead
+****************************************************************************//**
+*
+* Waits up to \c timeout milliseconds for data on \c fd and reads what is
+* available, up to \c size bytes.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FdRead(int fd, uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    struct pollfd pfd = { fd, POLLIN, 0 };
+
+    *count = 0U;
+    if ((fd >= 0) && (poll(&pfd, 1, (int)timeout) > 0) && ((pfd.revents & POLLIN) != 0))
+    {
+        ssize_t n = read(fd, buffer, size);
+        if (n > 0)
+        {
+            *count = (uint32_t)n;
+            status = CY_DFU_SUCCESS;
+        }
+    }
+    return (status);
+}
+
+
+/*******************************************************************************
+* Function Name: FdWrite
+****************************************************************************//**
+*
+* Writes all \c size bytes to \c fd.
+*
+*******************************************************************************/
+static cy_en_dfu_status_t FdWrite(int fd, const uint8_t buffer[], uint32_t size, uint32_t *count)
+{
+    uint32_t written = 0U;
+
+    while ((fd >= 0) && (written < size))
+    {
+        ssize_t n = write(fd, &buffer[written], size - written);
+        if (n <= 0)
+        {
+            break;
+        }
+        written += (uint32_t)n;
+    }
+    *count = written;
+    return ((written == size) ? CY_DFU_SUCCESS : CY_DFU_ERROR_TIMEOUT);
+}
+
+
+/*******************************************************************************
+*        Pipe
+*******************************************************************************/
+
+/*******************************************************************************
+* Function Name: SimPipe_HostWrite
+****************************************************************************//**
+*
+* Queues the bytes the DFU Host sends to the device.
+*
+*******************************************************************************/
+void SimPipe_HostWrite(const uint8_t data[], uint32_t size)
+{
+    if (pipeRxHead == pipeRxTail)
+    {
+        pipeRxHead = 0U;
+        pipeRxTail = 0U;
+    }
+    CY_ASSERT((pipeRxTail + size) <= PIPE_SIZE);
+    (void) memcpy(&pipeRx[pipeRxTail], data, size);
+    pipeRxTail += size;
+}
+
+
+/*******************************************************************************
+* Function Name: SimPipe_HostRead
+****************************************************************************//**
+*
+* Takes the bytes the device has sent to the DFU Host.
+*
+* \return The number of bytes copied into \c data.
+*
+*******************************************************************************/
+uint32_t SimPipe_HostRead(uint8_t data[], uint32_t size)
+{
+    uint32_t count = (pipeTxCount < size) ? pipeTxCount : size;
+
+    (void) memcpy(data, pipeTx, count);
+    (void) memmove(pipeTx, &pipeTx[count], pipeTxCount - count);
+    pipeTxCount -= count;
+    return (count);
+}
+
+
+static void SimPipe_Start(void)
+{
+    pipeRxHead = 0U;
+    pipeRxTail = 0U;
+    pipeTxCount = 0U;
+}
+
+
+static void SimPipe_Stop(void)
+{
+}
+
+
+static void SimPipe_Reset(void)
+{
+    pipeRxHead = pipeRxTail;
+}
+
+
+static cy_en_dfu_status_t SimPipe_Read(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    uint32_t available = pipeRxTail - pipeRxHead;
+    uint32_t n = (available < size) ? available : size;
+
+    (void) timeout;
+    (void) memcpy(buffer, &pipeRx[pipeRxHead], n);
+    pipeRxHead += n;
+    *count = n;
+    return ((n != 0U) ? CY_DFU_SUCCESS : CY_DFU_ERROR_TIMEOUT);
+}
+
+
+static cy_en_dfu_status_t SimPipe_Write(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    (void) timeout;
+    CY_ASSERT((pipeTxCount + size) <= PIPE_SIZE);
+    (void) memcpy(&pipeTx[pipeTxCount], buffer, size);
+    pipeTxCount += size;
+    *count = size;
+    return (CY_DFU_SUCCESS);
+}
+
+
+/*******************************************************************************
+*        Pty
+*******************************************************************************/
+
+static void SimPty_Start(void)
+{
+    ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if ((ptyMaster >= 0) && (grantpt(ptyMaster) == 0) && (unlockpt(ptyMaster) == 0))
+    {
+        struct termios tio;
+        const char *name = ptsname(ptyMaster);
+
+        /* Keep the slave open so the line discipline stays raw between the DFU Host sessions */
+        ptySlave = open(name, O_RDWR | O_NOCTTY);
+        if ((ptySlave >= 0) && (tcgetattr(ptySlave, &tio) == 0))
+        {
+            cfmakeraw(&tio);
+            (void) tcsetattr(ptySlave, TCSANOW, &tio);
+        }
+        (void) printf("DFU device on %s\n", name);
+        (void) fflush(stdout);
+    }
+    else
+    {
+        perror("pty");
+    }
+}
+
+
+static void SimPty_Stop(void)
+{
+    if (ptySlave >= 0)
+    {
+        (void) close(ptySlave);
+        ptySlave = -1;
+    }
+    if (ptyMaster >= 0)
+    {
+        (void) close(ptyMaster);
+        ptyMaster = -1;
+    }
+}
+
+
+static void SimPty_Reset(void)
+{
+    (void) tcflush(ptyMaster, TCIFLUSH);
+}
+
+
+static cy_en_dfu_status_t SimPty_Read(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    return (FdRead(ptyMaster, buffer, size, count, timeout));
+}
+
+
+static cy_en_dfu_status_t SimPty_Write(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    (void) timeout;
+    return (FdWrite(ptyMaster, buffer, size, count));
+}
+
+
+/*******************************************************************************
+*        Socket
+*******************************************************************************/
+
+static void SimSocket_Start(void)
+{
+    struct sockaddr_un addr;
+
+    (void) memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    (void) strcpy(addr.sun_path, socketPath);
+    (void) unlink(socketPath);
+
+    socketListen = socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((socketListen < 0) ||
+        (bind(socketListen, (struct sockaddr *)&addr, sizeof(addr)) != 0) ||
+        (listen(socketListen, 1) != 0))
+    {
+        perror(socketPath);
+    }
+    else
+    {
+        (void) printf("DFU device on %s\n", socketPath);
+        (void) fflush(stdout);
+    }
+}
+
+
+static void SimSocket_Stop(void)
+{
+    if (socketClient >= 0)
+    {
+        (void) close(socketClient);
+        socketClient = -1;
+    }
+    if (socketListen >= 0)
+    {
+        (void) close(socketListen);
+        socketListen = -1;
+        (void) unlink(socketPath);
+    }
+}
+
+
+static void SimSocket_Reset(void)
+{
+    uint8_t drop[64];
+    uint32_t count;
+
+    while (FdRead(socketClient, drop, sizeof(drop), &count, 0U) == CY_DFU_SUCCESS)
+    {
+    }
+}
+
+
+static cy_en_dfu_status_t SimSocket_Read(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    cy_en_dfu_status_t status = CY_DFU_ERROR_TIMEOUT;
+    struct pollfd pfd = { socketListen, POLLIN, 0 };
+
+    *count = 0U;
+    if (socketClient < 0)
+    {
+        /* Wait for a DFU Host to connect */
+        if ((socketListen >= 0) && (poll(&pfd, 1, (int)timeout) > 0))
+        {
+            socketClient = accept(socketListen, NULL, NULL);
+        }
+    }
+    else
+    {
+        pfd.fd = socketClient;
+        if (poll(&pfd, 1, (int)timeout) > 0)
+        {
+            ssize_t n = read(socketClient, buffer, size);
+            if (n > 0)
+            {
+                *count = (uint32_t)n;
+                status = CY_DFU_SUCCESS;
+            }
+            else
+            {
+                /* The DFU Host has disconnected, wait for the next one */
+                (void) close(socketClient);
+                socketClient = -1;
+            }
+        }
+    }
+    return (status);
+}
+
+
+static cy_en_dfu_status_t SimSocket_Write(uint8_t buffer[], uint32_t size, uint32_t *count, uint32_t timeout)
+{
+    (void) timeout;
+    return (FdWrite(socketClient, buffer, size, count));
+}
+
+
+/*******************************************************************************
+*        Transport operations
+*******************************************************************************/
+
+/* The pipe never holds more than one packet, so it supports the zero-copy reads */
+const cy_stc_dfu_transport_ops_t SimPipe_Ops =
+{
+    .transport     = CY_DFU_UART,
+    .start         = &SimPipe_Start,
+    .stop          = &SimPipe_Stop,
+    .reset         = &SimPipe_Reset,
+    .read          = &SimPipe_Read,
+    .write         = &SimPipe_Write,
+    .maxPacketSize = 0U,
+    .capabilities  = CY_DFU_TRANSPORT_CAP_ZERO_COPY
+};
+
+const cy_stc_dfu_transport_ops_t SimPty_Ops =
+{
+    .transport     = CY_DFU_UART,
+    .start         = &SimPty_Start,
+    .stop          = &SimPty_Stop,
+    .reset         = &SimPty_Reset,
+    .read          = &SimPty_Read,
+    .write         = &SimPty_Write,
+    .maxPacketSize = 0U,
+    .capabilities  = 0U
+};
+
+const cy_stc_dfu_transport_ops_t SimSocket_Ops =
+{
+    .transport     = CY_DFU_UART,
+    .start         = &SimSocket_Start,
+    .stop          = &SimSocket_Stop,
+    .reset         = &SimSocket_Reset,
+    .read          = &SimSocket_Read,
+    .write         = &SimSocket_Write,
+    .maxPacketSize = 0U,
+    .capabilities  = 0U
+};
+
+
+/* [] END OF FILE */